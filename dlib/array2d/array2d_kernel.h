@@ -7,6 +7,7 @@
 #include "../algs.h"
 #include "../interfaces/enumerable.h"
 #include "../serialize.h"
+#include "../enable_if.h"
 #include "../geometry/rectangle.h"
 
 namespace dlib
@@ -348,6 +349,56 @@ namespace dlib
     ) { a.swap(b); }   
 
 
+    namespace impl
+    {
+        template <typename T, typename mem_manager>
+        typename enable_if_c<ser_helper::bulk_element_traits<T>::value,bool>::type serialize_array2d_bulk (
+            const array2d<T,mem_manager>& item, 
+            std::ostream& out 
+        )
+        {
+            // This is the same bulk format used by the matrix object.
+            ser_helper::serialize_bulk_header<T>(out);
+            serialize(item.nr(),out);
+            serialize(item.nc(),out);
+            if (item.size() != 0)
+                ser_helper::serialize_bulk_elements(&item[0][0], item.size(), out);
+            return true;
+        }
+
+        template <typename T, typename mem_manager>
+        typename disable_if_c<ser_helper::bulk_element_traits<T>::value,bool>::type serialize_array2d_bulk (
+            const array2d<T,mem_manager>& ,
+            std::ostream& 
+        ) { return false; }
+
+        template <typename T, typename mem_manager>
+        typename enable_if_c<ser_helper::bulk_element_traits<T>::value>::type deserialize_array2d_bulk (
+            array2d<T,mem_manager>& item, 
+            std::istream& in
+        )
+        {
+            char kind;
+            unsigned char size;
+            ser_helper::deserialize_bulk_header(kind, size, in);
+            long nr, nc;
+            deserialize(nr,in);
+            deserialize(nc,in);
+            if (nr < 0 || nc < 0)
+                abort();
+
+            item.set_size(nr,nc);
+            if (item.size() != 0)
+                ser_helper::deserialize_bulk_elements(&item[0][0], item.size(), kind, size, in);
+        }
+
+        template <typename T, typename mem_manager>
+        typename disable_if_c<ser_helper::bulk_element_traits<T>::value>::type deserialize_array2d_bulk (
+            array2d<T,mem_manager>& ,
+            std::istream& 
+        ) { abort(); }
+    }
+
     template <
         typename T,
         typename mem_manager
@@ -359,6 +410,12 @@ namespace dlib
     {
         try
         {
+            if (impl::serialize_array2d_bulk(item,out))
+            {
+                item.reset();
+                return;
+            }
+
             // The reason the serialization is a little funny is because we are trying to
             // maintain backwards compatibility with an older serialization format used by
             // dlib while also encoding things in a way that lets the array2d and matrix
@@ -388,6 +445,12 @@ namespace dlib
     {
         try
         {
+            if (ser_helper::bulk_format_is_next(in))
+            {
+                impl::deserialize_array2d_bulk(item,in);
+                return;
+            }
+
             long nr, nc;
             deserialize(nr,in);
             deserialize(nc,in);
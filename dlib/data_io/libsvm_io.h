@@ -12,6 +12,9 @@
 #include "../matrix.h"
 #include "../string.h"
 #include "../svm/sparse_vector.h"
+#include "../svm/ranking_tools.h"
+#include "../noncopyable.h"
+#include <sstream>
 #include <vector>
 
 namespace dlib
@@ -21,6 +24,89 @@ namespace dlib
         sample_data_io_error(const std::string& message): error(message) {}
     };
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        template <typename sample_type, typename label_type>
+        bool parse_libsvm_line (
+            const std::string& line,
+            std::istringstream& sin,
+            label_type& label,
+            sample_type& sample,
+            std::string& qid
+        )
+        /*!
+            ensures
+                - if (line is empty or is a comment) then
+                    - returns false
+                - else
+                    - parses line into label and sample and returns true.
+                    - if the line has a qid:<id> field right after the label then #qid == <id>,
+                      otherwise #qid == "".
+            throws
+                - sample_data_io_error
+                    This exception is thrown if line isn't in the libsvm format.
+        !*/
+        {
+            using namespace std;
+            typedef typename sample_type::value_type pair_type;
+            typedef typename basic_type<typename pair_type::first_type>::type key_type;
+            typedef typename pair_type::second_type value_type;
+
+            string::size_type pos = line.find_first_not_of(" \t\r\n");
+
+            // ignore empty lines or comment lines
+            if (pos == string::npos || line[pos] == '#')
+                return false;
+
+            sin.clear();
+            sin.str(line);
+            sample.clear();
+            qid.clear();
+
+            sin >> label;
+
+            if (!sin)
+                throw sample_data_io_error("Invalid libsvm formatted line: " + line);
+
+            // eat whitespace
+            sin >> ws;
+
+            // SVMrank style files put the query id right after the label.
+            if (sin.peek() == 'q')
+            {
+                sin >> qid >> ws;
+                if (qid.compare(0, 4, "qid:") != 0 || qid.size() == 4)
+                    throw sample_data_io_error("Invalid libsvm formatted line: " + line);
+                qid.erase(0, 4);
+            }
+
+            key_type key;
+            value_type value;
+            while (sin.peek() != EOF && sin.peek() != '#')
+            {
+
+                sin >> key >> ws;
+
+                // ignore what should be a : character
+                if (sin.get() != ':')
+                    throw sample_data_io_error("Invalid libsvm formatted line: " + line);
+
+                sin >> value;
+
+                if (sin && value != 0)
+                {
+                    sample.insert(sample.end(), make_pair(key, value));
+                }
+
+                sin >> ws;
+            }
+
+            return true;
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 
     template <typename sample_type, typename label_type, typename alloc1, typename alloc2>
@@ -33,7 +119,6 @@ namespace dlib
         using namespace std;
         typedef typename sample_type::value_type pair_type;
         typedef typename basic_type<typename pair_type::first_type>::type key_type;
-        typedef typename pair_type::second_type value_type;
 
         // You must use unsigned integral key types in your sparse vectors
         COMPILE_TIME_ASSERT(is_unsigned_type<key_type>::value);
@@ -44,62 +129,215 @@ namespace dlib
         ifstream fin(file_name.c_str());
 
         if (!fin)
-            abort();
+            throw sample_data_io_error("Unable to open file " + file_name);
 
         string line;
         istringstream sin;
-        key_type key;
-        value_type value;
         label_type label;
         sample_type sample;
-        long line_num = 0;
+        string qid;
         while (fin.peek() != EOF)
         {
-            ++line_num;
             getline(fin, line);
 
-            string::size_type pos = line.find_first_not_of(" \t\r\n");
+            if (impl::parse_libsvm_line(line, sin, label, sample, qid))
+            {
+                samples.push_back(sample);
+                labels.push_back(label);
+            }
+        }
 
-            // ignore empty lines or comment lines
-            if (pos == string::npos || line[pos] == '#')
-                continue;
+    }
 
-            sin.clear();
-            sin.str(line);
-            sample.clear();
+// ----------------------------------------------------------------------------------------
 
-            sin >> label;
+    template <
+        typename sample_type_,
+        typename label_type_ = double
+        >
+    class libsvm_sample_source : noncopyable
+    {
+    public:
+        typedef sample_type_ sample_type;
+        typedef label_type_ label_type;
+
+        libsvm_sample_source (
+            const std::string& file_name_,
+            unsigned long batch_size_ = 10000
+        ) : 
+            file_name(file_name_),
+            batch_size(batch_size_)
+        {
+            typedef typename sample_type::value_type pair_type;
+            typedef typename basic_type<typename pair_type::first_type>::type key_type;
 
-            if (!sin)
-                abort();
+            // You must use unsigned integral key types in your sparse vectors
+            COMPILE_TIME_ASSERT(is_unsigned_type<key_type>::value);
 
-            // eat whitespace
-            sin >> ws;
+            // make sure requires clause is not broken
+            DLIB_ASSERT(batch_size > 0,
+                "\t libsvm_sample_source::libsvm_sample_source()"
+                << "\n\t invalid inputs were given to this function"
+                << "\n\t batch_size: " << batch_size 
+                );
 
-            while (sin.peek() != EOF && sin.peek() != '#')
+            reset();
+        }
+
+        const std::string& get_file_name (
+        ) const { return file_name; }
+
+        unsigned long get_batch_size (
+        ) const { return batch_size; }
+
+        void reset (
+        )
+        {
+            fin.close();
+            fin.clear();
+            fin.open(file_name.c_str());
+            if (!fin)
+                throw sample_data_io_error("Unable to open file " + file_name);
+        }
+
+        bool next_batch (
+            std::vector<sample_type>& samples,
+            std::vector<label_type>& labels
+        )
+        {
+            samples.clear();
+            labels.clear();
+
+            label_type label;
+            while (samples.size() < batch_size && fin.peek() != EOF)
             {
+                std::getline(fin, line);
 
-                sin >> key >> ws;
+                samples.resize(samples.size()+1);
+                if (impl::parse_libsvm_line(line, sin, label, samples.back(), qid))
+                    labels.push_back(label);
+                else
+                    samples.pop_back();
+            }
 
-                // ignore what should be a : character
-                if (sin.get() != ':')
-                    abort();
+            return samples.size() != 0;
+        }
 
-                sin >> value;
+    private:
+        std::string file_name;
+        unsigned long batch_size;
+        std::ifstream fin;
+        std::string line;
+        std::istringstream sin;
+        std::string qid;
+    };
 
-                if (sin && value != 0)
-                {
-                    sample.insert(sample.end(), make_pair(key, value));
-                }
+// ----------------------------------------------------------------------------------------
 
-                sin >> ws;
+    template <
+        typename sample_type_
+        >
+    class libsvm_ranking_source : noncopyable
+    {
+    public:
+        typedef sample_type_ sample_type;
+
+        libsvm_ranking_source (
+            const std::string& file_name_,
+            unsigned long batch_size_ = 1000
+        ) : 
+            file_name(file_name_),
+            batch_size(batch_size_)
+        {
+            typedef typename sample_type::value_type pair_type;
+            typedef typename basic_type<typename pair_type::first_type>::type key_type;
+
+            // You must use unsigned integral key types in your sparse vectors
+            COMPILE_TIME_ASSERT(is_unsigned_type<key_type>::value);
+
+            // make sure requires clause is not broken
+            DLIB_ASSERT(batch_size > 0,
+                "\t libsvm_ranking_source::libsvm_ranking_source()"
+                << "\n\t invalid inputs were given to this function"
+                << "\n\t batch_size: " << batch_size 
+                );
+
+            reset();
+        }
+
+        const std::string& get_file_name (
+        ) const { return file_name; }
+
+        unsigned long get_batch_size (
+        ) const { return batch_size; }
+
+        void reset (
+        )
+        {
+            fin.close();
+            fin.clear();
+            fin.open(file_name.c_str());
+            if (!fin)
+                throw sample_data_io_error("Unable to open file " + file_name);
+            have_next = read_line();
+        }
+
+        bool next_batch (
+            std::vector<ranking_pair<sample_type> >& queries
+        )
+        {
+            queries.clear();
+
+            ranking_pair<sample_type> query;
+            while (queries.size() < batch_size && have_next)
+            {
+                // gather up all the consecutive lines with the same qid.
+                query.relevant.clear();
+                query.nonrelevant.clear();
+                const std::string cur_qid = next_qid;
+                do
+                {
+                    if (next_label > 0)
+                        query.relevant.push_back(next_sample);
+                    else
+                        query.nonrelevant.push_back(next_sample);
+                    have_next = read_line();
+                } while (have_next && next_qid == cur_qid);
+
+                // A query without both kinds of documents doesn't say anything about how
+                // to rank things, so skip it.
+                if (query.relevant.size() != 0 && query.nonrelevant.size() != 0)
+                    queries.push_back(query);
             }
 
-            samples.push_back(sample);
-            labels.push_back(label);
+            return queries.size() != 0;
         }
 
-    }
+    private:
+
+        bool read_line (
+        )
+        {
+            while (fin.peek() != EOF)
+            {
+                std::getline(fin, line);
+                if (impl::parse_libsvm_line(line, sin, next_label, next_sample, next_qid))
+                    return true;
+            }
+            return false;
+        }
+
+        std::string file_name;
+        unsigned long batch_size;
+        std::ifstream fin;
+        std::string line;
+        std::istringstream sin;
+
+        bool have_next;
+        double next_label;
+        sample_type next_sample;
+        std::string next_qid;
+    };
 
 // ----------------------------------------------------------------------------------------
 // ----------------------------------------------------------------------------------------
@@ -8,6 +8,8 @@
 #include <utility>
 #include "../algs.h"
 #include "../matrix.h"
+#include "../noncopyable.h"
+#include "../svm/ranking_tools_abstract.h"
 #include <vector>
 
 namespace dlib
@@ -43,11 +45,186 @@ namespace dlib
               in samples
             - #labels.size() == #samples.size()
             - for all valid i: #labels[i] is the label for #samples[i]
+            - Any SVMrank style qid:<id> fields in the file are ignored.
         throws
             - sample_data_io_error
                 This exception is thrown if there is any problem loading data from file
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename sample_type_,
+        typename label_type_ = double
+        >
+    class libsvm_sample_source : noncopyable
+    {
+        /*!
+            REQUIREMENTS ON sample_type_
+                - sample_type_ must be an STL container
+                - sample_type_::value_type == std::pair<T,U> where T is some kind of 
+                  unsigned integral type
+
+            WHAT THIS OBJECT REPRESENTS
+                This object reads a libsvm formatted file a batch at a time.  It
+                implements the interface defined by dlib::example_sample_source (see
+                dlib/svm/sample_source_abstract.h) and so can be given to the
+                train_from_source() methods of the linear SVM trainers to train on files
+                too big to load into memory.  Only one batch of samples is ever held by
+                this object.
+        !*/
+
+    public:
+        typedef sample_type_ sample_type;
+        typedef label_type_ label_type;
+
+        libsvm_sample_source (
+            const std::string& file_name,
+            unsigned long batch_size = 10000
+        );
+        /*!
+            requires
+                - batch_size > 0
+            ensures
+                - #get_file_name() == file_name
+                - #get_batch_size() == batch_size
+                - the next call to next_batch() returns the first samples in the file.
+            throws
+                - sample_data_io_error
+                    This exception is thrown if the file can't be opened.
+        !*/
+
+        const std::string& get_file_name (
+        ) const;
+        /*!
+            ensures
+                - returns the name of the file this object reads from.
+        !*/
+
+        unsigned long get_batch_size (
+        ) const;
+        /*!
+            ensures
+                - returns the maximum number of samples loaded by a call to next_batch().
+        !*/
+
+        void reset (
+        );
+        /*!
+            ensures
+                - rewinds the file so that the next call to next_batch() returns the first
+                  samples in the file.
+            throws
+                - sample_data_io_error
+                    This exception is thrown if the file can't be opened.
+        !*/
+
+        bool next_batch (
+            std::vector<sample_type>& samples,
+            std::vector<label_type>& labels
+        );
+        /*!
+            ensures
+                - reads the next get_batch_size() samples from the file, or however many
+                  are left if there are fewer, and stores them in #samples.
+                - #labels.size() == #samples.size()
+                - for all valid i: #labels[i] is the label for #samples[i]
+                - returns #samples.size() != 0
+                - SVMrank style qid:<id> fields in the file are ignored.
+            throws
+                - sample_data_io_error
+                    This exception is thrown if there is any problem parsing the file.
+        !*/
+    };
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename sample_type_
+        >
+    class libsvm_ranking_source : noncopyable
+    {
+        /*!
+            REQUIREMENTS ON sample_type_
+                - sample_type_ must be an STL container
+                - sample_type_::value_type == std::pair<T,U> where T is some kind of 
+                  unsigned integral type
+
+            WHAT THIS OBJECT REPRESENTS
+                This object reads an SVMrank style libsvm file a batch of queries at a
+                time.  That is, a file where each line looks like:
+                    <label> qid:<id> <index>:<value> <index>:<value> ...
+                Consecutive lines with the same qid make up one query and become one
+                ranking_pair.  Lines with a label > 0 go into its relevant vector and the
+                others go into its nonrelevant vector.  Queries that end up with no
+                relevant or no nonrelevant samples carry no ranking information and are
+                skipped.
+
+                This object implements the interface defined by
+                dlib::example_ranking_source (see dlib/svm/sample_source_abstract.h) and
+                so can be given to svm_rank_trainer::train_from_source().
+        !*/
+
+    public:
+        typedef sample_type_ sample_type;
+
+        libsvm_ranking_source (
+            const std::string& file_name,
+            unsigned long batch_size = 1000
+        );
+        /*!
+            requires
+                - batch_size > 0
+            ensures
+                - #get_file_name() == file_name
+                - #get_batch_size() == batch_size
+                - the next call to next_batch() returns the first queries in the file.
+            throws
+                - sample_data_io_error
+                    This exception is thrown if the file can't be opened or its first
+                    line can't be parsed.
+        !*/
+
+        const std::string& get_file_name (
+        ) const;
+        /*!
+            ensures
+                - returns the name of the file this object reads from.
+        !*/
+
+        unsigned long get_batch_size (
+        ) const;
+        /*!
+            ensures
+                - returns the maximum number of queries loaded by a call to next_batch().
+        !*/
+
+        void reset (
+        );
+        /*!
+            ensures
+                - rewinds the file so that the next call to next_batch() returns the first
+                  queries in the file.
+            throws
+                - sample_data_io_error
+                    This exception is thrown if the file can't be opened or its first
+                    line can't be parsed.
+        !*/
+
+        bool next_batch (
+            std::vector<ranking_pair<sample_type> >& queries
+        );
+        /*!
+            ensures
+                - reads the next get_batch_size() queries from the file, or however many
+                  are left if there are fewer, and stores them in #queries.
+                - returns #queries.size() != 0
+            throws
+                - sample_data_io_error
+                    This exception is thrown if there is any problem parsing the file.
+        !*/
+    };
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -14,6 +14,15 @@
 #include <string>
 #include <set>
 #include "../image_processing/full_object_detection.h"
+#include "../threads.h"
+#include "../serialize.h"
+#include "../crc32.h"
+#include <fstream>
+#include <iomanip>
+#include <cstdio>
+#include <sstream>
+#include <typeinfo>
+#include <algorithm>
 
 
 namespace dlib
@@ -29,6 +38,7 @@ namespace dlib
             _skip_empty_images = false;
             _have_parts = false;
             _filename = filename;
+            _num_threads = 1;
         }
 
         image_dataset_file boxes_match_label(
@@ -56,6 +66,29 @@ namespace dlib
             return temp;
         }
 
+        image_dataset_file use_threads(
+            unsigned long num_threads
+        ) const
+        {
+            // make sure requires clause is not broken
+            DLIB_ASSERT(num_threads > 0,
+                "\t image_dataset_file image_dataset_file::use_threads()"
+                << "\n\t You must use at least one thread."
+                );
+            image_dataset_file temp(*this);
+            temp._num_threads = num_threads;
+            return temp;
+        }
+
+        image_dataset_file use_cache(
+            const std::string& cache_filename
+        ) const
+        {
+            image_dataset_file temp(*this);
+            temp._cache_filename = cache_filename;
+            return temp;
+        }
+
         bool should_load_box (
             const image_dataset_metadata::box& box
         ) const
@@ -73,14 +106,256 @@ namespace dlib
         bool should_skip_empty_images() const { return _skip_empty_images; }
         bool should_boxes_have_parts() const { return _have_parts; }
         const std::set<std::string>& get_selected_box_labels() const { return _labels; }
+        unsigned long get_num_threads() const { return _num_threads; }
+        const std::string& get_cache_filename() const { return _cache_filename; }
 
     private:
         std::string _filename;
         std::set<std::string> _labels;
         bool _skip_empty_images;
         bool _have_parts;
+        unsigned long _num_threads;
+        std::string _cache_filename;
     };
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        /*
+            An image dataset cache file contains the following:
+                - the bytes of image_dataset_cache_header()
+                - a payload made of the serialized signature string and image array
+                - image_dataset_cache_trailer_size bytes holding the payload's length and
+                  crc32, as 16 and 8 hex digits.
+            dlib's deserialize() doesn't cope with a damaged file, so the trailer is
+            checked before any of the payload is deserialized.
+        */
+        inline const std::string& image_dataset_cache_header()
+        {
+            static const std::string header = "image_dataset_cache_v2\n";
+            return header;
+        }
+
+        const std::streamoff image_dataset_cache_trailer_size = 24;
+
+        inline bool image_dataset_cache_checksum (
+            std::istream& in,
+            std::streamoff length,
+            unsigned long& checksum
+        )
+        /*!
+            ensures
+                - #checksum == the crc32 of the next length bytes in in.
+                - returns false if in ends before length bytes have been read.
+        !*/
+        {
+            crc32 crc;
+            std::vector<char> buf;
+            while (length > 0)
+            {
+                buf.resize(static_cast<size_t>(std::min<std::streamoff>(length, 1<<16)));
+                in.read(&buf[0], buf.size());
+                if (in.gcount() != static_cast<std::streamsize>(buf.size()))
+                    return false;
+                crc.add(buf);
+                length -= buf.size();
+            }
+            checksum = crc.get_checksum();
+            return true;
+        }
+
+        template <
+            typename image_type, 
+            typename MM
+            >
+        bool load_image_dataset_cache (
+            array<image_type,MM>& images,
+            const std::string& cache_filename,
+            const std::string& signature
+        )
+        {
+            std::ifstream fin(cache_filename.c_str(), std::ios::binary);
+            if (!fin)
+                return false;
+
+            const std::string& header = image_dataset_cache_header();
+            const std::streamoff header_size = header.size();
+            std::string temp(header.size(), '\0');
+            fin.read(&temp[0], temp.size());
+            if (!fin || temp != header)
+                return false;
+
+            // Check the payload length and checksum recorded in the trailer.
+            fin.seekg(0, std::ios::end);
+            const std::streamoff payload_length = static_cast<std::streamoff>(fin.tellg()) -
+                header_size - image_dataset_cache_trailer_size;
+            if (payload_length <= 0)
+                return false;
+            fin.seekg(header_size + payload_length);
+            temp.resize(image_dataset_cache_trailer_size);
+            fin.read(&temp[0], temp.size());
+            if (!fin)
+                return false;
+            unsigned long long stored_length = 0;
+            unsigned long stored_checksum = 0;
+            std::istringstream sin1(temp.substr(0,16)), sin2(temp.substr(16));
+            sin1 >> std::hex >> stored_length;
+            sin2 >> std::hex >> stored_checksum;
+            if (!sin1 || !sin2 || stored_length != static_cast<unsigned long long>(payload_length))
+                return false;
+
+            unsigned long checksum;
+            fin.seekg(header_size);
+            if (!image_dataset_cache_checksum(fin, payload_length, checksum) || checksum != stored_checksum)
+                return false;
+
+            fin.seekg(header_size);
+            try
+            {
+                std::string sig;
+                deserialize(sig, fin);
+                if (sig != signature)
+                    return false;
+                deserialize(images, fin);
+                return true;
+            }
+            catch (serialization_error&)
+            {
+                images.clear();
+                return false;
+            }
+        }
+
+        template <
+            typename image_type, 
+            typename MM
+            >
+        void save_image_dataset_cache (
+            const array<image_type,MM>& images,
+            const std::string& cache_filename,
+            const std::string& signature
+        )
+        /*!
+            ensures
+                - writes images to cache_filename in the format read by
+                  load_image_dataset_cache().  The file is written under a temporary name
+                  and renamed into place, so an interrupted write never leaves a partial
+                  cache file behind.  If the cache can't be written it is simply skipped.
+        !*/
+        {
+            const std::string temp_filename = cache_filename + ".tmp";
+            const std::string& header = image_dataset_cache_header();
+            const std::streamoff header_size = header.size();
+            {
+                std::ofstream fout(temp_filename.c_str(), std::ios::binary);
+                if (!fout)
+                    return;
+                fout.write(header.c_str(), header.size());
+                serialize(signature, fout);
+                serialize(images, fout);
+            }
+
+            std::streamoff payload_length;
+            unsigned long checksum;
+            {
+                std::ifstream fin(temp_filename.c_str(), std::ios::binary);
+                fin.seekg(0, std::ios::end);
+                payload_length = static_cast<std::streamoff>(fin.tellg()) - header_size;
+                fin.seekg(header_size);
+                if (!fin || !image_dataset_cache_checksum(fin, payload_length, checksum))
+                {
+                    fin.close();
+                    std::remove(temp_filename.c_str());
+                    return;
+                }
+            }
+
+            std::ofstream fout(temp_filename.c_str(), std::ios::binary | std::ios::app);
+            fout << std::hex << std::setfill('0') 
+                 << std::setw(16) << static_cast<unsigned long long>(payload_length)
+                 << std::setw(8) << checksum;
+            fout.close();
+            // std::rename() won't replace an existing file on every platform.
+            std::remove(cache_filename.c_str());
+            if (!fout || std::rename(temp_filename.c_str(), cache_filename.c_str()) != 0)
+                std::remove(temp_filename.c_str());
+        }
+
+        template <
+            typename image_type, 
+            typename MM
+            >
+        void load_image_dataset_images (
+            array<image_type,MM>& images,
+            const std::vector<std::string>& filenames,
+            const image_dataset_file& source,
+            const std::string& old_working_dir
+        )
+        /*!
+            requires
+                - The current directory is the one containing the dataset's XML file, so
+                  the relative paths in filenames can be opened.
+            ensures
+                - #images.size() == filenames.size()
+                - #images[i] == the image in filenames[i]
+                - If source has a cache file then the images are read from it when it
+                  was made from the same image files, and otherwise they are loaded from
+                  the image files and the cache file is rewritten.  The cache filename is
+                  relative to old_working_dir.
+        !*/
+        {
+            // The cache is only valid for the same list of image files, of the same sizes
+            // and modification times, loaded into the same type of image object.
+            std::string signature;
+            if (source.get_cache_filename().size() != 0)
+            {
+                std::ostringstream sout;
+                sout << typeid(image_type).name() << "\n";
+                for (unsigned long i = 0; i < filenames.size(); ++i)
+                {
+                    const file f(filenames[i]);
+                    sout << filenames[i] << "\n" << f.size() << "\n"
+                         << f.last_modified().time_since_epoch().count() << "\n";
+                }
+                signature = sout.str();
+
+                const std::string dataset_dir = get_current_dir();
+                set_current_dir(old_working_dir);
+                const bool loaded = load_image_dataset_cache(images, source.get_cache_filename(), signature);
+                set_current_dir(dataset_dir);
+                if (loaded && images.size() == filenames.size())
+                    return;
+            }
+
+            images.clear();
+            images.resize(filenames.size());
+            // Each image is decoded into its own slot so the order of the images doesn't
+            // depend on which thread finishes first.
+            if (source.get_num_threads() > 1 && filenames.size() > 1)
+            {
+                thread_pool tp(std::min<unsigned long>(source.get_num_threads(), filenames.size()));
+                parallel_for(tp, 0, filenames.size(), [&](long i)
+                {
+                    load_image(images[i], filenames[i]);
+                });
+            }
+            else
+            {
+                for (unsigned long i = 0; i < filenames.size(); ++i)
+                    load_image(images[i], filenames[i]);
+            }
+
+            if (source.get_cache_filename().size() != 0)
+            {
+                const std::string dataset_dir = get_current_dir();
+                set_current_dir(old_working_dir);
+                save_image_dataset_cache(images, source.get_cache_filename(), signature);
+                set_current_dir(dataset_dir);
+            }
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -111,7 +386,7 @@ namespace dlib
 
 
 
-        image_type img;
+        std::vector<std::string> filenames;
         std::vector<rectangle> rects, ignored;
         for (unsigned long i = 0; i < data.images.size(); ++i)
         {
@@ -132,11 +407,12 @@ namespace dlib
             {
                 object_locations.push_back(rects);
                 ignored_rects.push_back(ignored);
-                load_image(img, data.images[i].filename);
-                images.push_back(img);
+                filenames.push_back(data.images[i].filename);
             }
         }
 
+        impl::load_image_dataset_images(images, filenames, source, old_working_dir);
+
         set_current_dir(old_working_dir);
         return ignored_rects;
     }
@@ -239,7 +515,7 @@ namespace dlib
 
         std::vector<std::vector<rectangle> > ignored_rects;
         std::vector<rectangle> ignored;
-        image_type img;
+        std::vector<std::string> filenames;
         std::vector<full_object_detection> object_dets;
         for (unsigned long i = 0; i < data.images.size(); ++i)
         {
@@ -274,11 +550,12 @@ namespace dlib
             {
                 object_locations.push_back(object_dets);
                 ignored_rects.push_back(ignored);
-                load_image(img, data.images[i].filename);
-                images.push_back(img);
+                filenames.push_back(data.images[i].filename);
             }
         }
 
+        impl::load_image_dataset_images(images, filenames, source, old_working_dir);
+
         set_current_dir(old_working_dir);
 
         return ignored_rects;
@@ -32,6 +32,8 @@ namespace dlib
             ensures
                 - #get_filename() == filename
                 - #should_skip_empty_images() == false
+                - #get_num_threads() == 1
+                - #get_cache_filename() == ""
                 - #get_selected_box_labels().size() == 0
                   This means that, initially, all boxes will be loaded.  Therefore, for all
                   possible boxes B we have:
@@ -95,6 +97,50 @@ namespace dlib
                   that #should_boxes_have_parts() == true.
         !*/
 
+        unsigned long get_num_threads(
+        ) const;
+        /*!
+            ensures
+                - returns the number of threads load_image_dataset() uses to decode the
+                  images in the dataset.  Regardless of this number, the images are always
+                  returned in the order they are listed in the XML file.
+        !*/
+
+        image_dataset_file use_threads(
+            unsigned long num_threads
+        ) const;
+        /*!
+            requires
+                - num_threads > 0
+            ensures
+                - returns a copy of *this that is identical in all respects to *this except
+                  that #get_num_threads() == num_threads.
+        !*/
+
+        const std::string& get_cache_filename(
+        ) const;
+        /*!
+            ensures
+                - returns the name of the file load_image_dataset() uses to cache the
+                  decoded images, or "" if no cache is used.  When the cache file exists
+                  and was made from the same image files (i.e. the same filenames with the
+                  same file sizes and modification times) loaded into the same image type,
+                  the images are deserialized from it rather than decoded.  Otherwise the
+                  images are decoded and the cache file is (re)written.  This includes the
+                  case where the cache file is truncated or isn't a cache file at all.  A
+                  relative cache filename is interpreted relative to the current working
+                  directory, not the directory of the XML file.
+        !*/
+
+        image_dataset_file use_cache(
+            const std::string& cache_filename
+        ) const;
+        /*!
+            ensures
+                - returns a copy of *this that is identical in all respects to *this except
+                  that #get_cache_filename() == cache_filename.
+        !*/
+
         bool should_load_box (
             const image_dataset_metadata::box& box
         ) const;
@@ -65,6 +65,7 @@ namespace dlib
             temp <<= 32;
             temp |= data.nFileSizeLow;
             state.file_size = temp;
+            state.last_modified = impl::filetime_to_time_point(data.ftLastWriteTime);
             FindClose(ffind);
         } 
 
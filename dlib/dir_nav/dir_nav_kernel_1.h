@@ -18,6 +18,7 @@
 #include "../windows_magic.h"
 #include <windows.h>
 #include <vector>
+#include <chrono>
 #include "../stl_checked.h"
 #include "../enable_if.h"
 #include "../queue.h"
@@ -26,6 +27,27 @@ namespace dlib
 {
 
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        inline std::chrono::time_point<std::chrono::system_clock> filetime_to_time_point (
+            const FILETIME& ft
+        )
+        {
+            // A FILETIME counts 100ns intervals since 1601-01-01 while system_clock counts
+            // from 1970-01-01.
+            uint64 temp = ft.dwHighDateTime;
+            temp <<= 32;
+            temp |= ft.dwLowDateTime;
+            const uint64 epoch_offset = 116444736000000000ULL;
+            const int64 ticks = static_cast<int64>(temp) - static_cast<int64>(epoch_offset);
+            return std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::duration<int64,std::ratio<1,10000000> >(ticks)));
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 // ----------------------------------------------------------------------------------------
     // file object    
@@ -39,11 +61,13 @@ namespace dlib
                 state.name        == name()
                 state.full_name   == full_name()
                 state.file_size   == size()
+                state.last_modified == last_modified()
 
             CONVENTION
                 state.name        == name()
                 state.full_name   == full_name()
                 state.file_size   == size()
+                state.last_modified == last_modified()
 
         !*/
 
@@ -54,6 +78,7 @@ namespace dlib
             uint64 file_size;
             std::string name;
             std::string full_name;
+            std::chrono::time_point<std::chrono::system_clock> last_modified;
         };
 
 
@@ -66,10 +91,12 @@ namespace dlib
             const std::string& name,
             const std::string& full_name,
             const uint64 file_size,
+            const std::chrono::time_point<std::chrono::system_clock>& last_modified,
             private_constructor
         )
         {
             state.file_size = file_size;
+            state.last_modified = last_modified;
             state.name = name;
             state.full_name = full_name;
         }
@@ -107,6 +134,9 @@ namespace dlib
         inline uint64 size (
         ) const { return state.file_size; }
 
+        inline std::chrono::time_point<std::chrono::system_clock> last_modified (
+        ) const { return state.last_modified; }
+
         bool operator == (
             const file& rhs
         ) const;
@@ -414,7 +444,8 @@ namespace dlib
                     file_size <<= 32;
                     file_size |= data.nFileSizeLow;
                     // this is a file so add it to the queue
-                    file temp(data.cFileName,path+data.cFileName,file_size, private_constructor());
+                    file temp(data.cFileName,path+data.cFileName,file_size,
+                              impl::filetime_to_time_point(data.ftLastWriteTime), private_constructor());
                     files.enqueue(temp);
                 }
 
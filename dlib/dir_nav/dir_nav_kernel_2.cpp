@@ -62,6 +62,7 @@ namespace dlib
         else
         {
             state.file_size = static_cast<uint64>(buffer.st_size);
+            state.last_modified = impl::stat_to_time_point(buffer);
         }
 
     }
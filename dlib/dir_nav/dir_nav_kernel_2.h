@@ -28,6 +28,7 @@
 #endif
 
 #include <vector>
+#include <chrono>
 #include "../stl_checked.h"
 #include "../enable_if.h"
 #include "../queue.h"
@@ -35,6 +36,31 @@
 namespace dlib
 {
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        inline std::chrono::time_point<std::chrono::system_clock> stat_to_time_point (
+            const struct stat64& buffer
+        )
+        {
+            // Keep the sub-second part of the modification time where stat provides it.
+            // st_mtime is a macro for st_mtim.tv_sec on systems with POSIX 2008 stat.
+#if defined(__APPLE__)
+            const struct timespec& t = buffer.st_mtimespec;
+#elif defined(st_mtime)
+            const struct timespec& t = buffer.st_mtim;
+#endif
+#if defined(__APPLE__) || defined(st_mtime)
+            return std::chrono::system_clock::from_time_t(t.tv_sec) +
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::nanoseconds(t.tv_nsec));
+#else
+            return std::chrono::system_clock::from_time_t(buffer.st_mtime);
+#endif
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 // ----------------------------------------------------------------------------------------
     // file object    
@@ -48,11 +74,13 @@ namespace dlib
                 state.name        == name()
                 state.full_name   == full_name()
                 state.file_size   == size()
+                state.last_modified == last_modified()
 
             CONVENTION
                 state.name        == name()
                 state.full_name   == full_name()
                 state.file_size   == size()
+                state.last_modified == last_modified()
 
         !*/
 
@@ -63,6 +91,7 @@ namespace dlib
             uint64 file_size;
             std::string name;
             std::string full_name;
+            std::chrono::time_point<std::chrono::system_clock> last_modified;
         };
 
         void init(const std::string& name);
@@ -74,10 +103,12 @@ namespace dlib
             const std::string& name,
             const std::string& full_name,
             const uint64 file_size,
+            const std::chrono::time_point<std::chrono::system_clock>& last_modified,
             private_constructor
         )
         {
             state.file_size = file_size;
+            state.last_modified = last_modified;
             state.name = name;
             state.full_name = full_name;
         }
@@ -110,6 +141,9 @@ namespace dlib
         inline uint64 size (
         ) const { return state.file_size; }
 
+        inline std::chrono::time_point<std::chrono::system_clock> last_modified (
+        ) const { return state.last_modified; }
+
         operator std::string (
         ) const { return full_name(); }
 
@@ -367,6 +401,7 @@ namespace dlib
                 }
 
                 uint64 file_size;
+                std::chrono::time_point<std::chrono::system_clock> last_modified;
                 // get a stat64 structure so we can see if this is a file
                 if (::stat64((path+data->d_name).c_str(), &buffer) != 0)
                 {
@@ -382,6 +417,7 @@ namespace dlib
                 else
                 {
                     file_size = static_cast<uint64>(buffer.st_size);
+                    last_modified = impl::stat_to_time_point(buffer);
                 }
 
                 if (S_ISDIR(buffer.st_mode) == 0)
@@ -391,6 +427,7 @@ namespace dlib
                         data->d_name,
                         path+data->d_name,
                         file_size,
+                        last_modified,
                         file::private_constructor()
                         );
                     files.enqueue(temp);
@@ -5,6 +5,7 @@
 
 #include <string>
 #include <vector>
+#include <chrono>
 #include "../uintn.h"
 #include "../algs.h"
 
@@ -139,6 +140,14 @@ namespace dlib
                 - returns the size of this file in bytes.
         !*/
 
+        std::chrono::time_point<std::chrono::system_clock> last_modified (
+        ) const;
+        /*!
+            ensures
+                - returns the time this file was last modified, as recorded when this
+                  object was constructed.
+        !*/
+
         operator std::string (
         ) const; 
         /*!
@@ -16,6 +16,7 @@
 #include <tuple>
 #include <cmath>
 #include <vector>
+#include <functional>
 #include "tensor_tools.h"
 #include <type_traits>
 
@@ -110,6 +111,88 @@ namespace dlib
             sout << "\t";
             return sout.str();
         }
+
+        class released_outputs
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This object is used by the layers of a network in inference mode to
+                    recycle output tensors.  It holds the output tensors that layers have
+                    finished with, along with the number of elements in the output of the
+                    layer that owns it the last time that layer ran.  The held tensors are
+                    lent down the network during forward() so each layer can write its
+                    output into a tensor of exactly the size it needs.  Since
+                    resizable_tensor reallocates whenever its size changes this means that
+                    repeated calls to forward() with inputs of the same shape don't
+                    allocate any memory once the network has run a couple of times.
+
+                    The held tensors are only a cache, so copies of this object start out
+                    empty.
+            !*/
+        public:
+            released_outputs() : output_size(0) {}
+            released_outputs(const released_outputs&) : output_size(0) {}
+            released_outputs& operator=(const released_outputs&) { clear(); return *this; }
+            released_outputs(released_outputs&& item) : released_outputs() { swap(item); }
+            released_outputs& operator=(released_outputs&& item) { swap(item); return *this; }
+
+            void clear()
+            {
+                tensors.clear();
+                output_size = 0;
+            }
+
+            void swap(released_outputs& item)
+            {
+                tensors.swap(item.tensors);
+                std::swap(output_size, item.output_size);
+            }
+
+            void swap_tensors(released_outputs& item)
+            {
+                tensors.swap(item.tensors);
+            }
+
+            void add(resizable_tensor& item)
+            {
+                if (item.size() == 0)
+                    return;
+                tensors.emplace_back();
+                tensors.back().swap(item);
+            }
+
+            void take(resizable_tensor& dest)
+            {
+                // Before the owning layer has run we don't know what size it needs, so
+                // any tensor will do.  After that only one of the right size is taken.
+                for (size_t i = tensors.size(); i-- > 0; )
+                {
+                    if (output_size == 0 || tensors[i].size() == output_size)
+                    {
+                        dest.swap(tensors[i]);
+                        tensors[i].swap(tensors.back());
+                        tensors.pop_back();
+                        return;
+                    }
+                }
+            }
+
+            void set_output_size(size_t size)
+            {
+                // If the output size changed then the shapes of the tensors flowing
+                // through the network changed, so the held tensors are the wrong size
+                // and are dropped.
+                if (output_size != 0 && output_size != size)
+                    tensors.clear();
+                output_size = size;
+            }
+
+            size_t size() const { return tensors.size(); }
+
+        private:
+            std::vector<resizable_tensor> tensors;
+            size_t output_size;
+        };
     }
 
 // ----------------------------------------------------------------------------------------
@@ -122,6 +205,10 @@ namespace dlib
     // Tell us if T is an instance of add_layer
     template <typename T> struct is_add_layer : std::false_type {};
 
+    // Called by back_propagate_error() with each layer's parameter gradient as soon as
+    // that layer's backward() has finished, while the layers below it are still running.
+    typedef std::function<void(tensor& params_grad)> gradient_ready_callback;
+
     namespace impl
     {
         template <size_t... n>
@@ -583,7 +670,8 @@ namespace dlib
             subnetwork(new subnet_type()),
             this_layer_setup_called(false),
             gradient_input_is_stale(true),
-            get_output_and_gradient_input_disabled(false)
+            get_output_and_gradient_input_disabled(false),
+            inference_mode(false)
         {
             if (this_layer_operates_inplace())
                 subnetwork->disable_output_and_gradient_getters();
@@ -596,6 +684,7 @@ namespace dlib
             this_layer_setup_called = item.this_layer_setup_called;
             gradient_input_is_stale = item.gradient_input_is_stale;
             get_output_and_gradient_input_disabled = item.get_output_and_gradient_input_disabled;
+            inference_mode = item.inference_mode;
             x_grad = item.x_grad;
             cached_output = item.cached_output; 
             params_grad = item.params_grad; 
@@ -627,11 +716,13 @@ namespace dlib
             this_layer_setup_called(item.this_layer_setup_called),
             gradient_input_is_stale(item.gradient_input_is_stale),
             get_output_and_gradient_input_disabled(item.get_output_and_gradient_input_disabled),
+            inference_mode(false),
             x_grad(item.x_grad),
             cached_output(item.cached_output)
         {
             if (this_layer_operates_inplace())
                 subnetwork->disable_output_and_gradient_getters();
+            inference_mode = item.inference_mode;
         }
 
         template <typename ...T>
@@ -643,7 +734,8 @@ namespace dlib
             subnetwork(new subnet_type(std::forward<T>(args)...)),
             this_layer_setup_called(false),
             gradient_input_is_stale(true),
-            get_output_and_gradient_input_disabled(false)
+            get_output_and_gradient_input_disabled(false),
+            inference_mode(false)
         {
             if (this_layer_operates_inplace())
                 subnetwork->disable_output_and_gradient_getters();
@@ -685,7 +777,8 @@ namespace dlib
             subnetwork(new subnet_type(std::forward<T>(args)...)),
             this_layer_setup_called(false),
             gradient_input_is_stale(true),
-            get_output_and_gradient_input_disabled(false)
+            get_output_and_gradient_input_disabled(false),
+            inference_mode(false)
         {
             if (this_layer_operates_inplace())
                 subnetwork->disable_output_and_gradient_getters();
@@ -700,7 +793,8 @@ namespace dlib
             subnetwork(new subnet_type(std::forward<T>(args)...)),
             this_layer_setup_called(false),
             gradient_input_is_stale(true),
-            get_output_and_gradient_input_disabled(false)
+            get_output_and_gradient_input_disabled(false),
+            inference_mode(false)
         {
             if (this_layer_operates_inplace())
                 subnetwork->disable_output_and_gradient_getters();
@@ -715,7 +809,8 @@ namespace dlib
             subnetwork(new subnet_type(tuple_tail(layer_det),std::forward<T>(args)...)),
             this_layer_setup_called(false),
             gradient_input_is_stale(true),
-            get_output_and_gradient_input_disabled(false)
+            get_output_and_gradient_input_disabled(false),
+            inference_mode(false)
         {
             if (this_layer_operates_inplace())
                 subnetwork->disable_output_and_gradient_getters();
@@ -767,7 +862,13 @@ namespace dlib
 
         const tensor& forward(const tensor& x)
         {
+            // Lend the output tensors we are holding to the subnetwork so its layers can
+            // write into them, then take back whatever is left over.
+            if (inference_mode)
+                subnetwork->private_swap_released_outputs(released_output);
             subnetwork->forward(x);
+            if (inference_mode)
+                subnetwork->private_swap_released_outputs(released_output);
             const dimpl::subnet_wrapper<subnet_type> wsub(*subnetwork);
             if (!this_layer_setup_called)
             {
@@ -775,14 +876,49 @@ namespace dlib
                 this_layer_setup_called = true;
             }
             if (this_layer_operates_inplace())
+            {
+                if (inference_mode)
+                    cached_output.clear();
                 impl::call_layer_forward(details, wsub, private_get_output());
+            }
             else
+            {
+                // Write into a buffer some other layer has finished with rather than
+                // allocating a new one.
+                if (inference_mode && cached_output.size() == 0)
+                    released_output.take(cached_output);
                 impl::call_layer_forward(details, wsub, cached_output);
+                // Once this layer has run nothing else needs the subnetwork's output
+                // (unless it's tagged, in which case private_release_output() keeps it).
+                if (inference_mode)
+                {
+                    released_output.set_output_size(cached_output.size());
+                    resizable_tensor temp;
+                    subnetwork->private_release_output(temp);
+                    released_output.add(temp);
+                }
+            }
 
             gradient_input_is_stale = true;
             return private_get_output();
         }
 
+        void set_inference_mode (
+            bool enabled
+        )
+        {
+            inference_mode = enabled;
+            if (inference_mode)
+            {
+                // None of the gradient buffers are used in inference mode.
+                x_grad.clear();
+                params_grad.clear();
+                gradient_input_is_stale = true;
+            }
+            released_output.clear();
+            subnetwork->set_inference_mode(enabled);
+        }
+
     private:
         tensor& private_get_output() const
         { 
@@ -833,12 +969,27 @@ namespace dlib
         }
         void back_propagate_error(const tensor& x, const tensor& gradient_input)
         {
+            back_propagate_error(x, gradient_input, gradient_ready_callback());
+        }
+        void back_propagate_error(const tensor& x, const gradient_ready_callback& on_gradient_ready)
+        {
+            back_propagate_error(x, private_get_gradient_input(), on_gradient_ready);
+        }
+        void back_propagate_error(
+            const tensor& x,
+            const tensor& gradient_input,
+            const gradient_ready_callback& on_gradient_ready
+        )
+        {
+            DLIB_CASSERT(!inference_mode, "back_propagate_error() can't be called in inference mode.");
             dimpl::subnet_wrapper<subnet_type> wsub(*subnetwork);
             params_grad.copy_size(details.get_layer_params());
             impl::call_layer_backward(details, private_get_output(),
                 gradient_input, wsub, static_cast<tensor&>(params_grad));
+            if (on_gradient_ready)
+                on_gradient_ready(params_grad);
 
-            subnetwork->back_propagate_error(x); 
+            subnetwork->back_propagate_error(x, on_gradient_ready); 
 
             // zero out get_gradient_input()
             gradient_input_is_stale = true;
@@ -876,6 +1027,7 @@ namespace dlib
             cached_output.clear();
             params_grad.clear();
             temp_tensor.clear();
+            released_output.clear();
             gradient_input_is_stale = true;
             subnetwork->clean();
         }
@@ -931,7 +1083,10 @@ namespace dlib
         {
             // This layer can run in-place if it's an in-place capable layer and also if
             // the layer it's on top of doesn't need its own output tensor (since in-place
-            // layers overwrite that tensor)
+            // layers overwrite that tensor).  Without back propagation the only layers
+            // that need that tensor are ones that reach it through a tag.
+            if (inference_mode)
+                return impl::is_inplace_layer(details, *subnetwork) && !subnetwork->this_layer_output_is_tagged();
             return impl::is_inplace_layer(details, *subnetwork) && !subnetwork->this_layer_requires_forward_output();
         }
         bool this_layer_requires_forward_output(
@@ -940,6 +1095,33 @@ namespace dlib
             return impl::backward_requires_forward_output(details, *subnetwork);
         }
 
+        // An in-place layer never sits on top of a tagged output, so the output of an
+        // add_layer is never tagged.
+        bool this_layer_output_is_tagged(
+        ) { return false; }
+
+        void private_release_output(
+            resizable_tensor& dest
+        )
+        {
+            if (this_layer_operates_inplace())
+            {
+                subnetwork->private_release_output(dest);
+            }
+            else
+            {
+                dest.clear();
+                dest.swap(cached_output);
+            }
+        }
+
+        void private_swap_released_outputs(
+            impl::released_outputs& item
+        )
+        {
+            released_output.swap_tensors(item);
+        }
+
         void swap(add_layer& item)
         {
             std::swap(subnetwork,item.subnetwork);
@@ -947,9 +1129,11 @@ namespace dlib
             std::swap(this_layer_setup_called, item.this_layer_setup_called);
             std::swap(gradient_input_is_stale, item.gradient_input_is_stale);
             std::swap(get_output_and_gradient_input_disabled, item.get_output_and_gradient_input_disabled);
+            std::swap(inference_mode, item.inference_mode);
             std::swap(x_grad, item.x_grad);
             std::swap(cached_output, item.cached_output);
             std::swap(params_grad, item.params_grad);
+            std::swap(released_output, item.released_output);
         }
 
 
@@ -958,6 +1142,7 @@ namespace dlib
         bool this_layer_setup_called;
         bool gradient_input_is_stale;
         bool get_output_and_gradient_input_disabled;
+        bool inference_mode;
         // Note that if this_layer_operates_inplace()==true then x_grad and cached_output
         // are not used at all.  Instead, this layer uses these variables from the lower
         // layer.
@@ -970,6 +1155,10 @@ namespace dlib
         // It is here only to prevent it from being reallocated over and over.
         resizable_tensor temp_tensor;
 
+        // In inference mode, this holds the output tensors of the layers in this network
+        // that are no longer needed so other layers can write their outputs into them.
+        impl::released_outputs released_output;
+
     };
 
     template <typename T, typename U, typename E>
@@ -1002,7 +1191,8 @@ namespace dlib
         ): 
             this_layer_setup_called(false),
             gradient_input_is_stale(true),
-            get_output_and_gradient_input_disabled(false)
+            get_output_and_gradient_input_disabled(false),
+            inference_mode(false)
         {}
 
         add_layer(const add_layer&) = default;
@@ -1032,6 +1222,7 @@ namespace dlib
             this_layer_setup_called(item.this_layer_setup_called),
             gradient_input_is_stale(item.gradient_input_is_stale),
             get_output_and_gradient_input_disabled(false),
+            inference_mode(item.inference_mode),
             x_grad(item.x_grad),
             cached_output(item.cached_output),
             grad_final(item.grad_final)
@@ -1044,7 +1235,8 @@ namespace dlib
             details(layer_det), 
             this_layer_setup_called(false),
             gradient_input_is_stale(true),
-            get_output_and_gradient_input_disabled(false)
+            get_output_and_gradient_input_disabled(false),
+            inference_mode(false)
         {}
 
         add_layer(
@@ -1053,7 +1245,8 @@ namespace dlib
             input_layer(il), 
             this_layer_setup_called(false),
             gradient_input_is_stale(true),
-            get_output_and_gradient_input_disabled(false)
+            get_output_and_gradient_input_disabled(false),
+            inference_mode(false)
         {}
 
         add_layer(
@@ -1062,7 +1255,8 @@ namespace dlib
             details(std::move(layer_det)), 
             this_layer_setup_called(false),
             gradient_input_is_stale(true),
-            get_output_and_gradient_input_disabled(false)
+            get_output_and_gradient_input_disabled(false),
+            inference_mode(false)
         {}
 
         add_layer(
@@ -1073,7 +1267,8 @@ namespace dlib
             input_layer(std::move(il)),
             this_layer_setup_called(false),
             gradient_input_is_stale(true),
-            get_output_and_gradient_input_disabled(false)
+            get_output_and_gradient_input_disabled(false),
+            inference_mode(false)
         {}
 
         add_layer(
@@ -1140,11 +1335,30 @@ namespace dlib
                 details.setup(wsub);
                 this_layer_setup_called = true;
             }
+            if (inference_mode && cached_output.size() == 0)
+                released_output.take(cached_output);
             impl::call_layer_forward(details, wsub, cached_output);
+            if (inference_mode)
+                released_output.set_output_size(cached_output.size());
             gradient_input_is_stale = true;
             return private_get_output();
         }
 
+        void set_inference_mode (
+            bool enabled_
+        )
+        {
+            inference_mode = enabled_;
+            if (inference_mode)
+            {
+                x_grad.clear();
+                grad_final.clear();
+                params_grad.clear();
+                gradient_input_is_stale = true;
+            }
+            released_output.clear();
+        }
+
     private:
         tensor& private_get_output() const { return const_cast<resizable_tensor&>(cached_output); }
         tensor& private_get_gradient_input() 
@@ -1182,6 +1396,19 @@ namespace dlib
         }
         void back_propagate_error(const tensor& x, const tensor& gradient_input)
         {
+            back_propagate_error(x, gradient_input, gradient_ready_callback());
+        }
+        void back_propagate_error(const tensor& x, const gradient_ready_callback& on_gradient_ready)
+        {
+            back_propagate_error(x, private_get_gradient_input(), on_gradient_ready);
+        }
+        void back_propagate_error(
+            const tensor& x,
+            const tensor& gradient_input,
+            const gradient_ready_callback& on_gradient_ready
+        )
+        {
+            DLIB_CASSERT(!inference_mode, "back_propagate_error() can't be called in inference mode.");
             // make sure grad_final is initialized to 0
             if (!have_same_dimensions(x, grad_final))
                 grad_final.copy_size(x);
@@ -1191,6 +1418,8 @@ namespace dlib
             params_grad.copy_size(details.get_layer_params());
             impl::call_layer_backward(details, private_get_output(),
                 gradient_input, wsub, static_cast<tensor&>(params_grad));
+            if (on_gradient_ready)
+                on_gradient_ready(params_grad);
 
             // zero out get_gradient_input()
             gradient_input_is_stale = true;
@@ -1228,6 +1457,7 @@ namespace dlib
             cached_output.clear();
             params_grad.clear();
             temp_tensor.clear();
+            released_output.clear();
             gradient_input_is_stale = true;
         }
 
@@ -1287,6 +1517,24 @@ namespace dlib
             return impl::backward_requires_forward_output(details, wsub);
         }
 
+        bool this_layer_output_is_tagged(
+        ) { return false; }
+
+        void private_release_output(
+            resizable_tensor& dest
+        )
+        {
+            dest.clear();
+            dest.swap(cached_output);
+        }
+
+        void private_swap_released_outputs(
+            impl::released_outputs& item
+        )
+        {
+            released_output.swap_tensors(item);
+        }
+
         class subnet_wrapper
         {
         public:
@@ -1319,9 +1567,11 @@ namespace dlib
             std::swap(this_layer_setup_called, item.this_layer_setup_called);
             std::swap(gradient_input_is_stale, item.gradient_input_is_stale);
             std::swap(get_output_and_gradient_input_disabled, item.get_output_and_gradient_input_disabled);
+            std::swap(inference_mode, item.inference_mode);
             std::swap(x_grad, item.x_grad); 
             std::swap(cached_output, item.cached_output); 
             std::swap(grad_final, item.grad_final); 
+            std::swap(released_output, item.released_output);
         }
 
         subnet_type input_layer;
@@ -1329,6 +1579,7 @@ namespace dlib
         bool this_layer_setup_called;
         bool gradient_input_is_stale;
         bool get_output_and_gradient_input_disabled;
+        bool inference_mode;
         resizable_tensor x_grad; 
         resizable_tensor cached_output; 
         resizable_tensor grad_final;
@@ -1338,6 +1589,10 @@ namespace dlib
         // member functions.
         resizable_tensor params_grad; 
         resizable_tensor temp_tensor; 
+
+        // In inference mode, this holds the output tensors lent to this layer by the
+        // layers above it during forward() so it can write its output into one of them.
+        impl::released_outputs released_output;
     };
 
 // ----------------------------------------------------------------------------------------
@@ -1414,6 +1669,13 @@ namespace dlib
             return subnetwork.forward(x);
         }
 
+        void set_inference_mode (
+            bool enabled
+        )
+        {
+            subnetwork.set_inference_mode(enabled);
+        }
+
         const tensor& get_output() const { return subnetwork.get_output(); }
 
         tensor& get_gradient_input() 
@@ -1432,6 +1694,18 @@ namespace dlib
         {
             subnetwork.back_propagate_error(x,gradient_input);
         }
+        void back_propagate_error(const tensor& x, const gradient_ready_callback& on_gradient_ready)
+        {
+            subnetwork.back_propagate_error(x,on_gradient_ready);
+        }
+        void back_propagate_error(
+            const tensor& x,
+            const tensor& gradient_input,
+            const gradient_ready_callback& on_gradient_ready
+        )
+        {
+            subnetwork.back_propagate_error(x,gradient_input,on_gradient_ready);
+        }
 
         template <typename solver_type>
         void update_parameters(sstack<solver_type> solvers, double learning_rate)
@@ -1500,6 +1774,23 @@ namespace dlib
         bool this_layer_requires_forward_output(
         ) { return true; } 
 
+        bool this_layer_output_is_tagged(
+        ) { return true; } 
+
+        void private_release_output(
+            resizable_tensor& 
+        )
+        {
+            // Layers further up the network may still want to look at the tagged output.
+        }
+
+        void private_swap_released_outputs(
+            impl::released_outputs& item
+        )
+        {
+            subnetwork.private_swap_released_outputs(item);
+        }
+
         void disable_output_and_gradient_getters (
         ) 
         { 
@@ -1568,7 +1859,8 @@ namespace dlib
 
         repeat(
         ) : 
-            details(num)
+            details(num),
+            inference_mode(false)
         {
         }
 
@@ -1600,7 +1892,8 @@ namespace dlib
         repeat(
             const repeat<num,T,U>& item
         ) : 
-            subnetwork(item.subnetwork)
+            subnetwork(item.subnetwork),
+            inference_mode(item.inference_mode)
         {
             for (auto&& d : item.details)
                 details.emplace_back(d);
@@ -1612,7 +1905,8 @@ namespace dlib
             U ...args2
         ): 
             details(num, std::move(arg1)),
-            subnetwork(std::move(args2)...)
+            subnetwork(std::move(args2)...),
+            inference_mode(false)
         {
         }
 
@@ -1622,7 +1916,8 @@ namespace dlib
             U ...args2
         ): 
             details(num, arg1.data),
-            subnetwork(std::move(args2)...)
+            subnetwork(std::move(args2)...),
+            inference_mode(false)
         {
         }
 
@@ -1633,7 +1928,8 @@ namespace dlib
             U ...args2
         ): 
             details(num, std::move(arg1)),
-            subnetwork(std::move(args2)...)
+            subnetwork(std::move(args2)...),
+            inference_mode(false)
         {
         }
 
@@ -1664,13 +1960,30 @@ namespace dlib
 
         const tensor& forward(const tensor& x)
         {
-            subnetwork.forward(x);
-            details[details.size()-1].forward(subnetwork.get_output());
+            forward_with_released_outputs(subnetwork, x);
+            forward_with_released_outputs(details[details.size()-1], subnetwork.get_output());
+            if (inference_mode)
+                release_output_of(subnetwork);
             for (long i = details.size()-2; i >= 0; --i)
-                details[i].forward(details[i+1].get_output());
+            {
+                forward_with_released_outputs(details[i], details[i+1].get_output());
+                if (inference_mode)
+                    release_output_of(details[i+1]);
+            }
             return private_get_output();
         }
 
+        void set_inference_mode (
+            bool enabled
+        )
+        {
+            inference_mode = enabled;
+            released_output.clear();
+            for (auto&& d : details)
+                d.set_inference_mode(enabled);
+            subnetwork.set_inference_mode(enabled);
+        }
+
     private:
         tensor& private_get_output() const
         { 
@@ -1701,23 +2014,35 @@ namespace dlib
             back_propagate_error(x, private_get_gradient_input());
         }
         void back_propagate_error(const tensor& x, const tensor& gradient_input)
+        {
+            back_propagate_error(x, gradient_input, gradient_ready_callback());
+        }
+        void back_propagate_error(const tensor& x, const gradient_ready_callback& on_gradient_ready)
+        {
+            back_propagate_error(x, private_get_gradient_input(), on_gradient_ready);
+        }
+        void back_propagate_error(
+            const tensor& x,
+            const tensor& gradient_input,
+            const gradient_ready_callback& on_gradient_ready
+        )
         {
             if (details.size() > 1)
             {
-                details[0].back_propagate_error(details[1].get_output(), gradient_input);
+                details[0].back_propagate_error(details[1].get_output(), gradient_input, on_gradient_ready);
                 for (size_t i = 1; i < details.size(); ++i)
                 {
                     if (i+1 < details.size())
-                        details[i].back_propagate_error(details[i+1].get_output(), details[i-1].get_final_data_gradient());
+                        details[i].back_propagate_error(details[i+1].get_output(), details[i-1].get_final_data_gradient(), on_gradient_ready);
                     else
-                        details[i].back_propagate_error(subnetwork.get_output(), details[i-1].get_final_data_gradient());
+                        details[i].back_propagate_error(subnetwork.get_output(), details[i-1].get_final_data_gradient(), on_gradient_ready);
                 }
             }
             else
             {
-                details[0].back_propagate_error(subnetwork.get_output(), gradient_input);
+                details[0].back_propagate_error(subnetwork.get_output(), gradient_input, on_gradient_ready);
             }
-            subnetwork.back_propagate_error(x, details.back().get_final_data_gradient());
+            subnetwork.back_propagate_error(x, details.back().get_final_data_gradient(), on_gradient_ready);
         }
 
         template <typename solver_type>
@@ -1734,6 +2059,7 @@ namespace dlib
         void clean()
         {
             temp_tensor.clear();
+            released_output.clear();
             subnetwork.clean();
             for (auto&& d : details)
                 d.clean();
@@ -1799,13 +2125,61 @@ namespace dlib
             details[0].disable_output_and_gradient_getters();
         }
 
+        bool this_layer_output_is_tagged(
+        ) 
+        { 
+            return details[0].this_layer_output_is_tagged(); 
+        } 
+
+        void private_release_output(
+            resizable_tensor& dest
+        )
+        {
+            details[0].private_release_output(dest);
+        }
+
+        void private_swap_released_outputs(
+            impl::released_outputs& item
+        )
+        {
+            released_output.swap_tensors(item);
+        }
+
+        template <typename net_type>
+        void forward_with_released_outputs(
+            net_type& net,
+            const tensor& x
+        )
+        {
+            // Lend the output tensors we are holding to net so its layers can write into
+            // them, then take back whatever is left over.
+            if (inference_mode)
+                net.private_swap_released_outputs(released_output);
+            net.forward(x);
+            if (inference_mode)
+                net.private_swap_released_outputs(released_output);
+        }
+
+        template <typename net_type>
+        void release_output_of(
+            net_type& net
+        )
+        {
+            resizable_tensor temp;
+            net.private_release_output(temp);
+            released_output.add(temp);
+        }
 
         std::vector<repeated_layer_type> details; 
         subnet_type subnetwork;
+        bool inference_mode;
 
         // temp_tensor doesn't logically contribute to the state of this class.
         // It is here only to void needing to reallocate it over and over.
         resizable_tensor temp_tensor;
+        // In inference mode, this holds the output tensors of the layers in this network
+        // that are no longer needed so other layers can write their outputs into them.
+        impl::released_outputs released_output;
     };
 
     template <
@@ -1906,6 +2280,13 @@ namespace dlib
             return get_output();
         }
 
+        void set_inference_mode (
+            bool 
+        )
+        {
+            // There aren't any add_layers below this tag so there is nothing to do.
+        }
+
         const tensor& get_output() const 
         { 
             if (cached_output_ptr)
@@ -1937,6 +2318,18 @@ namespace dlib
         {
             // nothing to do
         }
+        void back_propagate_error(const tensor& /*x*/, const gradient_ready_callback& /*on_gradient_ready*/)
+        {
+            // nothing to do
+        }
+        void back_propagate_error(
+            const tensor& /*x*/,
+            const tensor& /*gradient_input*/,
+            const gradient_ready_callback& /*on_gradient_ready*/
+        )
+        {
+            // nothing to do
+        }
 
         template <typename solver_type>
         void update_parameters(sstack<solver_type> /*solvers*/, double /*learning_rate*/)
@@ -2011,6 +2404,21 @@ namespace dlib
         bool this_layer_requires_forward_output(
         ) { return true; } 
 
+        bool this_layer_output_is_tagged(
+        ) { return true; } 
+
+        void private_release_output(
+            resizable_tensor& 
+        )
+        {
+        }
+
+        void private_swap_released_outputs(
+            impl::released_outputs& 
+        )
+        {
+        }
+
         void disable_output_and_gradient_getters (
         ) 
         { 
@@ -2255,6 +2663,19 @@ namespace dlib
             subnetwork.back_propagate_error(x);
             return l;
         }
+        template <typename label_iterator>
+        double compute_parameter_gradients (
+            const tensor& x,
+            label_iterator lbegin,
+            const gradient_ready_callback& on_gradient_ready
+        )
+        {
+            subnetwork.forward(x);
+            dimpl::subnet_wrapper<subnet_type> wsub(subnetwork);
+            double l = loss.compute_loss_value_and_gradient(x, lbegin, wsub);
+            subnetwork.back_propagate_error(x, on_gradient_ready);
+            return l;
+        }
         template <typename forward_iterator, typename label_iterator>
         double compute_parameter_gradients (
             forward_iterator ibegin,
@@ -2275,6 +2696,17 @@ namespace dlib
             subnetwork.back_propagate_error(x);
             return l;
         }
+        double compute_parameter_gradients (
+            const tensor& x,
+            const gradient_ready_callback& on_gradient_ready
+        )
+        {
+            subnetwork.forward(x);
+            dimpl::subnet_wrapper<subnet_type> wsub(subnetwork);
+            double l = loss.compute_loss_value_and_gradient(x, wsub);
+            subnetwork.back_propagate_error(x, on_gradient_ready);
+            return l;
+        }
         template <typename forward_iterator>
         double compute_parameter_gradients (
             forward_iterator ibegin,
@@ -2306,6 +2738,13 @@ namespace dlib
             subnetwork.clean();
         }
 
+        void set_inference_mode (
+            bool enabled
+        )
+        {
+            subnetwork.set_inference_mode(enabled);
+        }
+
         friend void serialize(const add_loss_layer& item, std::ostream& out)
         {
             int version = 1;
@@ -2611,6 +3050,13 @@ namespace dlib
             return layer<TAG_TYPE>(subnetwork).get_output();
         }
 
+        void set_inference_mode (
+            bool enabled
+        )
+        {
+            subnetwork.set_inference_mode(enabled);
+        }
+
         const tensor& get_output() const 
         { 
             return layer<TAG_TYPE>(subnetwork).get_output();
@@ -2631,6 +3077,10 @@ namespace dlib
         {
             subnetwork.back_propagate_error(x);
         }
+        void back_propagate_error(const tensor& x, const gradient_ready_callback& on_gradient_ready)
+        {
+            subnetwork.back_propagate_error(x, on_gradient_ready);
+        }
 
         template <typename solver_type>
         void update_parameters(sstack<solver_type> solvers, double learning_rate)
@@ -2709,6 +3159,23 @@ namespace dlib
         void disable_output_and_gradient_getters (
         ) { layer<TAG_TYPE>(subnetwork).disable_output_and_gradient_getters(); }
 
+        bool this_layer_output_is_tagged(
+        ) { return true; } 
+
+        void private_release_output(
+            resizable_tensor& 
+        )
+        {
+            // The output of this layer is the output of a tagged layer, so leave it alone.
+        }
+
+        void private_swap_released_outputs(
+            impl::released_outputs& item
+        )
+        {
+            subnetwork.private_swap_released_outputs(item);
+        }
+
         tensor& private_get_output() const
         { return layer<TAG_TYPE>(subnetwork).private_get_output(); }
         tensor& private_get_gradient_input() 
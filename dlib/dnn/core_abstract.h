@@ -8,12 +8,22 @@
 #include <type_traits>
 #include <tuple>
 #include <vector>
+#include <functional>
 #include "../rand.h"
 
 
 namespace dlib
 {
 
+// ----------------------------------------------------------------------------------------
+
+    typedef std::function<void(tensor& params_grad)> gradient_ready_callback;
+    /*!
+        This is the type of the callback given to back_propagate_error() and
+        compute_parameter_gradients() to find out when each layer's parameter gradient is
+        ready.  See add_layer::back_propagate_error() for the details.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -76,6 +86,11 @@ namespace dlib
             - If dlib should prefer to use fast algorithms rather than ones that use less
               RAM then this function returns true and false otherwise.
             - On program startup this function will default to true.
+            - On the CPU this means 3x3 stride 1 convolutions are computed with the
+              Winograd algorithm.  Its outputs differ from the plain img2col + matrix
+              multiply method only by floating point rounding (about 1e-5 relative to the
+              output values), but they are not bit for bit the same as what older
+              versions of dlib produced for the same network.
     !*/
 
     void set_dnn_prefer_fastest_algorithms(
@@ -92,6 +107,35 @@ namespace dlib
             - #dnn_prefer_fastest_algorithms() == false 
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    unsigned long dnn_cpu_num_threads(
+    );
+    /*!
+        ensures
+            - returns the number of threads the CPU implementations of the tensor
+              operations (i.e. the ones used when dlib isn't compiled with CUDA) split
+              their work across.  This is a single process wide setting.
+            - On program startup this function will default to the number of hardware
+              threads available on the machine.
+    !*/
+
+    void set_dnn_cpu_num_threads(
+        unsigned long num_threads
+    );
+    /*!
+        requires
+            - num_threads > 0
+            - No other thread is running any dnn code while this function executes.
+        ensures
+            - #dnn_cpu_num_threads() == num_threads
+            - If num_threads == 1 then all the CPU tensor operations run serially in the
+              calling thread.  Moreover, the outputs of the CPU tensor operations don't
+              depend on num_threads, with the exception of the convolution routines.
+              These split up their matrix multiplies differently when num_threads > 1 and
+              can therefore round slightly differently.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -503,6 +547,39 @@ namespace dlib
                   respect to x.
         !*/
 
+        void back_propagate_error(
+            const tensor& x, 
+            const gradient_ready_callback& on_gradient_ready
+        );
+        /*!
+            requires
+                - The requirements of back_propagate_error(x) are met.
+            ensures
+                - Does the same thing as back_propagate_error(x).  In addition, as soon as
+                  the backward() of a computational layer in this network has finished, and
+                  before the layers below it are processed, calls
+                  on_gradient_ready(PG) where PG is that layer's get_parameter_gradient()
+                  tensor.  The layers are visited from the top of the network down, in the
+                  same order as visit_layer_parameter_gradients() visits them, and each
+                  computational layer is reported exactly once.  So on_gradient_ready can,
+                  for instance, start sending the gradients of the upper layers to other
+                  machines while the lower layers are still being backpropagated.
+                - if (!on_gradient_ready) then this is just back_propagate_error(x).
+        !*/
+
+        void back_propagate_error(
+            const tensor& x, 
+            const tensor& gradient_input,
+            const gradient_ready_callback& on_gradient_ready
+        );
+        /*!
+            requires
+                - The requirements of back_propagate_error(x,gradient_input) are met.
+            ensures
+                - Does the same thing as back_propagate_error(x,gradient_input) and calls
+                  on_gradient_ready as described for back_propagate_error(x,on_gradient_ready).
+        !*/
+
         template <typename solver_type>
         void update_parameters(
             sstack<solver_type> solvers, 
@@ -542,6 +619,38 @@ namespace dlib
                   quicker.
         !*/
 
+        void set_inference_mode (
+            bool enabled
+        );
+        /*!
+            ensures
+                - If enabled==true then this network switches to an execution mode meant
+                  for running a trained network rather than training it.  In this mode:
+                    - forward() recycles the output tensor of each layer as soon as the
+                      layer above it has consumed it, and later layers write their outputs
+                      into recycled tensors of the right size.  So memory usage is roughly
+                      one tensor for each distinct layer output size rather than one per
+                      layer.  Outputs of layers that have an add_tag_layer on top of them
+                      are kept since other layers may reference them.
+                    - The recycled tensors are kept between calls to forward(), so once the
+                      network has run a couple of times, running more inputs of the same
+                      shape doesn't allocate any memory.  The recycled tensors are
+                      dropped when the shapes of the layer outputs change.
+                    - In-place layers (e.g. relu_, sig_, htan_, dropout_) run in place
+                      whenever the layer below them isn't tagged, even if the layer below
+                      needs its output for back propagation.
+                    - Gradient tensors are released and back_propagate_error() may not be
+                      called.  Calling compute_parameter_gradients() on a loss layer on top
+                      of this network is therefore also not allowed.
+                    - After forward() only get_output() of the top layer of the network and
+                      of tagged layers are meaningful.  The outputs of other layers are
+                      either empty or hold the output of some other layer.
+                - If enabled==false then the network goes back to its normal mode of
+                  operation, where every layer keeps its own output.
+                - The mode is applied to every layer in the network and is preserved when
+                  the network is copied.  It is not saved by serialize().
+        !*/
+
     };
 
     template <typename T, typename U> 
@@ -885,6 +994,23 @@ namespace dlib
                 - returns compute_loss(x,lbegin)
         !*/
 
+        template <typename label_iterator>
+        double compute_parameter_gradients (
+            const tensor& x,
+            label_iterator lbegin,
+            const gradient_ready_callback& on_gradient_ready
+        );
+        /*!
+            requires
+                - The requirements of compute_parameter_gradients(x,lbegin) are met.
+            ensures
+                - Does the same thing as compute_parameter_gradients(x,lbegin), except that
+                  the backpropagation is done with back_propagate_error(x,on_gradient_ready).
+                  So on_gradient_ready is called with each layer's parameter gradient as
+                  soon as that gradient is computed.
+                - returns compute_loss(x,lbegin)
+        !*/
+
         template <typename forward_iterator, typename label_iterator>
         double compute_parameter_gradients (
             forward_iterator ibegin,
@@ -924,6 +1050,24 @@ namespace dlib
                 - returns compute_loss(x)
         !*/
 
+        double compute_parameter_gradients (
+            const tensor& x,
+            const gradient_ready_callback& on_gradient_ready
+        );
+        /*!
+            requires
+                - The requirements of compute_parameter_gradients(x) are met.
+                - on_gradient_ready is a gradient_ready_callback object rather than, for
+                  example, a lambda.  Otherwise this call would be taken as
+                  compute_parameter_gradients(x,lbegin).
+            ensures
+                - Does the same thing as compute_parameter_gradients(x), except that the
+                  backpropagation is done with back_propagate_error(x,on_gradient_ready).
+                  So on_gradient_ready is called with each layer's parameter gradient as
+                  soon as that gradient is computed.
+                - returns compute_loss(x)
+        !*/
+
         template <typename forward_iterator>
         double compute_parameter_gradients (
             forward_iterator ibegin,
@@ -975,6 +1119,16 @@ namespace dlib
                 - Causes the network to forget about everything but its parameters.  
                 - invokes subnet().clean()
         !*/
+
+        void set_inference_mode (
+            bool enabled
+        );
+        /*!
+            ensures
+                - invokes subnet().set_inference_mode(enabled).  See add_layer's
+                  set_inference_mode() for a discussion of what that does.  While it is
+                  enabled compute_parameter_gradients() may not be called.
+        !*/
     };
 
     template <typename T, typename U> 
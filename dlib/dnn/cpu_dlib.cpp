@@ -7,12 +7,207 @@
 
 #include "cpu_dlib.h"
 #include "tensor_tools.h"
+#include "../threads/thread_pool_extension.h"
+#include "../threads/parallel_for_extension.h"
+#include "../simd/simd_check.h"
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace dlib
 {
     namespace cpu 
     {
 
+    // -----------------------------------------------------------------------------------
+
+        namespace
+        {
+            struct thread_pool_state
+            {
+                thread_pool_state() : num_threads(std::max(1u, std::thread::hardware_concurrency())) {}
+
+                std::mutex m;
+                unsigned long num_threads;
+                std::unique_ptr<thread_pool> tp;
+            };
+
+            thread_pool_state& get_thread_pool_state (
+            )
+            {
+                static thread_pool_state state;
+                return state;
+            }
+
+            // Below this many elementary operations it isn't worth waking up the thread
+            // pool since the synchronization overhead would dominate.
+            const size_t min_work_per_thread = 16*1024;
+
+            template <typename T>
+            void parallel_for_range (
+                long begin,
+                long end,
+                size_t work_per_index,
+                const T& funct
+            )
+            /*!
+                requires
+                    - begin <= end
+                    - funct(b,e) processes the indices in [b,e) and doesn't depend on the
+                      order in which the subranges of [begin,end) are processed.
+                ensures
+                    - Calls funct() on subranges that exactly cover [begin,end), using the
+                      dnn CPU thread pool when there is enough work to make it worthwhile.
+                      When get_num_threads()==1 this is just a call to funct(begin,end).
+            !*/
+            {
+                thread_pool_state& state = get_thread_pool_state();
+                thread_pool* tp = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock(state.m);
+                    if (state.num_threads > 1 && end-begin > 1 &&
+                        (end-begin)*work_per_index >= 2*min_work_per_thread)
+                    {
+                        if (!state.tp)
+                            state.tp.reset(new thread_pool(state.num_threads));
+                        tp = state.tp.get();
+                    }
+                }
+
+                if (tp == nullptr)
+                {
+                    funct(begin, end);
+                    return;
+                }
+
+                // Don't make chunks so small that each one has less than
+                // min_work_per_thread worth of work in it.
+                const long max_chunks = (end-begin)*work_per_index/min_work_per_thread;
+                const long chunks_per_thread = std::max(1L, std::min(4L, max_chunks/(long)tp->num_threads_in_pool()));
+                parallel_for_blocked(*tp, begin, end, funct, chunks_per_thread);
+            }
+        }
+
+        unsigned long get_num_threads (
+        )
+        {
+            thread_pool_state& state = get_thread_pool_state();
+            std::lock_guard<std::mutex> lock(state.m);
+            return state.num_threads;
+        }
+
+        void set_num_threads (
+            unsigned long num_threads
+        )
+        {
+            DLIB_CASSERT(num_threads > 0,"");
+            thread_pool_state& state = get_thread_pool_state();
+            std::lock_guard<std::mutex> lock(state.m);
+            if (state.num_threads != num_threads)
+            {
+                state.num_threads = num_threads;
+                // The pool will get recreated with the new size the next time it's needed.
+                state.tp.reset();
+            }
+        }
+
+    // -----------------------------------------------------------------------------------
+
+        namespace
+        {
+            template <typename EXP1, typename EXP2>
+            void gemm_impl (
+                tensor& dest,
+                float alpha,
+                const EXP1& lhs,
+                const EXP2& rhs
+            )
+            {
+                // Split the output into bands along whichever dimension is largest and
+                // give each band to a different thread.  Every output element is computed
+                // by exactly one thread in the same order regardless of the number of
+                // threads, so the results don't depend on get_num_threads().
+                float* d = dest.host();
+                const long nr = lhs.nr();
+                const long nc = rhs.nc();
+                const size_t work = lhs.nc()*(size_t)ma::gemm_mc*std::min(nr,nc);
+                if (nr >= nc)
+                {
+                    const long num_bands = (nr+ma::gemm_mc-1)/ma::gemm_mc;
+                    parallel_for_range(0, num_bands, work, [&](long begin, long end)
+                    {
+                        ma::packed_float_multiply(d, nc, lhs, rhs, alpha, 
+                            begin*ma::gemm_mc, std::min(nr, end*ma::gemm_mc), 0, nc);
+                    });
+                }
+                else
+                {
+                    const long num_bands = (nc+ma::gemm_mc-1)/ma::gemm_mc;
+                    parallel_for_range(0, num_bands, work, [&](long begin, long end)
+                    {
+                        ma::packed_float_multiply(d, nc, lhs, rhs, alpha, 
+                            0, nr, begin*ma::gemm_mc, std::min(nc, end*ma::gemm_mc));
+                    });
+                }
+            }
+        }
+
+        void gemm (
+            float beta,
+            tensor& dest,
+            float alpha,
+            const tensor& lhs,
+            bool trans_lhs,
+            const tensor& rhs,
+            bool trans_rhs
+        )
+        {
+#ifdef DLIB_USE_BLAS
+            // When we have a BLAS library the matrix expressions below are bound
+            // directly to sgemm(), which is already about as fast as it gets.
+            if (beta != 0)
+            {
+                if (trans_lhs && trans_rhs)
+                    dest = alpha*trans(mat(lhs))*trans(mat(rhs)) + beta*mat(dest);
+                else if (!trans_lhs && trans_rhs)
+                    dest = alpha*mat(lhs)*trans(mat(rhs)) + beta*mat(dest);
+                else if (trans_lhs && !trans_rhs)
+                    dest = alpha*trans(mat(lhs))*mat(rhs) + beta*mat(dest);
+                else
+                    dest = alpha*mat(lhs)*mat(rhs) + beta*mat(dest);
+            }
+            else
+            {
+                if (trans_lhs && trans_rhs)
+                    dest = alpha*trans(mat(lhs))*trans(mat(rhs));
+                else if (!trans_lhs && trans_rhs)
+                    dest = alpha*mat(lhs)*trans(mat(rhs));
+                else if (trans_lhs && !trans_rhs)
+                    dest = alpha*trans(mat(lhs))*mat(rhs);
+                else
+                    dest = alpha*mat(lhs)*mat(rhs);
+            }
+#else
+            DLIB_CASSERT(dest.num_samples() == (trans_lhs ? mat(lhs).nc() : mat(lhs).nr()) &&
+                         (long)(dest.size()/dest.num_samples()) == (trans_rhs ? mat(rhs).nr() : mat(rhs).nc()) &&
+                         (trans_lhs ? mat(lhs).nr() : mat(lhs).nc()) == (trans_rhs ? mat(rhs).nc() : mat(rhs).nr()),"");
+
+            if (beta == 0)
+                dest = 0;
+            else if (beta != 1)
+                dest *= beta;
+
+            if (trans_lhs && trans_rhs)
+                gemm_impl(dest, alpha, trans(mat(lhs)), trans(mat(rhs)));
+            else if (!trans_lhs && trans_rhs)
+                gemm_impl(dest, alpha, mat(lhs), trans(mat(rhs)));
+            else if (trans_lhs && !trans_rhs)
+                gemm_impl(dest, alpha, trans(mat(lhs)), mat(rhs));
+            else
+                gemm_impl(dest, alpha, mat(lhs), mat(rhs));
+#endif
+        }
+
     // -----------------------------------------------------------------------------------
 
         void multiply (
@@ -39,39 +234,51 @@ namespace dlib
             const auto s2 = src2.host();
             if (dest.size() == src1.size() && src1.size() == src2.size())
             {
-                if (add_to)
-                {
-                    for (size_t i = 0; i < src1.size(); ++i)
-                        d[i] += s1[i]*s2[i];
-                }
-                else
+                parallel_for_range(0, src1.size(), 1, [&](long begin, long end)
                 {
-                    for (size_t i = 0; i < src1.size(); ++i)
-                        d[i] = s1[i]*s2[i];
-                }
+                    if (add_to)
+                    {
+                        for (long i = begin; i < end; ++i)
+                            d[i] += s1[i]*s2[i];
+                    }
+                    else
+                    {
+                        for (long i = begin; i < end; ++i)
+                            d[i] = s1[i]*s2[i];
+                    }
+                });
             }
             else if (dest.num_samples() == 1)
             {
-                if (!add_to)
+                // Each element of dest is a sum over the samples.  So we split the work up
+                // by dest element and keep the summation order the same as a serial loop
+                // over i would.
+                parallel_for_range(0, dest.size(), MD, [&](long begin, long end)
                 {
-                    for (size_t i = 0; i < dest.size(); ++i)
-                        d[i] = 0;
-                }
-                for (size_t i = 0; i < max_size; ++i)
-                    d[i%dest.size()] += s1[i%src1.size()]*s2[i%src2.size()];
+                    for (long j = begin; j < end; ++j)
+                    {
+                        if (!add_to)
+                            d[j] = 0;
+                        for (size_t i = j; i < max_size; i += dest.size())
+                            d[j] += s1[i%src1.size()]*s2[i%src2.size()];
+                    }
+                });
             }
             else
             {
-                if (add_to)
-                {
-                    for (size_t i = 0; i < max_size; ++i)
-                        d[i] += s1[i%src1.size()]*s2[i%src2.size()];
-                }
-                else
+                parallel_for_range(0, max_size, 1, [&](long begin, long end)
                 {
-                    for (size_t i = 0; i < max_size; ++i)
-                        d[i] = s1[i%src1.size()]*s2[i%src2.size()];
-                }
+                    if (add_to)
+                    {
+                        for (long i = begin; i < end; ++i)
+                            d[i] += s1[i%src1.size()]*s2[i%src2.size()];
+                    }
+                    else
+                    {
+                        for (long i = begin; i < end; ++i)
+                            d[i] = s1[i%src1.size()]*s2[i%src2.size()];
+                    }
+                });
             }
         }
 
@@ -89,63 +296,48 @@ namespace dlib
             {
                 DLIB_CASSERT(src2.num_samples() == 1 && src2.nr() == 1 && src2.nc() == 1 && src2.k() == src1.k(),"");
 
-                if (add_to)
+                const long num = dest.nr()*dest.nc();
+                parallel_for_range(0, dest.num_samples()*dest.k(), num, [&](long begin, long end)
                 {
-                    for (long n = 0; n < dest.num_samples(); ++n)
+                    for (long j = begin; j < end; ++j)
                     {
-                        for (long k = 0; k < dest.k(); ++k)
+                        const auto k = j%dest.k();
+                        auto dd = d + j*num;
+                        auto ss = s1 + j*num;
+                        if (add_to)
                         {
-                            for (long r = 0; r < dest.nr(); ++r)
-                            {
-                                for (long c = 0; c < dest.nc(); ++c)
-                                {
-                                    *d++ += (*s1++)*s2[k];
-                                }
-                            }
+                            for (long i = 0; i < num; ++i)
+                                dd[i] += ss[i]*s2[k];
                         }
-                    }
-                }
-                else
-                {
-                    for (long n = 0; n < dest.num_samples(); ++n)
-                    {
-                        for (long k = 0; k < dest.k(); ++k)
+                        else
                         {
-                            for (long r = 0; r < dest.nr(); ++r)
-                            {
-                                for (long c = 0; c < dest.nc(); ++c)
-                                {
-                                    *d++ = (*s1++)*s2[k];
-                                }
-                            }
+                            for (long i = 0; i < num; ++i)
+                                dd[i] = ss[i]*s2[k];
                         }
                     }
-                }
+                });
             }
             else
             {
                 DLIB_CASSERT(have_same_dimensions(src1,src2),"");
                 DLIB_CASSERT(dest.num_samples() == 1 && dest.nr() == 1 && dest.nc() == 1 && dest.k() == src1.k(),"");
 
-                if (!add_to)
-                {
-                    for (long k = 0; k < src1.k(); ++k)
-                        d[k] = 0;
-                }
-
-                for (long n = 0; n < src1.num_samples(); ++n)
+                const long num = src1.nr()*src1.nc();
+                parallel_for_range(0, src1.k(), src1.num_samples()*num, [&](long begin, long end)
                 {
-                    for (long k = 0; k < src1.k(); ++k)
+                    for (long k = begin; k < end; ++k)
                     {
-                        for (long r = 0; r < src1.nr(); ++r)
+                        if (!add_to)
+                            d[k] = 0;
+
+                        for (long n = 0; n < src1.num_samples(); ++n)
                         {
-                            for (long c = 0; c < src1.nc(); ++c)
-                            {
-                                d[k] += (*s1++)*(*s2++);
-                            }
+                            const auto offset = (n*src1.k() + k)*num;
+                            for (long i = 0; i < num; ++i)
+                                d[k] += s1[offset+i]*s2[offset+i];
                         }
                     }
-                }
+                });
             }
         }
 
@@ -179,13 +371,16 @@ namespace dlib
                 return;
             }
 
-            auto d = dest.host();
-            auto s = src.host();
-            for (long n = 0; n < dest.num_samples(); ++n)
+            const auto dd = dest.host();
+            const auto s = src.host();
+            parallel_for_range(0, dest.num_samples()*dest.k(), dest.nr()*dest.nc(), [&](long begin, long end)
             {
-                const auto sn = src.num_samples()==1 ? 0:n;
-                for (long k = 0; k < dest.k(); ++k)
+                auto d = dd + begin*dest.nr()*dest.nc();
+                for (long j = begin; j < end; ++j)
                 {
+                    const auto n = j/dest.k();
+                    const auto k = j%dest.k();
+                    const auto sn = src.num_samples()==1 ? 0:n;
                     const auto sk = src.k()==1 ? 0:k;
                     for (long r = 0; r < dest.nr(); ++r)
                     {
@@ -200,7 +395,7 @@ namespace dlib
                         }
                     }
                 }
-            }
+            });
         }
 
     // ----------------------------------------------------------------------------------------
@@ -211,24 +406,30 @@ namespace dlib
             const tensor& src2
         )
         {
-            auto d = dest.host();
-            auto s1 = src1.host();
-            auto s2 = src2.host();
+            const auto dd = dest.host();
+            const auto s1 = src1.host();
+            const auto s2 = src2.host();
 
             // Do the simple and fast version if everything has the same dimensions
             if (have_same_dimensions(dest, src1) &&
                 have_same_dimensions(dest, src2))
             {
-                for (size_t i = 0; i < dest.size(); ++i)
-                    d[i] = s1[i] + s2[i];
+                parallel_for_range(0, dest.size(), 1, [&](long begin, long end)
+                {
+                    for (long i = begin; i < end; ++i)
+                        dd[i] = s1[i] + s2[i];
+                });
                 return;
             }
 
             // Otherwise, do the more complex version with bounds checking.
-            for (long n = 0; n < dest.num_samples(); ++n)
+            parallel_for_range(0, dest.num_samples()*dest.k(), dest.nr()*dest.nc(), [&](long begin, long end)
             {
-                for (long k = 0; k < dest.k(); ++k)
+                auto d = dd + begin*dest.nr()*dest.nc();
+                for (long j = begin; j < end; ++j)
                 {
+                    const long n = j/dest.k();
+                    const long k = j%dest.k();
                     for (long r = 0; r < dest.nr(); ++r)
                     {
                         for (long c = 0; c < dest.nc(); ++c)
@@ -261,7 +462,7 @@ namespace dlib
                         }
                     }
                 }
-            }
+            });
         }
 
     // ----------------------------------------------------------------------------------------
@@ -278,17 +479,21 @@ namespace dlib
                   gradient_input.nc() == grad.nc() &&
                   gradient_input.size() > 0,"");
 
-            auto out = grad.host();
-            auto in = gradient_input.host();
-
-            for (size_t i = 0; i < grad.size(); ++i)
-                out[i] = *in++;
+            const auto out = grad.host();
+            const auto in = gradient_input.host();
 
-            for (long j = 1; j < gradient_input.num_samples(); ++j)
+            parallel_for_range(0, grad.size(), gradient_input.num_samples(), [&](long begin, long end)
             {
-                for (size_t i = 0; i < grad.size(); ++i)
-                    out[i] += *in++;
-            }
+                for (long i = begin; i < end; ++i)
+                    out[i] = in[i];
+
+                for (long j = 1; j < gradient_input.num_samples(); ++j)
+                {
+                    const auto in2 = in + j*grad.size();
+                    for (long i = begin; i < end; ++i)
+                        out[i] += in2[i];
+                }
+            });
         }
 
     // ------------------------------------------------------------------------------------
@@ -308,25 +513,23 @@ namespace dlib
                   is_same_object(grad,gradient_input) == false
                   ,"");
 
-            auto g = grad.host();
-            auto gi = gradient_input.host();
-
-            for (long k = 0; k < gradient_input.k(); ++k)
-                g[k] = 0;
+            const auto g = grad.host();
+            const auto gi = gradient_input.host();
 
-            for (long n = 0; n < gradient_input.num_samples(); ++n)
+            const long num = gradient_input.nr()*gradient_input.nc();
+            parallel_for_range(0, gradient_input.k(), gradient_input.num_samples()*num, [&](long begin, long end)
             {
-                for (long k = 0; k < gradient_input.k(); ++k)
+                for (long k = begin; k < end; ++k)
                 {
-                    for (long r = 0; r < gradient_input.nr(); ++r)
+                    g[k] = 0;
+                    for (long n = 0; n < gradient_input.num_samples(); ++n)
                     {
-                        for (long c = 0; c < gradient_input.nc(); ++c)
-                        {
-                            g[k] += (*gi++);
-                        }
+                        const auto gi2 = gi + (n*gradient_input.k() + k)*num;
+                        for (long i = 0; i < num; ++i)
+                            g[k] += gi2[i];
                     }
                 }
-            }
+            });
         }
 
     // -----------------------------------------------------------------------------------
@@ -341,8 +544,11 @@ namespace dlib
             DLIB_CASSERT(dest.size()==src.size(),"");
             const auto d = dest.host();
             const auto s = src.host();
-            for (size_t i = 0; i < src.size(); ++i)
-                d[i] = A*s[i] + B;
+            parallel_for_range(0, src.size(), 1, [&](long begin, long end)
+            {
+                for (long i = begin; i < end; ++i)
+                    d[i] = A*s[i] + B;
+            });
         }
 
         void affine_transform(
@@ -359,8 +565,11 @@ namespace dlib
             const auto d = dest.host();
             const auto s1 = src1.host();
             const auto s2 = src2.host();
-            for (size_t i = 0; i < src1.size(); ++i)
-                d[i] = A*s1[i] + B*s2[i] + C;
+            parallel_for_range(0, src1.size(), 1, [&](long begin, long end)
+            {
+                for (long i = begin; i < end; ++i)
+                    d[i] = A*s1[i] + B*s2[i] + C;
+            });
         }
 
         void affine_transform(
@@ -381,8 +590,11 @@ namespace dlib
             const auto s1 = src1.host();
             const auto s2 = src2.host();
             const auto s3 = src3.host();
-            for (size_t i = 0; i < src1.size(); ++i)
-                d[i] = A*s1[i] + B*s2[i] + C*s3[i] + D;
+            parallel_for_range(0, src1.size(), 1, [&](long begin, long end)
+            {
+                for (long i = begin; i < end; ++i)
+                    d[i] = A*s1[i] + B*s2[i] + C*s3[i] + D;
+            });
         }
 
         void affine_transform_range(
@@ -405,8 +617,11 @@ namespace dlib
             const auto s1 = src1.host();
             const auto s2 = src2.host();
             const auto s3 = src3.host();
-            for (size_t i = begin; i < end; ++i)
-                d[i] = A*s1[i] + B*s2[i] + C*s3[i];
+            parallel_for_range(begin, end, 1, [&](long b, long e)
+            {
+                for (long i = b; i < e; ++i)
+                    d[i] = A*s1[i] + B*s2[i] + C*s3[i];
+            });
         }
 
     // -----------------------------------------------------------------------------------
@@ -426,27 +641,26 @@ namespace dlib
                   A.nc()==B.nc() && B.nc()==src.nc() &&
                   A.k() ==B.k()  && B.k()==src.k(),"");
 
-            auto d = dest.host();
-            auto s = src.host();
+            const auto d = dest.host();
+            const auto s = src.host();
             const auto a = A.host();
             const auto b = B.host();
             if (A.num_samples() == 1)
             {
                 const long num = src.size()/src.num_samples();
-                for (size_t i = 0; i < src.num_samples(); ++i)
+                parallel_for_range(0, src.size(), 1, [&](long begin, long end)
                 {
-                    for (long j = 0; j < num; ++j)
-                    {
-                        *d = a[j]*(*s) + b[j];
-                        d++;
-                        s++;
-                    }
-                }
+                    for (long i = begin; i < end; ++i)
+                        d[i] = a[i%num]*s[i] + b[i%num];
+                });
             }
             else
             {
-                for (size_t i = 0; i < src.size(); ++i)
-                    d[i] = a[i]*s[i] + b[i];
+                parallel_for_range(0, src.size(), 1, [&](long begin, long end)
+                {
+                    for (long i = begin; i < end; ++i)
+                        d[i] = a[i]*s[i] + b[i];
+                });
             }
         }
 
@@ -466,23 +680,22 @@ namespace dlib
                          A.nc() == 1 &&
                          A.k() == src.k(), "");
 
-            auto d = dest.host();
-            auto s = src.host();
+            const auto d = dest.host();
+            const auto s = src.host();
             const auto a = A.host();
             const auto b = B.host();
-            for (long n = 0; n < dest.num_samples(); ++n)
+            const long num = dest.nr()*dest.nc();
+            parallel_for_range(0, dest.num_samples()*dest.k(), num, [&](long begin, long end)
             {
-                for (long k = 0; k < dest.k(); ++k)
+                for (long j = begin; j < end; ++j)
                 {
-                    for (long r = 0; r < dest.nr(); ++r)
-                    {
-                        for (long c = 0; c < dest.nc(); ++c)
-                        {
-                            *d++ = a[k]*(*s++) + b[k];
-                        }
-                    }
+                    const auto k = j%dest.k();
+                    const auto dd = d + j*num;
+                    const auto ss = s + j*num;
+                    for (long i = 0; i < num; ++i)
+                        dd[i] = a[k]*ss[i] + b[k];
                 }
-            }
+            });
         }
 
     // -----------------------------------------------------------------------------------
@@ -519,13 +732,16 @@ namespace dlib
             auto ps = s.host_write_only();
             auto pparams = params.host();
             auto ppgrad = params_grad.host();
-            for (size_t i = begin; i < end; ++i)
+            parallel_for_range(begin, end, 8, [&](long b, long e)
             {
-                float g = weight_decay*pparams[i] + ppgrad[i];
-                pm[i] = momentum1*pm[i] + (1-momentum1)*g;
-                pv[i] = momentum2*pv[i] + (1-momentum2)*g*g;
-                ps[i] = -alpha*pm[i]/(std::sqrt(pv[i]) + eps);
-            }
+                for (long i = b; i < e; ++i)
+                {
+                    float g = weight_decay*pparams[i] + ppgrad[i];
+                    pm[i] = momentum1*pm[i] + (1-momentum1)*g;
+                    pv[i] = momentum2*pv[i] + (1-momentum2)*g*g;
+                    ps[i] = -alpha*pm[i]/(std::sqrt(pv[i]) + eps);
+                }
+            });
         }
 
     // -----------------------------------------------------------------------------------
@@ -580,15 +796,14 @@ namespace dlib
             auto v = running_variances.host();
 
             const long num = src.k()*src.nr()*src.nc();
-            for (long n = 0; n < src.num_samples(); ++n)
+            parallel_for_range(0, src.num_samples()*num, 4, [&](long begin, long end)
             {
-                for (long k = 0; k < num; ++k)
+                for (long i = begin; i < end; ++i)
                 {
-                    *d = g[k]*(*s - m[k])/std::sqrt(v[k]+eps) + b[k];
-                    ++d;
-                    ++s;
+                    const long k = i%num;
+                    d[i] = g[k]*(s[i] - m[k])/std::sqrt(v[k]+eps) + b[k];
                 }
-            }
+            });
         }
 
         void batch_normalize (
@@ -641,15 +856,18 @@ namespace dlib
             auto p_src = src.host();
             const long num = src.k()*src.nr()*src.nc();
             // compute means, and sum of squares
-            for (long i = 0; i < num; ++i)
+            parallel_for_range(0, num, src.num_samples(), [&](long begin, long end)
             {
-                for (long n = 0; n < src.num_samples(); ++n)
+                for (long i = begin; i < end; ++i)
                 {
-                    float val = p_src[n*num+i];
-                    p_means[i] += val;
-                    p_invstds[i] += val*val;
+                    for (long n = 0; n < src.num_samples(); ++n)
+                    {
+                        float val = p_src[n*num+i];
+                        p_means[i] += val;
+                        p_invstds[i] += val*val;
+                    }
                 }
-            }
+            });
             means /= src.num_samples();
             invstds /= src.num_samples();
             // copy data back to host
@@ -672,19 +890,18 @@ namespace dlib
             }
 
             p_src = src.host();
-            auto p_dest = dest.host();
+            const auto p_dest = dest.host();
             const auto p_gamma = gamma.host();   
             const auto p_beta = beta.host();   
-            for (long n = 0; n < src.num_samples(); ++n)
+            parallel_for_range(0, src.num_samples()*num, 2, [&](long begin, long end)
             {
-                for (long i = 0; i < num; ++i)
+                for (long j = begin; j < end; ++j)
                 {
-                    *p_dest = (*p_src - p_means[i])*p_invstds[i];
-                    *p_dest = (*p_dest)*p_gamma[i] + p_beta[i];
-                    ++p_src;
-                    ++p_dest;
+                    const long i = j%num;
+                    p_dest[j] = (p_src[j] - p_means[i])*p_invstds[i];
+                    p_dest[j] = p_dest[j]*p_gamma[i] + p_beta[i];
                 }
-            }
+            });
 
             // now keep track of the running means 
             running_means.copy_size(means);
@@ -736,57 +953,46 @@ namespace dlib
             const auto p_dvars = dvars.host();
             const auto p_dmeans = dmeans.host();
 
-            for (long n = 0; n < src.num_samples(); ++n)
-            {
-                for (long i = 0; i < num; ++i)
-                {
-                    const float x_hat = (*p_src - p_means[i])*p_invstds[i];
-                    p_beta_grad[i] += *p_grad;
-                    p_gamma_grad[i] += (*p_grad)*x_hat;
-
-                    const float dx = *p_grad * p_gamma[i];
-
-                    p_dvars[i] += dx*(*p_src - p_means[i])*-0.5*std::pow(p_invstds[i], 3.0f);
-
-                    ++p_grad;
-                    ++p_src;
-                }
-            }
-
             const float invnum = 1.0f/src.num_samples();
-            p_grad = gradient_input.host();
-            p_src = src.host();
-            for (long n = 0; n < src.num_samples(); ++n)
+            const auto p_src_grad = src_grad.host();
+            // Each of the num columns is independent of the others, so we split the work
+            // up by column.  Within a column everything is accumulated over the samples in
+            // the same order as a serial implementation would.
+            parallel_for_range(0, num, 3*src.num_samples(), [&](long begin, long end)
             {
-                for (long i = 0; i < num; ++i)
+                for (long i = begin; i < end; ++i)
                 {
-                    const float dx = *p_grad * p_gamma[i];
+                    for (long n = 0; n < src.num_samples(); ++n)
+                    {
+                        const long j = n*num+i;
+                        const float x_hat = (p_src[j] - p_means[i])*p_invstds[i];
+                        p_beta_grad[i] += p_grad[j];
+                        p_gamma_grad[i] += p_grad[j]*x_hat;
 
-                    p_dmeans[i] += dx*-p_invstds[i] + p_dvars[i] * -2*(*p_src - p_means[i])*invnum;
+                        const float dx = p_grad[j] * p_gamma[i];
 
-                    ++p_grad;
-                    ++p_src;
-                }
-            }
-            p_grad = gradient_input.host();
-            p_src = src.host();
-            auto p_src_grad = src_grad.host();
-            for (long n = 0; n < src.num_samples(); ++n)
-            {
-                for (long i = 0; i < num; ++i)
-                {
-                    const float dx = *p_grad * p_gamma[i];
+                        p_dvars[i] += dx*(p_src[j] - p_means[i])*-0.5*std::pow(p_invstds[i], 3.0f);
+                    }
 
-                    *p_src_grad += dx*p_invstds[i] + 
-                        p_dvars[i] *2*(*p_src - p_means[i])*invnum + 
-                        p_dmeans[i]*invnum;
+                    for (long n = 0; n < src.num_samples(); ++n)
+                    {
+                        const long j = n*num+i;
+                        const float dx = p_grad[j] * p_gamma[i];
+
+                        p_dmeans[i] += dx*-p_invstds[i] + p_dvars[i] * -2*(p_src[j] - p_means[i])*invnum;
+                    }
 
+                    for (long n = 0; n < src.num_samples(); ++n)
+                    {
+                        const long j = n*num+i;
+                        const float dx = p_grad[j] * p_gamma[i];
 
-                    ++p_grad;
-                    ++p_src;
-                    ++p_src_grad;
+                        p_src_grad[j] += dx*p_invstds[i] + 
+                            p_dvars[i] *2*(p_src[j] - p_means[i])*invnum + 
+                            p_dmeans[i]*invnum;
+                    }
                 }
-            }
+            });
         }
 
     // ----------------------------------------------------------------------------------------
@@ -841,19 +1047,18 @@ namespace dlib
             auto v = running_variances.host();
 
             const long num = src.nr()*src.nc();
-            for (long n = 0; n < src.num_samples(); ++n)
+            parallel_for_range(0, src.num_samples()*src.k(), num, [&](long begin, long end)
             {
-                for (long k = 0; k < src.k(); ++k)
+                for (long i = begin; i < end; ++i)
                 {
+                    const long k = i%src.k();
                     const float invstd = 1.0f/std::sqrt(v[k] + eps);
+                    const auto dd = d + i*num;
+                    const auto ss = s + i*num;
                     for (long j = 0; j < num; ++j)
-                    {
-                        *d = g[k]*(*s - m[k])*invstd + b[k];
-                        ++d;
-                        ++s;
-                    }
+                        dd[j] = g[k]*(ss[j] - m[k])*invstd + b[k];
                 }
-            }
+            });
         }
 
         void batch_normalize_conv (
@@ -910,18 +1115,21 @@ namespace dlib
             auto p_src = src.host();
             const long num = src.nr()*src.nc();
             // compute means, and sum of squares
-            for (long n = 0; n < src.num_samples(); ++n)
+            parallel_for_range(0, src.k(), src.num_samples()*num, [&](long begin, long end)
             {
-                for (long k = 0; k < src.k(); ++k)
+                for (long k = begin; k < end; ++k)
                 {
-                    for (long i = 0; i < num; ++i)
+                    for (long n = 0; n < src.num_samples(); ++n)
                     {
-                        p_means[k] += *p_src;
-                        p_invstds[k] += (*p_src)*(*p_src);
-                        ++p_src;
+                        const auto ss = p_src + (n*src.k() + k)*num;
+                        for (long i = 0; i < num; ++i)
+                        {
+                            p_means[k] += ss[i];
+                            p_invstds[k] += ss[i]*ss[i];
+                        }
                     }
                 }
-            }
+            });
             means /= src.num_samples()*num;
             invstds /= src.num_samples()*num;
             // copy data back to host
@@ -945,20 +1153,21 @@ namespace dlib
             }
 
             p_src = src.host();
-            auto p_dest = dest.host();
-            for (long n = 0; n < src.num_samples(); ++n)
+            const auto p_dest = dest.host();
+            parallel_for_range(0, src.num_samples()*src.k(), 2*num, [&](long begin, long end)
             {
-                for (long k = 0; k < src.k(); ++k)
+                for (long j = begin; j < end; ++j)
                 {
+                    const long k = j%src.k();
+                    const auto ss = p_src + j*num;
+                    const auto dd = p_dest + j*num;
                     for (long i = 0; i < num; ++i)
                     {
-                        *p_dest = (*p_src - p_means[k])*p_invstds[k];
-                        *p_dest = (*p_dest)*p_gamma[k] + p_beta[k];
-                        ++p_src;
-                        ++p_dest;
+                        dd[i] = (ss[i] - p_means[k])*p_invstds[k];
+                        dd[i] = dd[i]*p_gamma[k] + p_beta[k];
                     }
                 }
-            }
+            });
 
             // now keep track of the running means 
             running_means.copy_size(means);
@@ -1011,67 +1220,60 @@ namespace dlib
             const auto p_dvars = dvars.host();
             const auto p_dmeans = dmeans.host();
 
-            for (long n = 0; n < src.num_samples(); ++n)
+            const float invnum = 1.0f/(src.num_samples()*num);
+            const auto p_src_grad = src_grad.host();
+            // The channels are independent of each other, so we split the work up by
+            // channel.  Within a channel everything is accumulated in the same order as a
+            // serial implementation would.
+            parallel_for_range(0, src.k(), 3*src.num_samples()*num, [&](long begin, long end)
             {
-                for (long k = 0; k < src.k(); ++k)
+                for (long k = begin; k < end; ++k)
                 {
                     const float invstd_pow = -0.5*std::pow(p_invstds[k], 3.0f);
-                    for (long i = 0; i < num; ++i)
+                    for (long n = 0; n < src.num_samples(); ++n)
                     {
-                        const float x_hat = (*p_src - p_means[k])*p_invstds[k];
-                        p_beta_grad[k] += *p_grad;
-                        p_gamma_grad[k] += (*p_grad)*x_hat;
-
-                        const float dx = *p_grad * p_gamma[k];
+                        const auto g = p_grad + (n*src.k() + k)*num;
+                        const auto ss = p_src + (n*src.k() + k)*num;
+                        for (long i = 0; i < num; ++i)
+                        {
+                            const float x_hat = (ss[i] - p_means[k])*p_invstds[k];
+                            p_beta_grad[k] += g[i];
+                            p_gamma_grad[k] += g[i]*x_hat;
 
-                        p_dvars[k] += dx*(*p_src - p_means[k])*invstd_pow;
+                            const float dx = g[i] * p_gamma[k];
 
-                        ++p_grad;
-                        ++p_src;
+                            p_dvars[k] += dx*(ss[i] - p_means[k])*invstd_pow;
+                        }
                     }
-                }
-            }
 
-            p_grad = gradient_input.host();
-            p_src = src.host();
-            const float invnum = 1.0f/(src.num_samples()*num);
-            for (long n = 0; n < src.num_samples(); ++n)
-            {
-                for (long k = 0; k < src.k(); ++k)
-                {
-                    for (long i = 0; i < num; ++i)
+                    for (long n = 0; n < src.num_samples(); ++n)
                     {
-                        const float dx = *p_grad * p_gamma[k];
-
-                        p_dmeans[k] += -dx*p_invstds[k] + p_dvars[k] * -2*(*p_src - p_means[k])*invnum;
+                        const auto g = p_grad + (n*src.k() + k)*num;
+                        const auto ss = p_src + (n*src.k() + k)*num;
+                        for (long i = 0; i < num; ++i)
+                        {
+                            const float dx = g[i] * p_gamma[k];
 
-                        ++p_grad;
-                        ++p_src;
+                            p_dmeans[k] += -dx*p_invstds[k] + p_dvars[k] * -2*(ss[i] - p_means[k])*invnum;
+                        }
                     }
-                }
-            }
-            p_grad = gradient_input.host();
-            p_src = src.host();
-            auto p_src_grad = src_grad.host();
-            for (long n = 0; n < src.num_samples(); ++n)
-            {
-                for (long k = 0; k < src.k(); ++k)
-                {
-                    for (long i = 0; i < num; ++i)
-                    {
-                        const float dx = *p_grad * p_gamma[k];
-
-                        *p_src_grad += dx*p_invstds[k] + 
-                            p_dvars[k]*2*(*p_src - p_means[k])*invnum + 
-                            p_dmeans[k]*invnum;
 
+                    for (long n = 0; n < src.num_samples(); ++n)
+                    {
+                        const auto g = p_grad + (n*src.k() + k)*num;
+                        const auto ss = p_src + (n*src.k() + k)*num;
+                        const auto sg = p_src_grad + (n*src.k() + k)*num;
+                        for (long i = 0; i < num; ++i)
+                        {
+                            const float dx = g[i] * p_gamma[k];
 
-                        ++p_grad;
-                        ++p_src;
-                        ++p_src_grad;
+                            sg[i] += dx*p_invstds[k] + 
+                                p_dvars[k]*2*(ss[i] - p_means[k])*invnum + 
+                                p_dmeans[k]*invnum;
+                        }
                     }
                 }
-            }
+            });
         }
 
     // -----------------------------------------------------------------------------------
@@ -1082,8 +1284,11 @@ namespace dlib
         )
         {
             const auto d = data.host();
-            for (size_t i = 0; i < data.size(); ++i)
-                d[i] = d[i]>thresh ? 1:0;
+            parallel_for_range(0, data.size(), 1, [&](long begin, long end)
+            {
+                for (long i = begin; i < end; ++i)
+                    d[i] = d[i]>thresh ? 1:0;
+            });
         }
 
         void dot (
@@ -1117,16 +1322,21 @@ namespace dlib
             const auto s = src.host();
 
             const long num = src.nr()*src.nc();
-            // Note that we subtract out the max values in each channel before applying
-            // exp() to avoid numeric overflow in the subsequent computations.  Doing this
-            // doesn't change the resulting output, it just makes it more numerically
-            // stable.
-            for (long n = 0; n < src.num_samples(); ++n)
+            // Each spatial location of each sample is processed independently, so we
+            // split the work up over the num_samples()*nr()*nc() locations.
+            parallel_for_range(0, src.num_samples()*num, 3*src.k(), [&](long begin, long end)
             {
-                auto ss = s + num*src.k()*n;
-                auto dd = d + num*src.k()*n;
-                for (long i = 0; i < num; ++i)
+                for (long j = begin; j < end; ++j)
                 {
+                    const long n = j/num;
+                    const long i = j%num;
+                    const auto ss = s + num*src.k()*n + i;
+                    const auto dd = d + num*src.k()*n + i;
+
+                    // Note that we subtract out the max values in each channel before
+                    // applying exp() to avoid numeric overflow in the subsequent
+                    // computations.  Doing this doesn't change the resulting output, it
+                    // just makes it more numerically stable.
                     float max_val = -std::numeric_limits<float>::infinity();
                     for (long k = 0; k < src.k(); ++k)
                         max_val = std::max(max_val, ss[k*num]);
@@ -1134,31 +1344,14 @@ namespace dlib
                     for (long k = 0; k < src.k(); ++k)
                         dd[k*num] = std::exp(ss[k*num]-max_val);
 
-                    ++ss;
-                    ++dd;
-                }
-            }
-
-            // Now normalize each channel so they sum to 1.
-            for (long n = 0; n < src.num_samples(); ++n)
-            {
-                const auto ss = s + num*src.k()*n;
-                const auto dd = d + num*src.k()*n;
-                for (long r = 0; r < src.nr(); ++r)
-                {
-                    for (long c = 0; c < src.nc(); ++c)
-                    {
-                        const auto sss = ss+r*src.nc()+c;
-                        const auto ddd = dd+r*src.nc()+c;
-
-                        float temp = 0;
-                        for (long k = 0; k < src.k(); ++k)
-                            temp += ddd[k*num];
-                        for (long k = 0; k < src.k(); ++k)
-                            ddd[k*num] /= temp;
-                    }
+                    // Now normalize each channel so they sum to 1.
+                    float temp = 0;
+                    for (long k = 0; k < src.k(); ++k)
+                        temp += dd[k*num];
+                    for (long k = 0; k < src.k(); ++k)
+                        dd[k*num] /= temp;
                 }
-            }
+            });
         }
 
         void softmax_gradient (
@@ -1175,35 +1368,31 @@ namespace dlib
 
             const long num = grad.nr()*grad.nc();
 
-            for (long n = 0; n < grad.num_samples(); ++n)
+            parallel_for_range(0, grad.num_samples()*num, 2*grad.k(), [&](long begin, long end)
             {
-                const auto d2 = d + num*grad.k()*n;
-                const auto g2 = g + num*grad.k()*n;
-                const auto in2 = in + num*grad.k()*n;
-                for (long r = 0; r < grad.nr(); ++r)
+                for (long j = begin; j < end; ++j)
                 {
-                    for (long c = 0; c < grad.nc(); ++c)
+                    const long n = j/num;
+                    const long i = j%num;
+                    const auto d3 = d + num*grad.k()*n + i;
+                    const auto g3 = g + num*grad.k()*n + i;
+                    const auto in3 = in + num*grad.k()*n + i;
+
+                    float temp = 0;
+                    for (long k = 0; k < grad.k(); ++k)
+                        temp += -d3[k*num]*in3[k*num];
+                    if (is_same_object(gradient_input, grad))
                     {
-                        const auto d3 = d2+r*grad.nc()+c;
-                        const auto g3 = g2+r*grad.nc()+c;
-                        const auto in3 = in2+r*grad.nc()+c;
-
-                        float temp = 0;
                         for (long k = 0; k < grad.k(); ++k)
-                            temp += -d3[k*num]*in3[k*num];
-                        if (is_same_object(gradient_input, grad))
-                        {
-                            for (long k = 0; k < grad.k(); ++k)
-                                g3[k*num] = d3[k*num]*(temp+in3[k*num]);
-                        }
-                        else
-                        {
-                            for (long k = 0; k < grad.k(); ++k)
-                                g3[k*num] += d3[k*num]*(temp+in3[k*num]);
-                        }
+                            g3[k*num] = d3[k*num]*(temp+in3[k*num]);
+                    }
+                    else
+                    {
+                        for (long k = 0; k < grad.k(); ++k)
+                            g3[k*num] += d3[k*num]*(temp+in3[k*num]);
                     }
                 }
-            }
+            });
         }
 
     // ------------------------------------------------------------------------------------
@@ -1215,8 +1404,11 @@ namespace dlib
         {
             const auto d = dest.host();
             const auto s = src.host();
-            for (size_t i = 0; i < src.size(); ++i)
-                d[i] = 1/(1+std::exp(-s[i]));
+            parallel_for_range(0, src.size(), 4, [&](long begin, long end)
+            {
+                for (long i = begin; i < end; ++i)
+                    d[i] = 1/(1+std::exp(-s[i]));
+            });
         }
 
         void sigmoid_gradient (
@@ -1228,16 +1420,20 @@ namespace dlib
             const auto g = grad.host();
             const auto d = dest.host();
             const auto in = gradient_input.host();
-            if (is_same_object(gradient_input, grad))
-            {
-                for (size_t i = 0; i < dest.size(); ++i)
-                    g[i] = in[i]*d[i]*(1-d[i]);
-            }
-            else
+            const bool same = is_same_object(gradient_input, grad);
+            parallel_for_range(0, dest.size(), 1, [&](long begin, long end)
             {
-                for (size_t i = 0; i < dest.size(); ++i)
-                    g[i] += in[i]*d[i]*(1-d[i]);
-            }
+                if (same)
+                {
+                    for (long i = begin; i < end; ++i)
+                        g[i] = in[i]*d[i]*(1-d[i]);
+                }
+                else
+                {
+                    for (long i = begin; i < end; ++i)
+                        g[i] += in[i]*d[i]*(1-d[i]);
+                }
+            });
         }
 
     // ------------------------------------------------------------------------------------
@@ -1247,9 +1443,41 @@ namespace dlib
             const tensor& src
         )
         {
-            dest = lowerbound(mat(src), 0);
-        }
-
+            const auto d = dest.host();
+            const auto s = src.host();
+            parallel_for_range(0, src.size(), 1, [&](long begin, long end)
+            {
+                // This is the same computation lowerbound(mat(src),0) would perform.
+                for (long i = begin; i < end; ++i)
+                    d[i] = s[i] >= 0 ? s[i] : 0;
+            });
+        }
+
+        void add_bias_and_relu (
+            tensor& dest,
+            const tensor& biases
+        )
+        {
+            DLIB_CASSERT(biases.num_samples() == 1 && biases.k() == dest.k() &&
+                         biases.nr() == 1 && biases.nc() == 1,"");
+            const long plane_size = dest.nr()*dest.nc();
+            const auto d = dest.host();
+            const auto b = biases.host();
+            parallel_for_range(0, dest.num_samples()*dest.k(), plane_size, [&](long begin, long end)
+            {
+                for (long i = begin; i < end; ++i)
+                {
+                    const float bias = b[i%dest.k()];
+                    float* p = d + i*plane_size;
+                    for (long j = 0; j < plane_size; ++j)
+                    {
+                        const float val = p[j] + bias;
+                        p[j] = val >= 0 ? val : 0;
+                    }
+                }
+            });
+        }
+
         void relu_gradient (
             tensor& grad,
             const tensor& dest,
@@ -1259,24 +1487,28 @@ namespace dlib
             const float* gi = gradient_input.host();
             const float* in = dest.host();
             float* out = grad.host();
-            if (is_same_object(grad, gradient_input))
+            const bool same = is_same_object(grad, gradient_input);
+            parallel_for_range(0, dest.size(), 1, [&](long begin, long end)
             {
-                for (size_t i = 0; i < dest.size(); ++i)
+                if (same)
                 {
-                    if (in[i] > 0)
-                        out[i] = gi[i];
-                    else
-                        out[i] = 0;
+                    for (long i = begin; i < end; ++i)
+                    {
+                        if (in[i] > 0)
+                            out[i] = gi[i];
+                        else
+                            out[i] = 0;
+                    }
                 }
-            }
-            else
-            {
-                for (size_t i = 0; i < dest.size(); ++i)
+                else
                 {
-                    if (in[i] > 0)
-                        out[i] += gi[i];
+                    for (long i = begin; i < end; ++i)
+                    {
+                        if (in[i] > 0)
+                            out[i] += gi[i];
+                    }
                 }
-            }
+            });
         }
 
     // ----------------------------------------------------------------------------------------
@@ -1290,13 +1522,16 @@ namespace dlib
             const float p = param.host()[0];
             const float* s = src.host();
             float* d = dest.host();
-            for (size_t i = 0; i < dest.size(); ++i)
+            parallel_for_range(0, dest.size(), 1, [&](long begin, long end)
             {
-                if (s[i] > 0)
-                    d[i] = s[i];
-                else
-                    d[i] = p*s[i];
-            }
+                for (long i = begin; i < end; ++i)
+                {
+                    if (s[i] > 0)
+                        d[i] = s[i];
+                    else
+                        d[i] = p*s[i];
+                }
+            });
         }
 
         void prelu_gradient (
@@ -1337,8 +1572,11 @@ namespace dlib
         {
             const auto d = dest.host();
             const auto s = src.host();
-            for (size_t i = 0; i < src.size(); ++i)
-                d[i] = std::tanh(s[i]);
+            parallel_for_range(0, src.size(), 4, [&](long begin, long end)
+            {
+                for (long i = begin; i < end; ++i)
+                    d[i] = std::tanh(s[i]);
+            });
         }
 
         void tanh_gradient (
@@ -1350,16 +1588,20 @@ namespace dlib
             const auto g = grad.host();
             const auto d = dest.host();
             const auto in = gradient_input.host();
-            if (is_same_object(grad, gradient_input))
+            const bool same = is_same_object(grad, gradient_input);
+            parallel_for_range(0, dest.size(), 1, [&](long begin, long end)
             {
-                for (size_t i = 0; i < dest.size(); ++i)
-                    g[i] = in[i]*(1-d[i]*d[i]);
-            }
-            else
-            {
-                for (size_t i = 0; i < dest.size(); ++i)
-                    g[i] += in[i]*(1-d[i]*d[i]);
-            }
+                if (same)
+                {
+                    for (long i = begin; i < end; ++i)
+                        g[i] = in[i]*(1-d[i]*d[i]);
+                }
+                else
+                {
+                    for (long i = begin; i < end; ++i)
+                        g[i] += in[i]*(1-d[i]*d[i]);
+                }
+            });
         }
 
     // ------------------------------------------------------------------------------------
@@ -1470,12 +1712,15 @@ namespace dlib
             auto s = src.host();
             const long x_offset = window_width/2 - padding_x;
             const long y_offset = window_height/2 - padding_y;
+            const long work_per_plane = dest.nr()*dest.nc()*window_height*window_width;
             if (does_max_pooling())
             {
-                for (long n = 0; n < dest.num_samples(); ++n)
+                parallel_for_range(0, dest.num_samples()*dest.k(), work_per_plane, [&](long begin, long end)
                 {
-                    for (long k = 0; k < dest.k(); ++k)
+                    for (long j = begin; j < end; ++j)
                     {
+                        const long n = j/dest.k();
+                        const long k = j%dest.k();
                         auto simg = image_plane(src,n,k);
                         auto dimg = d + (n*dest.k() + k)*dest.nr()*dest.nc();
 
@@ -1491,14 +1736,16 @@ namespace dlib
                             }
                         }
                     }
-                }
+                });
             }
             else
             {
-                for (long n = 0; n < dest.num_samples(); ++n)
+                parallel_for_range(0, dest.num_samples()*dest.k(), work_per_plane, [&](long begin, long end)
                 {
-                    for (long k = 0; k < dest.k(); ++k)
+                    for (long j = begin; j < end; ++j)
                     {
+                        const long n = j/dest.k();
+                        const long k = j%dest.k();
                         auto simg = image_plane(src,n,k);
                         auto dimg = d + (n*dest.k() + k)*dest.nr()*dest.nc();
 
@@ -1514,7 +1761,7 @@ namespace dlib
                             }
                         }
                     }
-                }
+                });
             }
 
         }
@@ -1541,12 +1788,15 @@ namespace dlib
             auto s = src.host();
             const long x_offset = window_width/2 - padding_x;
             const long y_offset = window_height/2 - padding_y;
+            const long work_per_plane = dest.nr()*dest.nc()*window_height*window_width;
             if (does_max_pooling())
             {
-                for (long n = 0; n < dest.num_samples(); ++n)
+                parallel_for_range(0, dest.num_samples()*dest.k(), work_per_plane, [&](long begin, long end)
                 {
-                    for (long k = 0; k < dest.k(); ++k)
+                    for (long j = begin; j < end; ++j)
                     {
+                        const long n = j/dest.k();
+                        const long k = j%dest.k();
                         auto simg = image_plane(src,n,k);
                         auto gimg = g + (n*grad.k() + k)*grad.nr()*grad.nc();
                         auto giimg = gi + (n*dest.k() + k)*dest.nr()*dest.nc();
@@ -1565,14 +1815,16 @@ namespace dlib
                             }
                         }
                     }
-                }
+                });
             }
             else
             {
-                for (long n = 0; n < dest.num_samples(); ++n)
+                parallel_for_range(0, dest.num_samples()*dest.k(), work_per_plane, [&](long begin, long end)
                 {
-                    for (long k = 0; k < dest.k(); ++k)
+                    for (long j = begin; j < end; ++j)
                     {
+                        const long n = j/dest.k();
+                        const long k = j%dest.k();
                         auto simg = image_plane(src,n,k);
                         auto gimg = g + (n*grad.k() + k)*grad.nr()*grad.nc();
                         auto giimg = gi + (n*dest.k() + k)*dest.nr()*dest.nc();
@@ -1597,7 +1849,7 @@ namespace dlib
                             }
                         }
                     }
-                }
+                });
             }
 
         }
@@ -1627,23 +1879,23 @@ namespace dlib
             output.set_size(out_nr*out_nc, 
                             data.k()*filter_nr*filter_nc);
             DLIB_CASSERT(output.size() != 0,"");
-            float* t = &output(0,0);
 
-            // now fill in the Toeplitz output matrix for the n-th sample in data.  
-            size_t cnt = 0;
-            const long max_r = data.nr() + padding_y-(filter_nr-1);
-            const long max_c = data.nc() + padding_x-(filter_nc-1);
-            for (long r = -padding_y; r < max_r; r+=stride_y)
+            // now fill in the Toeplitz output matrix for the n-th sample in data.  Each
+            // row of it corresponds to one output location and doesn't depend on any of
+            // the others, so we can fill the rows in parallel.
+            parallel_for_range(0, output.nr(), output.nc(), [&](long begin, long end)
             {
-                for (long c = -padding_x; c < max_c; c+=stride_x)
+                for (long i = begin; i < end; ++i)
                 {
+                    const long r = -padding_y + (i/out_nc)*stride_y;
+                    const long c = -padding_x + (i%out_nc)*stride_x;
+                    float* t = &output(i,0);
                     for (long k = 0; k < data.k(); ++k)
                     {
                         for (long y = 0; y < filter_nr; ++y)
                         {
                             for (long x = 0; x < filter_nc; ++x)
                             {
-                                DLIB_ASSERT(cnt < output.size(),"");
                                 long xx = c+x;
                                 long yy = r+y;
                                 if (boundary.contains(xx,yy))
@@ -1651,12 +1903,11 @@ namespace dlib
                                 else
                                     *t = 0;
                                 ++t;
-                                ++cnt;
                             }
                         }
                     }
                 }
-            }
+            });
         }
 
         void col2img(
@@ -1675,30 +1926,446 @@ namespace dlib
             const rectangle boundary = get_rect(data);
 
             DLIB_CASSERT(output.size() != 0,"");
-            const float* t = &output(0,0);
 
-            // now fill in the Toeplitz output matrix for the n-th sample in data.  
-            const long max_r = data.nr() + padding_y-(filter_nr-1);
-            const long max_c = data.nc() + padding_x-(filter_nc-1);
-            for (long r = -padding_y; r < max_r; r+=stride_y)
+            // now add the Toeplitz output matrix back into the n-th sample in data.  The
+            // windows overlap so different output locations touch the same pixels.  But
+            // each channel is only touched by its own columns of the output matrix, so we
+            // split the work up by channel.
+            const long filter_size = filter_nr*filter_nc;
+            parallel_for_range(0, data.k(), output.nr()*filter_size, [&](long begin, long end)
             {
-                for (long c = -padding_x; c < max_c; c+=stride_x)
+                const long max_r = data.nr() + padding_y-(filter_nr-1);
+                const long max_c = data.nc() + padding_x-(filter_nc-1);
+                for (long k = begin; k < end; ++k)
                 {
-                    for (long k = 0; k < data.k(); ++k)
+                    const float* t = &output(0,0) + k*filter_size;
+                    for (long r = -padding_y; r < max_r; r+=stride_y)
                     {
-                        for (long y = 0; y < filter_nr; ++y)
+                        for (long c = -padding_x; c < max_c; c+=stride_x)
                         {
-                            for (long x = 0; x < filter_nc; ++x)
+                            for (long y = 0; y < filter_nr; ++y)
                             {
-                                long xx = c+x;
-                                long yy = r+y;
-                                if (boundary.contains(xx,yy))
-                                    d[(k*data.nr() + yy)*data.nc() + xx] += *t;
-                                ++t;
+                                for (long x = 0; x < filter_nc; ++x)
+                                {
+                                    long xx = c+x;
+                                    long yy = r+y;
+                                    if (boundary.contains(xx,yy))
+                                        d[(k*data.nr() + yy)*data.nc() + xx] += t[y*filter_nc+x];
+                                }
                             }
+                            t += output.nc();
                         }
                     }
                 }
+            });
+        }
+
+        namespace
+        {
+            void img2col_conv (
+                tensor& output,
+                const tensor& data,
+                const tensor& filters,
+                int stride_y,
+                int stride_x,
+                int padding_y,
+                int padding_x
+            )
+            {
+                const long num_threads = get_num_threads();
+                const auto out = output.host();
+                const long out_size = output.k()*output.nr()*output.nc();
+                if (num_threads == 1 || data.num_samples() >= num_threads)
+                {
+                    // Give each thread its own samples to work on.
+                    data.host();
+                    parallel_for_range(0, data.num_samples(), filters.size()*output.nr()*output.nc(), [&](long begin, long end)
+                    {
+                        matrix<float> temp;
+                        for (long n = begin; n < end; ++n)
+                        {
+                            img2col(temp, data, n, filters.nr(), filters.nc(), stride_y, stride_x, padding_y, padding_x);
+                            set_ptrm(out+n*out_size, output.k(), output.nr()*output.nc()) = mat(filters)*trans(temp);
+                        }
+                    });
+                }
+                else
+                {
+                    // There aren't enough samples to keep all the threads busy.  So instead,
+                    // process one sample at a time and split the matrix multiply up over the
+                    // output channels.
+                    matrix<float> temp;
+                    for (long n = 0; n < data.num_samples(); ++n)
+                    {
+                        img2col(temp, data, n, filters.nr(), filters.nc(), stride_y, stride_x, padding_y, padding_x);
+                        const auto filt = mat(filters);
+                        parallel_for_range(0, output.k(), filters.k()*filters.nr()*filters.nc()*temp.nr(), [&](long begin, long end)
+                        {
+                            set_ptrm(out+n*out_size+begin*temp.nr(), end-begin, temp.nr()) = 
+                                rowm(filt,range(begin,end-1))*trans(temp);
+                        });
+                    }
+                }
+            }
+
+        // ------------------------------------------------------------------------------------
+
+            void direct_conv (
+                tensor& output,
+                const tensor& data,
+                const tensor& filters,
+                int stride_y,
+                int stride_x,
+                int padding_y,
+                int padding_x
+            )
+            /*!
+                ensures
+                    - Computes the same thing as img2col_conv() but without making any
+                      temporary copies of data.  Each output plane is computed a band of
+                      rows at a time so that the part of the output being accumulated into
+                      stays in cache while we sweep over the input channels and filter
+                      taps.
+            !*/
+            {
+                const auto out = output.host();
+                const auto in = data.host();
+                const auto filt = filters.host();
+                const long out_nr = output.nr();
+                const long out_nc = output.nc();
+                const long in_plane_size = data.nr()*data.nc();
+                const long filter_size = filters.k()*filters.nr()*filters.nc();
+                // Number of output rows processed together.  Aim for bands of about 4096
+                // floats.
+                const long band_rows = std::max(1L, std::min(out_nr, 4096/out_nc));
+
+                parallel_for_range(0, output.num_samples()*output.k(), out_nr*out_nc*filter_size, [&](long begin, long end)
+                {
+                    for (long j = begin; j < end; ++j)
+                    {
+                        const long n = j/output.k();
+                        const long k = j%output.k();
+                        float* const oimg = out + j*out_nr*out_nc;
+                        const float* const w = filt + k*filter_size;
+
+                        for (long i = 0; i < out_nr*out_nc; ++i)
+                            oimg[i] = 0;
+
+                        for (long band = 0; band < out_nr; band += band_rows)
+                        {
+                            const long band_end = std::min(out_nr, band+band_rows);
+                            for (long c = 0; c < data.k(); ++c)
+                            {
+                                const float* const iimg = in + (n*data.k() + c)*in_plane_size;
+                                for (long fy = 0; fy < filters.nr(); ++fy)
+                                {
+                                    for (long fx = 0; fx < filters.nc(); ++fx)
+                                    {
+                                        const float wv = w[(c*filters.nr() + fy)*filters.nc() + fx];
+                                        // Find the range of output columns that read from
+                                        // inside the input image for this filter tap.
+                                        const long x_offset = fx - padding_x;
+                                        const long c_begin = x_offset >= 0 ? 0 : (-x_offset + stride_x-1)/stride_x;
+                                        const long last_x = data.nc()-1-x_offset;
+                                        const long c_end = last_x < 0 ? 0 : std::min(out_nc, last_x/stride_x + 1);
+                                        for (long r = band; r < band_end; ++r)
+                                        {
+                                            const long yy = r*stride_y - padding_y + fy;
+                                            if (yy < 0 || yy >= data.nr())
+                                                continue;
+                                            const float* const irow = iimg + yy*data.nc() + x_offset;
+                                            float* const orow = oimg + r*out_nc;
+                                            if (stride_x == 1)
+                                            {
+                                                for (long cc = c_begin; cc < c_end; ++cc)
+                                                    orow[cc] += wv*irow[cc];
+                                            }
+                                            else
+                                            {
+                                                for (long cc = c_begin; cc < c_end; ++cc)
+                                                    orow[cc] += wv*irow[cc*stride_x];
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                });
+            }
+
+        // ------------------------------------------------------------------------------------
+
+            template <long m>
+            struct winograd_3x3_transforms;
+            /*!
+                These are the transformation matrices for the Winograd minimal filtering
+                algorithm F(m x m, 3 x 3), as described in "Fast Algorithms for
+                Convolutional Neural Networks" by Andrew Lavin and Scott Gray.  Each tile
+                of (m+2) x (m+2) input pixels is transformed by BT*d*trans(BT), each 3x3
+                filter by G*g*trans(G), and the elementwise products of the two are mapped
+                back into an m x m output tile with AT*M*trans(AT).
+            !*/
+
+            template <>
+            struct winograd_3x3_transforms<2>
+            {
+                const static long alpha = 4;
+                static const float* BT() 
+                {
+                    static const float v[] = {
+                        1,  0, -1,  0,
+                        0,  1,  1,  0,
+                        0, -1,  1,  0,
+                        0,  1,  0, -1
+                    };
+                    return v;
+                }
+                static const float* G()
+                {
+                    static const float v[] = {
+                        1,     0,    0,
+                        0.5,   0.5,  0.5,
+                        0.5,  -0.5,  0.5,
+                        0,     0,    1
+                    };
+                    return v;
+                }
+                static const float* AT()
+                {
+                    static const float v[] = {
+                        1,  1,  1,  0,
+                        0,  1, -1, -1
+                    };
+                    return v;
+                }
+            };
+
+            template <>
+            struct winograd_3x3_transforms<4>
+            {
+                const static long alpha = 6;
+                static const float* BT() 
+                {
+                    static const float v[] = {
+                        4,  0, -5,  0,  1,  0,
+                        0, -4, -4,  1,  1,  0,
+                        0,  4, -4, -1,  1,  0,
+                        0, -2, -1,  2,  1,  0,
+                        0,  2, -1, -2,  1,  0,
+                        0,  4,  0, -5,  0,  1
+                    };
+                    return v;
+                }
+                static const float* G()
+                {
+                    static const float v[] = {
+                        1/4.0f,      0,         0,
+                       -1/6.0f,  -1/6.0f,  -1/6.0f,
+                       -1/6.0f,   1/6.0f,  -1/6.0f,
+                        1/24.0f,  1/12.0f,  1/6.0f,
+                        1/24.0f, -1/12.0f,  1/6.0f,
+                        0,        0,        1
+                    };
+                    return v;
+                }
+                static const float* AT()
+                {
+                    static const float v[] = {
+                        1,  1,  1,  1,  1,  0,
+                        0,  1, -1,  2, -2,  0,
+                        0,  1,  1,  4,  4,  0,
+                        0,  1, -1,  8, -8,  1
+                    };
+                    return v;
+                }
+            };
+
+            template <long rows, long inner, long cols>
+            inline void small_mult (
+                const float* A,
+                bool trans_A,
+                const float* B,
+                bool trans_B,
+                float* C
+            )
+            /*!
+                ensures
+                    - Computes C = A*B where A is rows x inner and B is inner x cols.  If
+                      trans_A is true then A is stored transposed (i.e. as inner x rows),
+                      likewise for trans_B.  The zeros in the Winograd transform matrices are
+                      skipped.
+            !*/
+            {
+                for (long r = 0; r < rows; ++r)
+                {
+                    for (long c = 0; c < cols; ++c)
+                        C[r*cols+c] = 0;
+                    for (long i = 0; i < inner; ++i)
+                    {
+                        const float a = trans_A ? A[i*rows+r] : A[r*inner+i];
+                        if (a == 0)
+                            continue;
+                        for (long c = 0; c < cols; ++c)
+                            C[r*cols+c] += a*(trans_B ? B[c*inner+i] : B[i*cols+c]);
+                    }
+                }
+            }
+
+            template <long m>
+            void winograd_conv (
+                tensor& output,
+                const tensor& data,
+                const tensor& filters,
+                int padding_y,
+                int padding_x
+            )
+            /*!
+                requires
+                    - filters.nr() == 3 && filters.nc() == 3
+                    - the convolution has a stride of 1
+                ensures
+                    - Computes the same thing as img2col_conv() but using the Winograd
+                      F(m x m, 3 x 3) algorithm, which needs fewer multiplies than the
+                      img2col approach.  The work for each sample is organized as alpha*alpha
+                      independent K x C by C x P matrix multiplies, where P is the number of
+                      output tiles in a sample.
+            !*/
+            {
+                typedef winograd_3x3_transforms<m> tr;
+                const long alpha = tr::alpha;
+                const long K = filters.num_samples();
+                const long C = data.k();
+                const long tiles_y = (output.nr()+m-1)/m;
+                const long tiles_x = (output.nc()+m-1)/m;
+                const long P = tiles_y*tiles_x;
+
+                // Transform the filters.  U[e](k,c) holds element e of G*g*trans(G) for
+                // the filter connecting input channel c to output channel k.
+                std::vector<matrix<float>> U(alpha*alpha), V(alpha*alpha), M(alpha*alpha);
+                for (auto& u : U)
+                    u.set_size(K,C);
+                const auto filt = filters.host();
+                parallel_for_range(0, K*C, alpha*alpha*12, [&](long begin, long end)
+                {
+                    float temp[alpha*3];
+                    float u[alpha*alpha];
+                    for (long j = begin; j < end; ++j)
+                    {
+                        small_mult<alpha,3,3>(tr::G(), false, filt+j*9, false, temp);
+                        small_mult<alpha,3,alpha>(temp, false, tr::G(), true, u);
+                        for (long e = 0; e < alpha*alpha; ++e)
+                            U[e](j/C, j%C) = u[e];
+                    }
+                });
+
+                for (auto& v : V)
+                    v.set_size(C,P);
+
+                const auto in = data.host();
+                const auto out = output.host();
+                for (long n = 0; n < data.num_samples(); ++n)
+                {
+                    // Transform the input tiles.  V[e](c,p) holds element e of BT*d*trans(BT)
+                    // for input tile p in channel c.
+                    parallel_for_range(0, C*P, alpha*alpha*alpha*2, [&](long begin, long end)
+                    {
+                        float d[alpha*alpha];
+                        float temp[alpha*alpha];
+                        float v[alpha*alpha];
+                        for (long j = begin; j < end; ++j)
+                        {
+                            const long c = j/P;
+                            const long p = j%P;
+                            const long top = (p/tiles_x)*m - padding_y;
+                            const long left = (p%tiles_x)*m - padding_x;
+                            const float* img = in + (n*C + c)*data.nr()*data.nc();
+                            for (long y = 0; y < alpha; ++y)
+                            {
+                                for (long x = 0; x < alpha; ++x)
+                                {
+                                    const long yy = top+y;
+                                    const long xx = left+x;
+                                    if (0 <= yy && yy < data.nr() && 0 <= xx && xx < data.nc())
+                                        d[y*alpha+x] = img[yy*data.nc()+xx];
+                                    else
+                                        d[y*alpha+x] = 0;
+                                }
+                            }
+                            small_mult<alpha,alpha,alpha>(tr::BT(), false, d, false, temp);
+                            small_mult<alpha,alpha,alpha>(temp, false, tr::BT(), true, v);
+                            for (long e = 0; e < alpha*alpha; ++e)
+                                V[e](c,p) = v[e];
+                        }
+                    });
+
+                    // Now do the elementwise products, summed over input channels.
+                    parallel_for_range(0, alpha*alpha, K*C*P, [&](long begin, long end)
+                    {
+                        for (long e = begin; e < end; ++e)
+                            M[e] = U[e]*V[e];
+                    });
+
+                    // Finally, map the products back into output tiles.
+                    parallel_for_range(0, K*P, alpha*alpha*alpha*2, [&](long begin, long end)
+                    {
+                        float mm[alpha*alpha];
+                        float temp[m*alpha];
+                        float y[m*m];
+                        for (long j = begin; j < end; ++j)
+                        {
+                            const long k = j/P;
+                            const long p = j%P;
+                            for (long e = 0; e < alpha*alpha; ++e)
+                                mm[e] = M[e](k,p);
+                            small_mult<m,alpha,alpha>(tr::AT(), false, mm, false, temp);
+                            small_mult<m,alpha,m>(temp, false, tr::AT(), true, y);
+
+                            const long top = (p/tiles_x)*m;
+                            const long left = (p%tiles_x)*m;
+                            float* oimg = out + (n*K + k)*output.nr()*output.nc();
+                            for (long r = 0; r < m && top+r < output.nr(); ++r)
+                            {
+                                for (long c = 0; c < m && left+c < output.nc(); ++c)
+                                    oimg[(top+r)*output.nc() + left+c] = y[r*m+c];
+                            }
+                        }
+                    });
+                }
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        tensor_conv::algorithm tensor_conv::
+        select_algorithm (
+            const tensor& data,
+            const tensor& filters,
+            int stride_y,
+            int stride_x
+        )
+        {
+            if (dnn_prefer_fastest_algorithms())
+            {
+                // Winograd is a big win for 3x3 filters, but only when there are enough
+                // channels to amortize the cost of transforming the tiles.
+                if (filters.nr() == 3 && filters.nc() == 3 && stride_y == 1 && stride_x == 1 &&
+                    filters.num_samples() >= 4 && data.k() >= 4)
+                {
+                    if (data.nr() >= 8 && data.nc() >= 8)
+                        return algorithm::winograd_4x4;
+                    else
+                        return algorithm::winograd_2x2;
+                }
+                return algorithm::img2col;
+            }
+            else
+            {
+                // The direct method doesn't need any temporary storage, but it's only
+                // competitive with the img2col method for small filters.
+                if (filters.nr()*filters.nc() <= 25)
+                    return algorithm::direct;
+                return algorithm::img2col;
             }
         }
 
@@ -1711,6 +2378,21 @@ namespace dlib
             int padding_y,
             int padding_x
         )
+        {
+            (*this)(output, data, filters, stride_y, stride_x, padding_y, padding_x,
+                select_algorithm(data, filters, stride_y, stride_x));
+        }
+
+        void tensor_conv::operator() (
+            resizable_tensor& output,
+            const tensor& data,
+            const tensor& filters,
+            int stride_y,
+            int stride_x,
+            int padding_y,
+            int padding_x,
+            algorithm alg
+        )
         {
             DLIB_CASSERT(is_same_object(output,data) == false,"");
             DLIB_CASSERT(is_same_object(output,filters) == false,"");
@@ -1728,11 +2410,17 @@ namespace dlib
                             1+(data.nr()+2*padding_y-filters.nr())/stride_y,
                             1+(data.nc()+2*padding_x-filters.nc())/stride_x);
 
-            matrix<float> temp;
-            for (long n = 0; n < data.num_samples(); ++n)
+            DLIB_CASSERT((alg != algorithm::winograd_2x2 && alg != algorithm::winograd_4x4) ||
+                (filters.nr() == 3 && filters.nc() == 3 && stride_y == 1 && stride_x == 1),
+                "The Winograd algorithms only handle 3x3 filters with a stride of 1.");
+
+            last_algorithm = alg;
+            switch (last_algorithm)
             {
-                img2col(temp, data, n, filters.nr(), filters.nc(), stride_y, stride_x, padding_y, padding_x);
-                output.set_sample(n, mat(filters)*trans(temp));
+                case algorithm::winograd_4x4: winograd_conv<4>(output, data, filters, padding_y, padding_x); break;
+                case algorithm::winograd_2x2: winograd_conv<2>(output, data, filters, padding_y, padding_x); break;
+                case algorithm::direct: direct_conv(output, data, filters, stride_y, stride_x, padding_y, padding_x); break;
+                case algorithm::img2col: img2col_conv(output, data, filters, stride_y, stride_x, padding_y, padding_x); break;
             }
 
             last_stride_y = stride_y;
@@ -1750,17 +2438,25 @@ namespace dlib
             tensor& data_gradient
         )
         {
-            matrix<float> temp;
-            for (long n = 0; n < gradient_input.num_samples(); ++n)
+            // Each sample of data_gradient only depends on the corresponding sample of
+            // gradient_input, so the samples can be processed in parallel.
+            const auto pgi = gradient_input.host();
+            data_gradient.host();
+            parallel_for_range(0, gradient_input.num_samples(), filters.size()*gradient_input.nr()*gradient_input.nc(), 
+                [&](long begin, long end)
             {
-                auto gi = mat(gradient_input.host()+gradient_input.k()*gradient_input.nr()*gradient_input.nc()*n,
-                              gradient_input.k(),
-                              gradient_input.nr()*gradient_input.nc());
-                                    
+                matrix<float> temp;
+                for (long n = begin; n < end; ++n)
+                {
+                    auto gi = mat(pgi+gradient_input.k()*gradient_input.nr()*gradient_input.nc()*n,
+                                  gradient_input.k(),
+                                  gradient_input.nr()*gradient_input.nc());
 
-                temp = trans(gi)*mat(filters);
-                col2img(temp, data_gradient, n, filters.nr(), filters.nc(), last_stride_y, last_stride_x, last_padding_y, last_padding_x);
-            }
+
+                    temp = trans(gi)*mat(filters);
+                    col2img(temp, data_gradient, n, filters.nr(), filters.nc(), last_stride_y, last_stride_x, last_padding_y, last_padding_x);
+                }
+            });
         }
 
     // ------------------------------------------------------------------------------------
@@ -1772,21 +2468,337 @@ namespace dlib
             tensor& filters_gradient
         )
         {
-            matrix<float> temp;
-            for (long n = 0; n < gradient_input.num_samples(); ++n)
+            const long num_threads = get_num_threads();
+            if (num_threads == 1)
             {
-                auto gi = mat(gradient_input.host()+gradient_input.k()*gradient_input.nr()*gradient_input.nc()*n,
-                              gradient_input.k(),
-                              gradient_input.nr()*gradient_input.nc());
+                matrix<float> temp;
+                for (long n = 0; n < gradient_input.num_samples(); ++n)
+                {
+                    auto gi = mat(gradient_input.host()+gradient_input.k()*gradient_input.nr()*gradient_input.nc()*n,
+                                  gradient_input.k(),
+                                  gradient_input.nr()*gradient_input.nc());
 
 
-                img2col(temp, data, n, filters_gradient.nr(), filters_gradient.nc(), last_stride_y, last_stride_x, last_padding_y, last_padding_x);
-                if (n == 0)
-                    filters_gradient = gi*temp;
-                else
-                    filters_gradient += gi*temp;
+                    img2col(temp, data, n, filters_gradient.nr(), filters_gradient.nc(), last_stride_y, last_stride_x, last_padding_y, last_padding_x);
+                    if (n == 0)
+                        filters_gradient = gi*temp;
+                    else
+                        filters_gradient += gi*temp;
+                }
+                return;
+            }
+
+            // Compute the per sample filter gradients num_threads samples at a time and
+            // then add them up in sample order.  This way the result doesn't depend on how
+            // the work got split up between the threads.
+            const auto pgi = gradient_input.host();
+            data.host();
+            std::vector<matrix<float>> temps(num_threads), grads(num_threads);
+            for (long n = 0; n < gradient_input.num_samples(); n += num_threads)
+            {
+                const long group_size = std::min(num_threads, gradient_input.num_samples()-n);
+                parallel_for_range(0, group_size, filters_gradient.size()*gradient_input.nr()*gradient_input.nc(), 
+                    [&](long begin, long end)
+                {
+                    for (long i = begin; i < end; ++i)
+                    {
+                        auto gi = mat(pgi+gradient_input.k()*gradient_input.nr()*gradient_input.nc()*(n+i),
+                                      gradient_input.k(),
+                                      gradient_input.nr()*gradient_input.nc());
+
+                        img2col(temps[i], data, n+i, filters_gradient.nr(), filters_gradient.nc(), last_stride_y, last_stride_x, last_padding_y, last_padding_x);
+                        grads[i] = gi*temps[i];
+                    }
+                });
+
+                for (long i = 0; i < group_size; ++i)
+                {
+                    if (n+i == 0)
+                        filters_gradient = grads[i];
+                    else
+                        filters_gradient += grads[i];
+                }
             }
         }
+    // ------------------------------------------------------------------------------------
+
+        namespace
+        {
+            // The filters and data are padded to a multiple of this many elements.
+            const long int8_block = 16;
+
+            inline int32_t int8_dot (
+                const int8_t* a,
+                const int8_t* b,
+                long n
+            )
+            /*!
+                requires
+                    - n%int8_block == 0
+                ensures
+                    - returns the dot product of the n element vectors a and b, computed
+                      with 32bit integer accumulators.
+            !*/
+            {
+#if defined(DLIB_HAVE_AVX2)
+                __m256i acc = _mm256_setzero_si256();
+                for (long i = 0; i < n; i += 16)
+                {
+                    const __m256i va = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(a+i)));
+                    const __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(b+i)));
+                    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+                }
+                __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc,1));
+                sum = _mm_hadd_epi32(sum, sum);
+                sum = _mm_hadd_epi32(sum, sum);
+                return _mm_cvtsi128_si32(sum);
+#elif defined(DLIB_HAVE_SSE41)
+                __m128i acc = _mm_setzero_si128();
+                for (long i = 0; i < n; i += 8)
+                {
+                    const __m128i va = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i*)(a+i)));
+                    const __m128i vb = _mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i*)(b+i)));
+                    acc = _mm_add_epi32(acc, _mm_madd_epi16(va, vb));
+                }
+                acc = _mm_hadd_epi32(acc, acc);
+                acc = _mm_hadd_epi32(acc, acc);
+                return _mm_cvtsi128_si32(acc);
+#else
+                int32_t acc = 0;
+                for (long i = 0; i < n; ++i)
+                    acc += (int32_t)a[i]*(int32_t)b[i];
+                return acc;
+#endif
+            }
+
+            inline int8_t quantize_value (
+                float val,
+                float inv_scale
+            )
+            {
+                val *= inv_scale;
+                val = std::min(std::max(val, -127.0f), 127.0f);
+                return static_cast<int8_t>(val >= 0 ? val+0.5f : val-0.5f);
+            }
+
+            void int8_gemm (
+                float* out,
+                long out_row_stride,
+                long out_col_stride,
+                const int8_t* lhs,
+                long num_rows,
+                const int8_t* filters,
+                long num_filters,
+                long padded_size,
+                const float* scales
+            )
+            /*!
+                ensures
+                    - for all valid r and f:
+                        - out[r*out_row_stride + f*out_col_stride] = scales[f] * 
+                          int8_dot(lhs+r*padded_size, filters+f*padded_size, padded_size)
+            !*/
+            {
+                // Work on blocks of filters small enough to stay in the cache while we
+                // sweep over all the rows of lhs.
+                const long filters_per_block = std::max(1L, 32*1024/padded_size);
+                for (long f0 = 0; f0 < num_filters; f0 += filters_per_block)
+                {
+                    const long f1 = std::min(num_filters, f0+filters_per_block);
+                    for (long r = 0; r < num_rows; ++r)
+                    {
+                        const int8_t* row = lhs + r*padded_size;
+                        float* o = out + r*out_row_stride;
+                        for (long f = f0; f < f1; ++f)
+                            o[f*out_col_stride] = scales[f]*int8_dot(row, filters+f*padded_size, padded_size);
+                    }
+                }
+            }
+        }
+
+        void int8_filters::
+        quantize (
+            const tensor& weights_,
+            bool filters_are_columns,
+            float input_range
+        )
+        {
+            DLIB_CASSERT(input_range >= 0,"");
+            const auto w = mat(weights_);
+            num_filters_ = filters_are_columns ? w.nc() : w.nr();
+            filter_size_ = filters_are_columns ? w.nr() : w.nc();
+            padded_size = (filter_size_+int8_block-1)/int8_block*int8_block;
+            input_scale = input_range > 0 ? input_range/127 : 1;
+
+            weights.assign(num_filters_*padded_size, 0);
+            scales.resize(num_filters_);
+            for (long f = 0; f < num_filters_; ++f)
+            {
+                float max_val = 0;
+                for (long i = 0; i < filter_size_; ++i)
+                    max_val = std::max(max_val, std::abs(filters_are_columns ? w(i,f) : w(f,i)));
+
+                const float scale = max_val > 0 ? max_val/127 : 1;
+                for (long i = 0; i < filter_size_; ++i)
+                    weights[f*padded_size+i] = quantize_value(filters_are_columns ? w(i,f) : w(f,i), 1/scale);
+
+                // fold the input scale in so the int32 results can be converted back to
+                // floats with a single multiply.
+                scales[f] = scale*input_scale;
+            }
+        }
+
+        void int8_filters::
+        clear(
+        )
+        {
+            num_filters_ = 0;
+            filter_size_ = 0;
+            padded_size = 0;
+            input_scale = 1;
+            weights.clear();
+            scales.clear();
+        }
+
+        void serialize(const int8_filters& item, std::ostream& out)
+        {
+            using dlib::serialize;
+            serialize("int8_filters", out);
+            serialize(item.num_filters_, out);
+            serialize(item.filter_size_, out);
+            serialize(item.padded_size, out);
+            serialize(item.input_scale, out);
+            serialize(item.scales, out);
+            // write the weights as raw bytes
+            const std::vector<char> temp(item.weights.begin(), item.weights.end());
+            serialize(temp, out);
+        }
+
+        void deserialize(int8_filters& item, std::istream& in)
+        {
+            using dlib::deserialize;
+            std::string version;
+            deserialize(version, in);
+            if (version != "int8_filters")
+                abort();
+            deserialize(item.num_filters_, in);
+            deserialize(item.filter_size_, in);
+            deserialize(item.padded_size, in);
+            deserialize(item.input_scale, in);
+            deserialize(item.scales, in);
+            std::vector<char> temp;
+            deserialize(temp, in);
+            item.weights.assign(temp.begin(), temp.end());
+        }
+
+        void int8_fc (
+            resizable_tensor& output,
+            const tensor& data,
+            const int8_filters& filters
+        )
+        {
+            const long num_inputs = data.k()*data.nr()*data.nc();
+            DLIB_CASSERT(!filters.empty() && num_inputs == filters.filter_size(),"");
+
+            const long num_samples = data.num_samples();
+            const long padded_size = filters.padded_size;
+            output.set_size(num_samples, filters.num_filters());
+
+            std::vector<int8_t> qdata(num_samples*padded_size, 0);
+            const float inv_scale = 1/filters.input_scale;
+            const float* d = data.host();
+            float* out = output.host_write_only();
+            parallel_for_range(0, num_samples, filters.num_filters()*padded_size, [&](long begin, long end)
+            {
+                for (long n = begin; n < end; ++n)
+                {
+                    for (long i = 0; i < num_inputs; ++i)
+                        qdata[n*padded_size+i] = quantize_value(d[n*num_inputs+i], inv_scale);
+                }
+                int8_gemm(out+begin*output.k(), output.k(), 1, &qdata[begin*padded_size], end-begin,
+                    &filters.weights[0], filters.num_filters(), padded_size, &filters.scales[0]);
+            });
+        }
+
+        void int8_conv (
+            resizable_tensor& output,
+            const tensor& data,
+            const int8_filters& filters,
+            long filter_nr,
+            long filter_nc,
+            int stride_y,
+            int stride_x,
+            int padding_y,
+            int padding_x
+        )
+        {
+            DLIB_CASSERT(!filters.empty() && data.k()*filter_nr*filter_nc == filters.filter_size(),"");
+            DLIB_CASSERT(stride_y > 0 && stride_x > 0,"");
+            DLIB_CASSERT(0 <= padding_y && padding_y < filter_nr &&
+                         0 <= padding_x && padding_x < filter_nc,"");
+
+            const long out_nr = 1+(data.nr()+2*padding_y-filter_nr)/stride_y;
+            const long out_nc = 1+(data.nc()+2*padding_x-filter_nc)/stride_x;
+            const long out_plane = out_nr*out_nc;
+            const long padded_size = filters.padded_size;
+            output.set_size(data.num_samples(), filters.num_filters(), out_nr, out_nc);
+
+            // Quantize all the input data once up front rather than once for every filter
+            // location that touches it.
+            std::vector<int8_t> qdata(data.size());
+            const float inv_scale = 1/filters.input_scale;
+            const float* d = data.host();
+            parallel_for_range(0, data.size(), 1, [&](long begin, long end)
+            {
+                for (long i = begin; i < end; ++i)
+                    qdata[i] = quantize_value(d[i], inv_scale);
+            });
+
+            // Since the quantization is symmetric, 0 represents 0 and padding the columns
+            // with zeros works the same as it does for the float img2col.
+            std::vector<int8_t> cols(out_plane*padded_size, 0);
+            const long sample_size = data.k()*data.nr()*data.nc();
+            float* out = output.host_write_only();
+            for (long n = 0; n < data.num_samples(); ++n)
+            {
+                const int8_t* s = &qdata[n*sample_size];
+                parallel_for_range(0, out_plane, filters.filter_size(), [&](long begin, long end)
+                {
+                    for (long i = begin; i < end; ++i)
+                    {
+                        const long r = -padding_y + (i/out_nc)*stride_y;
+                        const long c = -padding_x + (i%out_nc)*stride_x;
+                        int8_t* t = &cols[i*padded_size];
+                        for (long k = 0; k < data.k(); ++k)
+                        {
+                            for (long y = 0; y < filter_nr; ++y)
+                            {
+                                const long yy = r+y;
+                                for (long x = 0; x < filter_nc; ++x)
+                                {
+                                    const long xx = c+x;
+                                    if (0 <= yy && yy < data.nr() && 0 <= xx && xx < data.nc())
+                                        *t++ = s[(k*data.nr() + yy)*data.nc() + xx];
+                                    else
+                                        *t++ = 0;
+                                }
+                            }
+                        }
+                    }
+                });
+
+                // The output for this sample is num_filters x out_plane, so each column
+                // location i is written to a different position within every filter's
+                // output plane.
+                float* o = out + n*filters.num_filters()*out_plane;
+                parallel_for_range(0, out_plane, filters.num_filters()*padded_size, [&](long begin, long end)
+                {
+                    int8_gemm(o+begin, 1, out_plane, &cols[begin*padded_size], end-begin,
+                        &filters.weights[0], filters.num_filters(), padded_size, &filters.scales[0]);
+                });
+            }
+        }
+
     // ------------------------------------------------------------------------------------
     void copy_tensor(
             tensor& dest,
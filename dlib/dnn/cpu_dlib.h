@@ -7,12 +7,35 @@
 // and cudnn_dlibapi.h
 
 #include "tensor.h"
+#include <cstdint>
+#include <vector>
 
 namespace dlib
 {
     namespace cpu 
     {
 
+    // -----------------------------------------------------------------------------------
+
+        unsigned long get_num_threads (
+        );
+
+        void set_num_threads (
+            unsigned long num_threads
+        );
+
+    // -----------------------------------------------------------------------------------
+
+        void gemm (
+            float beta,
+            tensor& dest,
+            float alpha,
+            const tensor& lhs,
+            bool trans_lhs,
+            const tensor& rhs,
+            bool trans_rhs
+        );
+
     // -----------------------------------------------------------------------------------
 
         void multiply (
@@ -247,6 +270,11 @@ namespace dlib
             const tensor& src
         );
 
+        void add_bias_and_relu (
+            tensor& dest,
+            const tensor& biases
+        );
+
         void relu_gradient (
             tensor& grad,
             const tensor& dest,
@@ -354,6 +382,14 @@ namespace dlib
             void clear(
             ) {}
 
+            enum class algorithm 
+            {
+                img2col,
+                direct,
+                winograd_2x2,
+                winograd_4x4
+            };
+
             void operator() (
                 resizable_tensor& output,
                 const tensor& data,
@@ -363,6 +399,36 @@ namespace dlib
                 int padding_y,
                 int padding_x
             );
+            /*!
+                ensures
+                    - Computes the convolution using select_algorithm(data,filters,stride_y,stride_x).
+                    - Note that the different algorithms round differently, so the outputs
+                      only agree with the img2col method up to floating point error.  In
+                      particular, with the default dnn_prefer_fastest_algorithms()==true, 3x3
+                      stride 1 convolutions use Winograd, whose outputs differ from img2col by
+                      about 1e-5 relative to the size of the output values.
+            !*/
+
+            void operator() (
+                resizable_tensor& output,
+                const tensor& data,
+                const tensor& filters,
+                int stride_y,
+                int stride_x,
+                int padding_y,
+                int padding_x,
+                algorithm alg
+            );
+            /*!
+                requires
+                    - if (alg is winograd_2x2 or winograd_4x4) then
+                        - filters.nr() == 3 && filters.nc() == 3
+                        - stride_y == 1 && stride_x == 1
+                ensures
+                    - Computes the same convolution as the operator() above but always uses
+                      the given algorithm.  Use algorithm::img2col to get the outputs of the
+                      original CPU convolution.
+            !*/
 
             void get_gradient_for_data (
                 const tensor& gradient_input, 
@@ -376,14 +442,140 @@ namespace dlib
                 tensor& filters_gradient
             );
 
+            static algorithm select_algorithm (
+                const tensor& data,
+                const tensor& filters,
+                int stride_y,
+                int stride_x
+            );
+            /*!
+                ensures
+                    - returns the method operator() will use to compute the given
+                      convolution.  If dnn_prefer_fastest_algorithms()==true then 3x3
+                      stride 1 convolutions with at least 4 input and output channels use
+                      the Winograd F(4x4,3x3) method, or F(2x2,3x3) for small images, and
+                      everything else uses img2col followed by a matrix multiply.
+                      Otherwise, filters with at most 25 elements per channel are applied
+                      directly, which needs no temporary storage, and everything else uses
+                      img2col.
+            !*/
+
+            algorithm get_last_algorithm (
+            ) const { return last_algorithm; }
+
         private:
 
+            algorithm last_algorithm = algorithm::img2col;
             long last_stride_y;
             long last_stride_x;
             long last_padding_y;
             long last_padding_x;
         };
 
+    // -----------------------------------------------------------------------------------
+
+        class int8_filters
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This object holds a bank of filters (i.e. the weights of a fc_ or con_
+                    layer) quantized to 8 bit integers for fast inference.  Each filter
+                    (i.e. each output channel) gets its own scale factor so that a filter
+                    with small weights doesn't lose all its precision to a filter with
+                    large weights.  The object also records the scale used to quantize the
+                    data coming into the filters, which is determined ahead of time by
+                    calibrating on some representative data.
+            !*/
+        public:
+
+            int8_filters(
+            ) = default;
+
+            void quantize (
+                const tensor& weights,
+                bool filters_are_columns,
+                float input_range
+            );
+            /*!
+                requires
+                    - input_range >= 0
+                ensures
+                    - Quantizes the filters in mat(weights).  If filters_are_columns then
+                      each column of mat(weights) is a filter, otherwise each row is.
+                    - #num_filters() == the number of filters in weights.
+                    - #filter_size() == the number of elements in each filter.
+                    - Data given to int8_fc() or int8_conv() will be quantized assuming
+                      its values are in the range [-input_range, input_range].  Values
+                      outside this range are clipped.
+            !*/
+
+            void clear(
+            );
+
+            bool empty (
+            ) const { return weights.size() == 0; }
+
+            long num_filters (
+            ) const { return num_filters_; }
+
+            long filter_size (
+            ) const { return filter_size_; }
+
+            float get_input_range (
+            ) const { return input_scale*127; }
+
+            friend void serialize(const int8_filters& item, std::ostream& out);
+            friend void deserialize(int8_filters& item, std::istream& in);
+
+            friend void int8_fc (
+                resizable_tensor& output,
+                const tensor& data,
+                const int8_filters& filters
+            );
+
+            friend void int8_conv (
+                resizable_tensor& output,
+                const tensor& data,
+                const int8_filters& filters,
+                long filter_nr,
+                long filter_nc,
+                int stride_y,
+                int stride_x,
+                int padding_y,
+                int padding_x
+            );
+
+        private:
+
+            // The filters are stored one after another with each one padded out to
+            // padded_size elements so the dot product kernels never need to handle
+            // leftover elements.
+            long num_filters_ = 0;
+            long filter_size_ = 0;
+            long padded_size = 0;
+            float input_scale = 1;
+            std::vector<int8_t> weights;
+            std::vector<float> scales;
+        };
+
+        void int8_fc (
+            resizable_tensor& output,
+            const tensor& data,
+            const int8_filters& filters
+        );
+
+        void int8_conv (
+            resizable_tensor& output,
+            const tensor& data,
+            const int8_filters& filters,
+            long filter_nr,
+            long filter_nc,
+            int stride_y,
+            int stride_x,
+            int padding_y,
+            int padding_x
+        );
+
     // -----------------------------------------------------------------------------------
 
         void copy_tensor(
@@ -48,7 +48,8 @@ namespace dlib
             bias_learning_rate_multiplier(1),
             bias_weight_decay_multiplier(0),
             padding_y_(_padding_y),
-            padding_x_(_padding_x)
+            padding_x_(_padding_x),
+            use_relu(false)
         {}
 
         long num_filters() const { return _num_filters; }
@@ -81,7 +82,9 @@ namespace dlib
             bias_learning_rate_multiplier(item.bias_learning_rate_multiplier),
             bias_weight_decay_multiplier(item.bias_weight_decay_multiplier),
             padding_y_(item.padding_y_),
-            padding_x_(item.padding_x_)
+            padding_x_(item.padding_x_),
+            use_relu(item.use_relu),
+            qfilters(item.qfilters)
         {
             // this->conv is non-copyable and basically stateless, so we have to write our
             // own copy to avoid trying to copy it and getting an error.
@@ -105,9 +108,48 @@ namespace dlib
             weight_decay_multiplier = item.weight_decay_multiplier;
             bias_learning_rate_multiplier = item.bias_learning_rate_multiplier;
             bias_weight_decay_multiplier = item.bias_weight_decay_multiplier;
+            use_relu = item.use_relu;
+            qfilters = item.qfilters;
             return *this;
         }
 
+        bool fuse_affine_transform (
+            const tensor& gamma,
+            const tensor& beta
+        )
+        {
+            if (params.size() == 0 || is_quantized() || use_relu ||
+                gamma.size() != (size_t)_num_filters || beta.size() != (size_t)_num_filters)
+                return false;
+
+            // Scaling each filter's output by gamma is the same as scaling the filter
+            // itself, so fold the transform into the filters and biases.
+            auto f = filters(params,0);
+            auto b = biases(params,filters.size());
+            f = scale_rows(mat(f), mat(gamma.host(), _num_filters, 1));
+            b = pointwise_multiply(mat(b), mat(gamma.host(), 1, _num_filters)) + mat(beta.host(), 1, _num_filters);
+            return true;
+        }
+
+        void enable_relu (
+        ) { use_relu = true; }
+
+        bool relu_is_enabled (
+        ) const { return use_relu; }
+
+        void quantize (
+            float input_range
+        )
+        {
+            DLIB_CASSERT(params.size() != 0 && !is_quantized(),"");
+            qfilters.quantize(filters(params,0), false, input_range);
+            // Only the biases are still needed in floating point form.
+            params = resizable_tensor(biases(params,filters.size()));
+        }
+
+        bool is_quantized (
+        ) const { return !qfilters.empty(); }
+
         template <typename SUBNET>
         void setup (const SUBNET& sub)
         {
@@ -129,6 +171,14 @@ namespace dlib
         template <typename SUBNET>
         void forward(const SUBNET& sub, resizable_tensor& output)
         {
+            if (is_quantized())
+            {
+                tt::int8_conv(output, sub.get_output(), qfilters, _nr, _nc, 
+                    _stride_y, _stride_x, padding_y_, padding_x_);
+                add_biases(output, biases(params,0));
+                return;
+            }
+
             conv(output,
                 sub.get_output(),
                 filters(params,0),
@@ -138,12 +188,14 @@ namespace dlib
                 padding_x_
                 );
 
-            tt::add(1,output,1,biases(params,filters.size()));
+            add_biases(output, biases(params,filters.size()));
         } 
 
         template <typename SUBNET>
         void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad)
         {
+            DLIB_CASSERT(!is_quantized(), "A quantized con_ layer can't be trained.");
+            DLIB_CASSERT(!use_relu, "A con_ layer with a fused relu can't be trained.");
             conv.get_gradient_for_data (gradient_input, filters(params,0), sub.get_gradient_input());
             // no point computing the parameter gradients if they won't be used.
             if (learning_rate_multiplier != 0)
@@ -160,7 +212,13 @@ namespace dlib
 
         friend void serialize(const con_& item, std::ostream& out)
         {
-            serialize("con_4", out);
+            // Only use the new format when we have to so that unquantized networks can
+            // still be loaded by older versions of dlib.
+            const bool use_new_format = item.is_quantized() || item.use_relu;
+            if (use_new_format)
+                serialize("con_5", out);
+            else
+                serialize("con_4", out);
             serialize(item.params, out);
             serialize(_num_filters, out);
             serialize(_nr, out);
@@ -175,6 +233,11 @@ namespace dlib
             serialize(item.weight_decay_multiplier, out);
             serialize(item.bias_learning_rate_multiplier, out);
             serialize(item.bias_weight_decay_multiplier, out);
+            if (use_new_format)
+            {
+                serialize(item.use_relu, out);
+                serialize(item.qfilters, out);
+            }
         }
 
         friend void deserialize(con_& item, std::istream& in)
@@ -186,7 +249,7 @@ namespace dlib
             long nc;
             int stride_y;
             int stride_x;
-            if (version == "con_4")
+            if (version == "con_4" || version == "con_5")
             {
                 deserialize(item.params, in);
                 deserialize(num_filters, in);
@@ -209,6 +272,16 @@ namespace dlib
                 if (nc != _nc) abort();
                 if (stride_y != _stride_y) abort();
                 if (stride_x != _stride_x) abort();
+                if (version == "con_5")
+                {
+                    deserialize(item.use_relu, in);
+                    deserialize(item.qfilters, in);
+                }
+                else
+                {
+                    item.use_relu = false;
+                    item.qfilters.clear();
+                }
             }
             else
             {
@@ -232,6 +305,10 @@ namespace dlib
             out << " weight_decay_mult="<<item.weight_decay_multiplier;
             out << " bias_learning_rate_mult="<<item.bias_learning_rate_multiplier;
             out << " bias_weight_decay_mult="<<item.bias_weight_decay_multiplier;
+            if (item.use_relu)
+                out << " relu";
+            if (item.is_quantized())
+                out << " int8";
             return out;
         }
 
@@ -255,6 +332,17 @@ namespace dlib
 
     private:
 
+        void add_biases (
+            tensor& output,
+            const tensor& b
+        ) const
+        {
+            if (use_relu)
+                tt::add_bias_and_relu(output, b);
+            else
+                tt::add(1,output,1,b);
+        }
+
         resizable_tensor params;
         alias_tensor filters, biases;
 
@@ -269,6 +357,13 @@ namespace dlib
         int padding_y_;
         int padding_x_;
 
+        // true if a relu layer has been fused into this layer.
+        bool use_relu;
+
+        // Non-empty only after quantize() has been called, in which case params holds
+        // just the biases.
+        tt::int8_filters qfilters;
+
     };
 
     template <
@@ -889,7 +984,8 @@ namespace dlib
             learning_rate_multiplier(1),
             weight_decay_multiplier(1),
             bias_learning_rate_multiplier(1),
-            bias_weight_decay_multiplier(0)
+            bias_weight_decay_multiplier(0),
+            use_relu(false)
         {}
 
         fc_() : fc_(num_fc_outputs(num_outputs_)) {}
@@ -910,6 +1006,54 @@ namespace dlib
         fc_bias_mode get_bias_mode (
         ) const { return bias_mode; }
 
+        void quantize (
+            float input_range
+        )
+        {
+            DLIB_CASSERT(params.size() != 0 && !is_quantized(),"");
+            qfilters.quantize(weights(params,0), true, input_range);
+            // Only the biases are still needed in floating point form.
+            if (bias_mode == FC_HAS_BIAS)
+                params = resizable_tensor(biases(params,weights.size()));
+            else
+                params.clear();
+        }
+
+        bool is_quantized (
+        ) const { return !qfilters.empty(); }
+
+        bool fuse_affine_transform (
+            const tensor& gamma,
+            const tensor& beta
+        )
+        {
+            if (params.size() == 0 || is_quantized() || use_relu ||
+                gamma.size() != num_outputs || beta.size() != num_outputs)
+                return false;
+
+            // Without a bias term there is nowhere to put beta.
+            if (bias_mode == FC_NO_BIAS && max(abs(mat(beta))) != 0)
+                return false;
+
+            // Each column of the weight matrix produces one output, so scaling an output
+            // by gamma is the same as scaling its column.
+            const auto g = mat(gamma.host(), 1, num_outputs);
+            auto w = weights(params,0);
+            w = scale_columns(mat(w), g);
+            if (bias_mode == FC_HAS_BIAS)
+            {
+                auto b = biases(params,weights.size());
+                b = pointwise_multiply(mat(b), g) + mat(beta.host(), 1, num_outputs);
+            }
+            return true;
+        }
+
+        void enable_relu (
+        ) { use_relu = true; }
+
+        bool relu_is_enabled (
+        ) const { return use_relu; }
+
         template <typename SUBNET>
         void setup (const SUBNET& sub)
         {
@@ -935,20 +1079,25 @@ namespace dlib
         template <typename SUBNET>
         void forward(const SUBNET& sub, resizable_tensor& output)
         {
+            if (is_quantized())
+            {
+                tt::int8_fc(output, sub.get_output(), qfilters);
+                add_biases(output, 0);
+                return;
+            }
+
             output.set_size(sub.get_output().num_samples(), num_outputs);
 
             auto w = weights(params, 0);
             tt::gemm(0,output, 1,sub.get_output(),false, w,false);
-            if (bias_mode == FC_HAS_BIAS)
-            {
-                auto b = biases(params, weights.size());
-                tt::add(1,output,1,b);
-            }
+            add_biases(output, weights.size());
         } 
 
         template <typename SUBNET>
         void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad)
         {
+            DLIB_CASSERT(!is_quantized(), "A quantized fc_ layer can't be trained.");
+            DLIB_CASSERT(!use_relu, "A fc_ layer with a fused relu can't be trained.");
             // no point computing the parameter gradients if they won't be used.
             if (learning_rate_multiplier != 0)
             {
@@ -974,7 +1123,13 @@ namespace dlib
 
         friend void serialize(const fc_& item, std::ostream& out)
         {
-            serialize("fc_2", out);
+            // Only use the new format when we have to so that unquantized networks can
+            // still be loaded by older versions of dlib.
+            const bool use_new_format = item.is_quantized() || item.use_relu;
+            if (use_new_format)
+                serialize("fc_3", out);
+            else
+                serialize("fc_2", out);
             serialize(item.num_outputs, out);
             serialize(item.num_inputs, out);
             serialize(item.params, out);
@@ -985,13 +1140,18 @@ namespace dlib
             serialize(item.weight_decay_multiplier, out);
             serialize(item.bias_learning_rate_multiplier, out);
             serialize(item.bias_weight_decay_multiplier, out);
+            if (use_new_format)
+            {
+                serialize(item.use_relu, out);
+                serialize(item.qfilters, out);
+            }
         }
 
         friend void deserialize(fc_& item, std::istream& in)
         {
             std::string version;
             deserialize(version, in);
-            if (version != "fc_2")
+            if (version != "fc_2" && version != "fc_3")
                 abort();
 
             deserialize(item.num_outputs, in);
@@ -1006,6 +1166,16 @@ namespace dlib
             deserialize(item.weight_decay_multiplier, in);
             deserialize(item.bias_learning_rate_multiplier, in);
             deserialize(item.bias_weight_decay_multiplier, in);
+            if (version == "fc_3")
+            {
+                deserialize(item.use_relu, in);
+                deserialize(item.qfilters, in);
+            }
+            else
+            {
+                item.use_relu = false;
+                item.qfilters.clear();
+            }
         }
 
         friend std::ostream& operator<<(std::ostream& out, const fc_& item)
@@ -1028,6 +1198,10 @@ namespace dlib
                 out << " learning_rate_mult="<<item.learning_rate_multiplier;
                 out << " weight_decay_mult="<<item.weight_decay_multiplier;
             }
+            if (item.use_relu)
+                out << " relu";
+            if (item.is_quantized())
+                out << " int8";
             return out;
         }
 
@@ -1059,6 +1233,25 @@ namespace dlib
 
     private:
 
+        void add_biases (
+            tensor& output,
+            size_t bias_offset
+        )
+        {
+            if (bias_mode == FC_HAS_BIAS)
+            {
+                auto b = biases(params, bias_offset);
+                if (use_relu)
+                    tt::add_bias_and_relu(output, b);
+                else
+                    tt::add(1,output,1,b);
+            }
+            else if (use_relu)
+            {
+                tt::relu(output, output);
+            }
+        }
+
         unsigned long num_outputs;
         unsigned long num_inputs;
         resizable_tensor params;
@@ -1067,6 +1260,13 @@ namespace dlib
         double weight_decay_multiplier;
         double bias_learning_rate_multiplier;
         double bias_weight_decay_multiplier;
+
+        // true if a relu layer has been fused into this layer.
+        bool use_relu;
+
+        // Non-empty only after quantize() has been called, in which case params holds
+        // just the biases.
+        tt::int8_filters qfilters;
     };
 
     template <
@@ -1288,13 +1488,13 @@ namespace dlib
     {
     public:
         affine_(
-        ) : mode(FC_MODE)
+        ) : mode(FC_MODE), disabled(false)
         {
         }
 
         affine_(
             layer_mode mode_
-        ) : mode(mode_)
+        ) : mode(mode_), disabled(false)
         {
         }
 
@@ -1303,7 +1503,7 @@ namespace dlib
             >
         affine_(
             const bn_<bnmode>& item
-        )
+        ) : disabled(false)
         {
             gamma = item.gamma;
             beta = item.beta;
@@ -1324,6 +1524,19 @@ namespace dlib
 
         layer_mode get_mode() const { return mode; }
 
+        alias_tensor_instance get_gamma() { return gamma(params,0); }
+        alias_tensor_instance get_beta() { return beta(params,gamma.size()); }
+
+        void disable (
+        ) 
+        {
+            params.clear();
+            disabled = true;
+        }
+
+        bool is_disabled (
+        ) const { return disabled; }
+
         template <typename SUBNET>
         void setup (const SUBNET& sub)
         {
@@ -1348,6 +1561,13 @@ namespace dlib
 
         void forward_inplace(const tensor& input, tensor& output)
         {
+            if (disabled)
+            {
+                if (!is_same_object(input, output))
+                    memcpy(output, input);
+                return;
+            }
+
             auto g = gamma(params,0);
             auto b = beta(params,gamma.size());
             if (mode == FC_MODE)
@@ -1362,6 +1582,7 @@ namespace dlib
             tensor& /*params_grad*/
         )
         {
+            DLIB_CASSERT(!disabled, "A disabled affine_ layer can't be trained.");
             auto g = gamma(params,0);
             auto b = beta(params,gamma.size());
 
@@ -1387,11 +1608,18 @@ namespace dlib
 
         friend void serialize(const affine_& item, std::ostream& out)
         {
-            serialize("affine_", out);
+            // Only use the new format when we have to so that older versions of dlib can
+            // still load networks that don't use disabled layers.
+            if (item.disabled)
+                serialize("affine_2", out);
+            else
+                serialize("affine_", out);
             serialize(item.params, out);
             serialize(item.gamma, out);
             serialize(item.beta, out);
             serialize((int)item.mode, out);
+            if (item.disabled)
+                serialize(item.disabled, out);
         }
 
         friend void deserialize(affine_& item, std::istream& in)
@@ -1419,7 +1647,7 @@ namespace dlib
                 return;
             }
 
-            if (version != "affine_")
+            if (version != "affine_" && version != "affine_2")
                 abort();
             deserialize(item.params, in);
             deserialize(item.gamma, in);
@@ -1427,11 +1655,17 @@ namespace dlib
             int mode;
             deserialize(mode, in);
             item.mode = (layer_mode)mode;
+            if (version == "affine_2")
+                deserialize(item.disabled, in);
+            else
+                item.disabled = false;
         }
 
-        friend std::ostream& operator<<(std::ostream& out, const affine_& )
+        friend std::ostream& operator<<(std::ostream& out, const affine_& item)
         {
             out << "affine";
+            if (item.disabled)
+                out << " (disabled)";
             return out;
         }
 
@@ -1451,6 +1685,7 @@ namespace dlib
         resizable_tensor params, empty_params; 
         alias_tensor gamma, beta;
         layer_mode mode;
+        bool disabled;
     };
 
     template <typename SUBNET>
@@ -1560,10 +1795,16 @@ namespace dlib
     class relu_
     {
     public:
-        relu_() 
+        relu_() : disabled(false)
         {
         }
 
+        void disable (
+        ) { disabled = true; }
+
+        bool is_disabled (
+        ) const { return disabled; }
+
         template <typename SUBNET>
         void setup (const SUBNET& /*sub*/)
         {
@@ -1571,6 +1812,13 @@ namespace dlib
 
         void forward_inplace(const tensor& input, tensor& output)
         {
+            if (disabled)
+            {
+                if (!is_same_object(input, output))
+                    memcpy(output, input);
+                return;
+            }
+
             tt::relu(output, input);
         } 
 
@@ -1581,28 +1829,43 @@ namespace dlib
             tensor& 
         )
         {
+            DLIB_CASSERT(!disabled, "A disabled relu_ layer can't be trained.");
             tt::relu_gradient(data_grad, computed_output, gradient_input);
         }
 
         const tensor& get_layer_params() const { return params; }
         tensor& get_layer_params() { return params; }
 
-        friend void serialize(const relu_& , std::ostream& out)
+        friend void serialize(const relu_& item, std::ostream& out)
         {
-            serialize("relu_", out);
+            if (item.disabled)
+            {
+                serialize("relu_2", out);
+                serialize(item.disabled, out);
+            }
+            else
+            {
+                serialize("relu_", out);
+            }
         }
 
-        friend void deserialize(relu_& , std::istream& in)
+        friend void deserialize(relu_& item, std::istream& in)
         {
             std::string version;
             deserialize(version, in);
-            if (version != "relu_")
+            if (version == "relu_2")
+                deserialize(item.disabled, in);
+            else if (version == "relu_")
+                item.disabled = false;
+            else
                 abort();
         }
 
-        friend std::ostream& operator<<(std::ostream& out, const relu_& )
+        friend std::ostream& operator<<(std::ostream& out, const relu_& item)
         {
             out << "relu";
+            if (item.disabled)
+                out << " (disabled)";
             return out;
         }
 
@@ -1613,6 +1876,7 @@ namespace dlib
 
     private:
         resizable_tensor params;
+        bool disabled;
     };
 
 
@@ -2106,8 +2370,87 @@ namespace dlib
                 itag1<B1<iskip< itag2<B2<iskip< itag3<B3<iskip<  itag4<B4<iskip<  itag5<B5<  itag0<SUBNET>>>>>>>>>>>>>>>>;
 // ----------------------------------------------------------------------------------------
 
+    namespace impl
+    {
+        class visitor_fuse_affine
+        {
+        public:
+
+            template <typename T>
+            void operator()(size_t , T& ) {}
+
+            template <typename U, typename E>
+            void operator()(size_t , add_layer<affine_,U,E>& l) 
+            {
+                if (!l.layer_details().is_disabled())
+                    fuse(l.layer_details(), l.subnet(), 0);
+            }
+
+        private:
+
+            template <typename SUBNET>
+            auto fuse(affine_& aff, SUBNET& sub, int) -> decltype(sub.layer_details().fuse_affine_transform(aff.get_gamma(),aff.get_beta()), void())
+            {
+                if (sub.layer_details().fuse_affine_transform(aff.get_gamma(), aff.get_beta()))
+                    aff.disable();
+            }
+
+            template <typename SUBNET>
+            void fuse(affine_&, SUBNET&, long) {}
+        };
+
+        class visitor_fuse_relu
+        {
+        public:
+
+            template <typename T>
+            void operator()(size_t , T& ) {}
+
+            template <typename U, typename E>
+            void operator()(size_t , add_layer<relu_,U,E>& l) 
+            {
+                if (!l.layer_details().is_disabled())
+                    fuse(l.layer_details(), l.subnet(), 0);
+            }
+
+        private:
+
+            template <typename SUBNET>
+            auto fuse(relu_& r, SUBNET& sub, int) -> decltype(sub.layer_details().enable_relu(), void())
+            {
+                if (!sub.layer_details().relu_is_enabled())
+                {
+                    sub.layer_details().enable_relu();
+                    r.disable();
+                }
+            }
+
+            // Look through affine layers that have already been folded into the layer
+            // below them.
+            template <typename U, typename E>
+            void fuse(relu_& r, add_layer<affine_,U,E>& sub, int)
+            {
+                if (sub.layer_details().is_disabled())
+                    fuse(r, sub.subnet(), 0);
+            }
+
+            template <typename SUBNET>
+            void fuse(relu_&, SUBNET&, long) {}
+        };
+    }
+
+    template <typename net_type>
+    void fuse_layers (
+        net_type& net
+    )
+    {
+        visit_layers(net, impl::visitor_fuse_affine());
+        visit_layers(net, impl::visitor_fuse_relu());
+    }
+
+// ----------------------------------------------------------------------------------------
+
 }
 
 #endif // DLIB_DNn_LAYERS_H_
 
-
@@ -498,6 +498,71 @@ namespace dlib
                 - #get_bias_weight_decay_multiplier() == val
         !*/
 
+        void quantize (
+            float input_range
+        );
+        /*!
+            requires
+                - setup() has been called.
+                - is_quantized() == false
+                - input_range >= 0
+            ensures
+                - Converts this layer into an 8 bit integer inference layer.  That is,
+                  the weights are quantized to 8 bits using a separate scale for each output,
+                  forward() quantizes its inputs to 8 bits assuming they are in the range
+                  [-input_range, input_range], and the products are accumulated in 32
+                  bit integers.  This makes the layer about 4 times smaller and usually
+                  much faster, at the cost of a small loss of accuracy.  You will
+                  usually call quantize_network() rather than calling this function
+                  directly.
+                - #is_quantized() == true
+                - #get_layer_params() contains only the bias terms.  
+                - backward() may no longer be called.
+        !*/
+
+        bool is_quantized (
+        ) const;
+        /*!
+            ensures
+                - returns true if quantize() has been called on this layer.
+        !*/
+
+        bool fuse_affine_transform (
+            const tensor& gamma,
+            const tensor& beta
+        );
+        /*!
+            ensures
+                - Attempts to fold a pointwise linear transformation of this layer's
+                  outputs into its weights and biases.  That is, if it can, this function
+                  modifies the layer so that its k-th output is multiplied by gamma[k] and
+                  then has beta[k] added to it, and returns true.  
+                - The transformation can only be folded if gamma and beta both have
+                  get_num_outputs() elements, setup() has been called,
+                  is_quantized()==false, and relu_is_enabled()==false.  Moreover, if the
+                  bias mode is FC_NO_BIAS then beta must be all 0.  If it can't be folded
+                  then this function returns false and doesn't modify the layer.
+                - You will usually call fuse_layers() rather than calling this function
+                  directly.
+        !*/
+
+        void enable_relu (
+        );
+        /*!
+            ensures
+                - #relu_is_enabled() == true
+                - forward() applies the relu function to its outputs as part of adding
+                  the biases, so a relu layer stacked on top of this one can be disabled.
+                - backward() may no longer be called.
+        !*/
+
+        bool relu_is_enabled (
+        ) const;
+        /*!
+            ensures
+                - returns true if forward() applies relu to its outputs.
+        !*/
+
         template <typename SUBNET> void setup (const SUBNET& sub);
         template <typename SUBNET> void forward(const SUBNET& sub, resizable_tensor& output);
         template <typename SUBNET> void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad);
@@ -706,6 +771,70 @@ namespace dlib
                 - #get_bias_weight_decay_multiplier() == val
         !*/
 
+        void quantize (
+            float input_range
+        );
+        /*!
+            requires
+                - setup() has been called.
+                - is_quantized() == false
+                - input_range >= 0
+            ensures
+                - Converts this layer into an 8 bit integer inference layer.  That is,
+                  the filters are quantized to 8 bits using a separate scale for each filter,
+                  forward() quantizes its inputs to 8 bits assuming they are in the range
+                  [-input_range, input_range], and the products are accumulated in 32
+                  bit integers.  This makes the layer about 4 times smaller and usually
+                  much faster, at the cost of a small loss of accuracy.  You will
+                  usually call quantize_network() rather than calling this function
+                  directly.
+                - #is_quantized() == true
+                - #get_layer_params() contains only the bias terms.  
+                - backward() may no longer be called.
+        !*/
+
+        bool is_quantized (
+        ) const;
+        /*!
+            ensures
+                - returns true if quantize() has been called on this layer.
+        !*/
+
+        bool fuse_affine_transform (
+            const tensor& gamma,
+            const tensor& beta
+        );
+        /*!
+            ensures
+                - Attempts to fold a pointwise linear transformation of this layer's
+                  outputs into its filters and biases.  That is, if it can, this function
+                  modifies the layer so that its k-th output is multiplied by gamma[k] and
+                  then has beta[k] added to it, and returns true.  
+                - The transformation can only be folded if gamma and beta both have
+                  num_filters() elements, setup() has been called,
+                  is_quantized()==false, and relu_is_enabled()==false.  If it can't be folded
+                  then this function returns false and doesn't modify the layer.
+                - You will usually call fuse_layers() rather than calling this function
+                  directly.
+        !*/
+
+        void enable_relu (
+        );
+        /*!
+            ensures
+                - #relu_is_enabled() == true
+                - forward() applies the relu function to its outputs as part of adding
+                  the biases, so a relu layer stacked on top of this one can be disabled.
+                - backward() may no longer be called.
+        !*/
+
+        bool relu_is_enabled (
+        ) const;
+        /*!
+            ensures
+                - returns true if forward() applies relu to its outputs.
+        !*/
+
         template <typename SUBNET> void setup (const SUBNET& sub);
         template <typename SUBNET> void forward(const SUBNET& sub, resizable_tensor& output);
         template <typename SUBNET> void backward(const tensor& gradient_input, SUBNET& sub, tensor& params_grad);
@@ -1105,6 +1234,36 @@ namespace dlib
                 - returns the mode of this layer, either CONV_MODE or FC_MODE.  
         !*/
 
+        alias_tensor_instance get_gamma(
+        );
+        alias_tensor_instance get_beta(
+        );
+        /*!
+            requires
+                - setup() has been called.
+                - is_disabled() == false
+            ensures
+                - returns the A and B tensors used by this layer to compute A*INPUT+B.
+        !*/
+
+        void disable(
+        );
+        /*!
+            ensures
+                - #is_disabled() == true
+                - This layer now simply passes its input through unchanged.  This is used
+                  by fuse_layers() once the transformation has been folded into the layer
+                  below.
+                - backward_inplace() may no longer be called.
+        !*/
+
+        bool is_disabled(
+        ) const;
+        /*!
+            ensures
+                - returns true if disable() has been called.
+        !*/
+
         template <typename SUBNET> void setup (const SUBNET& sub);
         void forward_inplace(const tensor& input, tensor& output);
         void backward_inplace(const tensor& computed_output, const tensor& gradient_input, tensor& data_grad, tensor& params_grad);
@@ -1427,6 +1586,23 @@ namespace dlib
         relu_(
         );
 
+        void disable(
+        );
+        /*!
+            ensures
+                - #is_disabled() == true
+                - This layer now simply passes its input through unchanged.  This is used
+                  by fuse_layers() once the relu has been moved into the layer below.
+                - backward_inplace() may no longer be called.
+        !*/
+
+        bool is_disabled(
+        ) const;
+        /*!
+            ensures
+                - returns true if disable() has been called.
+        !*/
+
         template <typename SUBNET> void setup (const SUBNET& sub);
         void forward_inplace(const tensor& input, tensor& output);
         void backward_inplace(const tensor& computed_output, const tensor& gradient_input, tensor& data_grad, tensor& params_grad);
@@ -1787,6 +1963,34 @@ namespace dlib
     using inception5 = concat5<itag1, itag2, itag3, itag4, itag5,
                 itag1<B1<iskip< itag2<B2<iskip< itag3<B3<iskip<  itag4<B4<iskip<  itag5<B5<  itag0<SUBNET>>>>>>>>>>>>>>>>;
 
+// ----------------------------------------------------------------------------------------
+
+    template <typename net_type>
+    void fuse_layers (
+        net_type& net
+    );
+    /*!
+        requires
+            - net_type is an object of type add_layer, add_loss_layer, add_skip_layer, or
+              add_tag_layer.
+        ensures
+            - Prepares net for deployment by combining layers where that doesn't change
+              what the network computes.  In particular:
+                - An affine_ layer sitting directly on top of a con_ or fc_ layer is
+                  folded into that layer's weights and biases using
+                  fuse_affine_transform() and then disabled.  To fuse batch
+                  normalization, first convert the bn_ layers into affine_ layers, e.g.
+                  by assigning the network to one that uses affine_ where it used bn_.
+                - A relu_ layer sitting directly on top of a con_ or fc_ layer, or on top
+                  of a disabled affine_ that is on top of one, is disabled and the relu is
+                  applied by the con_ or fc_ layer as part of adding its biases instead.
+            - So a con_ -> affine_ -> relu_ sequence computes its output with one pass
+              over the data after the convolution rather than three.
+            - The fused network can be serialized and deserialized like any other
+              network, but it can no longer be trained.
+            - If you also want to call quantize_network() then call fuse_layers() first.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
 }
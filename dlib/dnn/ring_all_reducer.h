@@ -0,0 +1,213 @@
+// Copyright (C) 2026  agent (agent@local)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_DNn_RING_ALL_REDUCER_H_
+#define DLIB_DNn_RING_ALL_REDUCER_H_
+
+#include "ring_all_reducer_abstract.h"
+#include "../sockets.h"
+#include "../threads.h"
+#include "../noncopyable.h"
+#include "../smart_pointers.h"
+#include "../string.h"
+#include "../misc_api.h"
+#include <vector>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    class ring_all_reducer : noncopyable
+    {
+    public:
+
+        ring_all_reducer(
+            const std::vector<network_address>& nodes_,
+            unsigned long rank_,
+            unsigned long timeout = 60000
+        ) :
+            nodes(nodes_),
+            rank(rank_),
+            sender(1)
+        {
+            DLIB_CASSERT(rank < nodes.size(), "");
+            if (nodes.size() == 1)
+                return;
+
+            if (create_listener(listen_socket, nodes[rank].port) != 0)
+                throw socket_error("ring_all_reducer: unable to listen on port " + cast_to_string(nodes[rank].port));
+            connect_ring(timeout);
+        }
+
+        ring_all_reducer(
+            const std::vector<network_address>& nodes_,
+            unsigned long rank_,
+            scoped_ptr<listener>& listen_socket_,
+            unsigned long timeout = 60000
+        ) :
+            nodes(nodes_),
+            rank(rank_),
+            sender(1)
+        {
+            DLIB_CASSERT(rank < nodes.size() && listen_socket_ &&
+                listen_socket_->get_listening_port() == nodes[rank].port, "");
+            listen_socket.swap(listen_socket_);
+            if (nodes.size() == 1)
+                return;
+            connect_ring(timeout);
+        }
+
+        unsigned long num_nodes (
+        ) const { return nodes.size(); }
+
+        unsigned long get_rank (
+        ) const { return rank; }
+
+        void sum (
+            float* data,
+            size_t size
+        )
+        {
+            const size_t n = nodes.size();
+            if (n == 1)
+                return;
+
+            // The data is split into n chunks.  In the first n-1 steps each node adds the
+            // chunk it receives from the previous node into its own copy and passes the
+            // result on, so that at the end each node holds the complete sum of one chunk.
+            // In the next n-1 steps those sums get passed around the ring.  Every node
+            // only ever sends and receives about 2*size floats in total, no matter how
+            // many nodes there are.
+            auto chunk_begin = [&](size_t c) { return size*c/n; };
+            auto chunk_size = [&](size_t c) { return chunk_begin(c+1)-chunk_begin(c); };
+            buffer.resize(size/n+1);
+
+            for (size_t s = 0; s+1 < n; ++s)
+            {
+                const size_t send_c = (rank + n - s)%n;
+                const size_t recv_c = (rank + 2*n - s - 1)%n;
+                start_send(data+chunk_begin(send_c), chunk_size(send_c));
+                receive((char*)&buffer[0], chunk_size(recv_c)*sizeof(float));
+                float* dest = data+chunk_begin(recv_c);
+                for (size_t i = 0; i < chunk_size(recv_c); ++i)
+                    dest[i] += buffer[i];
+                finish_send();
+            }
+
+            for (size_t s = 0; s+1 < n; ++s)
+            {
+                const size_t send_c = (rank + n - s + 1)%n;
+                const size_t recv_c = (rank + n - s)%n;
+                start_send(data+chunk_begin(send_c), chunk_size(send_c));
+                receive((char*)(data+chunk_begin(recv_c)), chunk_size(recv_c)*sizeof(float));
+                finish_send();
+            }
+        }
+
+    private:
+
+        void connect_ring (
+            unsigned long timeout
+        )
+        {
+            // Connect to the next node in the ring.  It may not be listening yet, so keep
+            // trying until the timeout expires.  Since connections to our own listener
+            // queue up until we accept them this can't deadlock.
+            const auto& next = nodes[(rank+1)%nodes.size()];
+            std::string ip = next.host_address;
+            if (!is_ip_address(ip) && hostname_to_ip(next.host_address, ip) != 0)
+                throw socket_error("ring_all_reducer: unable to resolve " + next.host_address);
+            const auto start = std::chrono::steady_clock::now();
+            while (create_connection(next_node, next.port, ip) != 0)
+            {
+                if (std::chrono::steady_clock::now()-start > std::chrono::milliseconds(timeout))
+                    throw socket_error("ring_all_reducer: unable to connect to " + cast_to_string(next));
+                dlib::sleep(50);
+            }
+            next_node->disable_nagle();
+            const uint32_t header[3] = {magic, (uint32_t)rank, (uint32_t)nodes.size()};
+            send((const char*)header, sizeof(header));
+
+            if (listen_socket->accept(prev_node, timeout) != 0)
+                throw socket_error("ring_all_reducer: timed out waiting for a connection from " +
+                    cast_to_string(nodes[(rank+nodes.size()-1)%nodes.size()]));
+            prev_node->disable_nagle();
+            uint32_t prev_header[3];
+            receive((char*)prev_header, sizeof(prev_header));
+            if (prev_header[0] != magic || prev_header[1] != (rank+nodes.size()-1)%nodes.size() ||
+                prev_header[2] != nodes.size())
+            {
+                throw socket_error("ring_all_reducer: the node connecting to us doesn't agree on the ring layout");
+            }
+        }
+
+        void send (
+            const char* buf,
+            size_t num
+        )
+        {
+            if (num != 0 && next_node->write(buf, num) != (long)num)
+                throw socket_error("ring_all_reducer: error writing to " + cast_to_string(nodes[(rank+1)%nodes.size()]));
+        }
+
+        void receive (
+            char* buf,
+            size_t num
+        )
+        {
+            while (num != 0)
+            {
+                const long status = prev_node->read(buf, num);
+                if (status <= 0)
+                    throw socket_error("ring_all_reducer: lost connection to " +
+                        cast_to_string(nodes[(rank+nodes.size()-1)%nodes.size()]));
+                buf += status;
+                num -= status;
+            }
+        }
+
+        // Sending happens in another thread so it overlaps with receiving.  Otherwise
+        // both ends of a connection could block on full socket buffers.
+        void start_send (
+            const float* buf,
+            size_t num
+        )
+        {
+            send_error.clear();
+            sender.add_task_by_value([this,buf,num]() {
+                try { send((const char*)buf, num*sizeof(float)); }
+                catch (std::exception& e) { send_error = e.what(); }
+            });
+        }
+
+        void finish_send (
+        )
+        {
+            sender.wait_for_all_tasks();
+            if (send_error.size() != 0)
+                throw socket_error(send_error);
+        }
+
+        const static uint32_t magic = 0x52415231;
+
+        std::vector<network_address> nodes;
+        unsigned long rank;
+        scoped_ptr<listener> listen_socket;
+        scoped_ptr<connection> next_node;
+        scoped_ptr<connection> prev_node;
+        thread_pool sender;
+        std::string send_error;
+        std::vector<float> buffer;
+    };
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_RING_ALL_REDUCER_H_
+
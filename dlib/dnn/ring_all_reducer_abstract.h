@@ -0,0 +1,132 @@
+// Copyright (C) 2026  agent (agent@local)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#undef DLIB_DNn_RING_ALL_REDUCER_ABSTRACT_H_
+#ifdef DLIB_DNn_RING_ALL_REDUCER_ABSTRACT_H_
+
+#include "../sockets/sockets_extensions_abstract.h"
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    class ring_all_reducer : noncopyable
+    {
+        /*!
+            WHAT THIS OBJECT REPRESENTS
+                This object lets a group of processes, possibly on different machines, add
+                up arrays of floats so that they all end up with the sum.  It does this
+                with the ring all-reduce algorithm: the processes are arranged in a ring
+                where each one has a TCP connection to the next and the array is passed
+                around the ring in pieces.  This way each process sends and receives about
+                twice the size of the array in total, regardless of how many processes
+                there are, and all the links in the ring are busy at the same time.
+
+                The dnn_trainer uses this object to do data parallel training across
+                processes.  See dnn_trainer::set_distributed_nodes().
+
+            THREAD SAFETY
+                It is not safe to call sum() from multiple threads at once.
+        !*/
+
+    public:
+
+        ring_all_reducer(
+            const std::vector<network_address>& nodes,
+            unsigned long rank,
+            unsigned long timeout = 60000
+        );
+        /*!
+            requires
+                - rank < nodes.size()
+                - timeout < 2000000
+                - Every process in the group creates a ring_all_reducer with the same nodes
+                  vector and a different rank.
+                - All the processes run on machines with the same floating point format and
+                  byte order.
+            ensures
+                - #num_nodes() == nodes.size()
+                - #get_rank() == rank
+                - This process is nodes[rank].  So this object listens for a connection
+                  from nodes[rank-1] on port nodes[rank].port and connects to
+                  nodes[rank+1] (wrapping around at the ends).  The constructor blocks
+                  until both connections are made.  Since the other processes might not be
+                  running yet it keeps trying for up to timeout milliseconds.
+                - if (nodes.size() == 1) then no connections are made.
+            throws
+                - socket_error
+                    This exception is thrown if the connections can't be made within the
+                    timeout or if the other nodes disagree about the layout of the ring.
+        !*/
+
+        ring_all_reducer(
+            const std::vector<network_address>& nodes,
+            unsigned long rank,
+            scoped_ptr<listener>& listen_socket,
+            unsigned long timeout = 60000
+        );
+        /*!
+            requires
+                - rank < nodes.size()
+                - timeout < 2000000
+                - listen_socket is listening on port nodes[rank].port.
+                - Every process in the group creates a ring_all_reducer with the same nodes
+                  vector and a different rank.
+                - All the processes run on machines with the same floating point format and
+                  byte order.
+            ensures
+                - This constructor is just like the one above except that, rather than
+                  opening its own listening socket, it takes ownership of listen_socket and
+                  waits for nodes[rank-1] to connect to it.  This is useful when the
+                  listening ports are picked by the OS (i.e. by listening on port 0) since
+                  the port never has to be released and reopened.
+                - #listen_socket.get() == 0
+            throws
+                - socket_error
+                    This exception is thrown if the connections can't be made within the
+                    timeout or if the other nodes disagree about the layout of the ring.
+        !*/
+
+        unsigned long num_nodes (
+        ) const;
+        /*!
+            ensures
+                - returns the number of processes in the ring.
+        !*/
+
+        unsigned long get_rank (
+        ) const;
+        /*!
+            ensures
+                - returns the index of this process in the ring.
+        !*/
+
+        void sum (
+            float* data,
+            size_t size
+        );
+        /*!
+            requires
+                - data points to an array of size floats.
+                - Every process in the ring calls sum() with the same size.  The calls are
+                  matched up in the order they happen, so all the processes must make the
+                  same sequence of calls.
+            ensures
+                - Blocks until every process in the ring has called sum().  Then replaces
+                  the contents of data with the element-wise sum of the data arrays given
+                  by all the processes.
+                - All processes get exactly the same result, bit for bit.
+            throws
+                - socket_error
+                    This exception is thrown if a connection to one of the neighbors in the
+                    ring is lost.
+        !*/
+    };
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_DNn_RING_ALL_REDUCER_ABSTRACT_H_
+
@@ -406,20 +406,14 @@ namespace dlib
         serialize(item.k(), out);
         serialize(item.nr(), out);
         serialize(item.nc(), out);
-        byte_orderer bo;
-        auto sbuf = out.rdbuf();
-        for (auto d : item)
-        {
-            // Write out our data as 4byte little endian IEEE floats rather than using
-            // dlib's default float serialization.  We do this because it will result in
-            // more compact outputs.  It's slightly less portable but it seems doubtful
-            // that any CUDA enabled platform isn't going to use IEEE floats.  But if one
-            // does we can just update the serialization code here to handle it if such a
-            // platform is encountered.
-            bo.host_to_little(d);
-            static_assert(sizeof(d)==4, "This serialization code assumes we are writing 4 byte floats");
-            sbuf->sputn((char*)&d, sizeof(d));
-        }
+        // Write out our data as 4byte little endian IEEE floats rather than using dlib's
+        // default float serialization.  We do this because it will result in more compact
+        // outputs and it lets us write the whole tensor in one block.  It's slightly less
+        // portable but it seems doubtful that any CUDA enabled platform isn't going to
+        // use IEEE floats.  But if one does we can just update the serialization code
+        // here to handle it if such a platform is encountered.
+        static_assert(sizeof(float)==4, "This serialization code assumes we are writing 4 byte floats");
+        ser_helper::serialize_bulk_elements(item.host(), item.size(), out);
     }
 
     inline void deserialize(resizable_tensor& item, std::istream& in)
@@ -435,18 +429,8 @@ namespace dlib
         deserialize(nr, in);
         deserialize(nc, in);
         item.set_size(num_samples, k, nr, nc);
-        byte_orderer bo;
-        auto sbuf = in.rdbuf();
-        for (auto& d : item)
-        {
-            static_assert(sizeof(d)==4, "This serialization code assumes we are writing 4 byte floats");
-            if (sbuf->sgetn((char*)&d,sizeof(d)) != sizeof(d))
-            {
-                in.setstate(std::ios::badbit);
-                abort();
-            }
-            bo.little_to_host(d);
-        }
+        static_assert(sizeof(float)==4, "This serialization code assumes we are writing 4 byte floats");
+        ser_helper::deserialize_bulk_elements(item.host(), item.size(), in);
     }
 
 // ----------------------------------------------------------------------------------------
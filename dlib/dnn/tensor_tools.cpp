@@ -36,6 +36,20 @@ namespace dlib
     {
         dnn_prefer_fastest_algo() = false;
     }
+
+    unsigned long dnn_cpu_num_threads (
+    )
+    {
+        return cpu::get_num_threads();
+    }
+
+    void set_dnn_cpu_num_threads (
+        unsigned long num_threads
+    )
+    {
+        DLIB_CASSERT(num_threads > 0,"");
+        cpu::set_num_threads(num_threads);
+    }
 }
 
 namespace dlib { namespace tt
@@ -56,28 +70,7 @@ namespace dlib { namespace tt
 #ifdef DLIB_USE_CUDA
         cuda::gemm(beta, dest, alpha, lhs, trans_lhs, rhs, trans_rhs);
 #else
-        if (beta != 0)
-        {
-            if (trans_lhs && trans_rhs)
-                dest = alpha*trans(mat(lhs))*trans(mat(rhs)) + beta*mat(dest);
-            else if (!trans_lhs && trans_rhs)
-                dest = alpha*mat(lhs)*trans(mat(rhs)) + beta*mat(dest);
-            else if (trans_lhs && !trans_rhs)
-                dest = alpha*trans(mat(lhs))*mat(rhs) + beta*mat(dest);
-            else
-                dest = alpha*mat(lhs)*mat(rhs) + beta*mat(dest);
-        }
-        else
-        {
-            if (trans_lhs && trans_rhs)
-                dest = alpha*trans(mat(lhs))*trans(mat(rhs));
-            else if (!trans_lhs && trans_rhs)
-                dest = alpha*mat(lhs)*trans(mat(rhs));
-            else if (trans_lhs && !trans_rhs)
-                dest = alpha*trans(mat(lhs))*mat(rhs);
-            else
-                dest = alpha*mat(lhs)*mat(rhs);
-        }
+        cpu::gemm(beta, dest, alpha, lhs, trans_lhs, rhs, trans_rhs);
 #endif
     }
 
@@ -608,6 +601,19 @@ namespace dlib { namespace tt
 #endif
     }
 
+    void add_bias_and_relu (
+        tensor& dest,
+        const tensor& biases
+    )
+    {
+#ifdef DLIB_USE_CUDA
+        add(1, dest, 1, biases);
+        cuda::relu(dest,dest);
+#else
+        cpu::add_bias_and_relu(dest,biases);
+#endif
+    }
+
     void relu_gradient (
         tensor& grad,
         const tensor& dest,
@@ -695,6 +701,32 @@ namespace dlib { namespace tt
 #endif
         }
 
+// ----------------------------------------------------------------------------------------
+
+    void int8_fc (
+        resizable_tensor& output,
+        const tensor& data,
+        const int8_filters& filters
+    )
+    {
+        cpu::int8_fc(output, data, filters);
+    }
+
+    void int8_conv (
+        resizable_tensor& output,
+        const tensor& data,
+        const int8_filters& filters,
+        long filter_nr,
+        long filter_nc,
+        int stride_y,
+        int stride_x,
+        int padding_y,
+        int padding_x
+    )
+    {
+        cpu::int8_conv(output, data, filters, filter_nr, filter_nc, stride_y, stride_x, padding_y, padding_x);
+    }
+
 // ----------------------------------------------------------------------------------------
 
 }}
@@ -17,6 +17,8 @@ namespace dlib
     bool dnn_prefer_fastest_algorithms();
     void set_dnn_prefer_fastest_algorithms();
     void set_dnn_prefer_smallest_algorithms();
+    unsigned long dnn_cpu_num_threads();
+    void set_dnn_cpu_num_threads(unsigned long num_threads);
 }
 
 namespace dlib { namespace tt
@@ -995,6 +997,23 @@ namespace dlib { namespace tt
               is_same_object(dest, src)==true
     !*/
 
+    void add_bias_and_relu (
+        tensor& dest,
+        const tensor& biases
+    );
+    /*!
+        requires
+            - biases.num_samples() == 1
+            - biases.k() == dest.k()
+            - biases.nr() == 1
+            - biases.nc() == 1
+        ensures
+            - Adds biases[k] to each element of the k-th channel of dest and then applies
+              relu to the results.  That is, this function computes the same thing as
+              add(1,dest,1,biases) followed by relu(dest,dest), but when running on the
+              CPU it does it in a single pass over dest.
+    !*/
+
     void relu_gradient (
         tensor& grad,
         const tensor& dest,
@@ -1254,6 +1273,62 @@ namespace dlib { namespace tt
                   Copies content of each sample from src in to corresponding place of sample at dest.
         !*/
 
+// ----------------------------------------------------------------------------------------
+
+    // The int8 routines only have CPU implementations, so even in CUDA builds they read
+    // their inputs from and write their outputs to host memory.
+    using cpu::int8_filters;
+
+    void int8_fc (
+        resizable_tensor& output,
+        const tensor& data,
+        const int8_filters& filters
+    );
+    /*!
+        requires
+            - filters.empty() == false
+            - data.k()*data.nr()*data.nc() == filters.filter_size()
+        ensures
+            - Computes the product of each sample in data with each filter, that is, the
+              output of a fc_ layer without its bias term.  The computation quantizes data
+              to 8 bits and accumulates the products in 32 bit integers, so the results
+              only approximate the float computation.
+            - #output.num_samples() == data.num_samples()
+            - #output.k() == filters.num_filters()
+            - #output.nr() == 1
+            - #output.nc() == 1
+    !*/
+
+    void int8_conv (
+        resizable_tensor& output,
+        const tensor& data,
+        const int8_filters& filters,
+        long filter_nr,
+        long filter_nc,
+        int stride_y,
+        int stride_x,
+        int padding_y,
+        int padding_x
+    );
+    /*!
+        requires
+            - filters.empty() == false
+            - data.k()*filter_nr*filter_nc == filters.filter_size()
+            - stride_y > 0
+            - stride_x > 0
+            - 0 <= padding_y < filter_nr
+            - 0 <= padding_x < filter_nc
+        ensures
+            - Convolves data with the filters, exactly like tensor_conv does for filters
+              of size filters.num_filters() x data.k() x filter_nr x filter_nc.  Like
+              int8_fc(), the data is quantized to 8 bits and the products are accumulated
+              in 32 bit integers, so the results only approximate the float computation.
+            - #output.num_samples() == data.num_samples()
+            - #output.k() == filters.num_filters()
+            - #output.nr() == 1+(data.nr()+2*padding_y-filter_nr)/stride_y
+            - #output.nc() == 1+(data.nc()+2*padding_x-filter_nc)/stride_x
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
 }}
@@ -16,10 +16,15 @@
 #include "../threads.h"
 #include "cuda_dlib.h"
 #include "../statistics/running_gradient.h"
+#include "ring_all_reducer.h"
 #include <atomic>
 #include <cstdio>
 #include <set>
+#include <map>
 #include <future>
+#include <functional>
+#include <exception>
+#include <limits>
 
 namespace dlib
 {
@@ -50,6 +55,147 @@ namespace dlib
     }
 
 
+    template <
+        typename input_type,
+        typename label_type
+        >
+    class mini_batch_prefetcher : noncopyable
+    {
+    public:
+
+        typedef std::function<bool(unsigned long long, std::vector<input_type>&, std::vector<label_type>&)> source_type;
+
+        mini_batch_prefetcher(
+            const source_type& source_,
+            unsigned long num_threads = 4,
+            unsigned long max_queued_batches_ = 8
+        ) :
+            source(source_),
+            max_queued_batches(max_queued_batches_),
+            batch_ready(m),
+            space_available(m),
+            next_to_produce(0),
+            next_to_deliver(0),
+            end_index(std::numeric_limits<unsigned long long>::max()),
+            stopping(false)
+        {
+            DLIB_CASSERT(num_threads > 0 && max_queued_batches > 0, "");
+            for (unsigned long i = 0; i < num_threads; ++i)
+                workers.emplace_back(new thread_function([this](){ this->thread(); }));
+        }
+
+        ~mini_batch_prefetcher(
+        )
+        {
+            {
+                auto_mutex lock(m);
+                stopping = true;
+                space_available.broadcast();
+            }
+            // The thread_function destructors wait for the threads to terminate.
+            workers.clear();
+        }
+
+        bool get_next_batch (
+            std::vector<input_type>& data,
+            std::vector<label_type>& labels
+        )
+        {
+            auto_mutex lock(m);
+            while (true)
+            {
+                if (next_to_deliver >= end_index)
+                {
+                    if (error)
+                        std::rethrow_exception(error);
+                    return false;
+                }
+
+                auto i = ready.find(next_to_deliver);
+                if (i != ready.end())
+                {
+                    data.swap(i->second.first);
+                    labels.swap(i->second.second);
+                    ready.erase(i);
+                    ++next_to_deliver;
+                    space_available.broadcast();
+                    return true;
+                }
+                batch_ready.wait();
+            }
+        }
+
+    private:
+
+        void thread()
+        {
+            while (true)
+            {
+                unsigned long long idx;
+                {
+                    auto_mutex lock(m);
+                    // Don't get more than max_queued_batches ahead of the consumer.
+                    while (!stopping && next_to_produce < end_index &&
+                           next_to_produce >= next_to_deliver + max_queued_batches)
+                    {
+                        space_available.wait();
+                    }
+                    if (stopping || next_to_produce >= end_index)
+                        return;
+                    idx = next_to_produce++;
+                }
+
+                std::pair<std::vector<input_type>, std::vector<label_type>> batch;
+                bool have_batch = false;
+                std::exception_ptr eptr;
+                try
+                {
+                    have_batch = source(idx, batch.first, batch.second);
+                }
+                catch (...)
+                {
+                    eptr = std::current_exception();
+                }
+
+                auto_mutex lock(m);
+                if (idx < end_index)
+                {
+                    if (have_batch)
+                    {
+                        ready[idx].swap(batch);
+                    }
+                    else
+                    {
+                        // The stream ends at the first batch the source didn't produce,
+                        // so throw away anything that was made after it.
+                        end_index = idx;
+                        error = eptr;
+                        ready.erase(ready.lower_bound(idx), ready.end());
+                        space_available.broadcast();
+                    }
+                }
+                batch_ready.broadcast();
+            }
+        }
+
+        source_type source;
+        const unsigned long max_queued_batches;
+
+        mutex m;
+        signaler batch_ready;
+        signaler space_available;
+        unsigned long long next_to_produce;
+        unsigned long long next_to_deliver;
+        unsigned long long end_index;
+        bool stopping;
+        std::exception_ptr error;
+        std::map<unsigned long long,std::pair<std::vector<input_type>,std::vector<label_type>>> ready;
+
+        std::vector<std::unique_ptr<thread_function>> workers;
+    };
+
+// ----------------------------------------------------------------------------------------
+
     template <
         typename net_type, 
         typename solver_type = sgd
@@ -345,6 +491,25 @@ namespace dlib
             sync_to_disk(updated_the_network);
         }
 
+        void train (
+            mini_batch_prefetcher<input_type,label_type>& batches
+        )
+        {
+            std::vector<input_type> data;
+            std::vector<label_type> labels;
+            bool updated_the_network = false;
+            // The prefetcher's threads make the next batches while this one is being
+            // processed.
+            while (learning_rate >= min_learning_rate && batches.get_next_batch(data, labels))
+            {
+                train_one_step_on(data, labels, (const label_type*)0);
+                updated_the_network = true;
+            }
+            wait_for_thread_to_pause();
+            // if we modified the network at all then be sure to sync the final result.
+            sync_to_disk(updated_the_network);
+        }
+
         void set_synchronization_file (
             const std::string& filename,
             std::chrono::seconds time_between_syncs_ = std::chrono::minutes(15)
@@ -360,6 +525,52 @@ namespace dlib
                 deserialize(*this, fin);
         }
 
+        void set_distributed_nodes (
+            const std::vector<network_address>& nodes,
+            unsigned long rank,
+            unsigned long timeout = 60000
+        )
+        {
+            DLIB_CASSERT(rank < nodes.size(), "");
+            wait_for_thread_to_pause();
+            reducer.reset();
+            distributed_steps = 0;
+            if (nodes.size() > 1)
+                reducer.reset(new ring_all_reducer(nodes, rank, timeout));
+        }
+
+        void set_distributed_nodes (
+            const std::vector<network_address>& nodes,
+            unsigned long rank,
+            scoped_ptr<listener>& listen_socket,
+            unsigned long timeout = 60000
+        )
+        {
+            DLIB_CASSERT(rank < nodes.size() && listen_socket &&
+                listen_socket->get_listening_port() == nodes[rank].port, "");
+            wait_for_thread_to_pause();
+            reducer.reset();
+            distributed_steps = 0;
+            if (nodes.size() > 1)
+                reducer.reset(new ring_all_reducer(nodes, rank, listen_socket, timeout));
+            else
+                listen_socket.reset();
+        }
+
+        void set_distributed_bucket_size (
+            size_t num_floats
+        )
+        {
+            DLIB_CASSERT(num_floats > 0, "");
+            distributed_bucket_size = num_floats;
+        }
+
+        size_t get_distributed_bucket_size (
+        ) const
+        {
+            return distributed_bucket_size;
+        }
+
         double get_average_loss (
         ) const 
         { 
@@ -477,6 +688,19 @@ namespace dlib
 
     private:
 
+        template <typename T>
+        void train_one_step_on (
+            const std::vector<input_type>& data,
+            const std::vector<label_type>& labels,
+            const T*
+        ) { train_one_step(data, labels); }
+
+        void train_one_step_on (
+            const std::vector<input_type>& data,
+            const std::vector<label_type>& ,
+            const no_label_type*
+        ) { train_one_step(data); }
+
         void record_loss(double loss)
         {
             // Say that we will check if the gradient is bad 200 times during each
@@ -494,13 +718,18 @@ namespace dlib
         }
 
         template <typename T>
-        double compute_parameter_gradients(size_t device, job_t& next_job, const T&)
+        double compute_parameter_gradients(
+            size_t device,
+            job_t& next_job,
+            const T&,
+            const gradient_ready_callback& on_gradient_ready = gradient_ready_callback()
+        )
         {
             if (next_job.have_data[device])
             {
                 auto&& dev = *devices[device];
                 dlib::cuda::set_device(dev.device_id);
-                return dev.net.compute_parameter_gradients(next_job.t[device], next_job.labels[device].begin());
+                return dev.net.compute_parameter_gradients(next_job.t[device], next_job.labels[device].begin(), on_gradient_ready);
             }
             else
             {
@@ -508,14 +737,19 @@ namespace dlib
             }
         }
 
-        double compute_parameter_gradients(size_t device, job_t& next_job, const no_label_type&)
+        double compute_parameter_gradients(
+            size_t device,
+            job_t& next_job,
+            const no_label_type&,
+            const gradient_ready_callback& on_gradient_ready = gradient_ready_callback()
+        )
         {
             if (next_job.have_data[device])
             {
                 auto&& dev = *devices[device];
                 dlib::cuda::set_device(dev.device_id);
                 no_label_type pick_which_run_update;
-                return dev.net.compute_parameter_gradients(next_job.t[device]);
+                return dev.net.compute_parameter_gradients(next_job.t[device], on_gradient_ready);
             }
             else
             {
@@ -523,6 +757,92 @@ namespace dlib
             }
         }
 
+        template <typename T>
+        double compute_and_sum_parameter_gradients(
+            job_t& next_job,
+            const T& pick_which_run_update,
+            thread_pool& bucket_pool,
+            std::vector<std::vector<float>>& buckets,
+            std::vector<std::vector<tensor*>>& bucket_tensors,
+            std::string& bucket_error
+        )
+        {
+            // This is what we do instead of compute_parameter_gradients() when there is
+            // one device and other processes are training with us.  As soon as
+            // back_propagate_error() finishes a layer its gradient is copied into the
+            // current bucket, and full buckets are summed with the other processes on
+            // bucket_pool while the layers below are still being computed.  The bucket
+            // boundaries only depend on the layer sizes so every process fills the same
+            // buckets in the same order.  If summing fails bucket_error is set to the
+            // reason, since we can't throw from inside the device's thread_pool.
+            bucket_error.clear();
+            size_t cur = 0;
+            auto start_bucket = [&]()
+            {
+                if (cur == buckets.size())
+                {
+                    buckets.emplace_back();
+                    bucket_tensors.emplace_back();
+                }
+                buckets[cur].clear();
+                bucket_tensors[cur].clear();
+            };
+            auto sum_bucket = [&]()
+            {
+                // The outer vectors may grow while this task runs but the float buffers
+                // of the inner ones don't move when that happens.
+                float* data = buckets[cur].data();
+                const size_t size = buckets[cur].size();
+                bucket_pool.add_task_by_value([this,data,size,&bucket_error]()
+                {
+                    // Once the ring is broken there is no point in trying the other
+                    // buckets, each one would just wait for the timeout.
+                    if (bucket_error.size() != 0)
+                        return;
+                    try { reducer->sum(data, size); }
+                    catch (std::exception& e) { bucket_error = e.what(); }
+                });
+                ++cur;
+            };
+
+            start_bucket();
+            gradient_ready_callback on_gradient_ready = [&](tensor& t)
+            {
+                if (t.size() == 0)
+                    return;
+                bucket_tensors[cur].push_back(&t);
+                buckets[cur].insert(buckets[cur].end(), t.host(), t.host()+t.size());
+                if (buckets[cur].size() >= distributed_bucket_size)
+                {
+                    sum_bucket();
+                    start_bucket();
+                }
+            };
+            double loss = compute_parameter_gradients(0, next_job, pick_which_run_update, on_gradient_ready);
+
+            // The loss goes into the last bucket so that every process makes the same
+            // learning rate decisions.
+            buckets[cur].push_back(loss);
+            sum_bucket();
+            bucket_pool.wait_for_all_tasks();
+            if (bucket_error.size() != 0)
+                return 0;
+
+            const float num_nodes = reducer->num_nodes();
+            for (size_t i = 0; i < cur; ++i)
+            {
+                const float* src = buckets[i].data();
+                for (auto t : bucket_tensors[i])
+                {
+                    float* dest = t->host_write_only();
+                    for (size_t j = 0; j < t->size(); ++j)
+                        dest[j] = src[j]/num_nodes;
+                    src += t->size();
+                }
+            }
+            return buckets[cur-1].back()/num_nodes;
+        }
+
         void update_parameters(size_t device)
         {
             auto&& dev = *devices[device];
@@ -554,6 +874,13 @@ namespace dlib
             for (size_t i = 0; i < devices.size(); ++i)
                 tp.push_back(std::make_shared<thread_pool>(1));
 
+            // Sums gradient buckets with the other processes while the backward pass is
+            // still running.  See compute_and_sum_parameter_gradients().
+            thread_pool bucket_pool(1);
+            std::vector<std::vector<float>> buckets;
+            std::vector<std::vector<tensor*>> bucket_tensors;
+            std::string bucket_error;
+
 
             size_t iteration = 0;
             while(job_pipe.dequeue(next_job))
@@ -562,13 +889,19 @@ namespace dlib
                 // Call compute_parameter_gradients() and update_parameters() but pick the
                 // right version for unsupervised or supervised training based on the type
                 // of label_type.
-                for (size_t i = 0; i < devices.size(); ++i)
-                    tp[i]->add_task_by_value([&,i](double& loss){ loss = compute_parameter_gradients(i, next_job, pick_which_run_update); }, losses[i]);
+                const bool overlap_reduce = reducer && devices.size() == 1;
+                if (overlap_reduce)
+                    tp[0]->add_task_by_value([&](double& loss){ loss = compute_and_sum_parameter_gradients(next_job, pick_which_run_update, bucket_pool, buckets, bucket_tensors, bucket_error); }, losses[0]);
+                else
+                    for (size_t i = 0; i < devices.size(); ++i)
+                        tp[i]->add_task_by_value([&,i](double& loss){ loss = compute_parameter_gradients(i, next_job, pick_which_run_update); }, losses[i]);
                 // aggregate loss values from all the network computations.
                 double theloss = 0;
                 for (auto&& loss : losses)
                     theloss += loss.get();
-                record_loss(theloss/losses.size());
+                theloss /= losses.size();
+                if (overlap_reduce && bucket_error.size() != 0)
+                    throw socket_error(bucket_error);
 
                 // Now, if there is more than one active device we need to synchronize the
                 // gradient updates between devices.  So we do that now.
@@ -611,6 +944,43 @@ namespace dlib
                         avg.average();
                 }
 
+                // If other processes are training with us then average the gradients
+                // with theirs.  The loss gets averaged too so that every process makes the
+                // same learning rate decisions.  With one device this already happened
+                // inside compute_and_sum_parameter_gradients(), overlapped with the
+                // backward pass.  With several we have to wait for the devices to be
+                // averaged first.
+                if (reducer && !overlap_reduce)
+                {
+                    pack_tensors(sync_buffer, [&](tensor_visitor f){ visit_layer_parameter_gradients(devices[0]->net, f); });
+                    sync_buffer.push_back(theloss);
+                    reducer->sum(sync_buffer.data(), sync_buffer.size());
+                    for (auto& v : sync_buffer)
+                        v /= reducer->num_nodes();
+                    theloss = sync_buffer.back();
+                    for (auto&& d : devices)
+                        unpack_tensors(sync_buffer, [&](tensor_visitor f){ visit_layer_parameter_gradients(d->net, f); });
+                }
+                record_loss(theloss);
+
+                // The processes may have initialized their networks differently, and
+                // even if they didn't there is no guarantee they compute exactly the same
+                // things on different hardware.  So every now and then, and in particular
+                // on the first step, copy the parameters of the first process to all the
+                // others.  This happens before the updates so the solvers, which can
+                // depend on the parameters, also end up in the same state.  We count steps
+                // from when the processes were connected since that's the only count they
+                // all agree on.
+                if (reducer && distributed_steps++%2000 == 0)
+                {
+                    pack_tensors(sync_buffer, [&](tensor_visitor f){ visit_layer_parameters(devices[0]->net, f); });
+                    if (reducer->get_rank() != 0)
+                        std::fill(sync_buffer.begin(), sync_buffer.end(), 0);
+                    reducer->sum(sync_buffer.data(), sync_buffer.size());
+                    for (auto&& d : devices)
+                        unpack_tensors(sync_buffer, [&](tensor_visitor f){ visit_layer_parameters(d->net, f); });
+                }
+
 
                 // Now apply all the updates to each device.
                 for (size_t i = 0; i < devices.size(); ++i)
@@ -669,6 +1039,31 @@ namespace dlib
             abort();
         }
 
+        typedef std::function<void(size_t, tensor&)> tensor_visitor;
+
+        template <typename visit_tensors>
+        static void pack_tensors (
+            std::vector<float>& buf,
+            visit_tensors visit
+        )
+        {
+            buf.clear();
+            visit([&](size_t, tensor& t){ buf.insert(buf.end(), t.host(), t.host()+t.size()); });
+        }
+
+        template <typename visit_tensors>
+        static void unpack_tensors (
+            const std::vector<float>& buf,
+            visit_tensors visit
+        )
+        {
+            size_t pos = 0;
+            visit([&](size_t, tensor& t){ 
+                std::copy(buf.begin()+pos, buf.begin()+pos+t.size(), t.host_write_only());
+                pos += t.size();
+            });
+        }
+
         void wait_for_thread_to_pause() const
         {
             job_pipe.wait_for_num_blocked_dequeues(1);
@@ -693,6 +1088,8 @@ namespace dlib
             train_one_step_calls = 0;
             gradient_check_budget = 0;
             lr_schedule_pos = 0;
+            distributed_steps = 0;
+            distributed_bucket_size = 1<<20;
             start();
         }
 
@@ -911,6 +1308,11 @@ namespace dlib
         dlib::pipe<job_t> job_pipe;
         job_t job;
 
+        std::unique_ptr<ring_all_reducer> reducer;
+        unsigned long long distributed_steps;
+        std::vector<float> sync_buffer;
+        std::atomic<size_t> distributed_bucket_size;
+
 
         running_stats<double> rs;
         std::deque<double> previous_loss_values;
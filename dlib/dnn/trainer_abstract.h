@@ -12,6 +12,82 @@
 namespace dlib
 {
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename input_type,
+        typename label_type
+        >
+    class mini_batch_prefetcher : noncopyable
+    {
+        /*!
+            WHAT THIS OBJECT REPRESENTS
+                This object makes mini-batches of training data in background threads so
+                they are ready by the time a dnn_trainer wants them.  You give it a
+                function that makes the i-th mini-batch, for example by loading and
+                augmenting some images from disk, and it calls that function from a pool
+                of threads, keeping a bounded number of finished batches queued up.  So
+                the training data doesn't need to fit in RAM and the cost of preparing it
+                overlaps with training.
+
+                The batches always come out in order of their index, regardless of which
+                thread made them, so training runs are repeatable.
+        !*/
+
+    public:
+
+        typedef std::function<bool(unsigned long long, std::vector<input_type>&, std::vector<label_type>&)> source_type;
+
+        mini_batch_prefetcher(
+            const source_type& source,
+            unsigned long num_threads = 4,
+            unsigned long max_queued_batches = 8
+        );
+        /*!
+            requires
+                - num_threads > 0
+                - max_queued_batches > 0
+                - source(i, data, labels) must be safe to call from several threads at
+                  once, with different values of i.
+            ensures
+                - Starts num_threads threads which call source(i, data, labels) for
+                  i == 0, 1, 2, ... to make the mini-batches.  Each call is given empty
+                  data and labels vectors, which it should fill with the i-th mini-batch
+                  and then return true.  If there is no i-th mini-batch then it should
+                  return false, which marks the end of the stream.  Since source is told
+                  the index of the batch it should make it can, e.g., seed a random number
+                  generator with it to get repeatable data augmentation.
+                - At most max_queued_batches batches beyond the one most recently returned
+                  by get_next_batch() are made ahead of time.
+                - When training a network with an unsupervised loss label_type is
+                  no_label_type and source should leave labels empty.
+        !*/
+
+        ~mini_batch_prefetcher(
+        );
+        /*!
+            ensures
+                - Stops the background threads, waiting for any in-progress calls to
+                  source to finish, and frees all resources.
+        !*/
+
+        bool get_next_batch (
+            std::vector<input_type>& data,
+            std::vector<label_type>& labels
+        );
+        /*!
+            ensures
+                - Blocks until the next mini-batch is ready.  If there is one then it is
+                  swapped into #data and #labels and this function returns true.  The
+                  first call gives batch 0, the next batch 1, and so on.
+                - If the source reported the end of the stream at the next index then
+                  returns false.
+            throws
+                - If the call to source that made the next batch threw an exception then
+                  that exception is rethrown by get_next_batch().  The stream ends there.
+        !*/
+    };
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -334,6 +410,94 @@ namespace dlib
                   interrupted.
         !*/
 
+        void set_distributed_nodes (
+            const std::vector<network_address>& nodes,
+            unsigned long rank,
+            unsigned long timeout = 60000
+        );
+        /*!
+            requires
+                - rank < nodes.size()
+                - Every process in the group calls set_distributed_nodes() with the same
+                  nodes vector and a different rank.  See ring_all_reducer's constructor
+                  for the full requirements.
+            ensures
+                - Makes this trainer do data parallel training together with the trainers
+                  in the other processes listed in nodes.  This process is nodes[rank].
+                  Each training step, the gradients and loss computed by each process are
+                  averaged over all the processes (using a ring_all_reducer) before the
+                  solvers are applied.  So if each process is given different mini-batches
+                  the effect is the same as training on one mini-batch made of all of them.
+                - If this trainer uses only one device then the averaging overlaps the
+                  backward pass.  As each layer's parameter gradient becomes ready it is
+                  added to a bucket and whole buckets, see get_distributed_bucket_size(),
+                  are sent around the ring while the layers below are still computing
+                  their gradients.  All the buckets are finished before the solvers are
+                  applied.  With several devices the gradients are first averaged over the
+                  devices and then over the processes in one go.
+                - Since the averaged loss is the same everywhere all the processes make the
+                  same learning rate decisions.  The parameters of the network in the
+                  process with rank 0 are also copied to all the others on the first
+                  training step and periodically thereafter.  So it doesn't matter if the
+                  networks were initialized differently.
+                - All the processes must execute the same number of training steps,
+                  otherwise they will block waiting for each other.  Note that train()
+                  executes a number of steps that depends on the size of the training data.
+                - if (nodes.size() == 1) then distributed training is disabled.
+            throws
+                - socket_error
+                    This exception is thrown if the connections to the other processes
+                    can't be made.
+        !*/
+
+        void set_distributed_nodes (
+            const std::vector<network_address>& nodes,
+            unsigned long rank,
+            scoped_ptr<listener>& listen_socket,
+            unsigned long timeout = 60000
+        );
+        /*!
+            requires
+                - rank < nodes.size()
+                - listen_socket is listening on port nodes[rank].port.
+                - Every process in the group calls set_distributed_nodes() with the same
+                  nodes vector and a different rank.  See ring_all_reducer's constructor
+                  for the full requirements.
+            ensures
+                - This function is just like the set_distributed_nodes() above except that
+                  the ring_all_reducer takes ownership of listen_socket rather than opening
+                  its own listening socket on nodes[rank].port.
+                - #listen_socket.get() == 0
+            throws
+                - socket_error
+                    This exception is thrown if the connections to the other processes
+                    can't be made.
+        !*/
+
+        void set_distributed_bucket_size (
+            size_t num_floats
+        );
+        /*!
+            requires
+                - num_floats > 0
+            ensures
+                - #get_distributed_bucket_size() == num_floats
+        !*/
+
+        size_t get_distributed_bucket_size (
+        ) const;
+        /*!
+            ensures
+                - During distributed training on one device, see set_distributed_nodes(),
+                  parameter gradients are grouped into buckets of about this many floats
+                  and each bucket is averaged over the processes as soon as the backward
+                  pass has filled it.  Smaller buckets start communicating earlier but
+                  send more messages.  A bucket is only closed at a layer boundary so it
+                  may hold more than get_distributed_bucket_size() floats.
+                - All the processes training together must use the same bucket size.
+                - The default is 1048576.
+        !*/
+
         void train (
             const std::vector<input_type>& data,
             const std::vector<label_type>& labels 
@@ -388,6 +552,27 @@ namespace dlib
                   calling get_average_loss().
         !*/
 
+        void train (
+            mini_batch_prefetcher<input_type,label_type>& batches
+        );
+        /*!
+            ensures
+                - Trains the network on the stream of mini-batches produced by batches.
+                  That is, this function calls train_one_step() on each batch returned by
+                  batches.get_next_batch() until either it returns false or 
+                  get_learning_rate() < get_min_learning_rate().  If net_type uses an
+                  unsupervised loss then the labels from batches are ignored.
+                - The size of each mini-batch is determined by batches rather than
+                  get_mini_batch_size(), and since batches defines the whole stream of
+                  training data get_max_num_epochs() doesn't apply.
+                - Like the other train() routines, this function does not reinitialize
+                  the state of get_net() or get_solvers() and it syncs the final state to
+                  disk if set_synchronization_file() has been used.
+                - Since the next batches are made in background threads while the current
+                  one is being used for training, the training data doesn't all need to
+                  be in memory at once.
+        !*/
+
         void train_one_step (
             const std::vector<input_type>& data,
             const std::vector<label_type>& labels 
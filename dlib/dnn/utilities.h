@@ -5,6 +5,7 @@
 
 #include "core.h"
 #include "utilities_abstract.h"
+#include <vector>
 
 namespace dlib
 {
@@ -107,6 +108,116 @@ namespace dlib
         out << "</net>\n";
     }
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        // Returns the tensor that was given to the layer l as input.  This is the output
+        // of l's subnet, unless l sits on top of the input layer, in which case it's x.
+        template <typename T>
+        auto quantization_layer_input(const T& l, const tensor&, int) -> decltype(l.subnet().get_output())
+        { return l.subnet().get_output(); }
+
+        template <typename T>
+        const tensor& quantization_layer_input(const T&, const tensor& x, long) { return x; }
+
+        template <typename T>
+        auto quantize_layer_details(T& details, float input_range, int) -> decltype(details.quantize(input_range))
+        { return details.quantize(input_range); }
+
+        template <typename T>
+        void quantize_layer_details(T&, float, long) {}
+
+        class visitor_quantization_ranges
+        {
+        public:
+
+            visitor_quantization_ranges(
+                std::vector<float>& ranges_,
+                const tensor& x_
+            ) : ranges(ranges_), x(x_) {}
+
+            template <typename T>
+            void operator()(size_t , T& ) {}
+
+            template <typename T, typename U, typename E>
+            void operator()(size_t idx, add_layer<T,U,E>& l) 
+            {
+                update_range(idx, l, l.layer_details(), 0);
+            }
+
+        private:
+
+            // Only look at the inputs to layers that can be quantized.  The inputs to
+            // other layers might not even be accessible since in-place layers take over
+            // the output tensors of the layers below them.
+            template <typename L, typename T>
+            auto update_range(size_t idx, L& l, T& details, int) -> decltype(details.quantize(0.0f), void())
+            {
+                const tensor& input = quantization_layer_input(l, x, 0);
+                if (input.size() != 0)
+                    ranges[idx] = std::max(ranges[idx], max(abs(mat(input))));
+            }
+
+            template <typename L, typename T>
+            void update_range(size_t, L&, T&, long) {}
+
+            std::vector<float>& ranges;
+            const tensor& x;
+        };
+
+        class visitor_quantize
+        {
+        public:
+
+            visitor_quantize(
+                const std::vector<float>& ranges_
+            ) : ranges(ranges_) {}
+
+            template <typename T>
+            void operator()(size_t , T& ) {}
+
+            template <typename T, typename U, typename E>
+            void operator()(size_t idx, add_layer<T,U,E>& l) 
+            {
+                quantize_layer_details(l.layer_details(), ranges[idx], 0);
+            }
+
+        private:
+            const std::vector<float>& ranges;
+        };
+
+        template <typename T, typename U>
+        void quantization_forward(add_loss_layer<T,U>& net, const tensor& x) { net.subnet().forward(x); }
+        template <typename net_type>
+        void quantization_forward(net_type& net, const tensor& x) { net.forward(x); }
+    }
+
+    template <typename net_type>
+    void quantize_network (
+        net_type& net,
+        const std::vector<typename net_type::input_type>& calibration_samples,
+        size_t mini_batch_size = 64
+    )
+    {
+        DLIB_CASSERT(calibration_samples.size() > 0 && mini_batch_size > 0,"");
+
+        // Run the calibration data through the float network and record the largest
+        // magnitude value that goes into each layer.
+        std::vector<float> ranges(net_type::num_layers, 0);
+        resizable_tensor x;
+        for (size_t i = 0; i < calibration_samples.size(); i += mini_batch_size)
+        {
+            auto ibegin = calibration_samples.begin()+i;
+            auto iend = calibration_samples.begin()+std::min(i+mini_batch_size, calibration_samples.size());
+            net.to_tensor(ibegin, iend, x);
+            impl::quantization_forward(net, x);
+            visit_layers(net, impl::visitor_quantization_ranges(ranges, x));
+        }
+
+        visit_layers(net, impl::visitor_quantize(ranges));
+    }
+
 // ----------------------------------------------------------------------------------------
 
 }
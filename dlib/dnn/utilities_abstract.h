@@ -55,6 +55,35 @@ namespace dlib
               stream.
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    template <typename net_type>
+    void quantize_network (
+        net_type& net,
+        const std::vector<typename net_type::input_type>& calibration_samples,
+        size_t mini_batch_size = 64
+    );
+    /*!
+        requires
+            - net_type is an object of type add_layer, add_loss_layer, add_skip_layer, or
+              add_tag_layer.
+            - calibration_samples.size() > 0
+            - mini_batch_size > 0
+            - None of the layers in net have been quantized already.
+        ensures
+            - Converts net into an 8 bit integer inference network.  To do this, the
+              calibration_samples are run through net, mini_batch_size samples at a time,
+              and the largest magnitude input seen by each layer is recorded.  Then
+              quantize() is called on each layer that has a quantize() method (e.g. fc_
+              and con_) with that value as its input_range.  The other layers are left
+              unchanged and continue to run in floating point.
+            - calibration_samples should be a representative sample of the data the
+              network will be run on, since inputs larger than anything seen during
+              calibration are clipped.
+            - The quantized network can be serialized and deserialized like any other
+              network, but it can no longer be trained.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
 }
@@ -25,6 +25,42 @@ namespace dlib
     public: image_load_error(const std::string& str) : error(EIMAGE_LOAD,str){}
     };
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        class image_row_sink
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This is the interface the jpeg and png decoders use to hand decoded
+                    rows to a templated get_image() without having to hold the whole
+                    decoded image in memory.  Rows are always delivered in order, each
+                    exactly once.
+            !*/
+        public:
+            virtual ~image_row_sink() {}
+
+            virtual unsigned char* get_row_buffer (
+                unsigned long row
+            ) = 0;
+            /*!
+                ensures
+                    - returns the memory the decoder should write the given row into.
+                      This is either the row of the output image itself, when the
+                      decoded pixels already have the right layout, or a scratch buffer.
+            !*/
+
+            virtual void row_done (
+                unsigned long row
+            ) = 0;
+            /*!
+                ensures
+                    - called once the row has been written into get_row_buffer(row).
+            !*/
+        };
+    }
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -25,25 +25,59 @@ namespace dlib
 // ----------------------------------------------------------------------------------------
 
     jpeg_loader::
-    jpeg_loader( const char* filename ) : height_( 0 ), width_( 0 ), output_components_(0)
+    jpeg_loader( const char* filename ) : 
+        buffer_(0), buffer_size_(0), scale_(1), height_( 0 ), width_( 0 ), output_components_(0)
     {
-        read_image( filename );
+        if ( filename == NULL )
+        {
+            abort();
+        }
+        filename_ = filename;
+        read_header();
     }
 
 // ----------------------------------------------------------------------------------------
 
     jpeg_loader::
-    jpeg_loader( const std::string& filename ) : height_( 0 ), width_( 0 ), output_components_(0)
+    jpeg_loader( const std::string& filename ) : 
+        filename_(filename), buffer_(0), buffer_size_(0), scale_(1), height_( 0 ), width_( 0 ), output_components_(0)
     {
-        read_image( filename.c_str() );
+        read_header();
     }
 
 // ----------------------------------------------------------------------------------------
 
     jpeg_loader::
-    jpeg_loader( const dlib::file& f ) : height_( 0 ), width_( 0 ), output_components_(0)
+    jpeg_loader( const dlib::file& f ) : 
+        filename_(f.full_name()), buffer_(0), buffer_size_(0), scale_(1), height_( 0 ), width_( 0 ), output_components_(0)
+    {
+        read_header();
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    jpeg_loader::
+    jpeg_loader( const unsigned char* imgbuffer, size_t buffer_size ) : 
+        buffer_(imgbuffer), buffer_size_(buffer_size), scale_(1), height_( 0 ), width_( 0 ), output_components_(0)
+    {
+        if ( imgbuffer == NULL )
+        {
+            abort();
+        }
+        read_header();
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void jpeg_loader::set_downscale( unsigned long factor )
     {
-        read_image( f.full_name().c_str() );
+        DLIB_CASSERT(factor == 1 || factor == 2 || factor == 4 || factor == 8,
+            "\t void jpeg_loader::set_downscale()"
+            << "\n\t Invalid inputs were given to this function."
+            << "\n\t factor: " << factor 
+            );
+        scale_ = factor;
+        read_header();
     }
 
 // ----------------------------------------------------------------------------------------
@@ -77,81 +111,171 @@ namespace dlib
         longjmp(myerr->setjmp_buffer, 1);
     }
 
+    // Warnings, like the ones about truncated files, shouldn't get printed to stderr.
+    void jpeg_loader_output_message_silent (j_common_ptr)
+    {
+    }
+
 // ----------------------------------------------------------------------------------------
 
-    void jpeg_loader::read_image( const char* filename )
+    // A libjpeg source manager that reads from a buffer which already holds the whole
+    // JPEG file.
+    void jpeg_loader_init_source (j_decompress_ptr)
     {
-        if ( filename == NULL )
+    }
+
+    boolean jpeg_loader_fill_input_buffer (j_decompress_ptr cinfo)
+    {
+        // We only get here if the buffer ended before the JPEG data did.  Do what the
+        // libjpeg stdio source does in that case and insert a fake EOI marker.
+        static const JOCTET fake_eoi[2] = { 0xFF, JPEG_EOI };
+        cinfo->src->next_input_byte = fake_eoi;
+        cinfo->src->bytes_in_buffer = 2;
+        return TRUE;
+    }
+
+    void jpeg_loader_skip_input_data (j_decompress_ptr cinfo, long num_bytes)
+    {
+        if (num_bytes <= 0)
+            return;
+
+        if ((size_t)num_bytes > cinfo->src->bytes_in_buffer)
         {
-            abort();
+            jpeg_loader_fill_input_buffer(cinfo);
         }
-        FILE *fp = fopen( filename, "rb" );
+        else
+        {
+            cinfo->src->next_input_byte += num_bytes;
+            cinfo->src->bytes_in_buffer -= num_bytes;
+        }
+    }
+
+    void jpeg_loader_term_source (j_decompress_ptr)
+    {
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    FILE* jpeg_loader::open_file() const
+    {
+        if ( buffer_ != 0 )
+            return 0;
+
+        FILE* fp = fopen( filename_.c_str(), "rb" );
         if ( !fp )
         {
             abort();
         }
+        return fp;
+    }
 
+// ----------------------------------------------------------------------------------------
+
+    void jpeg_loader::read_header()
+    {
+        // The file is opened and closed out here rather than in decode() because decode()
+        // calls setjmp().  Any local variable of decode() that changed after setjmp()
+        // would have an indeterminate value once libjpeg longjmp()s back to it.
+        FILE* fp = open_file();
+        decode(fp, 0, height_, width_, output_components_);
+        if (fp)
+            fclose( fp );
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void jpeg_loader::read_rows( impl::image_row_sink& sink ) const
+    {
+        unsigned long height, width, components;
+        FILE* fp = open_file();
+        decode(fp, &sink, height, width, components);
+        if (fp)
+            fclose( fp );
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void jpeg_loader::decode( 
+        FILE* fp,
+        impl::image_row_sink* sink,
+        unsigned long& height,
+        unsigned long& width,
+        unsigned long& components
+    ) const
+    {
         jpeg_decompress_struct cinfo;
         jpeg_loader_error_mgr jerr;
+        jpeg_source_mgr src;
 
         cinfo.err = jpeg_std_error(&jerr.pub);
 
         jerr.pub.error_exit = jpeg_loader_error_exit;
+        jerr.pub.output_message = jpeg_loader_output_message_silent;
 
         /* Establish the setjmp return context for my_error_exit to use. */
         if (setjmp(jerr.setjmp_buffer)) 
         {
             /* If we get here, the JPEG code has signaled an error.
-             * We need to clean up the JPEG object, close the input file, and return.
+             * We need to clean up the JPEG object and return.
              */
             jpeg_destroy_decompress(&cinfo);
-            fclose(fp);
             abort();
         }
 
 
         jpeg_create_decompress(&cinfo);
 
-        jpeg_stdio_src(&cinfo, fp);
+        if (fp)
+        {
+            jpeg_stdio_src(&cinfo, fp);
+        }
+        else
+        {
+            src.init_source = jpeg_loader_init_source;
+            src.fill_input_buffer = jpeg_loader_fill_input_buffer;
+            src.skip_input_data = jpeg_loader_skip_input_data;
+            src.resync_to_restart = jpeg_resync_to_restart;
+            src.term_source = jpeg_loader_term_source;
+            src.next_input_byte = buffer_;
+            src.bytes_in_buffer = buffer_size_;
+            cinfo.src = &src;
+        }
 
         jpeg_read_header(&cinfo, TRUE);
 
-        jpeg_start_decompress(&cinfo);
+        // libjpeg can shrink the image while doing the inverse DCT, which is a lot
+        // cheaper than decoding it at full size and downsampling it afterwards.
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = scale_;
+        jpeg_calc_output_dimensions(&cinfo);
 
-        height_ = cinfo.output_height;
-        width_ = cinfo.output_width;
-        output_components_ = cinfo.output_components;
+        height = cinfo.output_height;
+        width = cinfo.output_width;
+        components = cinfo.output_components;
 
-        if (output_components_ != 1 && 
-            output_components_ != 3)
+        if (components != 1 && 
+            components != 3)
         {
-            fclose( fp );
             jpeg_destroy_decompress(&cinfo);
-            std::ostringstream sout;
-            sout << "jpeg_loader: Unsupported number of colors (" << output_components_ << ") in file " << filename;
             abort();
         }
 
-        std::vector<unsigned char*> rows;
-        rows.resize(height_);
-
-        // size the image buffer
-        data.resize(height_*width_*output_components_);
-
-        // setup pointers to each row
-        for (unsigned long i = 0; i < rows.size(); ++i)
-            rows[i] = &data[i*width_*output_components_];
-
-        // read the data into the buffer
-        while (cinfo.output_scanline < cinfo.output_height)
+        if (sink)
         {
-            jpeg_read_scanlines(&cinfo, &rows[cinfo.output_scanline], 100);
+            jpeg_start_decompress(&cinfo);
+
+            // decode the image one row at a time straight into the sink
+            while (cinfo.output_scanline < cinfo.output_height)
+            {
+                const unsigned long r = cinfo.output_scanline;
+                JSAMPROW row = sink->get_row_buffer(r);
+                if (jpeg_read_scanlines(&cinfo, &row, 1) == 1)
+                    sink->row_done(r);
+            }
+
+            jpeg_finish_decompress(&cinfo);
         }
-
-        jpeg_finish_decompress(&cinfo);
         jpeg_destroy_decompress(&cinfo);
-
-        fclose( fp );
     }
 
 // ----------------------------------------------------------------------------------------
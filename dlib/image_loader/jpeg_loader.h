@@ -9,6 +9,8 @@
 #include "../pixel.h"
 #include "../dir_nav.h"
 #include <vector>
+#include <string>
+#include <cstdio>
 
 namespace dlib
 {
@@ -20,10 +22,17 @@ namespace dlib
         jpeg_loader( const char* filename );
         jpeg_loader( const std::string& filename );
         jpeg_loader( const dlib::file& f );
+        jpeg_loader( const unsigned char* imgbuffer, size_t buffer_size );
 
         bool is_gray() const;
         bool is_rgb() const;
 
+        unsigned long nr() const { return height_; }
+        unsigned long nc() const { return width_; }
+
+        void set_downscale( unsigned long factor );
+        unsigned long get_downscale() const { return scale_; }
+
         template<typename T>
         void get_image( T& t_) const
         {
@@ -36,20 +45,62 @@ namespace dlib
             !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!*/
             COMPILE_TIME_ASSERT(sizeof(T) == 0);
 #endif
+            typedef typename image_traits<T>::pixel_type pixel_type;
             image_view<T> t(t_);
 
             t.set_size( height_, width_ );
-            for ( unsigned n = 0; n < height_;n++ )
+
+            // If the image uses the same pixel layout as libjpeg's output then the
+            // decoder can write straight into it.  Otherwise each row goes through a
+            // small buffer and gets converted.
+            const bool direct = (is_gray() && is_same_type<pixel_type,unsigned char>::value) ||
+                                (is_rgb() && is_same_type<pixel_type,rgb_pixel>::value);
+            row_sink<T> sink(t, output_components_, direct);
+            read_rows(sink);
+        }
+
+    private:
+
+        template <typename T>
+        class row_sink : public impl::image_row_sink
+        {
+        public:
+            row_sink(
+                image_view<T>& t_,
+                unsigned long components,
+                bool direct_
+            ) : t(t_), direct(direct_), gray(components == 1)
             {
-                const unsigned char* v = get_row( n );
-                for ( unsigned m = 0; m < width_;m++ )
+                if (!direct)
+                    row.resize(t.nc()*components);
+            }
+
+            virtual unsigned char* get_row_buffer (
+                unsigned long n
+            ) 
+            { 
+                if (direct)
+                    return reinterpret_cast<unsigned char*>(&t[n][0]);
+                else
+                    return &row[0];
+            }
+
+            virtual void row_done (
+                unsigned long n
+            )
+            {
+                if (direct)
+                    return;
+
+                const unsigned char* v = &row[0];
+                for ( long m = 0; m < t.nc();m++ )
                 {
-                    if ( is_gray() )
+                    if ( gray )
                     {
                         unsigned char p = v[m];
                         assign_pixel( t[n][m], p );
                     }
-                    else // if ( is_rgb() )
+                    else 
                     {
                         rgb_pixel p;
                         p.red = v[m*3];
@@ -59,19 +110,32 @@ namespace dlib
                     }
                 }
             }
-        }
 
-    private:
-        const unsigned char* get_row( unsigned long i ) const
-        {
-            return &data[i*width_*output_components_];
-        }
-
-        void read_image( const char* filename );
+        private:
+            image_view<T>& t;
+            const bool direct;
+            const bool gray;
+            std::vector<unsigned char> row;
+        };
+
+        void read_header();
+        void read_rows( impl::image_row_sink& sink ) const;
+        FILE* open_file() const;
+        void decode( 
+            FILE* fp,
+            impl::image_row_sink* sink,
+            unsigned long& height,
+            unsigned long& width,
+            unsigned long& components
+        ) const;
+
+        std::string filename_;
+        const unsigned char* buffer_;
+        size_t buffer_size_;
+        unsigned long scale_;
         unsigned long height_; 
         unsigned long width_;
         unsigned long output_components_;
-        std::vector<unsigned char> data;
     };
 
 // ----------------------------------------------------------------------------------------
@@ -87,6 +151,18 @@ namespace dlib
         jpeg_loader(file_name).get_image(image);
     }
 
+    template <
+        typename image_type
+        >
+    void load_jpeg (
+        image_type& image,
+        const unsigned char* imgbuffer,
+        size_t buffer_size
+    )
+    {
+        jpeg_loader(imgbuffer, buffer_size).get_image(image);
+    }
+
 // ----------------------------------------------------------------------------------------
 
 }
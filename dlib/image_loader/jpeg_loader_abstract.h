@@ -21,7 +21,12 @@ namespace dlib
             WHAT THIS OBJECT REPRESENTS
                 This object represents a class capable of loading JPEG image files.
                 Once an instance of it is created to contain a JPEG file from
-                disk you can obtain the image stored in it via get_image().
+                disk, or from a buffer in memory, you can obtain the image stored in
+                it via get_image().  
+
+                The constructors only read the JPEG header.  The pixels are decoded by
+                get_image(), one row at a time, straight into the image you give it.
+                So at no point is there a second full size copy of the image in memory.
         !*/
 
     public:
@@ -30,6 +35,9 @@ namespace dlib
             const char* filename 
         );
         /*!
+            requires
+                - The file must not be deleted or modified for as long as this object
+                  exists since get_image() reopens it and decodes the pixels from it.
             ensures
                 - loads the JPEG file with the given file name into this object
             throws
@@ -43,6 +51,9 @@ namespace dlib
             const std::string& filename 
         );
         /*!
+            requires
+                - The file must not be deleted or modified for as long as this object
+                  exists since get_image() reopens it and decodes the pixels from it.
             ensures
                 - loads the JPEG file with the given file name into this object
             throws
@@ -56,6 +67,9 @@ namespace dlib
             const dlib::file& f 
         );
         /*!
+            requires
+                - The file must not be deleted or modified for as long as this object
+                  exists since get_image() reopens it and decodes the pixels from it.
             ensures
                 - loads the JPEG file with the given file name into this object
             throws
@@ -65,6 +79,24 @@ namespace dlib
                   us from loading the given JPEG file.
         !*/
 
+        jpeg_loader( 
+            const unsigned char* imgbuffer,
+            size_t buffer_size
+        );
+        /*!
+            requires
+                - imgbuffer points to buffer_size bytes containing a JPEG file.
+                - The buffer must remain valid, and unmodified, for as long as this
+                  object exists since get_image() decodes directly from it.
+            ensures
+                - loads the JPEG file in the given buffer into this object
+            throws
+                - std::bad_alloc
+                - image_load_error
+                  This exception is thrown if there is some error that prevents
+                  us from loading the given JPEG file.
+        !*/
+
         ~jpeg_loader(
         );
         /*!
@@ -92,6 +124,46 @@ namespace dlib
                     - returns false
         !*/
 
+        unsigned long nr (
+        ) const;
+        /*!
+            ensures
+                - returns the number of rows in the image get_image() will produce.  This
+                  accounts for the current downscale factor.
+        !*/
+
+        unsigned long nc (
+        ) const;
+        /*!
+            ensures
+                - returns the number of columns in the image get_image() will produce.
+                  This accounts for the current downscale factor.
+        !*/
+
+        void set_downscale (
+            unsigned long factor
+        );
+        /*!
+            requires
+                - factor == 1, 2, 4, or 8
+            ensures
+                - #get_downscale() == factor
+                - Makes get_image() output an image that is factor times smaller in each
+                  dimension than the one stored in the JPEG file.  This uses libjpeg's
+                  ability to scale the image while doing the inverse DCT, so it is a lot
+                  faster than decoding the full image and downsampling it afterwards.
+                - #nr() == the number of rows in the file divided by factor, rounded up.
+                - #nc() == the number of columns in the file divided by factor, rounded up.
+        !*/
+
+        unsigned long get_downscale (
+        ) const;
+        /*!
+            ensures
+                - returns the factor by which get_image() shrinks the image stored in the
+                  JPEG file.  The initial value is 1, i.e. no downscaling.
+        !*/
+
         template<
             typename image_type 
             >
@@ -104,6 +176,11 @@ namespace dlib
                   dlib/image_processing/generic_image.h 
             ensures
                 - loads the JPEG image stored in this object into img
+                - #img.nr() == nr()
+                - #img.nc() == nc()
+                - If img contains unsigned char pixels and is_gray() == true, or contains
+                  rgb_pixel pixels and is_rgb() == true, then libjpeg decodes directly
+                  into img.  Otherwise the pixels are converted one row at a time.
         !*/
 
     };
@@ -125,6 +202,25 @@ namespace dlib
             - performs: jpeg_loader(file_name).get_image(image);
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_type
+        >
+    void load_jpeg (
+        image_type& image,
+        const unsigned char* imgbuffer,
+        size_t buffer_size
+    );
+    /*!
+        requires
+            - image_type == an image object that implements the interface defined in
+              dlib/image_processing/generic_image.h 
+            - imgbuffer points to buffer_size bytes containing a JPEG file.
+        ensures
+            - performs: jpeg_loader(imgbuffer, buffer_size).get_image(image);
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
 }
@@ -13,57 +13,51 @@
 #include <png.h>
 #include "../string.h"
 #include "../byte_orderer.h"
+#include <cstring>
+#include <vector>
 
 namespace dlib
 {
 
-// ----------------------------------------------------------------------------------------
-
-    struct LibpngData
-    {
-        png_bytep* row_pointers_;
-        png_structp png_ptr_;
-        png_infop info_ptr_;
-        png_infop end_info_;
-    };
-
 // ----------------------------------------------------------------------------------------
 
     png_loader::
-    png_loader( const char* filename ) : height_( 0 ), width_( 0 )
+    png_loader( const char* filename ) : buffer_(0), buffer_size_(0), height_( 0 ), width_( 0 )
     {
-        read_image( filename );
+        if ( filename == NULL )
+        {
+            abort();
+        }
+        filename_ = filename;
+        read_header();
     }
 
 // ----------------------------------------------------------------------------------------
 
     png_loader::
-    png_loader( const std::string& filename ) : height_( 0 ), width_( 0 )
+    png_loader( const std::string& filename ) : filename_(filename), buffer_(0), buffer_size_(0), height_( 0 ), width_( 0 )
     {
-        read_image( filename.c_str() );
+        read_header();
     }
 
 // ----------------------------------------------------------------------------------------
 
     png_loader::
-    png_loader( const dlib::file& f ) : height_( 0 ), width_( 0 )
+    png_loader( const dlib::file& f ) : filename_(f.full_name()), buffer_(0), buffer_size_(0), height_( 0 ), width_( 0 )
     {
-        read_image( f.full_name().c_str() );
+        read_header();
     }
 
 // ----------------------------------------------------------------------------------------
 
-    const unsigned char* png_loader::get_row( unsigned i ) const
-    {
-        return ld_->row_pointers_[i];
-    }
-
-// ----------------------------------------------------------------------------------------
-
-    png_loader::~png_loader()
+    png_loader::
+    png_loader( const unsigned char* imgbuffer, size_t buffer_size ) : buffer_(imgbuffer), buffer_size_(buffer_size), height_( 0 ), width_( 0 )
     {
-        if ( ld_ && ld_->row_pointers_ != NULL )
-            png_destroy_read_struct( &( ld_->png_ptr_ ), &( ld_->info_ptr_ ), &( ld_->end_info_ ) );
+        if ( imgbuffer == NULL )
+        {
+            abort();
+        }
+        read_header();
     }
 
 // ----------------------------------------------------------------------------------------
@@ -106,99 +100,191 @@ namespace dlib
     {
     }
 
-    void png_loader::read_image( const char* filename )
+    struct png_loader_memory_reader
     {
-        ld_.reset(new LibpngData);
-        if ( filename == NULL )
-        {
-            abort();
-        }
-        FILE *fp = fopen( filename, "rb" );
+        const unsigned char* data;
+        size_t size;
+        size_t pos;
+    };
+
+    void png_loader_read_from_memory(png_structp png_ptr, png_bytep out, png_size_t length)
+    {
+        png_loader_memory_reader* reader = (png_loader_memory_reader*)png_get_io_ptr(png_ptr);
+        if (length > reader->size - reader->pos)
+            png_error(png_ptr, "png_loader: unexpected end of image buffer");
+        memcpy(out, reader->data + reader->pos, length);
+        reader->pos += length;
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    FILE* png_loader::open_file() const
+    {
+        if ( buffer_ != 0 )
+            return 0;
+
+        FILE* fp = fopen( filename_.c_str(), "rb" );
         if ( !fp )
         {
             abort();
         }
+        return fp;
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void png_loader::read_header()
+    {
+        // The file is opened and closed out here rather than in decode() because decode()
+        // calls setjmp().  Any local variable of decode() that changed after setjmp()
+        // would have an indeterminate value once libpng longjmp()s back to it.
+        FILE* fp = open_file();
+        decode(fp, 0, height_, width_, bit_depth_, color_type_);
+        if (fp)
+            fclose( fp );
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void png_loader::read_rows( impl::image_row_sink& sink ) const
+    {
+        unsigned height, width, bit_depth;
+        int color_type;
+        FILE* fp = open_file();
+        decode(fp, &sink, height, width, bit_depth, color_type);
+        if (fp)
+            fclose( fp );
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void png_loader::decode( 
+        FILE* fp,
+        impl::image_row_sink* sink,
+        unsigned& height,
+        unsigned& width,
+        unsigned& bit_depth,
+        int& color_type
+    ) const
+    {
+        png_loader_memory_reader reader;
+        reader.data = buffer_;
+        reader.size = buffer_size_;
+        reader.pos = 0;
         png_byte sig[8];
-        if (fread( sig, 1, 8, fp ) != 8)
+        if ( fp )
         {
-            fclose( fp );
-            abort();
+            if (fread( sig, 1, 8, fp ) != 8)
+            {
+                abort();
+            }
         }
-        if ( png_sig_cmp( sig, 0, 8 ) != 0 )
+        else
         {
-            fclose( fp );
-            abort();
+            if (buffer_size_ < 8)
+            {
+                abort();
+            }
+            memcpy(sig, buffer_, 8);
+            reader.pos = 8;
         }
-        ld_->png_ptr_ = png_create_read_struct( PNG_LIBPNG_VER_STRING, NULL, &png_loader_user_error_fn_silent, &png_loader_user_warning_fn_silent );
-        if ( ld_->png_ptr_ == NULL )
+        if ( png_sig_cmp( sig, 0, 8 ) != 0 )
         {
-            fclose( fp );
             abort();
         }
-        ld_->info_ptr_ = png_create_info_struct( ld_->png_ptr_ );
-        if ( ld_->info_ptr_ == NULL )
+        png_structp png_ptr = png_create_read_struct( PNG_LIBPNG_VER_STRING, NULL, &png_loader_user_error_fn_silent, &png_loader_user_warning_fn_silent );
+        if ( png_ptr == NULL )
         {
-            fclose( fp );
-            png_destroy_read_struct( &( ld_->png_ptr_ ), ( png_infopp )NULL, ( png_infopp )NULL );
             abort();
         }
-        ld_->end_info_ = png_create_info_struct( ld_->png_ptr_ );
-        if ( ld_->end_info_ == NULL )
+        png_infop info_ptr = png_create_info_struct( png_ptr );
+        if ( info_ptr == NULL )
         {
-            fclose( fp );
-            png_destroy_read_struct( &( ld_->png_ptr_ ), &( ld_->info_ptr_ ), ( png_infopp )NULL );
+            png_destroy_read_struct( &png_ptr, ( png_infopp )NULL, ( png_infopp )NULL );
             abort();
         }
 
-        if (setjmp(png_jmpbuf(ld_->png_ptr_)))
+        // Only used for interlaced images.  Declared here so nothing with a destructor
+        // is created after the setjmp() call.
+        std::vector<png_byte> interlaced_data;
+        std::vector<png_bytep> interlaced_rows;
+
+        if (setjmp(png_jmpbuf(png_ptr)))
         {
-            // If we get here, we had a problem writing the file 
-            fclose(fp);
-            png_destroy_read_struct( &( ld_->png_ptr_ ), &( ld_->info_ptr_ ), &( ld_->end_info_ ) );
+            // If we get here, we had a problem reading the file 
+            png_destroy_read_struct( &png_ptr, &info_ptr, ( png_infopp )NULL );
             abort();
         }
 
-        png_set_palette_to_rgb(ld_->png_ptr_);
+        png_set_palette_to_rgb(png_ptr);
+
+        if (fp)
+            png_init_io( png_ptr, fp );
+        else
+            png_set_read_fn( png_ptr, &reader, &png_loader_read_from_memory );
+        png_set_sig_bytes( png_ptr, 8 );
+        png_read_info( png_ptr, info_ptr );
 
-        png_init_io( ld_->png_ptr_, fp );
-        png_set_sig_bytes( ld_->png_ptr_, 8 );
-        // flags force one byte per channel output
+        // force one byte per channel output
+        png_set_packing(png_ptr);
         byte_orderer bo;
-        int png_transforms = PNG_TRANSFORM_PACKING;
         if (bo.host_is_little_endian())
-            png_transforms |= PNG_TRANSFORM_SWAP_ENDIAN;
-        png_read_png( ld_->png_ptr_, ld_->info_ptr_, png_transforms, NULL );
-        height_ = png_get_image_height( ld_->png_ptr_, ld_->info_ptr_ );
-        width_ = png_get_image_width( ld_->png_ptr_, ld_->info_ptr_ );
-        bit_depth_ = png_get_bit_depth( ld_->png_ptr_, ld_->info_ptr_ );
-        color_type_ = png_get_color_type( ld_->png_ptr_, ld_-> info_ptr_ );
-
-
-        if (color_type_ != PNG_COLOR_TYPE_GRAY && 
-            color_type_ != PNG_COLOR_TYPE_RGB && 
-            color_type_ != PNG_COLOR_TYPE_RGB_ALPHA &&
-            color_type_ != PNG_COLOR_TYPE_GRAY_ALPHA)
+            png_set_swap(png_ptr);
+        const int passes = png_set_interlace_handling(png_ptr);
+        png_read_update_info( png_ptr, info_ptr );
+
+        height = png_get_image_height( png_ptr, info_ptr );
+        width = png_get_image_width( png_ptr, info_ptr );
+        bit_depth = png_get_bit_depth( png_ptr, info_ptr );
+        color_type = png_get_color_type( png_ptr, info_ptr );
+
+
+        if (color_type != PNG_COLOR_TYPE_GRAY && 
+            color_type != PNG_COLOR_TYPE_RGB && 
+            color_type != PNG_COLOR_TYPE_RGB_ALPHA &&
+            color_type != PNG_COLOR_TYPE_GRAY_ALPHA)
         {
-            fclose( fp );
-            png_destroy_read_struct( &( ld_->png_ptr_ ), &( ld_->info_ptr_ ), &( ld_->end_info_ ) );
+            png_destroy_read_struct( &png_ptr, &info_ptr, ( png_infopp )NULL );
             abort();
         }
 
-        if (bit_depth_ != 8 && bit_depth_ != 16)
+        if (bit_depth != 8 && bit_depth != 16)
         {
-            fclose( fp );
-            png_destroy_read_struct( &( ld_->png_ptr_ ), &( ld_->info_ptr_ ), &( ld_->end_info_ ) );
+            png_destroy_read_struct( &png_ptr, &info_ptr, ( png_infopp )NULL );
             abort();
         }
 
-        ld_->row_pointers_ = png_get_rows( ld_->png_ptr_, ld_->info_ptr_ );
-
-        fclose( fp );
-        if ( ld_->row_pointers_ == NULL )
+        if (sink)
         {
-            png_destroy_read_struct( &( ld_->png_ptr_ ), &( ld_->info_ptr_ ), &( ld_->end_info_ ) );
-            abort();
+            if (passes == 1)
+            {
+                // decode the image one row at a time straight into the sink
+                for (unsigned long r = 0; r < height; ++r)
+                {
+                    png_read_row( png_ptr, sink->get_row_buffer(r), NULL );
+                    sink->row_done(r);
+                }
+            }
+            else
+            {
+                // Interlaced images are spread over several passes through the whole
+                // image, so no row is finished until all of them have been decoded.
+                const size_t row_bytes = png_get_rowbytes( png_ptr, info_ptr );
+                interlaced_data.resize(row_bytes*height);
+                interlaced_rows.resize(height);
+                for (unsigned long r = 0; r < height; ++r)
+                    interlaced_rows[r] = &interlaced_data[r*row_bytes];
+                png_read_image( png_ptr, &interlaced_rows[0] );
+                for (unsigned long r = 0; r < height; ++r)
+                {
+                    memcpy(sink->get_row_buffer(r), interlaced_rows[r], row_bytes);
+                    sink->row_done(r);
+                }
+            }
+            png_read_end( png_ptr, NULL );
         }
+
+        png_destroy_read_struct( &png_ptr, &info_ptr, ( png_infopp )NULL );
     }
 
 // ----------------------------------------------------------------------------------------
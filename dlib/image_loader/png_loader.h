@@ -8,11 +8,13 @@
 #include "image_loader.h"
 #include "../pixel.h"
 #include "../dir_nav.h"
+#include <vector>
+#include <string>
+#include <cstdio>
 
 namespace dlib
 {
 
-    struct LibpngData;
     class png_loader : noncopyable
     {
     public:
@@ -20,7 +22,7 @@ namespace dlib
         png_loader( const char* filename );
         png_loader( const std::string& filename );
         png_loader( const dlib::file& f );
-        ~png_loader();
+        png_loader( const unsigned char* imgbuffer, size_t buffer_size );
 
         bool is_gray() const;
         bool is_graya() const;
@@ -29,6 +31,9 @@ namespace dlib
 
         unsigned int bit_depth () const { return bit_depth_; }
 
+        unsigned long nr() const { return height_; }
+        unsigned long nc() const { return width_; }
+
         template<typename T>
         void get_image( T& t_) const
         {
@@ -46,155 +51,206 @@ namespace dlib
             image_view<T> t(t_);
             t.set_size( height_, width_ );
 
+            if (is_rgba() && !pixel_traits<pixel_type>::has_alpha)
+                assign_all_pixels(t,0);
+
+            // If the image uses the same pixel layout as libpng's output then the decoder
+            // can write straight into it.  Otherwise each row goes through a small buffer
+            // and gets converted.
+            const bool direct = (bit_depth_ == 8 && is_gray() && is_same_type<pixel_type,unsigned char>::value) ||
+                                (bit_depth_ == 16 && is_gray() && is_same_type<pixel_type,uint16>::value) ||
+                                (bit_depth_ == 8 && is_rgb() && is_same_type<pixel_type,rgb_pixel>::value) ||
+                                (bit_depth_ == 8 && is_rgba() && is_same_type<pixel_type,rgb_alpha_pixel>::value);
+            row_sink<T> sink(*this, t, direct);
+            read_rows(sink);
+        }
+
+    private:
 
-            if (is_gray() && bit_depth_ == 8)
+        template <typename T>
+        class row_sink : public impl::image_row_sink
+        {
+        public:
+            row_sink(
+                const png_loader& loader_,
+                image_view<T>& t_,
+                bool direct_
+            ) : loader(loader_), t(t_), direct(direct_)
             {
-                for ( unsigned n = 0; n < height_;n++ )
+                if (!direct)
                 {
-                    const unsigned char* v = get_row( n );
-                    for ( unsigned m = 0; m < width_;m++ )
-                    {
-                        unsigned char p = v[m];
-                        assign_pixel( t[n][m], p );
-                    }
+                    unsigned long channels = 1;
+                    if (loader.is_graya()) channels = 2;
+                    else if (loader.is_rgb()) channels = 3;
+                    else if (loader.is_rgba()) channels = 4;
+                    row.resize(t.nc()*channels*(loader.bit_depth()/8));
                 }
             }
-            else if (is_gray() && bit_depth_ == 16)
-            {
-                for ( unsigned n = 0; n < height_;n++ )
-                {
-                    const uint16* v = (uint16*)get_row( n );
-                    for ( unsigned m = 0; m < width_;m++ )
-                    {
-                        dlib::uint16 p = v[m];
-                        assign_pixel( t[n][m], p );
-                    }
-                }
+
+            virtual unsigned char* get_row_buffer (
+                unsigned long n
+            ) 
+            { 
+                if (direct)
+                    return reinterpret_cast<unsigned char*>(&t[n][0]);
+                else
+                    return &row[0];
             }
-            else if (is_graya() && bit_depth_ == 8)
+
+            virtual void row_done (
+                unsigned long n
+            );
+
+        private:
+            typedef typename image_traits<T>::pixel_type pixel_type;
+            const png_loader& loader;
+            image_view<T>& t;
+            const bool direct;
+            std::vector<unsigned char> row;
+        };
+
+        void read_header();
+        void read_rows( impl::image_row_sink& sink ) const;
+        FILE* open_file() const;
+        void decode( 
+            FILE* fp,
+            impl::image_row_sink* sink,
+            unsigned& height,
+            unsigned& width,
+            unsigned& bit_depth,
+            int& color_type
+        ) const;
+
+        std::string filename_;
+        const unsigned char* buffer_;
+        size_t buffer_size_;
+        unsigned height_, width_;
+        unsigned bit_depth_;
+        int color_type_;
+    };
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename T>
+    void png_loader::row_sink<T>::
+    row_done (
+        unsigned long n
+    )
+    {
+        if (direct)
+            return;
+
+        const unsigned long width_ = t.nc();
+        const unsigned int bit_depth_ = loader.bit_depth();
+        if (loader.is_gray() && bit_depth_ == 8)
+        {
+            const unsigned char* v = &row[0];
+            for ( unsigned m = 0; m < width_;m++ )
             {
-                for ( unsigned n = 0; n < height_;n++ )
-                {
-                    const unsigned char* v = get_row( n );
-                    for ( unsigned m = 0; m < width_; m++ )
-                    {
-                        unsigned char p = v[m*2];
-                        if (!pixel_traits<pixel_type>::has_alpha)
-                        {
-                            assign_pixel( t[n][m], p );
-                        }
-                        else
-                        {
-                            unsigned char pa = v[m*2+1];
-                            rgb_alpha_pixel pix;
-                            assign_pixel(pix, p);
-                            assign_pixel(pix.alpha, pa);
-                            assign_pixel(t[n][m], pix);
-                        }
-                    }
-                }
+                unsigned char p = v[m];
+                assign_pixel( t[n][m], p );
             }
-            else if (is_graya() && bit_depth_ == 16)
+        }
+        else if (loader.is_gray() && bit_depth_ == 16)
+        {
+            const uint16* v = (uint16*)&row[0];
+            for ( unsigned m = 0; m < width_;m++ )
             {
-                for ( unsigned n = 0; n < height_;n++ )
-                {
-                    const uint16* v = (uint16*)get_row( n );
-                    for ( unsigned m = 0; m < width_; m++ )
-                    {
-                        dlib::uint16 p = v[m*2];
-                        if (!pixel_traits<pixel_type>::has_alpha)
-                        {
-                            assign_pixel( t[n][m], p );
-                        }
-                        else
-                        {
-                            dlib::uint16 pa = v[m*2+1];
-                            rgb_alpha_pixel pix;
-                            assign_pixel(pix, p);
-                            assign_pixel(pix.alpha, pa);
-                            assign_pixel(t[n][m], pix);
-                        }
-                    }
-                }
+                dlib::uint16 p = v[m];
+                assign_pixel( t[n][m], p );
             }
-            else if (is_rgb() && bit_depth_ == 8)
+        }
+        else if (loader.is_graya() && bit_depth_ == 8)
+        {
+            const unsigned char* v = &row[0];
+            for ( unsigned m = 0; m < width_; m++ )
             {
-                for ( unsigned n = 0; n < height_;n++ )
+                unsigned char p = v[m*2];
+                if (!pixel_traits<pixel_type>::has_alpha)
                 {
-                    const unsigned char* v = get_row( n );
-                    for ( unsigned m = 0; m < width_;m++ )
-                    {
-                        rgb_pixel p;
-                        p.red = v[m*3];
-                        p.green = v[m*3+1];
-                        p.blue = v[m*3+2];
-                        assign_pixel( t[n][m], p );
-                    }
+                    assign_pixel( t[n][m], p );
                 }
-            }
-            else if (is_rgb() && bit_depth_ == 16)
-            {
-                for ( unsigned n = 0; n < height_;n++ )
+                else
                 {
-                    const uint16* v = (uint16*)get_row( n );
-                    for ( unsigned m = 0; m < width_;m++ )
-                    {
-                        rgb_pixel p;
-                        p.red   = static_cast<uint8>(v[m*3]);
-                        p.green = static_cast<uint8>(v[m*3+1]);
-                        p.blue  = static_cast<uint8>(v[m*3+2]);
-                        assign_pixel( t[n][m], p );
-                    }
+                    unsigned char pa = v[m*2+1];
+                    rgb_alpha_pixel pix;
+                    assign_pixel(pix, p);
+                    assign_pixel(pix.alpha, pa);
+                    assign_pixel(t[n][m], pix);
                 }
             }
-            else if (is_rgba() && bit_depth_ == 8)
+        }
+        else if (loader.is_graya() && bit_depth_ == 16)
+        {
+            const uint16* v = (uint16*)&row[0];
+            for ( unsigned m = 0; m < width_; m++ )
             {
+                dlib::uint16 p = v[m*2];
                 if (!pixel_traits<pixel_type>::has_alpha)
-                    assign_all_pixels(t,0);
-
-                for ( unsigned n = 0; n < height_;n++ )
                 {
-                    const unsigned char* v = get_row( n );
-                    for ( unsigned m = 0; m < width_;m++ )
-                    {
-                        rgb_alpha_pixel p;
-                        p.red = v[m*4];
-                        p.green = v[m*4+1];
-                        p.blue = v[m*4+2];
-                        p.alpha = v[m*4+3];
-                        assign_pixel( t[n][m], p );
-                    }
+                    assign_pixel( t[n][m], p );
                 }
-            }
-            else if (is_rgba() && bit_depth_ == 16)
-            {
-                if (!pixel_traits<pixel_type>::has_alpha)
-                    assign_all_pixels(t,0);
-
-                for ( unsigned n = 0; n < height_;n++ )
+                else
                 {
-                    const uint16* v = (uint16*)get_row( n );
-                    for ( unsigned m = 0; m < width_;m++ )
-                    {
-                        rgb_alpha_pixel p;
-                        p.red   = static_cast<uint8>(v[m*4]);
-                        p.green = static_cast<uint8>(v[m*4+1]);
-                        p.blue  = static_cast<uint8>(v[m*4+2]);
-                        p.alpha = static_cast<uint8>(v[m*4+3]);
-                        assign_pixel( t[n][m], p );
-                    }
+                    dlib::uint16 pa = v[m*2+1];
+                    rgb_alpha_pixel pix;
+                    assign_pixel(pix, p);
+                    assign_pixel(pix.alpha, pa);
+                    assign_pixel(t[n][m], pix);
                 }
             }
         }
-
-    private:
-        const unsigned char* get_row( unsigned i ) const;
-        void read_image( const char* filename );
-        unsigned height_, width_;
-        unsigned bit_depth_;
-        int color_type_;
-        scoped_ptr<LibpngData> ld_;
-    };
+        else if (loader.is_rgb() && bit_depth_ == 8)
+        {
+            const unsigned char* v = &row[0];
+            for ( unsigned m = 0; m < width_;m++ )
+            {
+                rgb_pixel p;
+                p.red = v[m*3];
+                p.green = v[m*3+1];
+                p.blue = v[m*3+2];
+                assign_pixel( t[n][m], p );
+            }
+        }
+        else if (loader.is_rgb() && bit_depth_ == 16)
+        {
+            const uint16* v = (uint16*)&row[0];
+            for ( unsigned m = 0; m < width_;m++ )
+            {
+                rgb_pixel p;
+                p.red   = static_cast<uint8>(v[m*3]);
+                p.green = static_cast<uint8>(v[m*3+1]);
+                p.blue  = static_cast<uint8>(v[m*3+2]);
+                assign_pixel( t[n][m], p );
+            }
+        }
+        else if (loader.is_rgba() && bit_depth_ == 8)
+        {
+            const unsigned char* v = &row[0];
+            for ( unsigned m = 0; m < width_;m++ )
+            {
+                rgb_alpha_pixel p;
+                p.red = v[m*4];
+                p.green = v[m*4+1];
+                p.blue = v[m*4+2];
+                p.alpha = v[m*4+3];
+                assign_pixel( t[n][m], p );
+            }
+        }
+        else if (loader.is_rgba() && bit_depth_ == 16)
+        {
+            const uint16* v = (uint16*)&row[0];
+            for ( unsigned m = 0; m < width_;m++ )
+            {
+                rgb_alpha_pixel p;
+                p.red   = static_cast<uint8>(v[m*4]);
+                p.green = static_cast<uint8>(v[m*4+1]);
+                p.blue  = static_cast<uint8>(v[m*4+2]);
+                p.alpha = static_cast<uint8>(v[m*4+3]);
+                assign_pixel( t[n][m], p );
+            }
+        }
+    }
 
 // ----------------------------------------------------------------------------------------
 
@@ -209,6 +265,18 @@ namespace dlib
         png_loader(file_name).get_image(image);
     }
 
+    template <
+        typename image_type
+        >
+    void load_png (
+        image_type& image,
+        const unsigned char* imgbuffer,
+        size_t buffer_size
+    )
+    {
+        png_loader(imgbuffer, buffer_size).get_image(image);
+    }
+
 // ----------------------------------------------------------------------------------------
 
 }
@@ -21,7 +21,12 @@ namespace dlib
             WHAT THIS OBJECT REPRESENTS
                 This object represents a class capable of loading PNG image files.
                 Once an instance of it is created to contain a PNG file from
-                disk you can obtain the image stored in it via get_image().
+                disk, or from a buffer in memory, you can obtain the image stored in
+                it via get_image().
+
+                The constructors only read the PNG header.  The pixels are decoded by
+                get_image() straight into the image you give it, one row at a time for
+                non-interlaced files.
         !*/
 
     public:
@@ -30,6 +35,9 @@ namespace dlib
             const char* filename 
         );
         /*!
+            requires
+                - The file must not be deleted or modified for as long as this object
+                  exists since get_image() reopens it and decodes the pixels from it.
             ensures
                 - loads the PNG file with the given file name into this object
             throws
@@ -43,6 +51,9 @@ namespace dlib
             const std::string& filename 
         );
         /*!
+            requires
+                - The file must not be deleted or modified for as long as this object
+                  exists since get_image() reopens it and decodes the pixels from it.
             ensures
                 - loads the PNG file with the given file name into this object
             throws
@@ -56,6 +67,9 @@ namespace dlib
             const dlib::file& f 
         );
         /*!
+            requires
+                - The file must not be deleted or modified for as long as this object
+                  exists since get_image() reopens it and decodes the pixels from it.
             ensures
                 - loads the PNG file with the given file name into this object
             throws
@@ -65,6 +79,24 @@ namespace dlib
                   us from loading the given PNG file.
         !*/
 
+        png_loader( 
+            const unsigned char* imgbuffer,
+            size_t buffer_size
+        );
+        /*!
+            requires
+                - imgbuffer points to buffer_size bytes containing a PNG file.
+                - The buffer must remain valid, and unmodified, for as long as this
+                  object exists since get_image() decodes directly from it.
+            ensures
+                - loads the PNG file in the given buffer into this object
+            throws
+                - std::bad_alloc
+                - image_load_error
+                  This exception is thrown if there is some error that prevents
+                  us from loading the given PNG file.
+        !*/
+
         ~png_loader(
         );
         /*!
@@ -120,6 +152,20 @@ namespace dlib
                   object.  The possible values are 8 or 16.
         !*/
 
+        unsigned long nr (
+        ) const;
+        /*!
+            ensures
+                - returns the number of rows in the image contained by this object.
+        !*/
+
+        unsigned long nc (
+        ) const;
+        /*!
+            ensures
+                - returns the number of columns in the image contained by this object.
+        !*/
+
         template<
             typename image_type 
             >
@@ -132,6 +178,11 @@ namespace dlib
                   dlib/image_processing/generic_image.h 
             ensures
                 - loads the PNG image stored in this object into img
+                - #img.nr() == nr()
+                - #img.nc() == nc()
+                - If the pixels in img have the same layout as the decoded PNG data (e.g.
+                  rgb_pixel for an 8bit RGB file) then libpng decodes directly into img.
+                  Otherwise the pixels are converted one row at a time.
         !*/
 
     };
@@ -153,6 +204,25 @@ namespace dlib
             - performs: png_loader(file_name).get_image(image);
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_type
+        >
+    void load_png (
+        image_type& image,
+        const unsigned char* imgbuffer,
+        size_t buffer_size
+    );
+    /*!
+        requires
+            - image_type == an image object that implements the interface defined in
+              dlib/image_processing/generic_image.h 
+            - imgbuffer points to buffer_size bytes containing a PNG file.
+        ensures
+            - performs: png_loader(imgbuffer, buffer_size).get_image(image);
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
 }
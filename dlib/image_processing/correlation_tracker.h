@@ -8,6 +8,8 @@
 #include "../matrix.h"
 #include "../array2d.h"
 #include "../image_transforms/assign_image.h"
+#include "../threads.h"
+#include <memory>
 
 
 namespace dlib
@@ -46,6 +48,12 @@ namespace dlib
                 dist = std::min(dist, pi/2);
                 scale_cos_mask[k] = std::cos(dist);
             }
+
+            // All the FFTs are of real data so only half of each spectrum is stored.
+            // Grab the plans up front so update() never has to recompute twiddle factors.
+            space_row_plan = impl::get_real_fft_plan<double>(get_filter_size());
+            space_col_plan = impl::get_fft_plan<double>(get_filter_size());
+            scale_plan = impl::get_real_fft_plan<double>(get_num_scale_levels());
         }
 
         template <typename image_type>
@@ -61,9 +69,10 @@ namespace dlib
 
             B.set_size(0,0);
 
-            point_transform_affine tform = inv(make_chip(img, p, F));
+            point_transform_affine tform = inv(make_chip(img, p));
+            F.resize(ws.feats.size());
             for (unsigned long i = 0; i < F.size(); ++i)
-                fft_inplace(F[i]);
+                fft_space(ws.feats[i], F[i]);
             make_target_location_image(tform(center(p)), G);
             A.resize(F.size());
             for (unsigned long i = 0; i < F.size(); ++i)
@@ -75,9 +84,7 @@ namespace dlib
             position = p;
 
             // now do the scale space stuff
-            make_scale_space(img, Fs);
-            for (unsigned long i = 0; i < Fs.size(); ++i)
-                fft_inplace(Fs[i]);
+            make_scale_space(img);
             make_scale_target_location_image(get_num_scale_levels()/2, Gs);
             Bs.set_size(0);
             As.resize(Fs.size());
@@ -130,32 +137,33 @@ namespace dlib
             );
 
 
-            const point_transform_affine tform = make_chip(img, guess, F);
+            const point_transform_affine tform = make_chip(img, guess);
+            F.resize(ws.feats.size());
             for (unsigned long i = 0; i < F.size(); ++i)
-                fft_inplace(F[i]);
+                fft_space(ws.feats[i], F[i]);
 
             // use the current filter to predict the object's location
             G = 0;
             for (unsigned long i = 0; i < F.size(); ++i)
                 G += pointwise_multiply(F[i],conj(A[i]));
             G = pointwise_multiply(G, reciprocal(B+get_regularizer_space()));
-            ifft_inplace(G);
-            const dlib::vector<double,2> pp = max_point_interpolated(real(G));
+            ifft_space(G, ws.g);
+            const dlib::vector<double,2> pp = max_point_interpolated(ws.g);
 
 
             // Compute the peak to side lobe ratio.
             const point p = pp;
             running_stats<double> rs;
             const rectangle peak = centered_rect(p, 8,8);
-            for (long r = 0; r < G.nr(); ++r)
+            for (long r = 0; r < ws.g.nr(); ++r)
             {
-                for (long c = 0; c < G.nc(); ++c)
+                for (long c = 0; c < ws.g.nc(); ++c)
                 {
                     if (!peak.contains(point(c,r)))
-                        rs.add(G(r,c).real());
+                        rs.add(ws.g(r,c));
                 }
             }
-            const double psr = (G(p.y(),p.x()).real()-rs.mean())/rs.stddev();
+            const double psr = (ws.g(p.y(),p.x())-rs.mean())/rs.stddev();
 
             // update the position of the object
             position = translate_rect(guess, tform(pp)-center(guess));
@@ -165,7 +173,8 @@ namespace dlib
             B *= (1-get_nu_space());
             for (unsigned long i = 0; i < F.size(); ++i)
             {
-                A[i] = get_nu_space()*pointwise_multiply(G, F[i]) + (1-get_nu_space())*A[i];
+                A[i] *= 1-get_nu_space();
+                A[i] += get_nu_space()*pointwise_multiply(G, F[i]);
                 B += get_nu_space()*(squared(real(F[i]))+squared(imag(F[i])));
             }
 
@@ -181,15 +190,14 @@ namespace dlib
             double psr = update_noscale(img, guess);
 
             // Now predict the scale change
-            make_scale_space(img, Fs);
-            for (unsigned long i = 0; i < Fs.size(); ++i)
-                fft_inplace(Fs[i]);
+            make_scale_space(img);
             Gs = 0;
             for (unsigned long i = 0; i < Fs.size(); ++i)
                 Gs += pointwise_multiply(Fs[i],conj(As[i]));
             Gs = pointwise_multiply(Gs, reciprocal(Bs+get_regularizer_scale()));
-            ifft_inplace(Gs);
-            const double pos = max_point_interpolated(real(Gs)).y();
+            ws.gs.set_size(get_num_scale_levels());
+            scale_plan->backward(&Gs(0), &ws.gs(0), ws.fft_buf);
+            const double pos = max_point_interpolated(ws.gs).y();
 
             // update the rectangle's scale
             position *= std::pow(get_scale_pyramid_alpha(), pos-(double)get_num_scale_levels()/2);
@@ -201,7 +209,8 @@ namespace dlib
             Bs *= (1-get_nu_scale());
             for (unsigned long i = 0; i < Fs.size(); ++i)
             {
-                As[i] = get_nu_scale()*pointwise_multiply(Gs, Fs[i]) + (1-get_nu_scale())*As[i];
+                As[i] *= 1-get_nu_scale();
+                As[i] += get_nu_scale()*pointwise_multiply(Gs, Fs[i]);
                 Bs += get_nu_scale()*(squared(real(Fs[i]))+squared(imag(Fs[i])));
             }
 
@@ -229,24 +238,23 @@ namespace dlib
 
         template <typename image_type>
         void make_scale_space(
-            const image_type& img,
-            std::vector<matrix<std::complex<double>,0,1> >& Fs
-        ) const
+            const image_type& img
+        )
         {
             typedef typename image_traits<image_type>::pixel_type pixel_type;
 
-            // Make an image pyramid and put it into the chips array.
+            // Pull chips out of an image pyramid and extract HOG from each.
             const long chip_size = get_scale_window_size();
             drectangle ppp = position*std::pow(get_scale_pyramid_alpha(), -(double)get_num_scale_levels()/2);
-            dlib::array<array2d<pixel_type> > chips;
+            array2d<pixel_type> chip(chip_size,chip_size);
+            dlib::array<dlib::array<array2d<float> > >& hogs = ws.scale_hogs;
+            hogs.resize(get_num_scale_levels());
             std::vector<dlib::vector<double,2> > from_points, to_points;
             from_points.push_back(point(0,0));
             from_points.push_back(point(chip_size-1,0));
             from_points.push_back(point(chip_size-1,chip_size-1));
             for (unsigned long i = 0; i < get_num_scale_levels(); ++i)
             {
-                array2d<pixel_type> chip(chip_size,chip_size);
-
                 // pull box into chip
                 to_points.clear();
                 to_points.push_back(ppp.tl_corner());
@@ -254,24 +262,18 @@ namespace dlib
                 to_points.push_back(ppp.br_corner());
                 transform_image(img,chip,interpolate_bilinear(),find_affine_transform(from_points, to_points));
 
-                chips.push_back(chip);
-                ppp *= get_scale_pyramid_alpha();
-            }
-
-
-            // extract HOG for each chip
-            dlib::array<dlib::array<array2d<float> > > hogs(chips.size());
-            for (unsigned long i = 0; i < chips.size(); ++i)
-            {
-                extract_fhog_features(chips[i], hogs[i], 4);
+                extract_fhog_features(chip, hogs[i], 4);
                 hogs[i].resize(32);
-                assign_image(hogs[i][31], chips[i]);
+                assign_image(hogs[i][31], chip);
                 assign_image(hogs[i][31], mat(hogs[i][31])/255.0);
+
+                ppp *= get_scale_pyramid_alpha();
             }
 
-            // Now copy the hog features into the Fs outputs and also apply the cosine
-            // windowing.
+            // Now apply the cosine windowing across the scales and transform each HOG
+            // feature's values into the Fs outputs.
             Fs.resize(hogs[0].size()*hogs[0][0].size());
+            ws.scale_line.set_size(hogs.size());
             unsigned long i = 0; 
             for (long r = 0; r < hogs[0][0].nr(); ++r)
             {
@@ -279,11 +281,12 @@ namespace dlib
                 {
                     for (unsigned long j = 0; j < hogs[0].size(); ++j)
                     {
-                        Fs[i].set_size(hogs.size());
                         for (unsigned long k = 0; k < hogs.size(); ++k)
                         {
-                            Fs[i](k) = hogs[k][j][r][c]*scale_cos_mask[k];
+                            ws.scale_line(k) = hogs[k][j][r][c]*scale_cos_mask[k];
                         }
+                        Fs[i].set_size(hogs.size()/2+1);
+                        scale_plan->forward(&ws.scale_line(0), &Fs[i](0), ws.fft_buf);
                         ++i;
                     }
                 }
@@ -293,9 +296,12 @@ namespace dlib
         template <typename image_type>
         point_transform_affine make_chip (
             const image_type& img,
-            drectangle p,
-            std::vector<matrix<std::complex<double> > >& chip
-        ) const
+            drectangle p
+        )
+        /*!
+            ensures
+                - puts the 32 feature planes of the chip around p into ws.feats.
+        !*/
         {
             typedef typename image_traits<image_type>::pixel_type pixel_type;
             array2d<pixel_type> temp;
@@ -304,35 +310,90 @@ namespace dlib
             extract_image_chip(img, details, temp);
 
 
+            std::vector<matrix<double> >& chip = ws.feats;
             chip.resize(32);
-            dlib::array<array2d<float> > hog;
-            extract_fhog_features(temp, hog, 1, 3,3 );
-            for (unsigned long i = 0; i < hog.size(); ++i)
-                assign_image(chip[i], pointwise_multiply(matrix_cast<double>(mat(hog[i])), mask));
+            extract_fhog_features(temp, ws.hog, 1, 3,3 );
+            for (unsigned long i = 0; i < ws.hog.size(); ++i)
+                chip[i] = pointwise_multiply(matrix_cast<double>(mat(ws.hog[i])), mask);
 
             assign_image(chip[31], temp);
-            assign_image(chip[31], pointwise_multiply(mat(chip[31]), mask)/255.0);
+            chip[31] = pointwise_multiply(chip[31], mask)/255.0;
 
             return inv(get_mapping_to_chip(details));
         }
 
+        void fft_space (
+            const matrix<double>& in,
+            matrix<std::complex<double> >& out
+        )
+        /*!
+            ensures
+                - #out == the first get_filter_size()/2+1 columns of fft(complex_matrix(in))
+        !*/
+        {
+            const long n = get_filter_size();
+            out.set_size(n, n/2+1);
+            for (long r = 0; r < n; ++r)
+                space_row_plan->forward(&in(r,0), &out(r,0), ws.fft_buf);
+
+            std::vector<std::complex<double> >& col = ws.fft_buf;
+            col.resize(n);
+            for (long c = 0; c < out.nc(); ++c)
+            {
+                for (long r = 0; r < n; ++r)
+                    col[r] = out(r,c);
+                space_col_plan->execute(&col[0], false);
+                for (long r = 0; r < n; ++r)
+                    out(r,c) = col[r];
+            }
+        }
+
+        void ifft_space (
+            matrix<std::complex<double> >& in,
+            matrix<double>& out
+        )
+        /*!
+            ensures
+                - inverts fft_space(), except that like ifft_inplace() the output isn't
+                  divided by the number of elements.  in is used as scratch space so its
+                  contents are destroyed.
+        !*/
+        {
+            const long n = get_filter_size();
+            std::vector<std::complex<double> >& col = ws.fft_buf2;
+            col.resize(n);
+            for (long c = 0; c < in.nc(); ++c)
+            {
+                for (long r = 0; r < n; ++r)
+                    col[r] = in(r,c);
+                space_col_plan->execute(&col[0], true);
+                for (long r = 0; r < n; ++r)
+                    in(r,c) = col[r];
+            }
+
+            out.set_size(n, n);
+            for (long r = 0; r < n; ++r)
+                space_row_plan->backward(&in(r,0), &out(r,0), ws.fft_buf);
+        }
+
         void make_target_location_image (
             const dlib::vector<double,2>& p,
             matrix<std::complex<double> >& g
-        ) const
+        )
         {
-            g.set_size(get_filter_size(), get_filter_size());
-            g = 0;
-            rectangle area = centered_rect(p, 21,21).intersect(get_rect(g));
+            matrix<double>& target = ws.target;
+            target.set_size(get_filter_size(), get_filter_size());
+            target = 0;
+            rectangle area = centered_rect(p, 21,21).intersect(get_rect(target));
             for (long r = area.top(); r <= area.bottom(); ++r)
             {
                 for (long c = area.left(); c <= area.right(); ++c)
                 {
                     double dist = length(point(c,r)-p);
-                    g(r,c) = std::exp(-dist/3.0);
+                    target(r,c) = std::exp(-dist/3.0);
                 }
             }
-            fft_inplace(g);
+            fft_space(target, g);
             g = conj(g);
         }
 
@@ -340,15 +401,16 @@ namespace dlib
         void make_scale_target_location_image (
             const double scale,
             matrix<std::complex<double>,0,1>& g
-        ) const
+        )
         {
-            g.set_size(get_num_scale_levels());
-            for (long i = 0; i < g.size(); ++i)
+            ws.scale_line.set_size(get_num_scale_levels());
+            for (long i = 0; i < ws.scale_line.size(); ++i)
             {
                 double dist = std::pow((i-scale),2.0);
-                g(i) = std::exp(-dist/1.000);
+                ws.scale_line(i) = std::exp(-dist/1.000);
             }
-            fft_inplace(g);
+            g.set_size(get_num_scale_levels()/2+1);
+            scale_plan->forward(&ws.scale_line(0), &g(0), ws.fft_buf);
             g = conj(g);
         }
 
@@ -373,6 +435,8 @@ namespace dlib
         }
 
 
+        // These hold only the non-redundant halves of the spectra since the inputs
+        // are all real.
         std::vector<matrix<std::complex<double> > > A, F;
         matrix<double> B;
 
@@ -388,6 +452,33 @@ namespace dlib
         matrix<std::complex<double> > G;
         matrix<std::complex<double>,0,1> Gs;
 
+        struct workspace
+        {
+            /*!
+                Scratch memory reused from one frame to the next so update() doesn't
+                allocate.  It's not part of the tracker's state, so copies of a tracker
+                just get their own empty workspace.
+            !*/
+            workspace() {}
+            workspace(const workspace&) {}
+            workspace& operator= (const workspace&) { return *this; }
+
+            std::vector<matrix<double> > feats;
+            dlib::array<array2d<float> > hog;
+            dlib::array<dlib::array<array2d<float> > > scale_hogs;
+            matrix<double> target;
+            matrix<double> g;
+            matrix<double,0,1> gs;
+            matrix<double,0,1> scale_line;
+            std::vector<std::complex<double> > fft_buf;
+            std::vector<std::complex<double> > fft_buf2;
+        };
+        workspace ws;
+
+        std::shared_ptr<const impl::real_fft_plan<double> > space_row_plan;
+        std::shared_ptr<const impl::fft_plan<double> > space_col_plan;
+        std::shared_ptr<const impl::real_fft_plan<double> > scale_plan;
+
         unsigned long filter_size;
         unsigned long num_scale_levels;
         unsigned long scale_window_size;
@@ -397,6 +488,25 @@ namespace dlib
         double nu_scale;
         double scale_pyramid_alpha;
     };
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename image_type>
+    std::vector<double> update_trackers (
+        std::vector<correlation_tracker>& trackers,
+        const image_type& img
+    )
+    {
+        std::vector<double> psr(trackers.size());
+        parallel_for(default_thread_pool(), 0, trackers.size(), [&](long i)
+        {
+            psr[i] = trackers[i].update(img);
+        });
+        return psr;
+    }
+
+// ----------------------------------------------------------------------------------------
+
 }
 
 #endif // DLIB_CORRELATION_TrACKER_H_
@@ -4,6 +4,7 @@
 #ifdef DLIB_CORRELATION_TrACKER_ABSTRACT_H_
 
 #include "../geometry/drectangle_abstract.h"
+#include <vector>
 
 namespace dlib
 {
@@ -154,6 +155,32 @@ namespace dlib
         !*/
 
     };
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_type
+        >
+    std::vector<double> update_trackers (
+        std::vector<correlation_tracker>& trackers,
+        const image_type& img
+    );
+    /*!
+        requires
+            - image_type == an image object that implements the interface defined in
+              dlib/image_processing/generic_image.h 
+            - for all valid i: trackers[i].get_position().is_empty() == false
+        ensures
+            - Calls update(img) on each of the trackers and returns the resulting peak to
+              side-lobe ratios.  That is, returns a vector PSR such that:
+                - PSR.size() == trackers.size()
+                - PSR[i] == the value returned by trackers[i].update(img)
+            - The trackers are updated in parallel using default_thread_pool().  The
+              results are identical to calling update() on each tracker one at a time.
+    !*/
+
+// ----------------------------------------------------------------------------------------
+
 }
 
 #endif // DLIB_CORRELATION_TrACKER_ABSTRACT_H_
@@ -0,0 +1,401 @@
+// Copyright (C) 2026  agent (agent@local)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_EXTERNAL_IMAGE_Hh_
+#define DLIB_EXTERNAL_IMAGE_Hh_
+
+#include "external_image_abstract.h"
+#include "../algs.h"
+#include "../pixel.h"
+#include "../matrix/matrix_mat.h"
+#include "generic_image.h"
+#include <utility>
+
+namespace dlib
+{
+
+    template <
+        typename pixel_type
+        >
+    class external_image
+    {
+    public:
+        typedef pixel_type type;
+        typedef default_memory_manager mem_manager_type;
+
+        external_image(
+        ) : _data(0), _widthStep(0), _nr(0), _nc(0) {}
+
+        external_image (
+            pixel_type* data,
+            long nr_,
+            long nc_
+        ) 
+        {
+            init(data, nr_, nc_, nc_*sizeof(pixel_type));
+        }
+
+        external_image (
+            pixel_type* data,
+            long nr_,
+            long nc_,
+            long width_step_
+        ) 
+        {
+            init(data, nr_, nc_, width_step_);
+        }
+
+        unsigned long size () const { return static_cast<unsigned long>(_nr*_nc); }
+
+        inline pixel_type* operator[](const long row ) 
+        { 
+            // make sure requires clause is not broken
+            DLIB_ASSERT(0 <= row && row < nr(),
+                "\tpixel_type* external_image::operator[](row)"
+                << "\n\t you have asked for an out of bounds row " 
+                << "\n\t row:  " << row
+                << "\n\t nr(): " << nr() 
+                << "\n\t this:  " << this
+                );
+
+            return reinterpret_cast<pixel_type*>( _data + _widthStep*row);
+        }
+
+        inline const pixel_type* operator[](const long row ) const
+        { 
+            // make sure requires clause is not broken
+            DLIB_ASSERT(0 <= row && row < nr(),
+                "\tconst pixel_type* external_image::operator[](row)"
+                << "\n\t you have asked for an out of bounds row " 
+                << "\n\t row:  " << row
+                << "\n\t nr(): " << nr() 
+                << "\n\t this:  " << this
+                );
+
+            return reinterpret_cast<const pixel_type*>( _data + _widthStep*row);
+        }
+
+        long nr() const { return _nr; }
+        long nc() const { return _nc; }
+        long width_step() const { return _widthStep; }
+
+        void set_size (
+            long rows,
+            long cols
+        )
+        {
+            // The memory belongs to someone else so we can't reallocate it.  However,
+            // lots of routines call set_image_size() on their outputs so we allow it as
+            // long as the size doesn't actually change.
+            DLIB_CASSERT(rows == nr() && cols == nc(),
+                "\t void external_image::set_size(rows,cols)"
+                << "\n\t An external_image can't be resized."
+                << "\n\t rows: " << rows
+                << "\n\t cols: " << cols
+                << "\n\t nr(): " << nr()
+                << "\n\t nc(): " << nc()
+                << "\n\t this: " << this
+                );
+        }
+
+        void swap (
+            external_image& item
+        )
+        {
+            std::swap(_data, item._data);
+            std::swap(_widthStep, item._widthStep);
+            std::swap(_nr, item._nr);
+            std::swap(_nc, item._nc);
+        }
+
+    private:
+
+        void init (
+            pixel_type* data,
+            long nr_,
+            long nc_,
+            long width_step_
+        ) 
+        {
+            DLIB_CASSERT(nr_ >= 0 && nc_ >= 0 && width_step_ >= nc_*(long)sizeof(pixel_type) &&
+                         (data != 0 || nr_*nc_ == 0),
+                "\t external_image::external_image(data,nr,nc,width_step)"
+                << "\n\t Invalid inputs were given to this function."
+                << "\n\t data:       " << data 
+                << "\n\t nr:         " << nr_ 
+                << "\n\t nc:         " << nc_ 
+                << "\n\t width_step: " << width_step_ 
+                );
+
+            if (nr_ == 0 || nc_ == 0)
+            {
+                _data = 0;
+                _widthStep = 0;
+                _nr = 0;
+                _nc = 0;
+            }
+            else
+            {
+                _data = reinterpret_cast<char*>(data);
+                _widthStep = width_step_;
+                _nr = nr_;
+                _nc = nc_;
+            }
+        }
+
+        char* _data;
+        long _widthStep;
+        long _nr;
+        long _nc;
+    };
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename pixel_type
+        >
+    class const_external_image
+    {
+    public:
+        typedef pixel_type type;
+        typedef default_memory_manager mem_manager_type;
+
+        const_external_image(
+        ) : _data(0), _widthStep(0), _nr(0), _nc(0) {}
+
+        const_external_image (
+            const pixel_type* data,
+            long nr_,
+            long nc_
+        ) 
+        {
+            init(data, nr_, nc_, nc_*sizeof(pixel_type));
+        }
+
+        const_external_image (
+            const pixel_type* data,
+            long nr_,
+            long nc_,
+            long width_step_
+        ) 
+        {
+            init(data, nr_, nc_, width_step_);
+        }
+
+        const_external_image (
+            const external_image<pixel_type>& img
+        ) 
+        {
+            if (img.size() != 0)
+                init(&img[0][0], img.nr(), img.nc(), img.width_step());
+            else
+                init(0, 0, 0, 0);
+        }
+
+        unsigned long size () const { return static_cast<unsigned long>(_nr*_nc); }
+
+        inline const pixel_type* operator[](const long row ) const
+        { 
+            // make sure requires clause is not broken
+            DLIB_ASSERT(0 <= row && row < nr(),
+                "\tconst pixel_type* const_external_image::operator[](row)"
+                << "\n\t you have asked for an out of bounds row " 
+                << "\n\t row:  " << row
+                << "\n\t nr(): " << nr() 
+                << "\n\t this:  " << this
+                );
+
+            return reinterpret_cast<const pixel_type*>( _data + _widthStep*row);
+        }
+
+        long nr() const { return _nr; }
+        long nc() const { return _nc; }
+        long width_step() const { return _widthStep; }
+
+        void swap (
+            const_external_image& item
+        )
+        {
+            std::swap(_data, item._data);
+            std::swap(_widthStep, item._widthStep);
+            std::swap(_nr, item._nr);
+            std::swap(_nc, item._nc);
+        }
+
+    private:
+
+        void init (
+            const pixel_type* data,
+            long nr_,
+            long nc_,
+            long width_step_
+        ) 
+        {
+            DLIB_CASSERT(nr_ >= 0 && nc_ >= 0 && width_step_ >= nc_*(long)sizeof(pixel_type) &&
+                         (data != 0 || nr_*nc_ == 0),
+                "\t const_external_image::const_external_image(data,nr,nc,width_step)"
+                << "\n\t Invalid inputs were given to this function."
+                << "\n\t data:       " << data 
+                << "\n\t nr:         " << nr_ 
+                << "\n\t nc:         " << nc_ 
+                << "\n\t width_step: " << width_step_ 
+                );
+
+            if (nr_ == 0 || nc_ == 0)
+            {
+                _data = 0;
+                _widthStep = 0;
+                _nr = 0;
+                _nc = 0;
+            }
+            else
+            {
+                _data = reinterpret_cast<const char*>(data);
+                _widthStep = width_step_;
+                _nr = nr_;
+                _nc = nc_;
+            }
+        }
+
+        const char* _data;
+        long _widthStep;
+        long _nr;
+        long _nc;
+    };
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename T
+        >
+    const matrix_op<op_array2d_to_mat<external_image<T> > > mat (
+        const external_image<T>& m 
+    )
+    {
+        typedef op_array2d_to_mat<external_image<T> > op;
+        return matrix_op<op>(op(m));
+    }
+
+    template <
+        typename T
+        >
+    const matrix_op<op_array2d_to_mat<const_external_image<T> > > mat (
+        const const_external_image<T>& m 
+    )
+    {
+        typedef op_array2d_to_mat<const_external_image<T> > op;
+        return matrix_op<op>(op(m));
+    }
+
+// ----------------------------------------------------------------------------------------
+
+// Define the global functions that make external_image a proper "generic image" according
+// to ../image_processing/generic_image.h
+    template <typename T>
+    struct image_traits<external_image<T> >
+    {
+        typedef T pixel_type;
+    };
+
+    template <typename T>
+    inline long num_rows( const external_image<T>& img) { return img.nr(); }
+    template <typename T>
+    inline long num_columns( const external_image<T>& img) { return img.nc(); }
+
+    template <typename T>
+    inline void set_image_size(
+        external_image<T>& img,
+        long rows,
+        long cols
+    )
+    {
+        img.set_size(rows,cols);
+    }
+
+    template <typename T>
+    inline void* image_data(
+        external_image<T>& img
+    )
+    {
+        if (img.size() != 0)
+            return &img[0][0];
+        else
+            return 0;
+    }
+
+    template <typename T>
+    inline const void* image_data(
+        const external_image<T>& img
+    )
+    {
+        if (img.size() != 0)
+            return &img[0][0];
+        else
+            return 0;
+    }
+
+    template <typename T>
+    inline long width_step(
+        const external_image<T>& img
+    ) 
+    { 
+        return img.width_step(); 
+    }
+
+    template <typename T>
+    inline void swap(
+        external_image<T>& a,
+        external_image<T>& b
+    )
+    {
+        a.swap(b);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+// A const_external_image can only be read from, so it gets the global functions needed by
+// input images but not set_image_size() or the non-const image_data().
+    template <typename T>
+    struct image_traits<const_external_image<T> >
+    {
+        typedef T pixel_type;
+    };
+
+    template <typename T>
+    inline long num_rows( const const_external_image<T>& img) { return img.nr(); }
+    template <typename T>
+    inline long num_columns( const const_external_image<T>& img) { return img.nc(); }
+
+    template <typename T>
+    inline const void* image_data(
+        const const_external_image<T>& img
+    )
+    {
+        if (img.size() != 0)
+            return &img[0][0];
+        else
+            return 0;
+    }
+
+    template <typename T>
+    inline long width_step(
+        const const_external_image<T>& img
+    ) 
+    { 
+        return img.width_step(); 
+    }
+
+    template <typename T>
+    inline void swap(
+        const_external_image<T>& a,
+        const_external_image<T>& b
+    )
+    {
+        a.swap(b);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_EXTERNAL_IMAGE_Hh_
+
@@ -0,0 +1,355 @@
+// Copyright (C) 2026  agent (agent@local)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#undef DLIB_EXTERNAL_IMAGE_ABSTRACT_Hh_
+#ifdef DLIB_EXTERNAL_IMAGE_ABSTRACT_Hh_
+
+#include "../algs.h"
+#include "../pixel.h"
+#include "generic_image.h"
+
+namespace dlib
+{
+
+    template <
+        typename pixel_type
+        >
+    class external_image
+    {
+        /*!
+            REQUIREMENTS ON pixel_type
+                pixel_type must be a type with a pixel_traits specialization and must
+                match the layout of the pixels in the memory you give to this object.
+                For example, you might use unsigned char for an 8bit grayscale buffer
+                or rgb_pixel for a buffer of interleaved 8bit red, green, and blue
+                values.
+
+            WHAT THIS OBJECT REPRESENTS
+                This object is a simple wrapper around a block of pixels that lives in
+                memory owned by someone else, such as the output buffer of an image
+                decoder or a frame from a camera.  It implements the generic image
+                interface defined in dlib/image_processing/generic_image.h, so you can
+                hand it directly to the image processing routines in dlib without first
+                copying the pixels into an array2d or matrix.
+
+                Note that this object does NOT take ownership of the memory you give to
+                it.  Therefore, an external_image can only be used as long as the memory
+                it references remains valid.  Copying an external_image just copies the
+                pointer, so all copies refer to the same pixels.
+
+                Since the memory isn't owned by this object it can't be resized.
+                set_image_size() is still defined for it, but only as a no-op for the
+                size the image already has.  So an external_image can be used as the
+                output of a routine whenever that routine doesn't need to change its
+                size.
+        !*/
+
+    public:
+        typedef pixel_type type;
+        typedef default_memory_manager mem_manager_type;
+
+        external_image(
+        ); 
+        /*!
+            ensures
+                - #nr() == 0
+                - #nc() == 0
+        !*/
+
+        external_image (
+            pixel_type* data,
+            long nr,
+            long nc
+        );
+        /*!
+            requires
+                - nr >= 0
+                - nc >= 0
+                - data points to nr*nc pixels laid down in row major order with no
+                  padding between the rows.  
+            ensures
+                - #nr() == nr
+                - #nc() == nc
+                - #width_step() == nc*sizeof(pixel_type)
+                - using the operator[] on this object you will be able to access the
+                  pixels in data.  In particular, (*this)[r][c] == data[r*nc+c].
+        !*/
+
+        external_image (
+            pixel_type* data,
+            long nr,
+            long nc,
+            long width_step
+        );
+        /*!
+            requires
+                - nr >= 0
+                - nc >= 0
+                - width_step >= nc*sizeof(pixel_type)
+                - data points to nr rows of nc pixels each.  The first pixel of row r is
+                  located at (char*)data + r*width_step.  width_step must be a multiple
+                  of the alignment of pixel_type.
+            ensures
+                - #nr() == nr
+                - #nc() == nc
+                - if (nr*nc != 0) then
+                    - #width_step() == width_step
+                - using the operator[] on this object you will be able to access the
+                  pixels in data.
+        !*/
+
+        long nr(
+        ) const; 
+        /*!
+            ensures
+                - returns the number of rows in this image
+        !*/
+
+        long nc(
+        ) const;
+        /*!
+            ensures
+                - returns the number of columns in this image
+        !*/
+
+        unsigned long size (
+        ) const; 
+        /*!
+            ensures
+                - returns nr()*nc()
+                  (i.e. returns the number of pixels in this image)
+        !*/
+
+        inline pixel_type* operator[] (
+            const long row 
+        );
+        /*!
+            requires
+                - 0 <= row < nr()
+            ensures
+                - returns a pointer to the first pixel in the given row
+                  of this image
+        !*/
+
+        inline const pixel_type* operator[] (
+            const long row 
+        ) const;
+        /*!
+            requires
+                - 0 <= row < nr()
+            ensures
+                - returns a pointer to the first pixel in the given row
+                  of this image
+        !*/
+
+        long width_step (
+        ) const;
+        /*!
+            ensures
+                - returns the size of one row of the image, in bytes.  
+                  More precisely, return a number N such that:
+                  (char*)&item[0][0] + N == (char*)&item[1][0].
+        !*/
+
+        void set_size (
+            long rows,
+            long cols
+        );
+        /*!
+            requires
+                - rows == nr()
+                - cols == nc()
+            ensures
+                - This function does nothing.  It exists so that routines which call
+                  set_image_size() on their output images can write into an
+                  external_image of the right size.
+        !*/
+
+        void swap (
+            external_image& item
+        );
+        /*!
+            ensures
+                - swaps *this and item.  Only the pointers are swapped, the pixels
+                  themselves are not touched.
+        !*/
+    };
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename pixel_type
+        >
+    class const_external_image
+    {
+        /*!
+            REQUIREMENTS ON pixel_type
+                Same as for external_image.
+
+            WHAT THIS OBJECT REPRESENTS
+                This object is just like external_image except that it gives read-only
+                access to the pixels.  So it can wrap memory you are not allowed to
+                write to, such as a const buffer handed to you by some other library.
+                It implements the parts of the generic image interface that input images
+                need, so it can be given as the input to any of the image processing
+                routines in dlib.  However, it has no set_image_size() or non-const
+                image_data() so it can't be used as an output image.
+
+                Like external_image, this object does NOT take ownership of the memory
+                you give to it and can only be used as long as that memory remains
+                valid.
+        !*/
+
+    public:
+        typedef pixel_type type;
+        typedef default_memory_manager mem_manager_type;
+
+        const_external_image(
+        ); 
+        /*!
+            ensures
+                - #nr() == 0
+                - #nc() == 0
+        !*/
+
+        const_external_image (
+            const pixel_type* data,
+            long nr,
+            long nc
+        );
+        /*!
+            requires
+                - nr >= 0
+                - nc >= 0
+                - data points to nr*nc pixels laid down in row major order with no
+                  padding between the rows.  
+            ensures
+                - #nr() == nr
+                - #nc() == nc
+                - #width_step() == nc*sizeof(pixel_type)
+                - (*this)[r][c] == data[r*nc+c]
+        !*/
+
+        const_external_image (
+            const pixel_type* data,
+            long nr,
+            long nc,
+            long width_step
+        );
+        /*!
+            requires
+                - nr >= 0
+                - nc >= 0
+                - width_step >= nc*sizeof(pixel_type)
+                - data points to nr rows of nc pixels each.  The first pixel of row r is
+                  located at (const char*)data + r*width_step.  width_step must be a
+                  multiple of the alignment of pixel_type.
+            ensures
+                - #nr() == nr
+                - #nc() == nc
+                - if (nr*nc != 0) then
+                    - #width_step() == width_step
+                - using the operator[] on this object you will be able to read the
+                  pixels in data.
+        !*/
+
+        const_external_image (
+            const external_image<pixel_type>& img
+        );
+        /*!
+            ensures
+                - #nr() == img.nr()
+                - #nc() == img.nc()
+                - if (img.size() != 0) then
+                    - #width_step() == img.width_step()
+                - *this refers to the same pixels as img.
+        !*/
+
+        long nr(
+        ) const; 
+        /*!
+            ensures
+                - returns the number of rows in this image
+        !*/
+
+        long nc(
+        ) const;
+        /*!
+            ensures
+                - returns the number of columns in this image
+        !*/
+
+        unsigned long size (
+        ) const; 
+        /*!
+            ensures
+                - returns nr()*nc()
+                  (i.e. returns the number of pixels in this image)
+        !*/
+
+        inline const pixel_type* operator[] (
+            const long row 
+        ) const;
+        /*!
+            requires
+                - 0 <= row < nr()
+            ensures
+                - returns a pointer to the first pixel in the given row
+                  of this image
+        !*/
+
+        long width_step (
+        ) const;
+        /*!
+            ensures
+                - returns the size of one row of the image, in bytes.  
+                  More precisely, return a number N such that:
+                  (const char*)&item[0][0] + N == (const char*)&item[1][0].
+        !*/
+
+        void swap (
+            const_external_image& item
+        );
+        /*!
+            ensures
+                - swaps *this and item.  Only the pointers are swapped.
+        !*/
+    };
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename T
+        >
+    const matrix_exp mat (
+        const external_image<T>& img
+    );
+    /*!
+        ensures
+            - returns a matrix R such that:
+                - R.nr() == img.nr() 
+                - R.nc() == img.nc()
+                - for all valid r and c:
+                  R(r, c) == img[r][c]
+    !*/
+
+    template <
+        typename T
+        >
+    const matrix_exp mat (
+        const const_external_image<T>& img
+    );
+    /*!
+        ensures
+            - returns a matrix R such that:
+                - R.nr() == img.nr() 
+                - R.nc() == img.nc()
+                - for all valid r and c:
+                  R(r, c) == img[r][c]
+    !*/
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_EXTERNAL_IMAGE_ABSTRACT_Hh_
+
@@ -8,6 +8,8 @@
 #include <vector>
 #include "box_overlap_testing.h"
 #include "full_object_detection.h"
+#include "../threads.h"
+#include <memory>
 
 namespace dlib
 {
@@ -177,6 +179,23 @@ namespace dlib
             double adjust_threshold = 0
         );
 
+        template <
+            typename image_type
+            >
+        std::vector<std::vector<rectangle> > operator() (
+            const std::vector<image_type>& imgs,
+            double adjust_threshold = 0
+        );
+
+        template <
+            typename image_type
+            >
+        void operator() (
+            const std::vector<image_type>& imgs,
+            std::vector<std::vector<rect_detection> >& final_dets,
+            double adjust_threshold = 0
+        );
+
         template <typename T>
         friend void serialize (
             const object_detector<T>& item,
@@ -191,6 +210,23 @@ namespace dlib
 
     private:
 
+        template <
+            typename image_type
+            >
+        void detect (
+            image_scanner_type& scanner,
+            const image_type& img,
+            std::vector<rect_detection>& final_dets,
+            double adjust_threshold
+        ) const;
+
+        std::unique_ptr<image_scanner_type> get_pooled_scanner (
+        );
+
+        void return_pooled_scanner (
+            std::unique_ptr<image_scanner_type>& s
+        );
+
         bool overlaps_any_box (
             const std::vector<rect_detection>& rects,
             const dlib::rectangle& rect
@@ -207,6 +243,11 @@ namespace dlib
         test_box_overlap boxes_overlap;
         std::vector<processed_weight_vector<image_scanner_type> > w;
         image_scanner_type scanner;
+
+        // The batch operator() uses one scanner per thread.  They are kept here between
+        // calls so the memory they use for image pyramids and features gets reused.
+        mutex pool_mutex;
+        std::vector<std::unique_ptr<image_scanner_type> > scanner_pool;
     };
 
 // ----------------------------------------------------------------------------------------
@@ -240,6 +281,7 @@ namespace dlib
     {
         int version = 0;
         deserialize(version, in);
+        item.scanner_pool.clear();
         if (version == 1)
         {
             deserialize(item.scanner, in);
@@ -412,6 +454,8 @@ namespace dlib
         boxes_overlap = item.boxes_overlap;
         w = item.w;
         scanner.copy_configuration(item.scanner);
+        auto_mutex lock(pool_mutex);
+        scanner_pool.clear();
         return *this;
     }
 
@@ -429,6 +473,80 @@ namespace dlib
         std::vector<rect_detection>& final_dets,
         double adjust_threshold
     ) 
+    {
+        detect(scanner, img, final_dets, adjust_threshold);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_scanner_type
+        >
+    template <
+        typename image_type
+        >
+    void object_detector<image_scanner_type>::
+    operator() (
+        const std::vector<image_type>& imgs,
+        std::vector<std::vector<rect_detection> >& final_dets,
+        double adjust_threshold
+    ) 
+    {
+        final_dets.resize(imgs.size());
+        // Each image gets run all the way through the scanner by one thread, so while
+        // one thread is building an image pyramid another is running the filters over
+        // the pyramid of a different image.
+        parallel_for(default_thread_pool(), 0, imgs.size(), [&](long i)
+        {
+            std::unique_ptr<image_scanner_type> s = get_pooled_scanner();
+            detect(*s, imgs[i], final_dets[i], adjust_threshold);
+            return_pooled_scanner(s);
+        });
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_scanner_type
+        >
+    template <
+        typename image_type
+        >
+    std::vector<std::vector<rectangle> > object_detector<image_scanner_type>::
+    operator() (
+        const std::vector<image_type>& imgs,
+        double adjust_threshold
+    ) 
+    {
+        std::vector<std::vector<rect_detection> > dets;
+        (*this)(imgs,dets,adjust_threshold);
+
+        std::vector<std::vector<rectangle> > final_dets(dets.size());
+        for (unsigned long i = 0; i < dets.size(); ++i)
+        {
+            final_dets[i].resize(dets[i].size());
+            for (unsigned long j = 0; j < dets[i].size(); ++j)
+                final_dets[i][j] = dets[i][j].rect;
+        }
+
+        return final_dets;
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_scanner_type
+        >
+    template <
+        typename image_type
+        >
+    void object_detector<image_scanner_type>::
+    detect (
+        image_scanner_type& scanner,
+        const image_type& img,
+        std::vector<rect_detection>& final_dets,
+        double adjust_threshold
+    ) const
     {
         scanner.load(img);
         std::vector<std::pair<double, rectangle> > dets;
@@ -460,6 +578,44 @@ namespace dlib
         }
     }
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_scanner_type
+        >
+    std::unique_ptr<image_scanner_type> object_detector<image_scanner_type>::
+    get_pooled_scanner (
+    )
+    {
+        std::unique_ptr<image_scanner_type> s;
+        {
+            auto_mutex lock(pool_mutex);
+            if (scanner_pool.size() != 0)
+            {
+                s = std::move(scanner_pool.back());
+                scanner_pool.pop_back();
+                return s;
+            }
+        }
+        s.reset(new image_scanner_type);
+        s->copy_configuration(scanner);
+        return s;
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_scanner_type
+        >
+    void object_detector<image_scanner_type>::
+    return_pooled_scanner (
+        std::unique_ptr<image_scanner_type>& s
+    )
+    {
+        auto_mutex lock(pool_mutex);
+        scanner_pool.push_back(std::move(s));
+    }
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -366,6 +366,52 @@ namespace dlib
                   it doesn't include a double valued score.  That is, it just outputs the
                   full_object_detections.
         !*/
+
+        template <
+            typename image_type
+            >
+        void operator() (
+            const std::vector<image_type>& imgs,
+            std::vector<std::vector<rect_detection> >& dets,
+            double adjust_threshold = 0
+        );
+        /*!
+            requires
+                - each element of imgs == an object which can be accepted by
+                  image_scanner_type::load()
+            ensures
+                - Performs object detection on all the images in imgs.  The images are
+                  processed in parallel using the threads in default_thread_pool().
+                - #dets.size() == imgs.size()
+                - for all valid i: #dets[i] is exactly what calling
+                  (*this)(imgs[i], dets[i], adjust_threshold) would have output.
+                - Unlike the single image versions of operator(), this function doesn't
+                  load any image into #get_scanner().  Instead, it uses copies of the
+                  scanner's configuration.  These copies are kept inside this object and
+                  reused by later calls, so calling this function repeatedly doesn't keep
+                  allocating new memory for image pyramids and feature maps.
+                - It is not safe to call this function on the same object_detector from
+                  multiple threads at once.
+        !*/
+
+        template <
+            typename image_type
+            >
+        std::vector<std::vector<rectangle> > operator() (
+            const std::vector<image_type>& imgs,
+            double adjust_threshold = 0
+        );
+        /*!
+            requires
+                - each element of imgs == an object which can be accepted by
+                  image_scanner_type::load()
+            ensures
+                - This function is identical to the above operator() routine, except that
+                  it returns just the bounding boxes of the detections.  That is, it
+                  returns a vector V such that V.size() == imgs.size() and V[i] contains
+                  the bounding boxes that (*this)(imgs[i], adjust_threshold) would have
+                  returned.
+        !*/
     };
 
 // ----------------------------------------------------------------------------------------
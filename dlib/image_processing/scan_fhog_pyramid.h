@@ -9,6 +9,7 @@
 #include "../array.h"
 #include "../array2d.h"
 #include "object_detector.h"
+#include "../threads.h"
 
 namespace dlib
 {
@@ -323,6 +324,16 @@ namespace dlib
             nuclear_norm_regularization_strength = strength;
         }
 
+        void enable_parallel_processing (
+            thread_pool& tp = default_thread_pool()
+        ) { pool = &tp; }
+
+        void disable_parallel_processing (
+        ) { pool = 0; }
+
+        thread_pool* get_thread_pool (
+        ) const { return pool; }
+
         unsigned long get_fhog_window_width (
         ) const 
         {
@@ -393,6 +404,7 @@ namespace dlib
         unsigned long min_pyramid_layer_width;
         unsigned long min_pyramid_layer_height;
         double nuclear_norm_regularization_strength;
+        thread_pool* pool;
 
         void init()
         {
@@ -404,6 +416,7 @@ namespace dlib
             min_pyramid_layer_width = 64;
             min_pyramid_layer_height = 64;
             nuclear_norm_regularization_strength = 0;
+            pool = 0;
         }
 
     };
@@ -412,10 +425,10 @@ namespace dlib
 
     namespace impl
     {
-        template <typename fhog_filterbank>
+        template <typename fhog_filterbank, typename fhog_planes>
         rectangle apply_filters_to_fhog (
             const fhog_filterbank& w,
-            const array<array2d<float> >& feats,
+            const fhog_planes& feats,
             array2d<float>& saliency_image
         )
         {
@@ -454,7 +467,7 @@ namespace dlib
                 }
                 if (saliency_image.size() == 0)
                 {
-                    saliency_image.set_size(feats[0].nr(), feats[0].nc());
+                    saliency_image.set_size(num_rows(feats[0]), num_columns(feats[0]));
                     assign_all_pixels(saliency_image, 0);
                 }
             }
@@ -569,7 +582,8 @@ namespace dlib
             int filter_cols_padding,
             unsigned long min_pyramid_layer_width,
             unsigned long min_pyramid_layer_height,
-            unsigned long max_pyramid_levels
+            unsigned long max_pyramid_levels,
+            thread_pool* tp = 0
         )
         {
             unsigned long levels = 0;
@@ -588,7 +602,33 @@ namespace dlib
                 feats.set_max_size(levels);
             feats.set_size(levels);
 
+            typedef typename image_traits<image_type>::pixel_type pixel_type;
 
+            if (tp && tp->num_threads_in_pool() > 1 && feats.size() > 1)
+            {
+                // Each level is made from the one above it so the downsampling has to be
+                // done in order.  But it's cheap compared to the fHOG extraction, so we
+                // make all the levels first and then extract features from them in
+                // parallel.
+                array<array2d<pixel_type> > levels_imgs;
+                levels_imgs.set_max_size(feats.size()-1);
+                levels_imgs.set_size(feats.size()-1);
+                pyr(img, levels_imgs[0]);
+                for (unsigned long i = 1; i < levels_imgs.size(); ++i)
+                    pyr(levels_imgs[i-1], levels_imgs[i]);
+
+                parallel_for(*tp, 0, feats.size(), [&](long i)
+                {
+                    if (i == 0)
+                        fe(img, feats[0], cell_size,filter_rows_padding,filter_cols_padding);
+                    else
+                        fe(levels_imgs[i-1], feats[i], cell_size,filter_rows_padding,filter_cols_padding);
+                });
+                DLIB_ASSERT(feats[0].size() == fe.get_num_planes(), 
+                    "Invalid feature extractor used with dlib::scan_fhog_pyramid.  The output does not have the \n"
+                    "indicated number of planes.");
+                return;
+            }
 
             // build our feature pyramid
             fe(img, feats[0], cell_size,filter_rows_padding,filter_cols_padding);
@@ -598,7 +638,6 @@ namespace dlib
 
             if (feats.size() > 1)
             {
-                typedef typename image_traits<image_type>::pixel_type pixel_type;
                 array2d<pixel_type> temp1, temp2;
                 pyr(img, temp1);
                 fe(temp1, feats[1], cell_size,filter_rows_padding,filter_cols_padding);
@@ -632,7 +671,7 @@ namespace dlib
         compute_fhog_window_size(width,height);
         impl::create_fhog_pyramid<Pyramid_type>(img, fe, feats, cell_size, height,
             width, min_pyramid_layer_width, min_pyramid_layer_height,
-            max_pyramid_levels);
+            max_pyramid_levels, pool);
     }
 
 // ----------------------------------------------------------------------------------------
@@ -667,6 +706,7 @@ namespace dlib
         min_pyramid_layer_width = item.min_pyramid_layer_width;
         min_pyramid_layer_height = item.min_pyramid_layer_height;
         nuclear_norm_regularization_strength = item.nuclear_norm_regularization_strength;
+        pool = item.pool;
         fe = item.fe;
     }
 
@@ -758,13 +798,22 @@ namespace dlib
             return a.first < b.first;
         }
 
+        // The fHOG rows top through bottom, inclusive, of one pyramid level.
+        struct fhog_band
+        {
+            unsigned long level;
+            long top;
+            long bottom;
+        };
+
         template <
             typename pyramid_type,
             typename feature_extractor_type,
             typename fhog_filterbank
             >
-        void detect_from_fhog_pyramid (
+        void detect_in_fhog_band (
             const array<array<array2d<float> > >& feats,
+            const fhog_band& band,
             const feature_extractor_type& fe,
             const fhog_filterbank& w,
             const double thresh,
@@ -773,34 +822,118 @@ namespace dlib
             const int cell_size,
             const int filter_rows_padding,
             const int filter_cols_padding,
+            array2d<float>& saliency_image,
             std::vector<std::pair<double, rectangle> >& dets
-        ) 
+        )
         {
-            dets.clear();
-
-            array2d<float> saliency_image;
+            const array<array2d<float> >& level_feats = feats[band.level];
+            const rectangle band_rect(0, band.top, level_feats[0].nc()-1, band.bottom);
+            std::vector<const_sub_image_proxy<array2d<float> > > planes;
+            planes.reserve(level_feats.size());
+            for (unsigned long i = 0; i < level_feats.size(); ++i)
+                planes.push_back(const_sub_image_proxy<array2d<float> >(level_feats[i], band_rect));
+
+            const rectangle area = apply_filters_to_fhog(w, planes, saliency_image);
             pyramid_type pyr;
 
-            // for all pyramid levels
-            for (unsigned long l = 0; l < feats.size(); ++l)
+            // now search the saliency image for any detections
+            for (long r = area.top(); r <= area.bottom(); ++r)
             {
-                const rectangle area = apply_filters_to_fhog(w, feats[l], saliency_image);
+                for (long c = area.left(); c <= area.right(); ++c)
+                {
+                    // if we found a detection
+                    if (saliency_image[r][c] >= thresh)
+                    {
+                        rectangle rect = fe.feats_to_image(centered_rect(point(c,r+band.top),det_box_width,det_box_height), 
+                            cell_size, filter_rows_padding, filter_cols_padding);
+                        rect = pyr.rect_up(rect, band.level);
+                        dets.push_back(std::make_pair(saliency_image[r][c], rect));
+                    }
+                }
+            }
+        }
+
+        template <
+            typename pyramid_type,
+            typename feature_extractor_type,
+            typename fhog_filterbank
+            >
+        void detect_from_fhog_pyramid (
+            const array<array<array2d<float> > >& feats,
+            const feature_extractor_type& fe,
+            const fhog_filterbank& w,
+            const double thresh,
+            const unsigned long det_box_height,
+            const unsigned long det_box_width,
+            const int cell_size,
+            const int filter_rows_padding,
+            const int filter_cols_padding,
+            std::vector<std::pair<double, rectangle> >& dets,
+            thread_pool* tp = 0
+        ) 
+        {
+            dets.clear();
 
-                // now search the saliency image for any detections
-                for (long r = area.top(); r <= area.bottom(); ++r)
+            if (!tp || tp->num_threads_in_pool() <= 1)
+            {
+                array2d<float> saliency_image;
+                // for all pyramid levels
+                for (unsigned long l = 0; l < feats.size(); ++l)
+                {
+                    const fhog_band band = {l, 0, feats[l][0].nr()-1};
+                    detect_in_fhog_band<pyramid_type>(feats, band, fe, w, thresh, det_box_height,
+                        det_box_width, cell_size, filter_rows_padding, filter_cols_padding,
+                        saliency_image, dets);
+                }
+            }
+            else
+            {
+                // Split the levels into horizontal bands so that the threads have about the
+                // same amount of work to do even though the first level is much bigger
+                // than the others.  Each band includes the extra rows above and below it
+                // that the filters need, so every saliency value is computed exactly as it
+                // would be when filtering the whole level.
+                const long filter_nr = w.filters[0].nr();
+                const long top_border = filter_nr/2;
+                const long bottom_border = (filter_nr-1)/2;
+                long total_rows = 0;
+                for (unsigned long l = 0; l < feats.size(); ++l)
+                    total_rows += std::max<long>(0, feats[l][0].nr()-filter_nr+1);
+                const long band_rows = std::max<long>(16, total_rows/(4*tp->num_threads_in_pool()));
+
+                std::vector<fhog_band> bands;
+                for (unsigned long l = 0; l < feats.size(); ++l)
                 {
-                    for (long c = area.left(); c <= area.right(); ++c)
+                    const long valid_rows = feats[l][0].nr()-filter_nr+1;
+                    if (valid_rows < 2*band_rows)
+                    {
+                        const fhog_band band = {l, 0, feats[l][0].nr()-1};
+                        bands.push_back(band);
+                        continue;
+                    }
+                    const long num_bands = valid_rows/band_rows;
+                    for (long b = 0; b < num_bands; ++b)
                     {
-                        // if we found a detection
-                        if (saliency_image[r][c] >= thresh)
-                        {
-                            rectangle rect = fe.feats_to_image(centered_rect(point(c,r),det_box_width,det_box_height), 
-                                cell_size, filter_rows_padding, filter_cols_padding);
-                            rect = pyr.rect_up(rect, l);
-                            dets.push_back(std::make_pair(saliency_image[r][c], rect));
-                        }
+                        const long first = top_border + valid_rows*b/num_bands;
+                        const long last = top_border + valid_rows*(b+1)/num_bands - 1;
+                        const fhog_band band = {l, first-top_border, last+bottom_border};
+                        bands.push_back(band);
                     }
                 }
+
+                std::vector<std::vector<std::pair<double, rectangle> > > band_dets(bands.size());
+                parallel_for(*tp, 0, bands.size(), [&](long i)
+                {
+                    array2d<float> saliency_image;
+                    detect_in_fhog_band<pyramid_type>(feats, bands[i], fe, w, thresh, det_box_height,
+                        det_box_width, cell_size, filter_rows_padding, filter_cols_padding,
+                        saliency_image, band_dets[i]);
+                });
+
+                // Put the detections together in the same order the serial code finds
+                // them so the sort below gives exactly the same output.
+                for (unsigned long i = 0; i < band_dets.size(); ++i)
+                    dets.insert(dets.end(), band_dets[i].begin(), band_dets[i].end());
             }
 
             std::sort(dets.rbegin(), dets.rend(), compare_pair_rect);
@@ -852,7 +985,7 @@ namespace dlib
         compute_fhog_window_size(width,height);
 
         impl::detect_from_fhog_pyramid<pyramid_type>(feats, fe, w, thresh,
-            height-2*padding, width-2*padding, cell_size, height, width, dets);
+            height-2*padding, width-2*padding, cell_size, height, width, dets, pool);
     }
 
 // ----------------------------------------------------------------------------------------
@@ -1234,6 +1367,7 @@ namespace dlib
             return;
 
         const unsigned long cell_size = detectors[0].get_scanner().get_cell_size();
+        thread_pool* tp = detectors[0].get_scanner().get_thread_pool();
 
         // Find the maximum sized filters and also most extreme pyramiding settings used.
         unsigned long max_filter_width = 0;
@@ -1265,7 +1399,7 @@ namespace dlib
             impl::create_fhog_pyramid<pyramid_type>(img,
                 detectors[0].get_scanner().get_feature_extractor(), feats, cell_size,
                 max_filter_height, max_filter_width, min_pyramid_layer_width,
-                min_pyramid_layer_height, max_pyramid_levels);
+                min_pyramid_layer_height, max_pyramid_levels, tp);
         }
 
         std::vector<std::pair<double, rectangle> > temp_dets;
@@ -1277,7 +1411,7 @@ namespace dlib
                 impl::create_fhog_pyramid<pyramid_type>(img,
                     scanner.get_feature_extractor(), feats, scanner.get_cell_size(),
                     max_filter_height, max_filter_width, min_pyramid_layer_width,
-                    min_pyramid_layer_height, max_pyramid_levels);
+                    min_pyramid_layer_height, max_pyramid_levels, tp);
             }
 
             const unsigned long det_box_width  = scanner.get_fhog_window_width()  - 2*scanner.get_padding();
@@ -1291,7 +1425,7 @@ namespace dlib
                 impl::detect_from_fhog_pyramid<pyramid_type>(feats, scanner.get_feature_extractor(),
                     detectors[i].get_processed_w(d).get_detect_argument(), thresh+adjust_threshold,
                     det_box_height, det_box_width, cell_size, max_filter_height,
-                    max_filter_width, temp_dets);
+                    max_filter_width, temp_dets, tp);
 
                 for (unsigned long j = 0; j < temp_dets.size(); ++j)
                 {
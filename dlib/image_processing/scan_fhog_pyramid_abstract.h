@@ -6,6 +6,8 @@
 #include <vector>
 #include "../image_transforms/fhog_abstract.h"
 #include "object_detector_abstract.h"
+#include "../threads/thread_pool_extension_abstract.h"
+#include "../threads/async_abstract.h"
 
 namespace dlib
 {
@@ -672,6 +674,40 @@ namespace dlib
                 - #get_nuclear_norm_regularization_strength() == strength
         !*/
 
+        thread_pool* get_thread_pool (
+        ) const;
+        /*!
+            ensures
+                - returns a pointer to the thread pool used by load() and detect(), or 0 if
+                  they run entirely in the calling thread.  A newly constructed
+                  scan_fhog_pyramid doesn't use a thread pool.
+        !*/
+
+        void enable_parallel_processing (
+            thread_pool& tp = default_thread_pool()
+        );
+        /*!
+            requires
+                - tp remains valid for as long as this object, or any object that copies
+                  its configuration, uses it.
+            ensures
+                - #get_thread_pool() == &tp
+                - load() will extract the fHOG features of the pyramid levels in parallel
+                  and detect() will scan the levels, split into horizontal stripes, in
+                  parallel.  This lowers the time it takes to process a single image.  The
+                  outputs are exactly the same as without parallel processing.
+                - If tp has fewer than 2 threads then everything still runs in the calling
+                  thread.
+                - Note that the thread pool isn't part of the state saved by serialize().
+        !*/
+
+        void disable_parallel_processing (
+        );
+        /*!
+            ensures
+                - #get_thread_pool() == 0
+        !*/
+
     };
 
 // ----------------------------------------------------------------------------------------
@@ -11,6 +11,9 @@
 #include "../pixel.h"
 #include "../console_progress_indicator.h"
 #include "../statistics.h"
+#include "../simd.h"
+#include "../uintn.h"
+#include "../threads.h"
 #include <utility>
 
 namespace dlib
@@ -101,6 +104,169 @@ namespace dlib
             }
         };
 
+    // ------------------------------------------------------------------------------------
+
+        class flat_forest
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This object holds the same trees as a std::vector<regression_tree> but
+                    stores them in a few contiguous arrays rather than in lots of small
+                    heap allocated vectors and matrices.  The splits of all the trees are
+                    kept in three parallel arrays and all the leaf vectors are packed one
+                    after another into a single array of floats.  This makes evaluating
+                    the forest much more cache friendly.  It also lets us add the leaf
+                    vectors to the current shape with SIMD instructions.
+
+                    The leaves of the trees are numbered consecutively, so the leaves of
+                    tree i are numbered leaf_start[i] through leaf_start[i+1]-1.
+            !*/
+        public:
+
+            flat_forest(
+            ) : leaf_size(0) 
+            {
+                split_start.push_back(0);
+                leaf_start.push_back(0);
+            }
+
+            explicit flat_forest (
+                const std::vector<regression_tree>& trees
+            ) : leaf_size(0)
+            {
+                split_start.push_back(0);
+                leaf_start.push_back(0);
+                for (unsigned long i = 0; i < trees.size(); ++i)
+                {
+                    const regression_tree& tree = trees[i];
+                    for (unsigned long j = 0; j < tree.splits.size(); ++j)
+                    {
+                        idx1.push_back(tree.splits[j].idx1);
+                        idx2.push_back(tree.splits[j].idx2);
+                        thresh.push_back(tree.splits[j].thresh);
+                    }
+                    split_start.push_back(idx1.size());
+
+                    for (unsigned long j = 0; j < tree.leaf_values.size(); ++j)
+                    {
+                        DLIB_ASSERT(leaf_values.size() == 0 || tree.leaf_values[j].size() == (long)leaf_size, "");
+                        leaf_size = tree.leaf_values[j].size();
+                        leaf_values.insert(leaf_values.end(), tree.leaf_values[j].begin(), tree.leaf_values[j].end());
+                    }
+                    leaf_start.push_back(leaf_start.back() + tree.leaf_values.size());
+                }
+            }
+
+            std::vector<regression_tree> get_trees (
+            ) const
+            /*!
+                ensures
+                    - converts this object back into the trees it was made from.
+            !*/
+            {
+                std::vector<regression_tree> trees(num_trees());
+                for (unsigned long i = 0; i < trees.size(); ++i)
+                {
+                    for (unsigned long j = split_start[i]; j < split_start[i+1]; ++j)
+                    {
+                        split_feature split;
+                        split.idx1 = idx1[j];
+                        split.idx2 = idx2[j];
+                        split.thresh = thresh[j];
+                        trees[i].splits.push_back(split);
+                    }
+                    for (unsigned long j = leaf_start[i]; j < leaf_start[i+1]; ++j)
+                    {
+                        const float* leaf = leaf_values.data() + j*leaf_size;
+                        trees[i].leaf_values.push_back(dlib::mat(leaf, (long)leaf_size));
+                    }
+                }
+                return trees;
+            }
+
+            unsigned long num_trees (
+            ) const { return split_start.size()-1; }
+
+            unsigned long num_leaves (
+            ) const { return leaf_start.back(); }
+
+            void find_leaves (
+                const std::vector<float>& feature_pixel_values,
+                std::vector<unsigned long>& leaves
+            ) const
+            /*!
+                requires
+                    - All the index values in the splits are less than
+                      feature_pixel_values.size()
+                ensures
+                    - #leaves.size() == num_trees()
+                    - #leaves[i] == the leaf tree i ends up in, numbered as described
+                      above.  This is the same leaf regression_tree::operator() picks.
+            !*/
+            {
+                leaves.resize(num_trees());
+                const float* fpv = feature_pixel_values.data();
+                for (unsigned long t = 0; t < leaves.size(); ++t)
+                {
+                    const uint32* i1 = idx1.data() + split_start[t];
+                    const uint32* i2 = idx2.data() + split_start[t];
+                    const float* th = thresh.data() + split_start[t];
+                    const unsigned long num_splits = split_start[t+1]-split_start[t];
+                    unsigned long i = 0;
+                    while (i < num_splits)
+                    {
+                        if (fpv[i1[i]] - fpv[i2[i]] > th[i])
+                            i = left_child(i);
+                        else
+                            i = right_child(i);
+                    }
+                    leaves[t] = leaf_start[t] + i - num_splits;
+                }
+            }
+
+            void add_leaf_values (
+                const std::vector<unsigned long>& leaves,
+                matrix<float,0,1>& shape
+            ) const
+            /*!
+                requires
+                    - shape.size() == the size of the leaf vectors
+                    - all elements of leaves are < num_leaves()
+                ensures
+                    - adds the leaf vectors identified by leaves to shape.  They are
+                      added one at a time in order, so the floating point results are
+                      identical to adding the regression_tree outputs one after another.
+            !*/
+            {
+                float* out = &shape(0);
+                for (unsigned long t = 0; t < leaves.size(); ++t)
+                {
+                    const float* leaf = leaf_values.data() + leaves[t]*leaf_size;
+                    unsigned long k = 0;
+                    for (; k+8 <= leaf_size; k += 8)
+                    {
+                        simd8f a, b;
+                        a.load(out+k);
+                        b.load(leaf+k);
+                        a += b;
+                        a.store(out+k);
+                    }
+                    for (; k < leaf_size; ++k)
+                        out[k] += leaf[k];
+                }
+            }
+
+        private:
+
+            std::vector<uint32> idx1;
+            std::vector<uint32> idx2;
+            std::vector<float> thresh;
+            std::vector<unsigned long> split_start;
+            std::vector<unsigned long> leaf_start;
+            std::vector<float> leaf_values;
+            unsigned long leaf_size;
+        };
+
     // ------------------------------------------------------------------------------------
 
         inline vector<float,2> location (
@@ -238,7 +404,7 @@ namespace dlib
         template <typename image_type, typename feature_type>
         void extract_feature_pixel_values (
             const image_type& img_,
-            const rectangle& rect,
+            const point_transform_affine& tform_to_img,
             const matrix<float,0,1>& current_shape,
             const matrix<float,0,1>& reference_shape,
             const std::vector<unsigned long>& reference_pixel_anchor_idx,
@@ -259,11 +425,12 @@ namespace dlib
                     - #feature_pixel_values[i] == the value of the pixel in img_ that
                       corresponds to the pixel identified by reference_pixel_anchor_idx[i]
                       and reference_pixel_deltas[i] when the pixel is located relative to
-                      current_shape rather than reference_shape.
+                      current_shape rather than reference_shape.  tform_to_img maps the
+                      normalized shape space into img_, i.e. it is the
+                      unnormalizing_tform() of the object's bounding box.
         !*/
         {
             const matrix<float,2,2> tform = matrix_cast<float>(find_tform_between_shapes(reference_shape, current_shape).get_m());
-            const point_transform_affine tform_to_img = unnormalizing_tform(rect);
 
             const rectangle area = get_rect(img_);
 
@@ -281,6 +448,28 @@ namespace dlib
             }
         }
 
+        template <typename image_type, typename feature_type>
+        void extract_feature_pixel_values (
+            const image_type& img_,
+            const rectangle& rect,
+            const matrix<float,0,1>& current_shape,
+            const matrix<float,0,1>& reference_shape,
+            const std::vector<unsigned long>& reference_pixel_anchor_idx,
+            const std::vector<dlib::vector<float,2> >& reference_pixel_deltas,
+            std::vector<feature_type>& feature_pixel_values
+        )
+        /*!
+            ensures
+                - This function is identical to the one above except that it takes the
+                  bounding rectangle of the object and uses unnormalizing_tform(rect) as
+                  tform_to_img.
+        !*/
+        {
+            extract_feature_pixel_values(img_, unnormalizing_tform(rect), current_shape,
+                reference_shape, reference_pixel_anchor_idx, reference_pixel_deltas,
+                feature_pixel_values);
+        }
+
     } // end namespace impl
 
 // ----------------------------------------------------------------------------------------
@@ -298,7 +487,7 @@ namespace dlib
             const matrix<float,0,1>& initial_shape_,
             const std::vector<std::vector<impl::regression_tree> >& forests_,
             const std::vector<std::vector<dlib::vector<float,2> > >& pixel_coordinates
-        ) : initial_shape(initial_shape_), forests(forests_)
+        ) : initial_shape(initial_shape_)
         /*!
             requires
                 - initial_shape.size()%2 == 0
@@ -312,6 +501,8 @@ namespace dlib
                       (i.e. there need to be the right number of leaves given the number of splits in the tree)
         !*/
         {
+            for (unsigned long i = 0; i < forests_.size(); ++i)
+                forests.push_back(impl::flat_forest(forests_[i]));
             anchor_idx.resize(pixel_coordinates.size());
             deltas.resize(pixel_coordinates.size());
             // Each cascade uses a different set of pixels for its features.  We compute
@@ -331,8 +522,7 @@ namespace dlib
         {
             unsigned long num = 0;
             for (unsigned long iter = 0; iter < forests.size(); ++iter)
-                for (unsigned long i = 0; i < forests[iter].size(); ++i)
-                    num += forests[iter][i].num_leaves();
+                num += forests[iter].num_leaves();
             return num;
         }
 
@@ -342,25 +532,57 @@ namespace dlib
             const rectangle& rect
         ) const
         {
-            using namespace impl;
-            matrix<float,0,1> current_shape = initial_shape;
-            std::vector<float> feature_pixel_values;
-            for (unsigned long iter = 0; iter < forests.size(); ++iter)
+            prediction_buffers buf;
+            full_object_detection det;
+            predict(img, rect, buf, det);
+            return det;
+        }
+
+        template <typename image_type>
+        std::vector<full_object_detection> operator()(
+            const image_type& img,
+            const std::vector<rectangle>& rects
+        ) const
+        {
+            std::vector<full_object_detection> dets(rects.size());
+            parallel_for_blocked(default_thread_pool(), 0, rects.size(), [&](long begin, long end)
             {
-                extract_feature_pixel_values(img, rect, current_shape, initial_shape,
-                                             anchor_idx[iter], deltas[iter], feature_pixel_values);
-                unsigned long leaf_idx;
-                // evaluate all the trees at this level of the cascade.
-                for (unsigned long i = 0; i < forests[iter].size(); ++i)
-                    current_shape += forests[iter][i](feature_pixel_values, leaf_idx);
-            }
+                prediction_buffers buf;
+                for (long i = begin; i < end; ++i)
+                    predict(img, rects[i], buf, dets[i]);
+            });
+            return dets;
+        }
 
-            // convert the current_shape into a full_object_detection
-            const point_transform_affine tform_to_img = unnormalizing_tform(rect);
-            std::vector<point> parts(current_shape.size()/2);
-            for (unsigned long i = 0; i < parts.size(); ++i)
-                parts[i] = tform_to_img(location(current_shape, i));
-            return full_object_detection(rect, parts);
+        template <typename image_type>
+        std::vector<std::vector<full_object_detection> > operator()(
+            const std::vector<image_type>& imgs,
+            const std::vector<std::vector<rectangle> >& rects
+        ) const
+        {
+            DLIB_ASSERT(imgs.size() == rects.size(), "");
+            // Run over all the rectangles of all the images as one list so the work is
+            // spread evenly over the threads no matter how the faces are distributed
+            // among the images.
+            std::vector<std::pair<unsigned long,unsigned long> > jobs;
+            std::vector<std::vector<full_object_detection> > dets(rects.size());
+            for (unsigned long i = 0; i < rects.size(); ++i)
+            {
+                dets[i].resize(rects[i].size());
+                for (unsigned long j = 0; j < rects[i].size(); ++j)
+                    jobs.push_back(std::make_pair(i,j));
+            }
+            parallel_for_blocked(default_thread_pool(), 0, jobs.size(), [&](long begin, long end)
+            {
+                prediction_buffers buf;
+                for (long k = begin; k < end; ++k)
+                {
+                    const unsigned long i = jobs[k].first;
+                    const unsigned long j = jobs[k].second;
+                    predict(imgs[i], rects[i][j], buf, dets[i][j]);
+                }
+            });
+            return dets;
         }
 
         template <typename image_type, typename T, typename U>
@@ -372,26 +594,24 @@ namespace dlib
         {
             feats.clear();
             using namespace impl;
+            const point_transform_affine tform_to_img = unnormalizing_tform(rect);
             matrix<float,0,1> current_shape = initial_shape;
             std::vector<float> feature_pixel_values;
+            std::vector<unsigned long> leaves;
             unsigned long feat_offset = 0;
             for (unsigned long iter = 0; iter < forests.size(); ++iter)
             {
-                extract_feature_pixel_values(img, rect, current_shape, initial_shape,
+                extract_feature_pixel_values(img, tform_to_img, current_shape, initial_shape,
                                              anchor_idx[iter], deltas[iter], feature_pixel_values);
                 // evaluate all the trees at this level of the cascade.
-                for (unsigned long i = 0; i < forests[iter].size(); ++i)
-                {
-                    unsigned long leaf_idx;
-                    current_shape += forests[iter][i](feature_pixel_values, leaf_idx);
-
-                    feats.push_back(std::make_pair(feat_offset+leaf_idx, 1));
-                    feat_offset += forests[iter][i].num_leaves();
-                }
+                forests[iter].find_leaves(feature_pixel_values, leaves);
+                forests[iter].add_leaf_values(leaves, current_shape);
+                for (unsigned long i = 0; i < leaves.size(); ++i)
+                    feats.push_back(std::make_pair(feat_offset+leaves[i], 1));
+                feat_offset += forests[iter].num_leaves();
             }
 
             // convert the current_shape into a full_object_detection
-            const point_transform_affine tform_to_img = unnormalizing_tform(rect);
             std::vector<point> parts(current_shape.size()/2);
             for (unsigned long i = 0; i < parts.size(); ++i)
                 parts[i] = tform_to_img(location(current_shape, i));
@@ -403,8 +623,50 @@ namespace dlib
         friend void deserialize (shape_predictor& item, std::istream& in);
 
     private:
+
+        struct prediction_buffers
+        {
+            matrix<float,0,1> current_shape;
+            std::vector<float> feature_pixel_values;
+            std::vector<unsigned long> leaves;
+            std::vector<point> parts;
+        };
+
+        template <typename image_type>
+        void predict (
+            const image_type& img,
+            const rectangle& rect,
+            prediction_buffers& buf,
+            full_object_detection& det
+        ) const
+        /*!
+            ensures
+                - #det == (*this)(img, rect)
+                - buf is used as scratch space.  Reusing it between calls avoids
+                  allocating memory for each prediction.
+        !*/
+        {
+            using namespace impl;
+            const point_transform_affine tform_to_img = unnormalizing_tform(rect);
+            buf.current_shape = initial_shape;
+            for (unsigned long iter = 0; iter < forests.size(); ++iter)
+            {
+                extract_feature_pixel_values(img, tform_to_img, buf.current_shape, initial_shape,
+                                             anchor_idx[iter], deltas[iter], buf.feature_pixel_values);
+                // evaluate all the trees at this level of the cascade.
+                forests[iter].find_leaves(buf.feature_pixel_values, buf.leaves);
+                forests[iter].add_leaf_values(buf.leaves, buf.current_shape);
+            }
+
+            // convert the current_shape into a full_object_detection
+            buf.parts.resize(buf.current_shape.size()/2);
+            for (unsigned long i = 0; i < buf.parts.size(); ++i)
+                buf.parts[i] = tform_to_img(location(buf.current_shape, i));
+            det = full_object_detection(rect, buf.parts);
+        }
+
         matrix<float,0,1> initial_shape;
-        std::vector<std::vector<impl::regression_tree> > forests;
+        std::vector<impl::flat_forest> forests;
         std::vector<std::vector<unsigned long> > anchor_idx; 
         std::vector<std::vector<dlib::vector<float,2> > > deltas;
     };
@@ -414,7 +676,12 @@ namespace dlib
         int version = 1;
         dlib::serialize(version, out);
         dlib::serialize(item.initial_shape, out);
-        dlib::serialize(item.forests, out);
+        // The forests are saved as std::vector<std::vector<impl::regression_tree> > so
+        // the file format doesn't depend on how they are stored in memory.
+        const unsigned long num_cascades = item.forests.size();
+        dlib::serialize(num_cascades, out);
+        for (unsigned long i = 0; i < item.forests.size(); ++i)
+            dlib::serialize(item.forests[i].get_trees(), out);
         dlib::serialize(item.anchor_idx, out);
         dlib::serialize(item.deltas, out);
     }
@@ -426,7 +693,17 @@ namespace dlib
         if (version != 1)
             abort();
         dlib::deserialize(item.initial_shape, in);
-        dlib::deserialize(item.forests, in);
+        // Convert the forests into their flat form one cascade level at a time so we
+        // never have two copies of the whole model in memory.
+        unsigned long num_cascades = 0;
+        dlib::deserialize(num_cascades, in);
+        item.forests.resize(num_cascades);
+        std::vector<impl::regression_tree> trees;
+        for (unsigned long i = 0; i < item.forests.size(); ++i)
+        {
+            dlib::deserialize(trees, in);
+            item.forests[i] = impl::flat_forest(trees);
+        }
         dlib::deserialize(item.anchor_idx, in);
         dlib::deserialize(item.deltas, in);
     }
@@ -111,6 +111,47 @@ namespace dlib
                   where the 3d argument is discarded.
         !*/
 
+        template <typename image_type>
+        std::vector<full_object_detection> operator()(
+            const image_type& img,
+            const std::vector<rectangle>& rects
+        ) const;
+        /*!
+            requires
+                - image_type == an image object that implements the interface defined in
+                  dlib/image_processing/generic_image.h 
+            ensures
+                - Runs the shape predictor on each of the given rectangles in img and
+                  returns the results.  That is, returns a vector DETS such that:
+                    - DETS.size() == rects.size()
+                    - for all valid i: DETS[i] == (*this)(img, rects[i])
+                - The rectangles are processed in parallel using the threads in
+                  default_thread_pool().  Each thread reuses its scratch buffers for all
+                  the rectangles it processes.
+        !*/
+
+        template <typename image_type>
+        std::vector<std::vector<full_object_detection> > operator()(
+            const std::vector<image_type>& imgs,
+            const std::vector<std::vector<rectangle> >& rects
+        ) const;
+        /*!
+            requires
+                - image_type == an image object that implements the interface defined in
+                  dlib/image_processing/generic_image.h 
+                - imgs.size() == rects.size()
+            ensures
+                - Runs the shape predictor on each of the rectangles rects[i] in imgs[i]
+                  and returns the results.  That is, returns a vector DETS such that:
+                    - DETS.size() == rects.size()
+                    - for all valid i:
+                        - DETS[i].size() == rects[i].size()
+                        - for all valid j: DETS[i][j] == (*this)(imgs[i], rects[i][j])
+                - The rectangles of all the images are processed together, in parallel,
+                  using the threads in default_thread_pool().  Note that the output of
+                  object_detector's batch operator() can be given directly as rects.
+        !*/
+
     };
 
     void serialize (const shape_predictor& item, std::ostream& out);
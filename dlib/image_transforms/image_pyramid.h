@@ -8,6 +8,9 @@
 #include "../array2d.h"
 #include "../geometry.h"
 #include "spatial_filtering.h"
+#include "../simd.h"
+#include <vector>
+#include <cstring>
 
 namespace dlib
 {
@@ -147,6 +150,149 @@ namespace dlib
     namespace impl
     {
 
+        template <typename T, typename U>
+        struct is_simd_pyramid_down_2_1
+        {
+            // The pixel types handled by pyramid_down_2_1_simd() below.
+            typedef typename image_traits<T>::pixel_type T_pix;
+            typedef typename image_traits<U>::pixel_type U_pix;
+#ifdef DLIB_HAVE_SSE2
+            const static bool value = is_same_type<T_pix,U_pix>::value && 
+                                      (is_same_type<T_pix,unsigned char>::value ||
+                                       is_same_type<T_pix,rgb_pixel>::value ||
+                                       is_same_type<T_pix,bgr_pixel>::value);
+#else
+            const static bool value = false;
+#endif
+        };
+
+#ifdef DLIB_HAVE_SSE2
+
+        template <
+            typename in_image_type,
+            typename out_image_type
+            >
+        void pyramid_down_2_1_simd (
+            const in_image_type& original_,
+            out_image_type& down_
+        )
+        /*!
+            requires
+                - is_simd_pyramid_down_2_1<in_image_type,out_image_type>::value == true
+                - num_rows(original_) > 8 && num_columns(original_) > 8
+            ensures
+                - computes exactly the same image as the scalar code in
+                  pyramid_down_2_1::operator().  The pixels are treated as a flat array of
+                  bytes so grayscale and RGB images go through the same loops.  The column
+                  filter is applied before the row filter, which gives the same integer
+                  sums, and the row filter is evaluated at every byte so all the loads are
+                  contiguous.  Every sum is below 2^16 so 16 bit lanes are enough.
+        !*/
+        {
+            typedef typename image_traits<in_image_type>::pixel_type pixel_type;
+            const long channels = pixel_traits<pixel_type>::num;
+            COMPILE_TIME_ASSERT(sizeof(pixel_type) == pixel_traits<pixel_type>::num);
+
+            const_image_view<in_image_type> original(original_);
+            image_view<out_image_type> down(down_);
+            down.set_size((original.nr()-3)/2, (original.nc()-3)/2);
+
+            const long row_size = original.nc()*channels;
+            // Only bytes [0,num_filtered) of a filtered row are ever kept.
+            const long num_filtered = row_size - 4*channels;
+            std::vector<uint16> col(row_size);
+            // The padding lets the last SSE2 load in the grayscale copy below run past
+            // num_filtered.
+            std::vector<unsigned char> filtered(num_filtered+16);
+
+            for (long dr = 0; dr < down.nr(); ++dr)
+            {
+                const unsigned char* top    = reinterpret_cast<const unsigned char*>(&original[2*dr][0]);
+                const unsigned char* middle = reinterpret_cast<const unsigned char*>(&original[2*dr+1][0]);
+                const unsigned char* bottom = reinterpret_cast<const unsigned char*>(&original[2*dr+2][0]);
+
+                // apply column filter
+                long i = 0;
+                const __m128i zero = _mm_setzero_si128();
+                for (; i+16 <= row_size; i += 16)
+                {
+                    const __m128i t = _mm_loadu_si128((const __m128i*)(top+i));
+                    const __m128i m = _mm_loadu_si128((const __m128i*)(middle+i));
+                    const __m128i b = _mm_loadu_si128((const __m128i*)(bottom+i));
+                    __m128i t16 = _mm_unpacklo_epi8(t, zero);
+                    __m128i m16 = _mm_unpacklo_epi8(m, zero);
+                    __m128i b16 = _mm_unpacklo_epi8(b, zero);
+                    __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(t16,1), _mm_slli_epi16(m16,3)),
+                                                _mm_add_epi16(_mm_slli_epi16(b16,2), _mm_slli_epi16(b16,1)));
+                    _mm_storeu_si128((__m128i*)(&col[i]), sum);
+                    t16 = _mm_unpackhi_epi8(t, zero);
+                    m16 = _mm_unpackhi_epi8(m, zero);
+                    b16 = _mm_unpackhi_epi8(b, zero);
+                    sum = _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(t16,1), _mm_slli_epi16(m16,3)),
+                                        _mm_add_epi16(_mm_slli_epi16(b16,2), _mm_slli_epi16(b16,1)));
+                    _mm_storeu_si128((__m128i*)(&col[i+8]), sum);
+                }
+                for (; i < row_size; ++i)
+                    col[i] = 2*top[i] + 8*middle[i] + 6*bottom[i];
+
+                // apply row filter
+                const uint16* v = &col[0];
+                const long s = channels;
+                i = 0;
+                for (; i+16 <= num_filtered; i += 16)
+                {
+                    __m128i sum[2];
+                    for (int j = 0; j < 2; ++j)
+                    {
+                        const uint16* p = v + i + 8*j;
+                        const __m128i v0 = _mm_loadu_si128((const __m128i*)(p));
+                        const __m128i v1 = _mm_loadu_si128((const __m128i*)(p+s));
+                        const __m128i v2 = _mm_loadu_si128((const __m128i*)(p+2*s));
+                        const __m128i v3 = _mm_loadu_si128((const __m128i*)(p+3*s));
+                        const __m128i v4 = _mm_loadu_si128((const __m128i*)(p+4*s));
+                        sum[j] = _mm_add_epi16(_mm_add_epi16(v0, v4), 
+                                               _mm_slli_epi16(_mm_add_epi16(v1, v3), 2));
+                        sum[j] = _mm_add_epi16(sum[j], _mm_add_epi16(_mm_slli_epi16(v2,2), _mm_slli_epi16(v2,1)));
+                        sum[j] = _mm_srli_epi16(sum[j], 8);
+                    }
+                    _mm_storeu_si128((__m128i*)(&filtered[i]), _mm_packus_epi16(sum[0], sum[1]));
+                }
+                for (; i < num_filtered; ++i)
+                    filtered[i] = (v[i] + 4*v[i+s] + 6*v[i+2*s] + 4*v[i+3*s] + v[i+4*s])/256;
+
+                // keep every other pixel
+                unsigned char* out = reinterpret_cast<unsigned char*>(&down[dr][0]);
+                const unsigned char* src = &filtered[0];
+                const long out_nc = down.nc();
+                long c = 0;
+                if (channels == 1)
+                {
+                    const __m128i mask = _mm_set1_epi16(0x00FF);
+                    for (; c+16 <= out_nc; c += 16)
+                    {
+                        const __m128i lo = _mm_and_si128(_mm_loadu_si128((const __m128i*)(src+2*c)), mask);
+                        const __m128i hi = _mm_and_si128(_mm_loadu_si128((const __m128i*)(src+2*c+16)), mask);
+                        _mm_storeu_si128((__m128i*)(out+c), _mm_packus_epi16(lo, hi));
+                    }
+                }
+                else
+                {
+                    // Copy 4 bytes per pixel.  The extra byte is overwritten by the next
+                    // pixel.
+                    for (; c+1 < out_nc; ++c)
+                        std::memcpy(out+c*channels, src+2*c*channels, 4);
+                }
+                for (; c < out_nc; ++c)
+                {
+                    for (long k = 0; k < channels; ++k)
+                        out[c*channels+k] = src[2*c*channels+k];
+                }
+            }
+        }
+#endif // DLIB_HAVE_SSE2
+
+// ----------------------------------------------------------------------------------------
+
         class pyramid_down_2_1 : noncopyable
         {
         public:
@@ -243,7 +389,8 @@ namespace dlib
                 typename in_image_type,
                 typename out_image_type
                 >
-            typename disable_if<both_images_rgb<in_image_type,out_image_type> >::type operator() (
+            typename disable_if_c<both_images_rgb<in_image_type,out_image_type>::value ||
+                                  is_simd_pyramid_down_2_1<in_image_type,out_image_type>::value>::type operator() (
                 const in_image_type& original_,
                 out_image_type& down_
             ) const
@@ -344,7 +491,8 @@ namespace dlib
                 typename in_image_type,
                 typename out_image_type
                 >
-            typename enable_if<both_images_rgb<in_image_type,out_image_type> >::type operator() (
+            typename enable_if_c<both_images_rgb<in_image_type,out_image_type>::value &&
+                                 !is_simd_pyramid_down_2_1<in_image_type,out_image_type>::value>::type operator() (
                 const in_image_type& original_,
                 out_image_type& down_
             ) const
@@ -465,6 +613,37 @@ namespace dlib
 
             }
 
+#ifdef DLIB_HAVE_SSE2
+        // ------------------------------------------
+        //  OVERLOAD FOR 8 BIT GRAYSCALE, RGB AND BGR
+        // ------------------------------------------
+            template <
+                typename in_image_type,
+                typename out_image_type
+                >
+            typename enable_if<is_simd_pyramid_down_2_1<in_image_type,out_image_type> >::type operator() (
+                const in_image_type& original_,
+                out_image_type& down_
+            ) const
+            {
+                // make sure requires clause is not broken
+                DLIB_ASSERT( is_same_object(original_, down_) == false, 
+                            "\t void pyramid_down_2_1::operator()"
+                            << "\n\t is_same_object(original_, down_): " << is_same_object(original_, down_) 
+                            << "\n\t this:                           " << this
+                            );
+
+                if (num_rows(original_) <= 8 || num_columns(original_) <= 8)
+                {
+                    image_view<out_image_type> down(down_);
+                    down.clear();
+                    return;
+                }
+
+                pyramid_down_2_1_simd(original_, down_);
+            }
+#endif
+
             template <
                 typename image_type
                 >
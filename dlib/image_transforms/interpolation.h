@@ -9,6 +9,7 @@
 #include "assign_image.h"
 #include "image_pyramid.h"
 #include "../simd.h"
+#include "../threads.h"
 #include "../image_processing/full_object_detection.h"
 
 namespace dlib
@@ -657,322 +658,440 @@ namespace dlib
     template <typename image_type>
     struct is_grayscale_image { const static bool value = pixel_traits<typename image_traits<image_type>::pixel_type>::grayscale; };
 
-    // This is an optimized version of resize_image for the case where bilinear
-    // interpolation is used.
-    template <
-        typename image_type1,
-        typename image_type2
-        >
-    typename disable_if_c<(is_rgb_image<image_type1>::value&&is_rgb_image<image_type2>::value) || 
-                          (is_grayscale_image<image_type1>::value&&is_grayscale_image<image_type2>::value)>::type 
-    resize_image (
-        const image_type1& in_img_,
-        image_type2& out_img_,
-        interpolate_bilinear
-    )
+    namespace impl
     {
-        // make sure requires clause is not broken
-        DLIB_ASSERT( is_same_object(in_img_, out_img_) == false ,
-            "\t void resize_image()"
-            << "\n\t Invalid inputs were given to this function."
-            << "\n\t is_same_object(in_img_, out_img_):  " << is_same_object(in_img_, out_img_)
-            );
+        template <typename image_type1, typename image_type2>
+        struct is_simd_resizable_grayscale 
+        { 
+            // Grayscale pixels that fit into the 32bit lanes of the SIMD bilinear kernel
+            // below.  Anything bigger goes through the double precision scalar kernel.
+            typedef typename image_traits<image_type1>::pixel_type pixel_type;
+            const static bool value = is_same_type<pixel_type,typename image_traits<image_type2>::pixel_type>::value && 
+                                      pixel_traits<pixel_type>::grayscale && 
+                                      sizeof(pixel_type) <= 4;
+        };
 
-        const_image_view<image_type1> in_img(in_img_);
-        image_view<image_type2> out_img(out_img_);
+        template <typename image_type1, typename image_type2>
+        struct is_simd_resizable_rgb 
+        { 
+            typedef typename image_traits<image_type1>::pixel_type pixel_type;
+            const static bool value = is_same_type<pixel_type,typename image_traits<image_type2>::pixel_type>::value && 
+                                      is_rgb_image<image_type1>::value;
+        };
 
-        if (out_img.nr() <= 1 || out_img.nc() <= 1)
+        template <typename T>
+        typename enable_if<is_float_type<T> >::type store_bilinear_pixels (
+            const simd4f& val,
+            T* out
+        )
         {
-            assign_all_pixels(out_img, 0);
-            return;
+            float temp[4];
+            val.store(temp);
+            out[0] = temp[0];
+            out[1] = temp[1];
+            out[2] = temp[2];
+            out[3] = temp[3];
         }
 
+        template <typename T>
+        typename disable_if<is_float_type<T> >::type store_bilinear_pixels (
+            const simd4f& val,
+            T* out
+        )
+        {
+            int32 temp[4];
+            simd4i(val).store(temp);
+            out[0] = static_cast<T>(temp[0]);
+            out[1] = static_cast<T>(temp[1]);
+            out[2] = static_cast<T>(temp[2]);
+            out[3] = static_cast<T>(temp[3]);
+        }
 
-        typedef typename image_traits<image_type1>::pixel_type T;
-        typedef typename image_traits<image_type2>::pixel_type U;
-        const double x_scale = (in_img.nc()-1)/(double)std::max<long>((out_img.nc()-1),1);
-        const double y_scale = (in_img.nr()-1)/(double)std::max<long>((out_img.nr()-1),1);
-        double y = -y_scale;
-        for (long r = 0; r < out_img.nr(); ++r)
+        template <typename funct>
+        void resize_image_rows (
+            long nr,
+            thread_pool* tp,
+            const funct& process_rows
+        )
         {
-            y += y_scale;
-            const long top    = static_cast<long>(std::floor(y));
-            const long bottom = std::min(top+1, in_img.nr()-1);
-            const double tb_frac = y - top;
-            double x = -x_scale;
-            if (pixel_traits<U>::grayscale)
-            {
-                for (long c = 0; c < out_img.nc(); ++c)
-                {
-                    x += x_scale;
-                    const long left   = static_cast<long>(std::floor(x));
-                    const long right  = std::min(left+1, in_img.nc()-1);
-                    const double lr_frac = x - left;
+            // Each output row only depends on the input image so the rows can be
+            // computed in any order.
+            if (tp)
+                parallel_for_blocked(*tp, 0, nr, process_rows);
+            else
+                process_rows(0, nr);
+        }
 
-                    double tl = 0, tr = 0, bl = 0, br = 0;
+        template <
+            typename image_type1,
+            typename image_type2
+            >
+        typename disable_if_c<is_simd_resizable_grayscale<image_type1,image_type2>::value ||
+                              is_simd_resizable_rgb<image_type1,image_type2>::value>::type 
+        resize_image_bilinear (
+            const image_type1& in_img_,
+            image_type2& out_img_,
+            thread_pool* tp
+        )
+        {
+            const_image_view<image_type1> in_img(in_img_);
+            image_view<image_type2> out_img(out_img_);
 
-                    assign_pixel(tl, in_img[top][left]);
-                    assign_pixel(tr, in_img[top][right]);
-                    assign_pixel(bl, in_img[bottom][left]);
-                    assign_pixel(br, in_img[bottom][right]);
+            if (out_img.nr() <= 1 || out_img.nc() <= 1)
+            {
+                assign_all_pixels(out_img, 0);
+                return;
+            }
 
-                    double temp = (1-tb_frac)*((1-lr_frac)*tl + lr_frac*tr) + 
-                        tb_frac*((1-lr_frac)*bl + lr_frac*br);
 
-                    assign_pixel(out_img[r][c], temp);
-                }
-            }
-            else
+            typedef typename image_traits<image_type1>::pixel_type T;
+            typedef typename image_traits<image_type2>::pixel_type U;
+            const double x_scale = (in_img.nc()-1)/(double)std::max<long>((out_img.nc()-1),1);
+            const double y_scale = (in_img.nr()-1)/(double)std::max<long>((out_img.nr()-1),1);
+            resize_image_rows(out_img.nr(), tp, [&](long rbegin, long rend)
             {
-                for (long c = 0; c < out_img.nc(); ++c)
+                for (long r = rbegin; r < rend; ++r)
                 {
-                    x += x_scale;
-                    const long left   = static_cast<long>(std::floor(x));
-                    const long right  = std::min(left+1, in_img.nc()-1);
-                    const double lr_frac = x - left;
-
-                    const T tl = in_img[top][left];
-                    const T tr = in_img[top][right];
-                    const T bl = in_img[bottom][left];
-                    const T br = in_img[bottom][right];
-
-                    T temp;
-                    assign_pixel(temp, 0);
-                    vector_to_pixel(temp, 
-                        (1-tb_frac)*((1-lr_frac)*pixel_to_vector<double>(tl) + lr_frac*pixel_to_vector<double>(tr)) + 
-                            tb_frac*((1-lr_frac)*pixel_to_vector<double>(bl) + lr_frac*pixel_to_vector<double>(br)));
-                    assign_pixel(out_img[r][c], temp);
+                    const double y = r*y_scale;
+                    const long top    = static_cast<long>(std::floor(y));
+                    const long bottom = std::min(top+1, in_img.nr()-1);
+                    const double tb_frac = y - top;
+                    double x = -x_scale;
+                    if (pixel_traits<U>::grayscale)
+                    {
+                        for (long c = 0; c < out_img.nc(); ++c)
+                        {
+                            x += x_scale;
+                            const long left   = static_cast<long>(std::floor(x));
+                            const long right  = std::min(left+1, in_img.nc()-1);
+                            const double lr_frac = x - left;
+
+                            double tl = 0, tr = 0, bl = 0, br = 0;
+
+                            assign_pixel(tl, in_img[top][left]);
+                            assign_pixel(tr, in_img[top][right]);
+                            assign_pixel(bl, in_img[bottom][left]);
+                            assign_pixel(br, in_img[bottom][right]);
+
+                            double temp = (1-tb_frac)*((1-lr_frac)*tl + lr_frac*tr) + 
+                                tb_frac*((1-lr_frac)*bl + lr_frac*br);
+
+                            assign_pixel(out_img[r][c], temp);
+                        }
+                    }
+                    else
+                    {
+                        for (long c = 0; c < out_img.nc(); ++c)
+                        {
+                            x += x_scale;
+                            const long left   = static_cast<long>(std::floor(x));
+                            const long right  = std::min(left+1, in_img.nc()-1);
+                            const double lr_frac = x - left;
+
+                            const T tl = in_img[top][left];
+                            const T tr = in_img[top][right];
+                            const T bl = in_img[bottom][left];
+                            const T br = in_img[bottom][right];
+
+                            T temp;
+                            assign_pixel(temp, 0);
+                            vector_to_pixel(temp, 
+                                (1-tb_frac)*((1-lr_frac)*pixel_to_vector<double>(tl) + lr_frac*pixel_to_vector<double>(tr)) + 
+                                tb_frac*((1-lr_frac)*pixel_to_vector<double>(bl) + lr_frac*pixel_to_vector<double>(br)));
+                            assign_pixel(out_img[r][c], temp);
+                        }
+                    }
                 }
-            }
+            });
         }
-    }
 
-// ----------------------------------------------------------------------------------------
+    // ----------------------------------------------------------------------------------------
 
-    template <
-        typename image_type
-        >
-    typename enable_if<is_grayscale_image<image_type> >::type resize_image (
-        const image_type& in_img_,
-        image_type& out_img_,
-        interpolate_bilinear
-    )
-    {
-        // make sure requires clause is not broken
-        DLIB_ASSERT( is_same_object(in_img_, out_img_) == false ,
-            "\t void resize_image()"
-            << "\n\t Invalid inputs were given to this function."
-            << "\n\t is_same_object(in_img_, out_img_):  " << is_same_object(in_img_, out_img_)
-            );
+        template <
+            typename image_type1,
+            typename image_type2
+            >
+        typename enable_if<is_simd_resizable_grayscale<image_type1,image_type2> >::type resize_image_bilinear (
+            const image_type1& in_img_,
+            image_type2& out_img_,
+            thread_pool* tp
+        )
+        {
+            const_image_view<image_type1> in_img(in_img_);
+            image_view<image_type2> out_img(out_img_);
 
-        const_image_view<image_type> in_img(in_img_);
-        image_view<image_type> out_img(out_img_);
+            if (out_img.nr() <= 1 || out_img.nc() <= 1)
+            {
+                assign_all_pixels(out_img, 0);
+                return;
+            }
 
-        if (out_img.nr() <= 1 || out_img.nc() <= 1)
-        {
-            assign_all_pixels(out_img, 0);
-            return;
+            const double x_scale = (in_img.nc()-1)/(double)std::max<long>((out_img.nc()-1),1);
+            const double y_scale = (in_img.nr()-1)/(double)std::max<long>((out_img.nr()-1),1);
+            resize_image_rows(out_img.nr(), tp, [&](long rbegin, long rend)
+            {
+                for (long r = rbegin; r < rend; ++r)
+                {
+                    const double y = r*y_scale;
+                    const long top    = static_cast<long>(std::floor(y));
+                    const long bottom = std::min(top+1, in_img.nr()-1);
+                    const double tb_frac = y - top;
+                    double x = -4*x_scale;
+
+                    const simd4f _tb_frac = tb_frac;
+                    const simd4f _inv_tb_frac = 1-tb_frac;
+                    const simd4f _x_scale = 4*x_scale;
+                    simd4f _x(x, x+x_scale, x+2*x_scale, x+3*x_scale);
+                    long c = 0;
+                    for (;; c+=4)
+                    {
+                        _x += _x_scale;
+                        simd4i left = simd4i(_x);
+
+                        simd4f _lr_frac = _x-left;
+                        simd4f _inv_lr_frac = 1-_lr_frac; 
+                        simd4i right = left+1;
+
+                        simd4f tlf = _inv_tb_frac*_inv_lr_frac;
+                        simd4f trf = _inv_tb_frac*_lr_frac;
+                        simd4f blf = _tb_frac*_inv_lr_frac;
+                        simd4f brf = _tb_frac*_lr_frac;
+
+                        int32 fleft[4];
+                        int32 fright[4];
+                        left.store(fleft);
+                        right.store(fright);
+
+                        if (fright[3] >= in_img.nc())
+                            break;
+                        simd4f tl(in_img[top][fleft[0]],     in_img[top][fleft[1]],     in_img[top][fleft[2]],     in_img[top][fleft[3]]);
+                        simd4f tr(in_img[top][fright[0]],    in_img[top][fright[1]],    in_img[top][fright[2]],    in_img[top][fright[3]]);
+                        simd4f bl(in_img[bottom][fleft[0]],  in_img[bottom][fleft[1]],  in_img[bottom][fleft[2]],  in_img[bottom][fleft[3]]);
+                        simd4f br(in_img[bottom][fright[0]], in_img[bottom][fright[1]], in_img[bottom][fright[2]], in_img[bottom][fright[3]]);
+
+                        // Integer pixels are truncated like before but float pixels keep
+                        // their fractional part.
+                        store_bilinear_pixels(tlf*tl + trf*tr + blf*bl + brf*br, &out_img[r][c]);
+                    }
+                    x = -x_scale + c*x_scale;
+                    for (; c < out_img.nc(); ++c)
+                    {
+                        x += x_scale;
+                        const long left   = static_cast<long>(std::floor(x));
+                        const long right  = std::min(left+1, in_img.nc()-1);
+                        const float lr_frac = x - left;
+
+                        float tl = 0, tr = 0, bl = 0, br = 0;
+
+                        assign_pixel(tl, in_img[top][left]);
+                        assign_pixel(tr, in_img[top][right]);
+                        assign_pixel(bl, in_img[bottom][left]);
+                        assign_pixel(br, in_img[bottom][right]);
+
+                        float temp = (1-tb_frac)*((1-lr_frac)*tl + lr_frac*tr) + 
+                            tb_frac*((1-lr_frac)*bl + lr_frac*br);
+
+                        assign_pixel(out_img[r][c], temp);
+                    }
+                }
+            });
         }
 
-        typedef typename image_traits<image_type>::pixel_type T;
-        const double x_scale = (in_img.nc()-1)/(double)std::max<long>((out_img.nc()-1),1);
-        const double y_scale = (in_img.nr()-1)/(double)std::max<long>((out_img.nr()-1),1);
-        double y = -y_scale;
-        for (long r = 0; r < out_img.nr(); ++r)
+    // ----------------------------------------------------------------------------------------
+
+        template <
+            typename image_type1,
+            typename image_type2
+            >
+        typename enable_if<is_simd_resizable_rgb<image_type1,image_type2> >::type resize_image_bilinear (
+            const image_type1& in_img_,
+            image_type2& out_img_,
+            thread_pool* tp
+        )
         {
-            y += y_scale;
-            const long top    = static_cast<long>(std::floor(y));
-            const long bottom = std::min(top+1, in_img.nr()-1);
-            const double tb_frac = y - top;
-            double x = -4*x_scale;
-
-            const simd4f _tb_frac = tb_frac;
-            const simd4f _inv_tb_frac = 1-tb_frac;
-            const simd4f _x_scale = 4*x_scale;
-            simd4f _x(x, x+x_scale, x+2*x_scale, x+3*x_scale);
-            long c = 0;
-            for (;; c+=4)
+            const_image_view<image_type1> in_img(in_img_);
+            image_view<image_type2> out_img(out_img_);
+
+            if (out_img.nr() <= 1 || out_img.nc() <= 1)
             {
-                _x += _x_scale;
-                simd4i left = simd4i(_x);
-
-                simd4f _lr_frac = _x-left;
-                simd4f _inv_lr_frac = 1-_lr_frac; 
-                simd4i right = left+1;
-
-                simd4f tlf = _inv_tb_frac*_inv_lr_frac;
-                simd4f trf = _inv_tb_frac*_lr_frac;
-                simd4f blf = _tb_frac*_inv_lr_frac;
-                simd4f brf = _tb_frac*_lr_frac;
-
-                int32 fleft[4];
-                int32 fright[4];
-                left.store(fleft);
-                right.store(fright);
-
-                if (fright[3] >= in_img.nc())
-                    break;
-                simd4f tl(in_img[top][fleft[0]],     in_img[top][fleft[1]],     in_img[top][fleft[2]],     in_img[top][fleft[3]]);
-                simd4f tr(in_img[top][fright[0]],    in_img[top][fright[1]],    in_img[top][fright[2]],    in_img[top][fright[3]]);
-                simd4f bl(in_img[bottom][fleft[0]],  in_img[bottom][fleft[1]],  in_img[bottom][fleft[2]],  in_img[bottom][fleft[3]]);
-                simd4f br(in_img[bottom][fright[0]], in_img[bottom][fright[1]], in_img[bottom][fright[2]], in_img[bottom][fright[3]]);
-
-                simd4i out = simd4i(tlf*tl + trf*tr + blf*bl + brf*br);
-                int32 fout[4];
-                out.store(fout);
-
-                out_img[r][c]   = static_cast<T>(fout[0]);
-                out_img[r][c+1] = static_cast<T>(fout[1]);
-                out_img[r][c+2] = static_cast<T>(fout[2]);
-                out_img[r][c+3] = static_cast<T>(fout[3]);
+                assign_all_pixels(out_img, 0);
+                return;
             }
-            x = -x_scale + c*x_scale;
-            for (; c < out_img.nc(); ++c)
-            {
-                x += x_scale;
-                const long left   = static_cast<long>(std::floor(x));
-                const long right  = std::min(left+1, in_img.nc()-1);
-                const float lr_frac = x - left;
-
-                float tl = 0, tr = 0, bl = 0, br = 0;
 
-                assign_pixel(tl, in_img[top][left]);
-                assign_pixel(tr, in_img[top][right]);
-                assign_pixel(bl, in_img[bottom][left]);
-                assign_pixel(br, in_img[bottom][right]);
 
-                float temp = (1-tb_frac)*((1-lr_frac)*tl + lr_frac*tr) + 
-                    tb_frac*((1-lr_frac)*bl + lr_frac*br);
+            typedef typename image_traits<image_type1>::pixel_type T;
+            const double x_scale = (in_img.nc()-1)/(double)std::max<long>((out_img.nc()-1),1);
+            const double y_scale = (in_img.nr()-1)/(double)std::max<long>((out_img.nr()-1),1);
 
-                assign_pixel(out_img[r][c], temp);
+            // The columns sampled are the same in every row, so find them and their
+            // weights once up front.  simd_nc is the number of output columns done 4 at a
+            // time by the SIMD loop.
+            std::vector<int32> lefts, rights;
+            std::vector<float> lr_fracs, inv_lr_fracs;
+            long simd_nc = 0;
+            {
+                lefts.reserve(out_img.nc()+4);
+                rights.reserve(out_img.nc()+4);
+                lr_fracs.reserve(out_img.nc()+4);
+                inv_lr_fracs.reserve(out_img.nc()+4);
+                double x = -4*x_scale;
+                const simd4f _x_scale = 4*x_scale;
+                simd4f _x(x, x+x_scale, x+2*x_scale, x+3*x_scale);
+                for (;; simd_nc+=4)
+                {
+                    _x += _x_scale;
+                    simd4i left = simd4i(_x);
+                    simd4f lr_frac = _x-left;
+                    simd4f _inv_lr_frac = 1-lr_frac; 
+                    simd4i right = left+1;
+
+                    lefts.resize(simd_nc+4);
+                    rights.resize(simd_nc+4);
+                    lr_fracs.resize(simd_nc+4);
+                    inv_lr_fracs.resize(simd_nc+4);
+                    left.store(&lefts[simd_nc]);
+                    right.store(&rights[simd_nc]);
+                    lr_frac.store(&lr_fracs[simd_nc]);
+                    _inv_lr_frac.store(&inv_lr_fracs[simd_nc]);
+
+                    if (rights[simd_nc+3] >= in_img.nc())
+                        break;
+                }
             }
+
+            resize_image_rows(out_img.nr(), tp, [&](long rbegin, long rend)
+            {
+                for (long r = rbegin; r < rend; ++r)
+                {
+                    const double y = r*y_scale;
+                    const long top    = static_cast<long>(std::floor(y));
+                    const long bottom = std::min(top+1, in_img.nr()-1);
+                    const double tb_frac = y - top;
+                    double x;
+
+                    const simd4f _tb_frac = tb_frac;
+                    const simd4f _inv_tb_frac = 1-tb_frac;
+                    const T* in_top = &in_img[top][0];
+                    const T* in_bottom = &in_img[bottom][0];
+                    T* out_row = &out_img[r][0];
+                    long c = 0;
+                    for (; c < simd_nc; c+=4)
+                    {
+                        simd4f lr_frac, _inv_lr_frac;
+                        lr_frac.load(&lr_fracs[c]);
+                        _inv_lr_frac.load(&inv_lr_fracs[c]);
+
+                        simd4f tlf = _inv_tb_frac*_inv_lr_frac;
+                        simd4f trf = _inv_tb_frac*lr_frac;
+                        simd4f blf = _tb_frac*_inv_lr_frac;
+                        simd4f brf = _tb_frac*lr_frac;
+
+                        const int32* fleft = &lefts[c];
+                        const int32* fright = &rights[c];
+                        simd4f tl(in_top[fleft[0]].red,     in_top[fleft[1]].red,     in_top[fleft[2]].red,     in_top[fleft[3]].red);
+                        simd4f tr(in_top[fright[0]].red,    in_top[fright[1]].red,    in_top[fright[2]].red,    in_top[fright[3]].red);
+                        simd4f bl(in_bottom[fleft[0]].red,  in_bottom[fleft[1]].red,  in_bottom[fleft[2]].red,  in_bottom[fleft[3]].red);
+                        simd4f br(in_bottom[fright[0]].red, in_bottom[fright[1]].red, in_bottom[fright[2]].red, in_bottom[fright[3]].red);
+
+                        simd4i out = simd4i(tlf*tl + trf*tr + blf*bl + brf*br);
+                        int32 fout[4];
+                        out.store(fout);
+
+                        out_row[c].red   = static_cast<unsigned char>(fout[0]);
+                        out_row[c+1].red = static_cast<unsigned char>(fout[1]);
+                        out_row[c+2].red = static_cast<unsigned char>(fout[2]);
+                        out_row[c+3].red = static_cast<unsigned char>(fout[3]);
+
+
+                        tl = simd4f(in_top[fleft[0]].green,    in_top[fleft[1]].green,    in_top[fleft[2]].green,    in_top[fleft[3]].green);
+                        tr = simd4f(in_top[fright[0]].green,   in_top[fright[1]].green,   in_top[fright[2]].green,   in_top[fright[3]].green);
+                        bl = simd4f(in_bottom[fleft[0]].green, in_bottom[fleft[1]].green, in_bottom[fleft[2]].green, in_bottom[fleft[3]].green);
+                        br = simd4f(in_bottom[fright[0]].green, in_bottom[fright[1]].green, in_bottom[fright[2]].green, in_bottom[fright[3]].green);
+                        out = simd4i(tlf*tl + trf*tr + blf*bl + brf*br);
+                        out.store(fout);
+                        out_row[c].green   = static_cast<unsigned char>(fout[0]);
+                        out_row[c+1].green = static_cast<unsigned char>(fout[1]);
+                        out_row[c+2].green = static_cast<unsigned char>(fout[2]);
+                        out_row[c+3].green = static_cast<unsigned char>(fout[3]);
+
+
+                        tl = simd4f(in_top[fleft[0]].blue,     in_top[fleft[1]].blue,     in_top[fleft[2]].blue,     in_top[fleft[3]].blue);
+                        tr = simd4f(in_top[fright[0]].blue,    in_top[fright[1]].blue,    in_top[fright[2]].blue,    in_top[fright[3]].blue);
+                        bl = simd4f(in_bottom[fleft[0]].blue,  in_bottom[fleft[1]].blue,  in_bottom[fleft[2]].blue,  in_bottom[fleft[3]].blue);
+                        br = simd4f(in_bottom[fright[0]].blue, in_bottom[fright[1]].blue, in_bottom[fright[2]].blue, in_bottom[fright[3]].blue);
+                        out = simd4i(tlf*tl + trf*tr + blf*bl + brf*br);
+                        out.store(fout);
+                        out_row[c].blue   = static_cast<unsigned char>(fout[0]);
+                        out_row[c+1].blue = static_cast<unsigned char>(fout[1]);
+                        out_row[c+2].blue = static_cast<unsigned char>(fout[2]);
+                        out_row[c+3].blue = static_cast<unsigned char>(fout[3]);
+                    }
+                    x = -x_scale + c*x_scale;
+                    for (; c < out_img.nc(); ++c)
+                    {
+                        x += x_scale;
+                        const long left   = static_cast<long>(std::floor(x));
+                        const long right  = std::min(left+1, in_img.nc()-1);
+                        const double lr_frac = x - left;
+
+                        const T tl = in_img[top][left];
+                        const T tr = in_img[top][right];
+                        const T bl = in_img[bottom][left];
+                        const T br = in_img[bottom][right];
+
+                        T temp;
+                        assign_pixel(temp, 0);
+                        vector_to_pixel(temp, 
+                            (1-tb_frac)*((1-lr_frac)*pixel_to_vector<double>(tl) + lr_frac*pixel_to_vector<double>(tr)) + 
+                            tb_frac*((1-lr_frac)*pixel_to_vector<double>(bl) + lr_frac*pixel_to_vector<double>(br)));
+                        assign_pixel(out_img[r][c], temp);
+                    }
+                }
+            });
         }
     }
 
-// ----------------------------------------------------------------------------------------
-
+    // This is an optimized version of resize_image for the case where bilinear
+    // interpolation is used.
     template <
-        typename image_type
+        typename image_type1,
+        typename image_type2
         >
-    typename enable_if<is_rgb_image<image_type> >::type resize_image (
-        const image_type& in_img_,
-        image_type& out_img_,
+    void resize_image (
+        const image_type1& in_img,
+        image_type2& out_img,
         interpolate_bilinear
     )
     {
         // make sure requires clause is not broken
-        DLIB_ASSERT( is_same_object(in_img_, out_img_) == false ,
+        DLIB_ASSERT( is_same_object(in_img, out_img) == false ,
             "\t void resize_image()"
             << "\n\t Invalid inputs were given to this function."
-            << "\n\t is_same_object(in_img_, out_img_):  " << is_same_object(in_img_, out_img_)
+            << "\n\t is_same_object(in_img, out_img):  " << is_same_object(in_img, out_img)
             );
 
-        const_image_view<image_type> in_img(in_img_);
-        image_view<image_type> out_img(out_img_);
-
-        if (out_img.nr() <= 1 || out_img.nc() <= 1)
-        {
-            assign_all_pixels(out_img, 0);
-            return;
-        }
+        impl::resize_image_bilinear(in_img, out_img, 0);
+    }
 
+    template <
+        typename image_type1,
+        typename image_type2
+        >
+    void resize_image (
+        const image_type1& in_img,
+        image_type2& out_img,
+        interpolate_bilinear,
+        thread_pool& tp
+    )
+    {
+        // make sure requires clause is not broken
+        DLIB_ASSERT( is_same_object(in_img, out_img) == false ,
+            "\t void resize_image()"
+            << "\n\t Invalid inputs were given to this function."
+            << "\n\t is_same_object(in_img, out_img):  " << is_same_object(in_img, out_img)
+            );
 
-        typedef typename image_traits<image_type>::pixel_type T;
-        const double x_scale = (in_img.nc()-1)/(double)std::max<long>((out_img.nc()-1),1);
-        const double y_scale = (in_img.nr()-1)/(double)std::max<long>((out_img.nr()-1),1);
-        double y = -y_scale;
-        for (long r = 0; r < out_img.nr(); ++r)
-        {
-            y += y_scale;
-            const long top    = static_cast<long>(std::floor(y));
-            const long bottom = std::min(top+1, in_img.nr()-1);
-            const double tb_frac = y - top;
-            double x = -4*x_scale;
-
-            const simd4f _tb_frac = tb_frac;
-            const simd4f _inv_tb_frac = 1-tb_frac;
-            const simd4f _x_scale = 4*x_scale;
-            simd4f _x(x, x+x_scale, x+2*x_scale, x+3*x_scale);
-            long c = 0;
-            for (;; c+=4)
-            {
-                _x += _x_scale;
-                simd4i left = simd4i(_x);
-                simd4f lr_frac = _x-left;
-                simd4f _inv_lr_frac = 1-lr_frac; 
-                simd4i right = left+1;
-
-                simd4f tlf = _inv_tb_frac*_inv_lr_frac;
-                simd4f trf = _inv_tb_frac*lr_frac;
-                simd4f blf = _tb_frac*_inv_lr_frac;
-                simd4f brf = _tb_frac*lr_frac;
-
-                int32 fleft[4];
-                int32 fright[4];
-                left.store(fleft);
-                right.store(fright);
-
-                if (fright[3] >= in_img.nc())
-                    break;
-                simd4f tl(in_img[top][fleft[0]].red,     in_img[top][fleft[1]].red,     in_img[top][fleft[2]].red,     in_img[top][fleft[3]].red);
-                simd4f tr(in_img[top][fright[0]].red,    in_img[top][fright[1]].red,    in_img[top][fright[2]].red,    in_img[top][fright[3]].red);
-                simd4f bl(in_img[bottom][fleft[0]].red,  in_img[bottom][fleft[1]].red,  in_img[bottom][fleft[2]].red,  in_img[bottom][fleft[3]].red);
-                simd4f br(in_img[bottom][fright[0]].red, in_img[bottom][fright[1]].red, in_img[bottom][fright[2]].red, in_img[bottom][fright[3]].red);
-
-                simd4i out = simd4i(tlf*tl + trf*tr + blf*bl + brf*br);
-                int32 fout[4];
-                out.store(fout);
-
-                out_img[r][c].red   = static_cast<unsigned char>(fout[0]);
-                out_img[r][c+1].red = static_cast<unsigned char>(fout[1]);
-                out_img[r][c+2].red = static_cast<unsigned char>(fout[2]);
-                out_img[r][c+3].red = static_cast<unsigned char>(fout[3]);
-
-
-                tl = simd4f(in_img[top][fleft[0]].green,    in_img[top][fleft[1]].green,    in_img[top][fleft[2]].green,    in_img[top][fleft[3]].green);
-                tr = simd4f(in_img[top][fright[0]].green,   in_img[top][fright[1]].green,   in_img[top][fright[2]].green,   in_img[top][fright[3]].green);
-                bl = simd4f(in_img[bottom][fleft[0]].green, in_img[bottom][fleft[1]].green, in_img[bottom][fleft[2]].green, in_img[bottom][fleft[3]].green);
-                br = simd4f(in_img[bottom][fright[0]].green, in_img[bottom][fright[1]].green, in_img[bottom][fright[2]].green, in_img[bottom][fright[3]].green);
-                out = simd4i(tlf*tl + trf*tr + blf*bl + brf*br);
-                out.store(fout);
-                out_img[r][c].green   = static_cast<unsigned char>(fout[0]);
-                out_img[r][c+1].green = static_cast<unsigned char>(fout[1]);
-                out_img[r][c+2].green = static_cast<unsigned char>(fout[2]);
-                out_img[r][c+3].green = static_cast<unsigned char>(fout[3]);
-
-
-                tl = simd4f(in_img[top][fleft[0]].blue,     in_img[top][fleft[1]].blue,     in_img[top][fleft[2]].blue,     in_img[top][fleft[3]].blue);
-                tr = simd4f(in_img[top][fright[0]].blue,    in_img[top][fright[1]].blue,    in_img[top][fright[2]].blue,    in_img[top][fright[3]].blue);
-                bl = simd4f(in_img[bottom][fleft[0]].blue,  in_img[bottom][fleft[1]].blue,  in_img[bottom][fleft[2]].blue,  in_img[bottom][fleft[3]].blue);
-                br = simd4f(in_img[bottom][fright[0]].blue, in_img[bottom][fright[1]].blue, in_img[bottom][fright[2]].blue, in_img[bottom][fright[3]].blue);
-                out = simd4i(tlf*tl + trf*tr + blf*bl + brf*br);
-                out.store(fout);
-                out_img[r][c].blue   = static_cast<unsigned char>(fout[0]);
-                out_img[r][c+1].blue = static_cast<unsigned char>(fout[1]);
-                out_img[r][c+2].blue = static_cast<unsigned char>(fout[2]);
-                out_img[r][c+3].blue = static_cast<unsigned char>(fout[3]);
-            }
-            x = -x_scale + c*x_scale;
-            for (; c < out_img.nc(); ++c)
-            {
-                x += x_scale;
-                const long left   = static_cast<long>(std::floor(x));
-                const long right  = std::min(left+1, in_img.nc()-1);
-                const double lr_frac = x - left;
-
-                const T tl = in_img[top][left];
-                const T tr = in_img[top][right];
-                const T bl = in_img[bottom][left];
-                const T br = in_img[bottom][right];
-
-                T temp;
-                assign_pixel(temp, 0);
-                vector_to_pixel(temp, 
-                    (1-tb_frac)*((1-lr_frac)*pixel_to_vector<double>(tl) + lr_frac*pixel_to_vector<double>(tr)) + 
-                    tb_frac*((1-lr_frac)*pixel_to_vector<double>(bl) + lr_frac*pixel_to_vector<double>(br)));
-                assign_pixel(out_img[r][c], temp);
-            }
-        }
+        impl::resize_image_bilinear(in_img, out_img, &tp);
     }
 
 // ----------------------------------------------------------------------------------------
@@ -1707,6 +1826,113 @@ namespace dlib
         }
     }
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        template <
+            typename image_type1,
+            typename image_type2
+            >
+        void extract_image_chips (
+            const image_type1& img,
+            const std::vector<chip_details>& chip_locations,
+            dlib::array<image_type2>& chips,
+            thread_pool* tp
+        )
+        {
+            pyramid_down<2> pyr;
+            long max_depth = 0;
+            // If the chip is supposed to be much smaller than the source subwindow then you
+            // can't just extract it using bilinear interpolation since at a high enough
+            // downsampling amount it would effectively turn into nearest neighbor
+            // interpolation.  So we use an image pyramid to make sure the interpolation is
+            // fast but also high quality.  The first thing we do is figure out how deep the
+            // image pyramid needs to be.
+            rectangle bounding_box;
+            for (unsigned long i = 0; i < chip_locations.size(); ++i)
+            {
+                long depth = 0;
+                double grow = 2;
+                drectangle rect = pyr.rect_down(chip_locations[i].rect);
+                while (rect.area() > chip_locations[i].size())
+                {
+                    rect = pyr.rect_down(rect);
+                    ++depth;
+                    // We drop the image size by a factor of 2 each iteration and then assume a
+                    // border of 2 pixels is needed to avoid any border effects of the crop.
+                    grow = grow*2 + 2;
+                }
+                drectangle rot_rect;
+                const vector<double,2> cent = center(chip_locations[i].rect);
+                rot_rect += rotate_point<double>(cent,chip_locations[i].rect.tl_corner(),chip_locations[i].angle);
+                rot_rect += rotate_point<double>(cent,chip_locations[i].rect.tr_corner(),chip_locations[i].angle);
+                rot_rect += rotate_point<double>(cent,chip_locations[i].rect.bl_corner(),chip_locations[i].angle);
+                rot_rect += rotate_point<double>(cent,chip_locations[i].rect.br_corner(),chip_locations[i].angle);
+                bounding_box += grow_rect(rot_rect, grow).intersect(get_rect(img));
+                max_depth = std::max(depth,max_depth);
+            }
+            //std::cout << "max_depth: " << max_depth << std::endl;
+            //std::cout << "crop amount: " << bounding_box.area()/(double)get_rect(img).area() << std::endl;
+
+            // now make an image pyramid
+            dlib::array<array2d<typename image_traits<image_type1>::pixel_type> > levels(max_depth);
+            if (levels.size() != 0)
+                pyr(sub_image(img,bounding_box),levels[0]);
+            for (unsigned long i = 1; i < levels.size(); ++i)
+                pyr(levels[i-1],levels[i]);
+
+            // now pull out the chips
+            chips.resize(chip_locations.size());
+            auto extract_chip = [&](long i)
+            {
+                // If the chip doesn't have any rotation or scaling then use the basic version
+                // of chip extraction that just does a fast copy.
+                if (chip_locations[i].angle == 0 && 
+                    chip_locations[i].rows == chip_locations[i].rect.height() &&
+                    chip_locations[i].cols == chip_locations[i].rect.width())
+                {
+                    impl::basic_extract_image_chip(img, chip_locations[i].rect, chips[i]);
+                }
+                else
+                {
+                    set_image_size(chips[i], chip_locations[i].rows, chip_locations[i].cols);
+
+                    // figure out which level in the pyramid to use to extract the chip
+                    int level = -1;
+                    drectangle rect = translate_rect(chip_locations[i].rect, -bounding_box.tl_corner());
+                    while (pyr.rect_down(rect).area() > chip_locations[i].size())
+                    {
+                        ++level;
+                        rect = pyr.rect_down(rect);
+                    }
+
+                    // find the appropriate transformation that maps from the chip to the input
+                    // image
+                    std::vector<dlib::vector<double,2> > from, to;
+                    from.push_back(get_rect(chips[i]).tl_corner());  to.push_back(rotate_point<double>(center(rect),rect.tl_corner(),chip_locations[i].angle));
+                    from.push_back(get_rect(chips[i]).tr_corner());  to.push_back(rotate_point<double>(center(rect),rect.tr_corner(),chip_locations[i].angle));
+                    from.push_back(get_rect(chips[i]).bl_corner());  to.push_back(rotate_point<double>(center(rect),rect.bl_corner(),chip_locations[i].angle));
+                    point_transform_affine trns = find_affine_transform(from,to);
+
+                    // now extract the actual chip
+                    if (level == -1)
+                        transform_image(sub_image(img,bounding_box),chips[i],interpolate_bilinear(),trns);
+                    else
+                        transform_image(levels[level],chips[i],interpolate_bilinear(),trns);
+                }
+            };
+
+            // Each chip is written by exactly one call to extract_chip() and everything
+            // else is only read, so the chips can be extracted in parallel.
+            if (tp)
+                parallel_for(*tp, 0, chips.size(), extract_chip);
+            else
+                for (unsigned long i = 0; i < chips.size(); ++i)
+                    extract_chip(i);
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -1733,90 +1959,35 @@ namespace dlib
         }
 #endif 
 
-        pyramid_down<2> pyr;
-        long max_depth = 0;
-        // If the chip is supposed to be much smaller than the source subwindow then you
-        // can't just extract it using bilinear interpolation since at a high enough
-        // downsampling amount it would effectively turn into nearest neighbor
-        // interpolation.  So we use an image pyramid to make sure the interpolation is
-        // fast but also high quality.  The first thing we do is figure out how deep the
-        // image pyramid needs to be.
-        rectangle bounding_box;
+        impl::extract_image_chips(img, chip_locations, chips, 0);
+    }
+
+    template <
+        typename image_type1,
+        typename image_type2
+        >
+    void extract_image_chips (
+        const image_type1& img,
+        const std::vector<chip_details>& chip_locations,
+        dlib::array<image_type2>& chips,
+        thread_pool& tp
+    )
+    {
+        // make sure requires clause is not broken
+#ifdef ENABLE_ASSERTS
         for (unsigned long i = 0; i < chip_locations.size(); ++i)
         {
-            long depth = 0;
-            double grow = 2;
-            drectangle rect = pyr.rect_down(chip_locations[i].rect);
-            while (rect.area() > chip_locations[i].size())
-            {
-                rect = pyr.rect_down(rect);
-                ++depth;
-                // We drop the image size by a factor of 2 each iteration and then assume a
-                // border of 2 pixels is needed to avoid any border effects of the crop.
-                grow = grow*2 + 2;
-            }
-            drectangle rot_rect;
-            const vector<double,2> cent = center(chip_locations[i].rect);
-            rot_rect += rotate_point<double>(cent,chip_locations[i].rect.tl_corner(),chip_locations[i].angle);
-            rot_rect += rotate_point<double>(cent,chip_locations[i].rect.tr_corner(),chip_locations[i].angle);
-            rot_rect += rotate_point<double>(cent,chip_locations[i].rect.bl_corner(),chip_locations[i].angle);
-            rot_rect += rotate_point<double>(cent,chip_locations[i].rect.br_corner(),chip_locations[i].angle);
-            bounding_box += grow_rect(rot_rect, grow).intersect(get_rect(img));
-            max_depth = std::max(depth,max_depth);
+            DLIB_CASSERT(chip_locations[i].size() != 0 &&
+                         chip_locations[i].rect.is_empty() == false,
+            "\t void extract_image_chips()"
+            << "\n\t Invalid inputs were given to this function."
+            << "\n\t chip_locations["<<i<<"].size():            " << chip_locations[i].size()
+            << "\n\t chip_locations["<<i<<"].rect.is_empty(): " << chip_locations[i].rect.is_empty()
+            );
         }
-        //std::cout << "max_depth: " << max_depth << std::endl;
-        //std::cout << "crop amount: " << bounding_box.area()/(double)get_rect(img).area() << std::endl;
-
-        // now make an image pyramid
-        dlib::array<array2d<typename image_traits<image_type1>::pixel_type> > levels(max_depth);
-        if (levels.size() != 0)
-            pyr(sub_image(img,bounding_box),levels[0]);
-        for (unsigned long i = 1; i < levels.size(); ++i)
-            pyr(levels[i-1],levels[i]);
-
-        std::vector<dlib::vector<double,2> > from, to;
-
-        // now pull out the chips
-        chips.resize(chip_locations.size());
-        for (unsigned long i = 0; i < chips.size(); ++i)
-        {
-            // If the chip doesn't have any rotation or scaling then use the basic version
-            // of chip extraction that just does a fast copy.
-            if (chip_locations[i].angle == 0 && 
-                chip_locations[i].rows == chip_locations[i].rect.height() &&
-                chip_locations[i].cols == chip_locations[i].rect.width())
-            {
-                impl::basic_extract_image_chip(img, chip_locations[i].rect, chips[i]);
-            }
-            else
-            {
-                set_image_size(chips[i], chip_locations[i].rows, chip_locations[i].cols);
-
-                // figure out which level in the pyramid to use to extract the chip
-                int level = -1;
-                drectangle rect = translate_rect(chip_locations[i].rect, -bounding_box.tl_corner());
-                while (pyr.rect_down(rect).area() > chip_locations[i].size())
-                {
-                    ++level;
-                    rect = pyr.rect_down(rect);
-                }
+#endif 
 
-                // find the appropriate transformation that maps from the chip to the input
-                // image
-                from.clear();
-                to.clear();
-                from.push_back(get_rect(chips[i]).tl_corner());  to.push_back(rotate_point<double>(center(rect),rect.tl_corner(),chip_locations[i].angle));
-                from.push_back(get_rect(chips[i]).tr_corner());  to.push_back(rotate_point<double>(center(rect),rect.tr_corner(),chip_locations[i].angle));
-                from.push_back(get_rect(chips[i]).bl_corner());  to.push_back(rotate_point<double>(center(rect),rect.bl_corner(),chip_locations[i].angle));
-                point_transform_affine trns = find_affine_transform(from,to);
-
-                // now extract the actual chip
-                if (level == -1)
-                    transform_image(sub_image(img,bounding_box),chips[i],interpolate_bilinear(),trns);
-                else
-                    transform_image(levels[level],chips[i],interpolate_bilinear(),trns);
-            }
-        }
+        impl::extract_image_chips(img, chip_locations, chips, &tp);
     }
 
 // ----------------------------------------------------------------------------------------
@@ -386,6 +386,32 @@ namespace dlib
               pixel interpolation.
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_type1,
+        typename image_type2
+        >
+    void resize_image (
+        const image_type1& in_img,
+        image_type2& out_img,
+        interpolate_bilinear interp,
+        thread_pool& tp
+    );
+    /*!
+        requires
+            - image_type1 == an image object that implements the interface defined in
+              dlib/image_processing/generic_image.h 
+            - image_type2 == an image object that implements the interface defined in
+              dlib/image_processing/generic_image.h 
+            - pixel_traits<typename image_traits<image_type1>::pixel_type>::has_alpha == false
+            - is_same_object(in_img, out_img) == false
+        ensures
+            - performs: resize_image(in_img, out_img, interp) 
+              except that the rows of out_img are computed in parallel using the threads
+              in tp.  The output is exactly the same as the single threaded version.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
 
@@ -1120,6 +1146,35 @@ namespace dlib
             - Any pixels in an image chip that go outside img are set to 0 (i.e. black).
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename image_type1,
+        typename image_type2
+        >
+    void extract_image_chips (
+        const image_type1& img,
+        const std::vector<chip_details>& chip_locations,
+        dlib::array<image_type2>& chips,
+        thread_pool& tp
+    );
+    /*!
+        requires
+            - image_type1 == an image object that implements the interface defined in
+              dlib/image_processing/generic_image.h 
+            - image_type2 == an image object that implements the interface defined in
+              dlib/image_processing/generic_image.h 
+            - pixel_traits<typename image_traits<image_type1>::pixel_type>::has_alpha == false
+            - for all valid i: 
+                - chip_locations[i].rect.is_empty() == false
+                - chip_locations[i].size() != 0
+        ensures
+            - performs: extract_image_chips(img, chip_locations, chips)
+              except that the chips are extracted in parallel using the threads in tp.
+              The resulting chips are exactly the same as the ones produced by the single
+              threaded version.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -11,6 +11,7 @@
 #include "../matrix.h"
 #include "../geometry/border_enumerator.h"
 #include "../simd.h"
+#include "../threads.h"
 #include <limits>
 #include "assign_image.h"
 
@@ -429,7 +430,8 @@ namespace dlib
             const matrix_exp<EXP2>& _col_filter,
             T scale,
             bool use_abs,
-            bool add_to 
+            bool add_to,
+            thread_pool* tp = 0
         )
         {
             const_temp_matrix<EXP1> row_filter(_row_filter);
@@ -483,50 +485,68 @@ namespace dlib
             temp_img.set_size(in_img.nr(), in_img.nc());
 
             // apply the row filter
-            for (long r = 0; r < in_img.nr(); ++r)
+            auto filter_rows = [&](long begin, long end)
             {
-                for (long c = first_col; c < last_col; ++c)
+                for (long r = begin; r < end; ++r)
                 {
-                    ptype p;
-                    ptype temp = 0;
-                    for (long n = 0; n < row_filter.size(); ++n)
+                    for (long c = first_col; c < last_col; ++c)
                     {
-                        // pull out the current pixel and put it into p
-                        p = get_pixel_intensity(in_img[r][c-first_col+n]);
-                        temp += p*row_filter(n);
+                        ptype p;
+                        ptype temp = 0;
+                        for (long n = 0; n < row_filter.size(); ++n)
+                        {
+                            // pull out the current pixel and put it into p
+                            p = get_pixel_intensity(in_img[r][c-first_col+n]);
+                            temp += p*row_filter(n);
+                        }
+                        temp_img[r][c] = temp;
                     }
-                    temp_img[r][c] = temp;
                 }
-            }
+            };
 
             // apply the column filter 
-            for (long r = first_row; r < last_row; ++r)
+            auto filter_cols = [&](long begin, long end)
             {
-                for (long c = first_col; c < last_col; ++c)
+                for (long r = begin; r < end; ++r)
                 {
-                    ptype temp = 0;
-                    for (long m = 0; m < col_filter.size(); ++m)
+                    for (long c = first_col; c < last_col; ++c)
                     {
-                        temp += temp_img[r-first_row+m][c]*col_filter(m);
-                    }
+                        ptype temp = 0;
+                        for (long m = 0; m < col_filter.size(); ++m)
+                        {
+                            temp += temp_img[r-first_row+m][c]*col_filter(m);
+                        }
 
-                    temp /= scale;
+                        temp /= scale;
 
-                    if (use_abs && temp < 0)
-                    {
-                        temp = -temp;
-                    }
+                        if (use_abs && temp < 0)
+                        {
+                            temp = -temp;
+                        }
 
-                    // save this pixel to the output image
-                    if (add_to == false)
-                    {
-                        assign_pixel(out_img[r][c], temp);
-                    }
-                    else
-                    {
-                        assign_pixel(out_img[r][c], temp + out_img[r][c]);
+                        // save this pixel to the output image
+                        if (add_to == false)
+                        {
+                            assign_pixel(out_img[r][c], temp);
+                        }
+                        else
+                        {
+                            assign_pixel(out_img[r][c], temp + out_img[r][c]);
+                        }
                     }
                 }
+            };
+
+            if (tp)
+            {
+                parallel_for_blocked(*tp, 0, in_img.nr(), filter_rows);
+                if (first_row < last_row)
+                    parallel_for_blocked(*tp, first_row, last_row, filter_cols);
+            }
+            else
+            {
+                filter_rows(0, in_img.nr());
+                filter_cols(first_row, last_row);
             }
             return non_border;
         }
@@ -551,168 +571,297 @@ namespace dlib
 
 // ----------------------------------------------------------------------------------------
 
-    // This overload is optimized to use SIMD instructions when filtering float images with
-    // float filters.
-    template <
-        typename in_image_type,
-        typename out_image_type,
-        typename EXP1,
-        typename EXP2
-        >
-    rectangle float_spatially_filter_image_separable (
-        const in_image_type& in_img_,
-        out_image_type& out_img_,
-        const matrix_exp<EXP1>& _row_filter,
-        const matrix_exp<EXP2>& _col_filter,
-        out_image_type& scratch_,
-        bool add_to = false
-    )
+    namespace impl
     {
-        // You can only use this function with images and filters containing float
-        // variables.
-        COMPILE_TIME_ASSERT((is_float_filtering<in_image_type,out_image_type,EXP1,EXP2>::value == true));
-
-
-        const_temp_matrix<EXP1> row_filter(_row_filter);
-        const_temp_matrix<EXP2> col_filter(_col_filter);
-        DLIB_ASSERT(row_filter.size() != 0 && col_filter.size() != 0 &&
-            is_vector(row_filter) &&
-            is_vector(col_filter),
-            "\trectangle float_spatially_filter_image_separable()"
-            << "\n\t Invalid inputs were given to this function."
-            << "\n\t row_filter.size(): "<< row_filter.size()
-            << "\n\t col_filter.size(): "<< col_filter.size()
-            << "\n\t is_vector(row_filter): "<< is_vector(row_filter)
-            << "\n\t is_vector(col_filter): "<< is_vector(col_filter)
-        );
-        DLIB_ASSERT(is_same_object(in_img_, out_img_) == false,
-            "\trectangle float_spatially_filter_image_separable()"
-            << "\n\tYou must give two different image objects"
-        );
-
-
-        const_image_view<in_image_type> in_img(in_img_);
-        image_view<out_image_type> out_img(out_img_);
-
-        // if there isn't any input image then don't do anything
-        if (in_img.size() == 0)
-        {
-            out_img.clear();
-            return rectangle();
-        }
-
-        out_img.set_size(in_img.nr(),in_img.nc());
-
-        // figure out the range that we should apply the filter to
-        const long first_row = col_filter.size()/2;
-        const long first_col = row_filter.size()/2;
-        const long last_row = in_img.nr() - ((col_filter.size()-1)/2);
-        const long last_col = in_img.nc() - ((row_filter.size()-1)/2);
-
-        const rectangle non_border = rectangle(first_col, first_row, last_col-1, last_row-1);
-        if (!add_to)
-            zero_border_pixels(out_img, non_border); 
-
-        image_view<out_image_type> scratch(scratch_);
-        scratch.set_size(in_img.nr(), in_img.nc());
+        /*
+            The SIMD loops below compute 32 or 8 adjacent outputs at a time.  Each output
+            is still summed by a single accumulator in the same order as the scalar loops
+            that handle the leftover columns, so the SIMD and scalar results are
+            identical.  Filtering four blocks of 8 columns at once gives the CPU four
+            independent chains of additions to work on.
+        */
 
-        // apply the row filter
-        for (long r = 0; r < in_img.nr(); ++r)
+        template <
+            typename in_image_view,
+            typename scratch_view,
+            typename filter_type
+            >
+        void float_filter_rows (
+            const in_image_view& in_img,
+            scratch_view& scratch,
+            const filter_type& row_filter,
+            const long first_col,
+            const long last_col,
+            const long begin,
+            const long end
+        )
         {
-            long c = first_col;
-            for (; c < last_col-7; c+=8)
+            for (long r = begin; r < end; ++r)
             {
-                simd8f p,p2,p3, temp = 0, temp2=0, temp3=0;
-                long n = 0;
-                for (; n < row_filter.size()-2; n+=3)
+                long c = first_col;
+                for (; c < last_col-31; c+=32)
                 {
-                    // pull out the current pixel and put it into p
-                    p.load(&in_img[r][c-first_col+n]);
-                    p2.load(&in_img[r][c-first_col+n+1]);
-                    p3.load(&in_img[r][c-first_col+n+2]);
-                    temp += p*row_filter(n);
-                    temp2 += p2*row_filter(n+1);
-                    temp3 += p3*row_filter(n+2);
+                    simd8f p, temp = 0, temp2 = 0, temp3 = 0, temp4 = 0;
+                    for (long n = 0; n < row_filter.size(); ++n)
+                    {
+                        // pull out the current pixels and put them into p
+                        const float* in = &in_img[r][c-first_col+n];
+                        const simd8f f = row_filter(n);
+                        p.load(in);    temp  += p*f;
+                        p.load(in+8);  temp2 += p*f;
+                        p.load(in+16); temp3 += p*f;
+                        p.load(in+24); temp4 += p*f;
+                    }
+                    temp.store(&scratch[r][c]);
+                    temp2.store(&scratch[r][c+8]);
+                    temp3.store(&scratch[r][c+16]);
+                    temp4.store(&scratch[r][c+24]);
                 }
-                for (; n < row_filter.size(); ++n)
+                for (; c < last_col-7; c+=8)
                 {
-                    // pull out the current pixel and put it into p
-                    p.load(&in_img[r][c-first_col+n]);
-                    temp += p*row_filter(n);
+                    simd8f p, temp = 0;
+                    for (long n = 0; n < row_filter.size(); ++n)
+                    {
+                        p.load(&in_img[r][c-first_col+n]);
+                        temp += p*row_filter(n);
+                    }
+                    temp.store(&scratch[r][c]);
                 }
-                temp += temp2 + temp3;
-                temp.store(&scratch[r][c]);
-            }
-            for (; c < last_col; ++c)
-            {
-                float p;
-                float temp = 0;
-                for (long n = 0; n < row_filter.size(); ++n)
+                for (; c < last_col; ++c)
                 {
-                    // pull out the current pixel and put it into p
-                    p = in_img[r][c-first_col+n];
-                    temp += p*row_filter(n);
+                    float p;
+                    float temp = 0;
+                    for (long n = 0; n < row_filter.size(); ++n)
+                    {
+                        // pull out the current pixel and put it into p
+                        p = in_img[r][c-first_col+n];
+                        temp += p*row_filter(n);
+                    }
+                    scratch[r][c] = temp;
                 }
-                scratch[r][c] = temp;
             }
         }
 
-        // apply the column filter 
-        for (long r = first_row; r < last_row; ++r)
+        template <
+            typename scratch_view,
+            typename out_image_view,
+            typename filter_type
+            >
+        void float_filter_cols (
+            const scratch_view& scratch,
+            out_image_view& out_img,
+            const filter_type& col_filter,
+            const long first_row,
+            const long first_col,
+            const long last_col,
+            const long begin,
+            const long end,
+            const bool add_to
+        )
         {
-            long c = first_col;
-            for (; c < last_col-7; c+=8)
+            for (long r = begin; r < end; ++r)
             {
-                simd8f p, p2, p3, temp = 0, temp2 = 0, temp3 = 0;
-                long m = 0;
-                for (; m < col_filter.size()-2; m+=3)
+                long c = first_col;
+                for (; c < last_col-31; c+=32)
                 {
-                    p.load(&scratch[r-first_row+m][c]);
-                    p2.load(&scratch[r-first_row+m+1][c]);
-                    p3.load(&scratch[r-first_row+m+2][c]);
-                    temp += p*col_filter(m);
-                    temp2 += p2*col_filter(m+1);
-                    temp3 += p3*col_filter(m+2);
+                    simd8f p, temp = 0, temp2 = 0, temp3 = 0, temp4 = 0;
+                    for (long m = 0; m < col_filter.size(); ++m)
+                    {
+                        const float* in = &scratch[r-first_row+m][c];
+                        const simd8f f = col_filter(m);
+                        p.load(in);    temp  += p*f;
+                        p.load(in+8);  temp2 += p*f;
+                        p.load(in+16); temp3 += p*f;
+                        p.load(in+24); temp4 += p*f;
+                    }
+
+                    // save these pixels to the output image
+                    float* out = &out_img[r][c];
+                    if (add_to)
+                    {
+                        p.load(out);    temp  += p;
+                        p.load(out+8);  temp2 += p;
+                        p.load(out+16); temp3 += p;
+                        p.load(out+24); temp4 += p;
+                    }
+                    temp.store(out);
+                    temp2.store(out+8);
+                    temp3.store(out+16);
+                    temp4.store(out+24);
                 }
-                for (; m < col_filter.size(); ++m)
+                for (; c < last_col-7; c+=8)
                 {
-                    p.load(&scratch[r-first_row+m][c]);
-                    temp += p*col_filter(m);
-                }
-                temp += temp2+temp3;
+                    simd8f p, temp = 0;
+                    for (long m = 0; m < col_filter.size(); ++m)
+                    {
+                        p.load(&scratch[r-first_row+m][c]);
+                        temp += p*col_filter(m);
+                    }
 
-                // save this pixel to the output image
-                if (add_to == false)
-                {
+                    // save this pixel to the output image
+                    if (add_to)
+                    {
+                        p.load(&out_img[r][c]);
+                        temp += p;
+                    }
                     temp.store(&out_img[r][c]);
                 }
-                else
+                for (; c < last_col; ++c)
                 {
-                    p.load(&out_img[r][c]);
-                    temp += p;
-                    temp.store(&out_img[r][c]);
+                    float temp = 0;
+                    for (long m = 0; m < col_filter.size(); ++m)
+                    {
+                        temp += scratch[r-first_row+m][c]*col_filter(m);
+                    }
+
+                    // save this pixel to the output image
+                    if (add_to == false)
+                    {
+                        out_img[r][c] = temp;
+                    }
+                    else
+                    {
+                        out_img[r][c] += temp;
+                    }
                 }
             }
-            for (; c < last_col; ++c)
+        }
+
+        template <
+            typename in_image_type,
+            typename out_image_type,
+            typename EXP1,
+            typename EXP2
+            >
+        rectangle float_separable_filter (
+            const in_image_type& in_img_,
+            out_image_type& out_img_,
+            const matrix_exp<EXP1>& _row_filter,
+            const matrix_exp<EXP2>& _col_filter,
+            out_image_type& scratch_,
+            bool add_to,
+            thread_pool* tp
+        )
+        {
+            // You can only use this function with images and filters containing float
+            // variables.
+            COMPILE_TIME_ASSERT((is_float_filtering<in_image_type,out_image_type,EXP1,EXP2>::value == true));
+
+
+            const_temp_matrix<EXP1> row_filter(_row_filter);
+            const_temp_matrix<EXP2> col_filter(_col_filter);
+            DLIB_ASSERT(row_filter.size() != 0 && col_filter.size() != 0 &&
+                is_vector(row_filter) &&
+                is_vector(col_filter),
+                "\trectangle float_spatially_filter_image_separable()"
+                << "\n\t Invalid inputs were given to this function."
+                << "\n\t row_filter.size(): "<< row_filter.size()
+                << "\n\t col_filter.size(): "<< col_filter.size()
+                << "\n\t is_vector(row_filter): "<< is_vector(row_filter)
+                << "\n\t is_vector(col_filter): "<< is_vector(col_filter)
+            );
+            DLIB_ASSERT(is_same_object(in_img_, out_img_) == false,
+                "\trectangle float_spatially_filter_image_separable()"
+                << "\n\tYou must give two different image objects"
+            );
+
+
+            const_image_view<in_image_type> in_img(in_img_);
+            image_view<out_image_type> out_img(out_img_);
+
+            // if there isn't any input image then don't do anything
+            if (in_img.size() == 0)
             {
-                float temp = 0;
-                for (long m = 0; m < col_filter.size(); ++m)
-                {
-                    temp += scratch[r-first_row+m][c]*col_filter(m);
-                }
+                out_img.clear();
+                return rectangle();
+            }
 
-                // save this pixel to the output image
-                if (add_to == false)
+            out_img.set_size(in_img.nr(),in_img.nc());
+
+            // figure out the range that we should apply the filter to
+            const long first_row = col_filter.size()/2;
+            const long first_col = row_filter.size()/2;
+            const long last_row = in_img.nr() - ((col_filter.size()-1)/2);
+            const long last_col = in_img.nc() - ((row_filter.size()-1)/2);
+
+            const rectangle non_border = rectangle(first_col, first_row, last_col-1, last_row-1);
+            if (!add_to)
+                zero_border_pixels(out_img, non_border); 
+
+            image_view<out_image_type> scratch(scratch_);
+            scratch.set_size(in_img.nr(), in_img.nc());
+
+            if (tp)
+            {
+                // Each block of rows is independent of the others so the output doesn't
+                // depend on how the rows get split up.
+                parallel_for_blocked(*tp, 0, in_img.nr(), [&](long begin, long end)
                 {
-                    out_img[r][c] = temp;
+                    float_filter_rows(in_img, scratch, row_filter, first_col, last_col, begin, end);
+                });
+                if (first_row < last_row)
+                {
+                    parallel_for_blocked(*tp, first_row, last_row, [&](long begin, long end)
+                    {
+                        float_filter_cols(scratch, out_img, col_filter, first_row, first_col, last_col, begin, end, add_to);
+                    });
                 }
-                else
+            }
+            else
+            {
+                // Run the column filter on each output row as soon as the row filter has
+                // made the last scratch row it needs, while those rows are still in cache.
+                for (long r = 0; r < in_img.nr(); ++r)
                 {
-                    out_img[r][c] += temp;
+                    float_filter_rows(in_img, scratch, row_filter, first_col, last_col, r, r+1);
+                    const long out_r = r - (col_filter.size()-1) + first_row;
+                    if (out_r >= first_row)
+                        float_filter_cols(scratch, out_img, col_filter, first_row, first_col, last_col, out_r, out_r+1, add_to);
                 }
             }
+            return non_border;
         }
-        return non_border;
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    // This overload is optimized to use SIMD instructions when filtering float images with
+    // float filters.
+    template <
+        typename in_image_type,
+        typename out_image_type,
+        typename EXP1,
+        typename EXP2
+        >
+    rectangle float_spatially_filter_image_separable (
+        const in_image_type& in_img,
+        out_image_type& out_img,
+        const matrix_exp<EXP1>& row_filter,
+        const matrix_exp<EXP2>& col_filter,
+        out_image_type& scratch,
+        bool add_to = false
+    )
+    {
+        return impl::float_separable_filter(in_img, out_img, row_filter, col_filter, scratch, add_to, 0);
+    }
+
+    template <
+        typename in_image_type,
+        typename out_image_type,
+        typename EXP1,
+        typename EXP2
+        >
+    rectangle float_spatially_filter_image_separable (
+        const in_image_type& in_img,
+        out_image_type& out_img,
+        const matrix_exp<EXP1>& row_filter,
+        const matrix_exp<EXP2>& col_filter,
+        out_image_type& scratch,
+        bool add_to,
+        thread_pool& tp
+    )
+    {
+        return impl::float_separable_filter(in_img, out_img, row_filter, col_filter, scratch, add_to, &tp);
     }
 
 // ----------------------------------------------------------------------------------------
@@ -750,6 +899,40 @@ namespace dlib
         }
     }
 
+    template <
+        typename in_image_type,
+        typename out_image_type,
+        typename EXP1,
+        typename EXP2,
+        typename T
+        >
+    typename enable_if_c<pixel_traits<typename image_traits<out_image_type>::pixel_type>::grayscale && 
+                         is_float_filtering<in_image_type,out_image_type,EXP1,EXP2>::value,rectangle>::type 
+    spatially_filter_image_separable (
+        const in_image_type& in_img,
+        out_image_type& out_img,
+        const matrix_exp<EXP1>& row_filter,
+        const matrix_exp<EXP2>& col_filter,
+        T scale,
+        bool use_abs,
+        bool add_to,
+        thread_pool& tp
+    )
+    {
+        if (use_abs == false)
+        {
+            out_image_type scratch;
+            if (scale == 1)
+                return float_spatially_filter_image_separable(in_img, out_img, row_filter, col_filter, scratch, add_to, tp);
+            else
+                return float_spatially_filter_image_separable(in_img, out_img, row_filter/scale, col_filter, scratch,  add_to, tp);
+        }
+        else
+        {
+            return impl::grayscale_spatially_filter_image_separable(in_img, out_img, row_filter, col_filter, scale, true, add_to, &tp);
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -774,6 +957,29 @@ namespace dlib
         return impl::grayscale_spatially_filter_image_separable(in_img,out_img, row_filter, col_filter, scale, use_abs, add_to);
     }
 
+    template <
+        typename in_image_type,
+        typename out_image_type,
+        typename EXP1,
+        typename EXP2,
+        typename T
+        >
+    typename enable_if_c<pixel_traits<typename image_traits<out_image_type>::pixel_type>::grayscale && 
+                         !is_float_filtering<in_image_type,out_image_type,EXP1,EXP2>::value,rectangle>::type 
+    spatially_filter_image_separable (
+        const in_image_type& in_img,
+        out_image_type& out_img,
+        const matrix_exp<EXP1>& row_filter,
+        const matrix_exp<EXP2>& col_filter,
+        T scale,
+        bool use_abs,
+        bool add_to,
+        thread_pool& tp
+    )
+    {
+        return impl::grayscale_spatially_filter_image_separable(in_img,out_img, row_filter, col_filter, scale, use_abs, add_to, &tp);
+    }
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -69,6 +69,36 @@ namespace dlib
             - if (use_abs == false && all images and filers contain float types) then
                 - This function will use SIMD instructions and is particularly fast.  So if
                   you can use this form of the function it can give a decent speed boost.
+                  The SIMD code sums each output pixel in the same order as a plain
+                  scalar loop would, so it gives exactly the same results.
+    !*/
+
+    template <
+        typename in_image_type,
+        typename out_image_type,
+        typename EXP1,
+        typename EXP2,
+        typename T
+        >
+    rectangle spatially_filter_image_separable (
+        const in_image_type& in_img,
+        out_image_type& out_img,
+        const matrix_exp<EXP1>& row_filter,
+        const matrix_exp<EXP2>& col_filter,
+        T scale,
+        bool use_abs,
+        bool add_to,
+        thread_pool& tp
+    );
+    /*!
+        requires
+            - The requirements of the above spatially_filter_image_separable() are met.
+            - in_img and out_img contain grayscale pixels.
+        ensures
+            - This function is identical to the above spatially_filter_image_separable()
+              except that the row and column filtering passes are split into blocks of
+              rows that are processed in parallel by the threads in tp.  The output is
+              exactly the same as the output of the single threaded version.
     !*/
 
 // ----------------------------------------------------------------------------------------
@@ -182,6 +212,32 @@ namespace dlib
               allocated and freed for each call.
     !*/
 
+    template <
+        typename in_image_type,
+        typename out_image_type,
+        typename EXP1,
+        typename EXP2
+        >
+    rectangle float_spatially_filter_image_separable (
+        const in_image_type& in_img,
+        out_image_type& out_img,
+        const matrix_exp<EXP1>& row_filter,
+        const matrix_exp<EXP2>& col_filter,
+        out_image_type& scratch,
+        bool add_to,
+        thread_pool& tp
+    );
+    /*!
+        requires
+            - The requirements of the above float_spatially_filter_image_separable() are
+              met.
+        ensures
+            - This function is identical to the above float_spatially_filter_image_separable()
+              except that the rows of the image are split into blocks that are filtered in
+              parallel by the threads in tp.  The output is exactly the same as the output
+              of the single threaded version.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
     template <
@@ -1848,6 +1848,75 @@ namespace dlib
         matrix<T,NR,NC,mm,l>& b
     ) { a.swap(b); }
 
+    namespace impl
+    {
+        template <typename T, long NR, long NC, typename mm>
+        typename enable_if_c<ser_helper::bulk_element_traits<T>::value,bool>::type serialize_matrix_bulk (
+            const matrix<T,NR,NC,mm,row_major_layout>& item, 
+            std::ostream& out
+        )
+        {
+            ser_helper::serialize_bulk_header<T>(out);
+            serialize(item.nr(),out);
+            serialize(item.nc(),out);
+            if (item.size() != 0)
+                ser_helper::serialize_bulk_elements(&item(0,0), item.size(), out);
+            return true;
+        }
+
+        // Column major matrices, and matrices of other types of objects, are written
+        // element by element.
+        template <typename T, long NR, long NC, typename mm, typename l>
+        bool serialize_matrix_bulk (
+            const matrix<T,NR,NC,mm,l>& ,
+            std::ostream& 
+        ) { return false; }
+
+        template <typename T, long NR, long NC, typename mm, typename l>
+        typename enable_if_c<ser_helper::bulk_element_traits<T>::value>::type deserialize_matrix_bulk (
+            matrix<T,NR,NC,mm,l>& item, 
+            std::istream& in
+        )
+        {
+            char kind;
+            unsigned char size;
+            ser_helper::deserialize_bulk_header(kind, size, in);
+            long nr, nc;
+            deserialize(nr,in);
+            deserialize(nc,in);
+            if (nr < 0 || nc < 0)
+                abort();
+            if (NR != 0 && nr != NR)
+                abort();
+            if (NC != 0 && nc != NC)
+                abort();
+
+            item.set_size(nr,nc);
+            if (item.size() == 0)
+                return;
+            if (is_same_type<l,row_major_layout>::value)
+            {
+                ser_helper::deserialize_bulk_elements(&item(0,0), item.size(), kind, size, in);
+            }
+            else
+            {
+                std::vector<T> row(nc);
+                for (long r = 0; r < nr; ++r)
+                {
+                    ser_helper::deserialize_bulk_elements(&row[0], nc, kind, size, in);
+                    for (long c = 0; c < nc; ++c)
+                        item(r,c) = row[c];
+                }
+            }
+        }
+
+        template <typename T, long NR, long NC, typename mm, typename l>
+        typename disable_if_c<ser_helper::bulk_element_traits<T>::value>::type deserialize_matrix_bulk (
+            matrix<T,NR,NC,mm,l>& ,
+            std::istream& 
+        ) { abort(); }
+    }
+
     template <
         typename T,
         long NR,
@@ -1862,6 +1931,9 @@ namespace dlib
     {
         try
         {
+            if (impl::serialize_matrix_bulk(item,out))
+                return;
+
             // The reason the serialization is a little funny is because we are trying to
             // maintain backwards compatibility with an older serialization format used by
             // dlib while also encoding things in a way that lets the array2d and matrix
@@ -1896,6 +1968,12 @@ namespace dlib
     {
         try
         {
+            if (ser_helper::bulk_format_is_next(in))
+            {
+                impl::deserialize_matrix_bulk(item,in);
+                return;
+            }
+
             long nr, nc;
             deserialize(nr,in); 
             deserialize(nc,in); 
@@ -7,6 +7,8 @@
 #include "matrix.h"
 #include "matrix_utilities.h"
 #include "../enable_if.h"
+#include "../simd.h"
+#include <vector>
 
 namespace dlib
 {
@@ -61,6 +63,268 @@ namespace dlib
         matrix_assign_default(dest, lhs*rhs, 1, true);
     }
 
+// ------------------------------------------------------------------------------------
+
+    namespace ma
+    {
+        /*!
+            The following is a register and cache blocked float matrix multiply built on
+            dlib's simd8f type.  It follows the usual GotoBLAS design.  Blocks of lhs and
+            rhs are copied ("packed") into contiguous buffers laid out in the exact order
+            the micro-kernel reads them, and the micro-kernel then computes a
+            gemm_mr x gemm_nr tile of the output entirely in registers.  Since packing
+            reads the inputs through their operator(), lhs and rhs can be arbitrary float
+            matrix expressions.
+        !*/
+
+#ifdef DLIB_HAVE_AVX
+        // With AVX there are 16 ymm registers, enough for a 6x16 tile of accumulators
+        // plus the rhs values.
+        const long gemm_mr = 6;
+        const long gemm_nv = 2;
+#else
+        const long gemm_mr = 4;
+        const long gemm_nv = 1;
+#endif
+        // The number of output columns computed by one call to the micro-kernel.
+        const long gemm_nr = 8*gemm_nv;
+        // Cache blocking sizes.  A gemm_kc x gemm_nc panel of rhs is packed so it stays in
+        // the L2/L3 cache while gemm_mc x gemm_kc panels of lhs are streamed through the
+        // L1/L2 cache.
+        const long gemm_kc = 256;
+        const long gemm_mc = 12*gemm_mr;
+        const long gemm_nc = 128*gemm_nr;
+
+        inline simd8f gemm_mul_add (
+            const simd8f& a,
+            const simd8f& b,
+            const simd8f& c
+        )
+        {
+#if defined(DLIB_HAVE_AVX) && defined(DLIB_HAVE_FMA)
+            return _mm256_fmadd_ps(a,b,c);
+#else
+            return a*b + c;
+#endif
+        }
+
+        inline void gemm_micro_kernel (
+            const long kc,
+            const float* a,
+            const float* b,
+            float* c
+        )
+        /*!
+            requires
+                - a points to a packed gemm_mr x kc block of lhs, stored column by column.
+                - b points to a packed kc x gemm_nr block of rhs, stored row by row.
+                - c points to space for gemm_mr*gemm_nr floats.
+            ensures
+                - #c == the gemm_mr x gemm_nr row major matrix given by the product of
+                  the a and b blocks.
+        !*/
+        {
+            simd8f acc[gemm_mr][gemm_nv];
+            for (long r = 0; r < gemm_mr; ++r)
+                for (long v = 0; v < gemm_nv; ++v)
+                    acc[r][v] = simd8f(0.0f);
+
+            for (long p = 0; p < kc; ++p)
+            {
+                simd8f bv[gemm_nv];
+                for (long v = 0; v < gemm_nv; ++v)
+                    bv[v].load(b + p*gemm_nr + 8*v);
+                for (long r = 0; r < gemm_mr; ++r)
+                {
+                    const simd8f av(a[p*gemm_mr + r]);
+                    for (long v = 0; v < gemm_nv; ++v)
+                        acc[r][v] = gemm_mul_add(av, bv[v], acc[r][v]);
+                }
+            }
+
+            for (long r = 0; r < gemm_mr; ++r)
+                for (long v = 0; v < gemm_nv; ++v)
+                    acc[r][v].store(c + r*gemm_nr + 8*v);
+        }
+
+        template <
+            typename EXP1,
+            typename EXP2
+            >
+        void packed_float_multiply (
+            float* dest,
+            const long dest_row_stride,
+            const EXP1& lhs,
+            const EXP2& rhs,
+            const float alpha,
+            const long row_begin,
+            const long row_end,
+            const long col_begin,
+            const long col_end
+        )
+        /*!
+            requires
+                - lhs.nc() == rhs.nr()
+                - 0 <= row_begin <= row_end <= lhs.nr()
+                - 0 <= col_begin <= col_end <= rhs.nc()
+                - dest points to the top left corner of a row major float matrix with
+                  lhs.nr() rows, rhs.nc() columns, and dest_row_stride floats between the
+                  starts of consecutive rows.
+            ensures
+                - Performs dest(r,c) += alpha*(lhs*rhs)(r,c) for all r in [row_begin,
+                  row_end) and c in [col_begin, col_end).  No other parts of dest are
+                  touched, so different threads can safely work on disjoint blocks of
+                  the same dest.
+        !*/
+        {
+            const long K = lhs.nc();
+            std::vector<float> apack(gemm_mc*gemm_kc);
+            std::vector<float> bpack(std::min(gemm_nc, col_end-col_begin+gemm_nr)*gemm_kc);
+            float tile[gemm_mr*gemm_nr];
+
+            for (long jc = col_begin; jc < col_end; jc += gemm_nc)
+            {
+                const long nc = std::min(gemm_nc, col_end-jc);
+                for (long pc = 0; pc < K; pc += gemm_kc)
+                {
+                    const long kc = std::min(gemm_kc, K-pc);
+
+                    // Pack a kc x nc block of rhs into gemm_nr wide slivers, padding the
+                    // last sliver with zeros.
+                    for (long jr = 0; jr < nc; jr += gemm_nr)
+                    {
+                        float* bp = &bpack[jr*kc];
+                        const long nr = std::min(gemm_nr, nc-jr);
+                        for (long p = 0; p < kc; ++p)
+                        {
+                            long j = 0;
+                            for (; j < nr; ++j)
+                                bp[p*gemm_nr + j] = rhs(pc+p, jc+jr+j);
+                            for (; j < gemm_nr; ++j)
+                                bp[p*gemm_nr + j] = 0;
+                        }
+                    }
+
+                    for (long ic = row_begin; ic < row_end; ic += gemm_mc)
+                    {
+                        const long mc = std::min(gemm_mc, row_end-ic);
+
+                        // Pack an mc x kc block of lhs into gemm_mr tall slivers, padding
+                        // the last sliver with zeros.
+                        for (long ir = 0; ir < mc; ir += gemm_mr)
+                        {
+                            float* ap = &apack[ir*kc];
+                            const long mr = std::min(gemm_mr, mc-ir);
+                            for (long p = 0; p < kc; ++p)
+                            {
+                                long i = 0;
+                                for (; i < mr; ++i)
+                                    ap[p*gemm_mr + i] = lhs(ic+ir+i, pc+p);
+                                for (; i < gemm_mr; ++i)
+                                    ap[p*gemm_mr + i] = 0;
+                            }
+                        }
+
+                        for (long jr = 0; jr < nc; jr += gemm_nr)
+                        {
+                            const long nr = std::min(gemm_nr, nc-jr);
+                            for (long ir = 0; ir < mc; ir += gemm_mr)
+                            {
+                                const long mr = std::min(gemm_mr, mc-ir);
+                                gemm_micro_kernel(kc, &apack[ir*kc], &bpack[jr*kc], tile);
+                                float* d = dest + (ic+ir)*dest_row_stride + jc+jr;
+                                for (long i = 0; i < mr; ++i)
+                                {
+                                    for (long j = 0; j < nr; ++j)
+                                        d[i*dest_row_stride + j] += alpha*tile[i*gemm_nr + j];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename T>
+        struct is_row_major_float_matrix { static const bool value = false; };
+        template <long NR, long NC, typename MM>
+        struct is_row_major_float_matrix<matrix<float,NR,NC,MM,row_major_layout> > { static const bool value = true; };
+
+        template <
+            typename matrix_dest_type,
+            typename EXP1,
+            typename EXP2
+            >
+        typename enable_if<is_row_major_float_matrix<matrix_dest_type> >::type 
+        float_matrix_multiply (
+            matrix_dest_type& dest,
+            const EXP1& lhs,
+            const EXP2& rhs
+        )
+        {
+            packed_float_multiply(&dest(0,0), dest.nc(), lhs, rhs, 1, 0, lhs.nr(), 0, rhs.nc());
+        }
+
+        template <
+            typename matrix_dest_type,
+            typename EXP1,
+            typename EXP2
+            >
+        typename disable_if<is_row_major_float_matrix<matrix_dest_type> >::type 
+        float_matrix_multiply (
+            matrix_dest_type& dest,
+            const EXP1& lhs,
+            const EXP2& rhs
+        )
+        {
+            // dest isn't a simple contiguous matrix so compute into a temporary first.
+            matrix<float> temp(dest.nr(), dest.nc());
+            temp = 0;
+            packed_float_multiply(&temp(0,0), temp.nc(), lhs, rhs, 1, 0, lhs.nr(), 0, rhs.nc());
+            for (long r = 0; r < dest.nr(); ++r)
+            {
+                for (long c = 0; c < dest.nc(); ++c)
+                    dest(r,c) += temp(r,c);
+            }
+        }
+
+        template <typename dest_type, typename EXP1, typename EXP2>
+        struct use_packed_float_multiply
+        {
+            const static bool value = is_same_type<typename dest_type::type,float>::value &&
+                                      is_same_type<typename EXP1::type,float>::value &&
+                                      is_same_type<typename EXP2::type,float>::value;
+        };
+    }
+
+// ------------------------------------------------------------------------------------
+
+    template <
+        typename matrix_dest_type,
+        typename EXP1,
+        typename EXP2
+        >
+    typename enable_if_c<ma::matrix_is_vector<EXP1>::value == false && ma::matrix_is_vector<EXP2>::value == false &&
+                         ma::use_packed_float_multiply<matrix_dest_type,EXP1,EXP2>::value>::type 
+    default_matrix_multiply (
+        matrix_dest_type& dest,
+        const EXP1& lhs,
+        const EXP2& rhs
+    )
+    {
+        // if the matrices are small enough then just use the simple multiply algorithm
+        if (lhs.nc() <= 2 || rhs.nc() <= 2 || lhs.nr() <= 2 || rhs.nr() <= 2 || (lhs.size() <= 900 && rhs.size() <= 900) )
+        {
+            matrix_assign_default(dest, lhs*rhs, 1, true);
+        }
+        else
+        {
+            ma::float_matrix_multiply(dest, lhs, rhs);
+        }
+    }
+
 // ------------------------------------------------------------------------------------
 
     template <
@@ -68,7 +332,8 @@ namespace dlib
         typename EXP1,
         typename EXP2
         >
-    typename enable_if_c<ma::matrix_is_vector<EXP1>::value == false && ma::matrix_is_vector<EXP2>::value == false>::type 
+    typename enable_if_c<ma::matrix_is_vector<EXP1>::value == false && ma::matrix_is_vector<EXP2>::value == false &&
+                         !ma::use_packed_float_multiply<matrix_dest_type,EXP1,EXP2>::value>::type 
     default_matrix_multiply (
         matrix_dest_type& dest,
         const EXP1& lhs,
@@ -7,6 +7,13 @@
 #include "matrix_utilities.h"
 #include "../hash.h"
 #include "../algs.h"
+#include "../noncopyable.h"
+#include "../numeric_constants.h"
+#include <complex>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
 
 
 // No using FFTW until it becomes thread safe!
@@ -149,6 +156,20 @@ namespace dlib
                 return &data[p][0];
             }
 
+            const std::complex<T>* get_twiddles (
+                int p
+            ) const
+            /*!
+                requires
+                    - 0 <= p <= 64
+                    - the non-const get_twiddles(p) has been called previously.
+                ensures
+                    - returns a pointer to the twiddle factors needed by R8TX if nxtlt == 2^p
+            !*/
+            {
+                return &data[p][0];
+            }
+
         private:
             std::vector<std::vector<std::complex<T> > > data;
         };
@@ -217,35 +238,36 @@ namespace dlib
         }
 
     // ------------------------------------------------------------------------------------
-
-        template <typename T, long NR, long NC, typename MM, typename layout>
-        void fft1d_inplace(matrix<std::complex<T>,NR,NC,MM,layout>& data, bool do_backward_fft, twiddles<T>& cs)
+        template <typename T>
+        void fft1d_pow2_inplace(std::complex<T>* const b, const long size, bool do_backward_fft, const twiddles<T>& cs)
         /*!
             requires
-                - is_vector(data) == true
-                - is_power_of_two(data.size()) == true
+                - b points to an array of size elements
+                - is_power_of_two(size) == true
+                - cs.get_twiddles(p) has already been called in non-const form for every
+                  p this transform needs (fft_plan takes care of this).
             ensures
                 - This routine replaces the input std::complex<double> vector by its finite
-                  discrete complex fourier transform if do_backward_fft==true.  It replaces
+                  discrete complex fourier transform if do_backward_fft==false.  It replaces
                   the input std::complex<double> vector by its finite discrete complex
-                  inverse fourier transform if do_backward_fft==false.
+                  inverse fourier transform if do_backward_fft==true.  The inverse is not
+                  divided by size.
 
                   The implementation is a radix-2 FFT, but with faster shortcuts for
                   radix-4 and radix-8. It performs as many radix-8 iterations as possible,
                   and then finishes with a radix-2 or -4 iteration if needed.
         !*/
         {
-            if (data.size() == 0)
+            if (size == 0)
                 return;
 
-            std::complex<T>* const b = &data(0);
             int L[16],L1,L2,L3,L4,L5,L6,L7,L8,L9,L10,L11,L12,L13,L14,L15;
             int j1,j2,j3,j4,j5,j6,j7,j8,j9,j10,j11,j12,j13,j14;
             int j, ij, ji;
             int n2pow, n8pow, nthpo, ipass, nxtlt, length;
 
-            n2pow = fastlog2(data.size());
-            nthpo = data.size();
+            n2pow = fastlog2(size);
+            nthpo = size;
 
             n8pow = n2pow/3;
 
@@ -311,13 +333,508 @@ namespace dlib
             // unscramble outputs
             if(!do_backward_fft) 
             {
-                for(long i=1, j=data.size()-1; i<data.size()/2; i++,j--)
+                for(long i=1, j=size-1; i<size/2; i++,j--)
                 {
                     swap(b[j], b[i]);
                 }
             }
         }
 
+    // ------------------------------------------------------------------------------------
+
+        /*
+            The mixed radix routines below are a decimation in time FFT in the style of
+            Mark Borgerding's KISS FFT.  They handle any size of the form 2^a 3^b 5^c.
+            Each butterfly only computes forward transforms.  tw points to the
+            exp(-2*pi*i*k/n) values for the full transform size n.
+        */
+
+        template <typename T>
+        void mixed_radix_bfly2(std::complex<T>* out, const std::complex<T>* tw, long fstride, long m)
+        {
+            std::complex<T>* out2 = out + m;
+            for (long k = 0; k < m; ++k)
+            {
+                const std::complex<T> t = out2[k]*tw[k*fstride];
+                out2[k] = out[k] - t;
+                out[k] += t;
+            }
+        }
+
+        template <typename T>
+        void mixed_radix_bfly3(std::complex<T>* out, const std::complex<T>* tw, long fstride, long m)
+        {
+            const T epi3 = tw[fstride*m].imag();
+            for (long k = 0; k < m; ++k)
+            {
+                const std::complex<T> s1 = out[k+m]*tw[k*fstride];
+                const std::complex<T> s2 = out[k+2*m]*tw[2*k*fstride];
+                const std::complex<T> s3 = s1 + s2;
+                const std::complex<T> s0 = (s1 - s2)*epi3;
+
+                const std::complex<T> t = out[k] - s3*(T)0.5;
+                out[k] += s3;
+                out[k+2*m] = std::complex<T>(t.real() + s0.imag(), t.imag() - s0.real());
+                out[k+m]   = std::complex<T>(t.real() - s0.imag(), t.imag() + s0.real());
+            }
+        }
+
+        template <typename T>
+        void mixed_radix_bfly4(std::complex<T>* out, const std::complex<T>* tw, long fstride, long m)
+        {
+            for (long k = 0; k < m; ++k)
+            {
+                const std::complex<T> s0 = out[k+m]*tw[k*fstride];
+                const std::complex<T> s1 = out[k+2*m]*tw[2*k*fstride];
+                const std::complex<T> s2 = out[k+3*m]*tw[3*k*fstride];
+                const std::complex<T> s5 = out[k] - s1;
+                const std::complex<T> s3 = s0 + s2;
+                const std::complex<T> s4 = s0 - s2;
+                const std::complex<T> s6 = out[k] + s1;
+
+                out[k]     = s6 + s3;
+                out[k+2*m] = s6 - s3;
+                out[k+m]   = std::complex<T>(s5.real() + s4.imag(), s5.imag() - s4.real());
+                out[k+3*m] = std::complex<T>(s5.real() - s4.imag(), s5.imag() + s4.real());
+            }
+        }
+
+        template <typename T>
+        void mixed_radix_bfly5(std::complex<T>* out, const std::complex<T>* tw, long fstride, long m)
+        {
+            const std::complex<T> ya = tw[fstride*m];
+            const std::complex<T> yb = tw[fstride*2*m];
+            for (long k = 0; k < m; ++k)
+            {
+                const std::complex<T> s0 = out[k];
+                const std::complex<T> s1 = out[k+m]*tw[k*fstride];
+                const std::complex<T> s2 = out[k+2*m]*tw[2*k*fstride];
+                const std::complex<T> s3 = out[k+3*m]*tw[3*k*fstride];
+                const std::complex<T> s4 = out[k+4*m]*tw[4*k*fstride];
+
+                const std::complex<T> s7 = s1 + s4;
+                const std::complex<T> s10 = s1 - s4;
+                const std::complex<T> s8 = s2 + s3;
+                const std::complex<T> s9 = s2 - s3;
+
+                out[k] = s0 + s7 + s8;
+
+                const std::complex<T> s5 = s0 + s7*ya.real() + s8*yb.real();
+                const std::complex<T> s6(s10.imag()*ya.imag() + s9.imag()*yb.imag(),
+                                        -s10.real()*ya.imag() - s9.real()*yb.imag());
+                out[k+m]   = s5 - s6;
+                out[k+4*m] = s5 + s6;
+
+                const std::complex<T> s11 = s0 + s7*yb.real() + s8*ya.real();
+                const std::complex<T> s12(-s10.imag()*yb.imag() + s9.imag()*ya.imag(),
+                                          s10.real()*yb.imag() - s9.real()*ya.imag());
+                out[k+2*m] = s11 + s12;
+                out[k+3*m] = s11 - s12;
+            }
+        }
+
+        template <typename T>
+        void mixed_radix_work(
+            std::complex<T>* out,
+            const std::complex<T>* in,
+            long fstride,
+            const long* factors,
+            const std::complex<T>* tw
+        )
+        /*!
+            requires
+                - factors is a list of (p,m) pairs as made by fft_plan.
+            ensures
+                - writes the FFT of the p*m elements in[0], in[fstride], in[2*fstride], ...
+                  to out.
+        !*/
+        {
+            const long p = factors[0];
+            const long m = factors[1];
+
+            if (m == 1)
+            {
+                for (long i = 0; i < p; ++i)
+                    out[i] = in[i*fstride];
+            }
+            else
+            {
+                // Recursively compute the p sub-transforms of the decimated inputs.
+                for (long i = 0; i < p; ++i)
+                    mixed_radix_work(out + i*m, in + i*fstride, fstride*p, factors+2, tw);
+            }
+
+            switch (p)
+            {
+                case 2: mixed_radix_bfly2(out, tw, fstride, m); break;
+                case 3: mixed_radix_bfly3(out, tw, fstride, m); break;
+                case 4: mixed_radix_bfly4(out, tw, fstride, m); break;
+                case 5: mixed_radix_bfly5(out, tw, fstride, m); break;
+            }
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename T>
+        class fft_plan : noncopyable
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This object holds everything needed to compute FFTs of one size.
+                    Powers of two go to the radix-8 code above.  Sizes with only 2, 3,
+                    and 5 as prime factors use the mixed radix butterflies.  Anything
+                    else is done with Bluestein's algorithm, which turns the transform
+                    into a circular convolution that is computed with power of two FFTs.
+
+                    Once constructed a plan is never modified, so it can be shared by
+                    any number of threads.  Use get_fft_plan() to get cached plans.
+            !*/
+        public:
+
+            explicit fft_plan (
+                long n_
+            ) : n(n_)
+            {
+                if (n <= 1)
+                    return;
+
+                if (is_power_of_two(n))
+                {
+                    const int n2pow = fastlog2(n);
+                    for (int ipass = 1; ipass <= n2pow/3; ++ipass)
+                        pow2_twiddles.get_twiddles(n2pow - 3*ipass);
+                    return;
+                }
+
+                long remaining = n;
+                while (remaining > 1)
+                {
+                    long p;
+                    if (remaining%4 == 0)      p = 4;
+                    else if (remaining%2 == 0) p = 2;
+                    else if (remaining%3 == 0) p = 3;
+                    else if (remaining%5 == 0) p = 5;
+                    else break;
+                    remaining /= p;
+                    factors.push_back(p);
+                    factors.push_back(remaining);
+                }
+
+                if (remaining == 1)
+                {
+                    tw.resize(n);
+                    for (long k = 0; k < n; ++k)
+                        tw[k] = std::polar(1.0, -2*pi*k/n);
+                    return;
+                }
+
+                // Bluestein's algorithm.  Since jk == (j*j + k*k - (k-j)*(k-j))/2 the DFT
+                // can be written as a convolution with the chirp exp(-pi*i*k*k/n).
+                factors.clear();
+                long m = 1;
+                while (m < 2*n-1)
+                    m *= 2;
+                sub_plan.reset(new fft_plan<T>(m));
+
+                chirp.resize(n);
+                for (long k = 0; k < n; ++k)
+                {
+                    // Reduce k*k mod 2n so the angle stays accurate for large k.
+                    const long long kk = ((long long)k*k)%(2*n);
+                    chirp[k] = std::polar(1.0, -pi*kk/n);
+                }
+
+                chirp_filter.assign(m, std::complex<T>(0));
+                chirp_filter[0] = std::conj(chirp[0]);
+                for (long k = 1; k < n; ++k)
+                    chirp_filter[k] = chirp_filter[m-k] = std::conj(chirp[k]);
+                sub_plan->execute(&chirp_filter[0], false);
+                // Fold the 1/m of the inverse transform into the filter.
+                for (auto& v : chirp_filter)
+                    v /= (T)m;
+            }
+
+            long size (
+            ) const { return n; }
+
+            void execute (
+                std::complex<T>* data,
+                bool do_backward_fft
+            ) const
+            /*!
+                requires
+                    - data points to an array of size() elements
+                ensures
+                    - replaces data with its forward FFT, or with its inverse FFT if
+                      do_backward_fft==true.  The inverse is not divided by size().
+            !*/
+            {
+                if (n <= 1)
+                    return;
+
+                if (factors.size() == 0 && !sub_plan)
+                {
+                    fft1d_pow2_inplace(data, n, do_backward_fft, pow2_twiddles);
+                    return;
+                }
+
+                // ifft(x) == conj(fft(conj(x))) so only forward kernels are needed.
+                if (do_backward_fft)
+                {
+                    for (long i = 0; i < n; ++i)
+                        data[i] = std::conj(data[i]);
+                }
+
+                if (sub_plan)
+                {
+                    const long m = sub_plan->size();
+                    std::vector<std::complex<T> > buf(m);
+                    for (long k = 0; k < n; ++k)
+                        buf[k] = data[k]*chirp[k];
+                    sub_plan->execute(&buf[0], false);
+                    for (long k = 0; k < m; ++k)
+                        buf[k] *= chirp_filter[k];
+                    sub_plan->execute(&buf[0], true);
+                    for (long k = 0; k < n; ++k)
+                        data[k] = buf[k]*chirp[k];
+                }
+                else
+                {
+                    const std::vector<std::complex<T> > in(data, data+n);
+                    mixed_radix_work(data, &in[0], 1, &factors[0], &tw[0]);
+                }
+
+                if (do_backward_fft)
+                {
+                    for (long i = 0; i < n; ++i)
+                        data[i] = std::conj(data[i]);
+                }
+            }
+
+        private:
+
+            long n;
+
+            // used for powers of two
+            twiddles<T> pow2_twiddles;
+
+            // used for mixed radix sizes
+            std::vector<long> factors;
+            std::vector<std::complex<T> > tw;
+
+            // used by Bluestein's algorithm
+            std::unique_ptr<fft_plan<T> > sub_plan;
+            std::vector<std::complex<T> > chirp;
+            std::vector<std::complex<T> > chirp_filter;
+        };
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename plan_type>
+        std::shared_ptr<const plan_type> get_cached_plan (
+            long n
+        )
+        /*!
+            ensures
+                - returns a plan_type(n) object.  Plans are cached, so asking for the same
+                  size again returns the same object rather than recomputing all its
+                  twiddle factors.  This function is threadsafe.
+        !*/
+        {
+            static std::mutex m;
+            static std::map<long, std::shared_ptr<const plan_type> > plans;
+
+            {
+                std::lock_guard<std::mutex> lock(m);
+                auto i = plans.find(n);
+                if (i != plans.end())
+                    return i->second;
+            }
+
+            // Build the plan without holding the lock since making a Bluestein plan
+            // needs another plan.
+            std::shared_ptr<const plan_type> plan(new plan_type(n));
+
+            std::lock_guard<std::mutex> lock(m);
+            // Don't let the cache grow without bound if someone uses lots of sizes.
+            if (plans.size() >= 64)
+                plans.clear();
+            return plans.insert(std::make_pair(n, plan)).first->second;
+        }
+
+        template <typename T>
+        std::shared_ptr<const fft_plan<T> > get_fft_plan (long n)
+        { return get_cached_plan<fft_plan<T> >(n); }
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename T>
+        class real_fft_plan : noncopyable
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This object computes FFTs of real sequences of length n.  For even n
+                    the n real values are packed into n/2 complex values, transformed with
+                    a half size complex FFT, and then separated, which is about twice as
+                    fast as a complex FFT of size n.  Odd sizes just use a complex FFT.
+            !*/
+        public:
+
+            explicit real_fft_plan (
+                long n_
+            ) : n(n_)
+            {
+                if (n%2 == 1)
+                {
+                    plan = get_fft_plan<T>(n);
+                    return;
+                }
+
+                plan = get_fft_plan<T>(n/2);
+                tw.resize(n/2+1);
+                for (long k = 0; k <= n/2; ++k)
+                    tw[k] = std::polar(1.0, -2*pi*k/n);
+            }
+
+            long size (
+            ) const { return n; }
+
+            void forward (
+                const T* x,
+                std::complex<T>* out
+            ) const
+            {
+                std::vector<std::complex<T> > work;
+                forward(x, out, work);
+            }
+
+            void forward (
+                const T* x,
+                std::complex<T>* out,
+                std::vector<std::complex<T> >& work
+            ) const
+            /*!
+                requires
+                    - x points to size() elements and out to size()/2+1 elements.
+                ensures
+                    - out == the first size()/2+1 elements of the FFT of x.  The rest are
+                      implied by conjugate symmetry.
+                    - work is used as scratch space.  Passing the same vector to each call
+                      avoids allocating memory over and over.
+            !*/
+            {
+                if (n%2 == 1)
+                {
+                    std::vector<std::complex<T> >& buf = work;
+                    buf.assign(x, x+n);
+                    plan->execute(&buf[0], false);
+                    std::copy(buf.begin(), buf.begin()+n/2+1, out);
+                    return;
+                }
+
+                const long h = n/2;
+                std::vector<std::complex<T> >& z = work;
+                z.resize(h);
+                for (long j = 0; j < h; ++j)
+                    z[j] = std::complex<T>(x[2*j], x[2*j+1]);
+                plan->execute(&z[0], false);
+
+                // z held the even samples in its real part and the odd samples in its
+                // imaginary part.  Separate their transforms and do one last radix-2 step.
+                for (long k = 0; k <= h; ++k)
+                {
+                    const std::complex<T> zk = z[k%h];
+                    const std::complex<T> znk = std::conj(z[(h-k)%h]);
+                    const std::complex<T> even = (zk + znk)*(T)0.5;
+                    const std::complex<T> odd = (zk - znk)*std::complex<T>(0,-0.5);
+                    out[k] = even + tw[k]*odd;
+                }
+            }
+
+            void backward (
+                const std::complex<T>* in,
+                T* x
+            ) const
+            {
+                std::vector<std::complex<T> > work;
+                backward(in, x, work);
+            }
+
+            void backward (
+                const std::complex<T>* in,
+                T* x,
+                std::vector<std::complex<T> >& work
+            ) const
+            /*!
+                requires
+                    - in points to size()/2+1 elements and x to size() elements.
+                ensures
+                    - x == the real inverse FFT of the conjugate symmetric sequence whose
+                      first size()/2+1 elements are in.  x is not divided by size().
+                    - work is used as scratch space.
+            !*/
+            {
+                if (n%2 == 1)
+                {
+                    std::vector<std::complex<T> >& buf = work;
+                    buf.resize(n);
+                    buf[0] = in[0];
+                    for (long k = 1; k <= n/2; ++k)
+                    {
+                        buf[k] = in[k];
+                        buf[n-k] = std::conj(in[k]);
+                    }
+                    plan->execute(&buf[0], true);
+                    for (long j = 0; j < n; ++j)
+                        x[j] = buf[j].real();
+                    return;
+                }
+
+                const long h = n/2;
+                std::vector<std::complex<T> >& z = work;
+                z.resize(h);
+                for (long k = 0; k < h; ++k)
+                {
+                    const std::complex<T> xk = in[k];
+                    const std::complex<T> xnk = std::conj(in[h-k]);
+                    const std::complex<T> even = xk + xnk;
+                    const std::complex<T> odd = (xk - xnk)*std::conj(tw[k]);
+                    z[k] = even + std::complex<T>(-odd.imag(), odd.real());
+                }
+                plan->execute(&z[0], true);
+                for (long j = 0; j < h; ++j)
+                {
+                    x[2*j] = z[j].real();
+                    x[2*j+1] = z[j].imag();
+                }
+            }
+
+        private:
+
+            long n;
+            std::shared_ptr<const fft_plan<T> > plan;
+            std::vector<std::complex<T> > tw;
+        };
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename T>
+        std::shared_ptr<const real_fft_plan<T> > get_real_fft_plan (long n)
+        { return get_cached_plan<real_fft_plan<T> >(n); }
+
+    // ------------------------------------------------------------------------------------
+
+        template < typename T, long NR, long NC, typename MM, typename L >
+        void fft1d_inplace(
+            matrix<std::complex<T>,NR,NC,MM,L>& data,
+            bool do_backward_fft
+        )
+        {
+            if (data.size() == 0)
+                return;
+            get_fft_plan<T>(data.size())->execute(&data(0), do_backward_fft);
+        }
+
     // ------------------------------------------------------------------------------------
 
         template < typename T, long NR, long NC, typename MM, typename L >
@@ -330,13 +847,14 @@ namespace dlib
                 return;
 
             matrix<std::complex<double> > buff;
-            twiddles<double> cs;
+            const auto row_plan = get_fft_plan<double>(data.nc());
+            const auto col_plan = get_fft_plan<double>(data.nr());
 
             // Compute transform row by row
             for(long r=0; r<data.nr(); ++r) 
             {
                 buff = matrix_cast<std::complex<double> >(rowm(data,r));
-                fft1d_inplace(buff, do_backward_fft, cs);
+                row_plan->execute(&buff(0), do_backward_fft);
                 set_rowm(data,r) = matrix_cast<std::complex<T> >(buff);
             }
 
@@ -344,7 +862,7 @@ namespace dlib
             for(long c=0; c<data.nc(); ++c) 
             {
                 buff = matrix_cast<std::complex<double> >(colm(data,c));
-                fft1d_inplace(buff, do_backward_fft, cs);
+                col_plan->execute(&buff(0), do_backward_fft);
                 set_colm(data,c) = matrix_cast<std::complex<T> >(buff);
             }
         }
@@ -361,28 +879,19 @@ namespace dlib
             bool do_backward_fft
         )
         {
-            // make sure requires clause is not broken
-            DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-                "\t matrix fft(data)"
-                << "\n\t The number of rows and columns must be powers of two."
-                << "\n\t data.nr(): "<< data.nr()
-                << "\n\t data.nc(): "<< data.nc()
-                << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-                << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
-            );
-
             if (data.size() == 0)
                 return;
 
             matrix<std::complex<double> > buff;
             data_out.set_size(data.nr(), data.nc());
-            twiddles<double> cs;
+            const auto row_plan = get_fft_plan<double>(data.nc());
+            const auto col_plan = get_fft_plan<double>(data.nr());
 
             // Compute transform row by row
             for(long r=0; r<data.nr(); ++r) 
             {
                 buff = matrix_cast<std::complex<double> >(rowm(data,r));
-                fft1d_inplace(buff, do_backward_fft, cs);
+                row_plan->execute(&buff(0), do_backward_fft);
                 set_rowm(data_out,r) = matrix_cast<std::complex<T> >(buff);
             }
 
@@ -390,7 +899,7 @@ namespace dlib
             for(long c=0; c<data_out.nc(); ++c) 
             {
                 buff = matrix_cast<std::complex<double> >(colm(data_out,c));
-                fft1d_inplace(buff, do_backward_fft, cs);
+                col_plan->execute(&buff(0), do_backward_fft);
                 set_colm(data_out,c) = matrix_cast<std::complex<T> >(buff);
             }
         }
@@ -406,21 +915,11 @@ namespace dlib
     {
         // You have to give a complex matrix
         COMPILE_TIME_ASSERT(is_complex<typename EXP::type>::value);
-        // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t matrix fft(data)"
-            << "\n\t The number of rows and columns must be powers of two."
-            << "\n\t data.nr(): "<< data.nr()
-            << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
-            );
 
         if (data.nr() == 1 || data.nc() == 1)
         {
             matrix<typename EXP::type> temp(data);
-            impl::twiddles<typename EXP::type::value_type> cs;
-            impl::fft1d_inplace(temp, false, cs);
+            impl::fft1d_inplace(temp, false);
             return temp;
         }
         else
@@ -436,15 +935,6 @@ namespace dlib
     {
         // You have to give a complex matrix
         COMPILE_TIME_ASSERT(is_complex<typename EXP::type>::value);
-        // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t matrix ifft(data)"
-            << "\n\t The number of rows and columns must be powers of two."
-            << "\n\t data.nr(): "<< data.nr()
-            << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
-            );
 
         matrix<typename EXP::type> temp;
         if (data.size() == 0)
@@ -453,8 +943,7 @@ namespace dlib
         if (data.nr() == 1 || data.nc() == 1)
         {
             temp = data;
-            impl::twiddles<typename EXP::type::value_type> cs;
-            impl::fft1d_inplace(temp, true, cs);
+            impl::fft1d_inplace(temp, true);
         }
         else
         {
@@ -466,48 +955,135 @@ namespace dlib
 
 // ----------------------------------------------------------------------------------------
 
-    template < typename T, long NR, long NC, typename MM, typename L >
-    void fft_inplace (matrix<std::complex<T>,NR,NC,MM,L>& data)
-    // Note that we don't divide the outputs by data.size() so this isn't quite the inverse.
+    template <typename EXP>
+    matrix<std::complex<typename EXP::type> > rfft (const matrix_exp<EXP>& data)
     {
+        typedef typename EXP::type T;
+        // You have to give a real floating point matrix
+        COMPILE_TIME_ASSERT(is_float_type<T>::value);
+
+        matrix<std::complex<T> > out;
+        if (data.size() == 0)
+            return out;
+
+        const matrix<T> temp(data);
+        if (data.nr() == 1 || data.nc() == 1)
+        {
+            if (data.nc() == 1)
+                out.set_size(data.size()/2+1, 1);
+            else
+                out.set_size(1, data.size()/2+1);
+            impl::get_real_fft_plan<T>(data.size())->forward(&temp(0,0), &out(0,0));
+            return out;
+        }
+
+        // Real transforms along the rows, then complex ones down the remaining columns.
+        out.set_size(data.nr(), data.nc()/2+1);
+        const auto row_plan = impl::get_real_fft_plan<T>(data.nc());
+        for (long r = 0; r < data.nr(); ++r)
+            row_plan->forward(&temp(r,0), &out(r,0));
+
+        const auto col_plan = impl::get_fft_plan<T>(data.nr());
+        matrix<std::complex<T>,0,1> buff;
+        for (long c = 0; c < out.nc(); ++c)
+        {
+            buff = colm(out,c);
+            col_plan->execute(&buff(0), false);
+            set_colm(out,c) = buff;
+        }
+        return out;
+    }
+
+    template <typename EXP>
+    matrix<typename EXP::type::value_type> irfft (
+        const matrix_exp<EXP>& data,
+        long n
+    )
+    {
+        typedef typename EXP::type::value_type T;
+        // You have to give a complex matrix
+        COMPILE_TIME_ASSERT(is_complex<typename EXP::type>::value);
+        const bool is_vect = data.nr() == 1 || data.nc() == 1;
         // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t void fft_inplace(data)"
-            << "\n\t The number of rows and columns must be powers of two."
+        DLIB_CASSERT(data.size() > 0 && n > 0 && n/2+1 == (is_vect ? data.size() : data.nc()),
+            "\t matrix irfft(data, n)"
+            << "\n\t n must match the size of the half spectrum in data."
             << "\n\t data.nr(): "<< data.nr()
             << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
+            << "\n\t n:         "<< n
             );
 
-        if (data.nr() == 1 || data.nc() == 1)
+        matrix<T> out;
+        if (is_vect)
         {
-            impl::twiddles<T> cs;
-            impl::fft1d_inplace(data, false, cs);
+            const matrix<std::complex<T> > temp(data);
+            if (data.nc() == 1)
+                out.set_size(n, 1);
+            else
+                out.set_size(1, n);
+            impl::get_real_fft_plan<T>(n)->backward(&temp(0,0), &out(0,0));
+            out /= n;
+            return out;
         }
-        else
+
+        // Undo the column transforms, then do real inverse transforms along the rows.
+        matrix<std::complex<T> > temp(data);
+        const auto col_plan = impl::get_fft_plan<T>(data.nr());
+        matrix<std::complex<T>,0,1> buff;
+        for (long c = 0; c < temp.nc(); ++c)
         {
-            impl::fft2d_inplace(data, false);
+            buff = colm(temp,c);
+            col_plan->execute(&buff(0), true);
+            set_colm(temp,c) = buff;
         }
+
+        out.set_size(data.nr(), n);
+        const auto row_plan = impl::get_real_fft_plan<T>(n);
+        for (long r = 0; r < data.nr(); ++r)
+            row_plan->backward(&temp(r,0), &out(r,0));
+        out /= out.size();
+        return out;
     }
 
-    template < typename T, long NR, long NC, typename MM, typename L >
-    void ifft_inplace (matrix<std::complex<T>,NR,NC,MM,L>& data)
+    template <typename EXP>
+    matrix<typename EXP::type::value_type> irfft (
+        const matrix_exp<EXP>& data
+    )
     {
+        const bool is_vect = data.nr() == 1 || data.nc() == 1;
+        const long m = is_vect ? data.size() : data.nc();
         // make sure requires clause is not broken
-        DLIB_CASSERT(is_power_of_two(data.nr()) && is_power_of_two(data.nc()),
-            "\t void ifft_inplace(data)"
-            << "\n\t The number of rows and columns must be powers of two."
+        DLIB_CASSERT(m >= 2,
+            "\t matrix irfft(data)"
+            << "\n\t data must contain at least 2 frequency components."
             << "\n\t data.nr(): "<< data.nr()
             << "\n\t data.nc(): "<< data.nc()
-            << "\n\t is_power_of_two(data.nr()): " << is_power_of_two(data.nr())
-            << "\n\t is_power_of_two(data.nc()): " << is_power_of_two(data.nc())
             );
+        return irfft(data, 2*(m-1));
+    }
+
+// ----------------------------------------------------------------------------------------
 
+    template < typename T, long NR, long NC, typename MM, typename L >
+    void fft_inplace (matrix<std::complex<T>,NR,NC,MM,L>& data)
+    // Note that we don't divide the outputs by data.size() so this isn't quite the inverse.
+    {
+        if (data.nr() == 1 || data.nc() == 1)
+        {
+            impl::fft1d_inplace(data, false);
+        }
+        else
+        {
+            impl::fft2d_inplace(data, false);
+        }
+    }
+
+    template < typename T, long NR, long NC, typename MM, typename L >
+    void ifft_inplace (matrix<std::complex<T>,NR,NC,MM,L>& data)
+    {
         if (data.nr() == 1 || data.nc() == 1)
         {
-            impl::twiddles<T> cs;
-            impl::fft1d_inplace(data, true, cs);
+            impl::fft1d_inplace(data, true);
         }
         else
         {
@@ -29,8 +29,6 @@ namespace dlib
     /*!
         requires
             - data contains elements of type std::complex<>
-            - is_power_of_two(data.nr()) == true
-            - is_power_of_two(data.nc()) == true
         ensures
             - Computes the 1 or 2 dimensional discrete Fourier transform of the given data
               matrix and returns it.  In particular, we return a matrix D such that:
@@ -40,6 +38,11 @@ namespace dlib
                 - starting with D(0,0), D contains progressively higher frequency components
                   of the input data.
                 - ifft(D) == D
+            - Any size is supported.  Sizes with only 2, 3, and 5 as prime factors use
+              fast mixed radix kernels while other sizes fall back on Bluestein's
+              algorithm, so every transform takes O(N*log(N)) time.  The twiddle factors
+              for each size are cached, making repeated transforms of the same size
+              cheaper.  This function is threadsafe.
     !*/
 
 // ----------------------------------------------------------------------------------------
@@ -51,8 +54,6 @@ namespace dlib
     /*!
         requires
             - data contains elements of type std::complex<>
-            - is_power_of_two(data.nr()) == true
-            - is_power_of_two(data.nc()) == true
         ensures
             - Computes the 1 or 2 dimensional inverse discrete Fourier transform of the
               given data vector and returns it.  In particular, we return a matrix D such
@@ -62,6 +63,80 @@ namespace dlib
                 - fft(D) == data 
     !*/
 
+// ----------------------------------------------------------------------------------------
+
+    template <typename EXP>
+    matrix<std::complex<typename EXP::type> > rfft (
+        const matrix_exp<EXP>& data
+    );
+    /*!
+        requires
+            - data contains real floating point values (i.e. float, double, or long double)
+        ensures
+            - Computes the 1 or 2 dimensional discrete Fourier transform of the given real
+              data.  Since the transform of real data is conjugate symmetric only the
+              non-redundant half is returned.  In particular, we return a matrix D such
+              that:
+                - if (data.nr() == 1 || data.nc() == 1) then
+                    - D is a vector with the same orientation as data.
+                    - D.size() == data.size()/2+1
+                    - D == the first data.size()/2+1 elements of fft(complex_matrix(data))
+                - else
+                    - D.nr() == data.nr()
+                    - D.nc() == data.nc()/2+1
+                    - D == the first data.nc()/2+1 columns of fft(complex_matrix(data))
+            - For even sizes this is about twice as fast as calling fft() on a complex
+              version of data.
+    !*/
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename EXP>
+    matrix<typename EXP::type::value_type> irfft (
+        const matrix_exp<EXP>& data,
+        long n
+    );
+    /*!
+        requires
+            - data contains elements of type std::complex<>
+            - data.size() > 0
+            - n > 0
+            - if (data.nr() == 1 || data.nc() == 1) then
+                - n/2+1 == data.size()
+            - else
+                - n/2+1 == data.nc()
+        ensures
+            - This function is the inverse of rfft().  data is taken to be the
+              non-redundant half of a conjugate symmetric spectrum, such as the output of
+              rfft(), and the real inverse discrete Fourier transform of the full spectrum
+              is returned.  Since data doesn't say if the original length was even or odd
+              it is given by n.  In particular, we return a matrix D such that:
+                - if (data.nr() == 1 || data.nc() == 1) then
+                    - D is a vector with the same orientation as data.
+                    - D.size() == n
+                - else
+                    - D.nr() == data.nr()
+                    - D.nc() == n
+                - rfft(D) == data
+    !*/
+
+    template <typename EXP>
+    matrix<typename EXP::type::value_type> irfft (
+        const matrix_exp<EXP>& data
+    );
+    /*!
+        requires
+            - data contains elements of type std::complex<>
+            - if (data.nr() == 1 || data.nc() == 1) then
+                - data.size() >= 2
+            - else
+                - data.nc() >= 2
+        ensures
+            - returns irfft(data, 2*(M-1)) where M is data.size() if data is a vector and
+              data.nc() otherwise.  That is, the original data is assumed to have had an
+              even length.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
     template < 
@@ -77,8 +152,6 @@ namespace dlib
     /*!
         requires
             - data contains elements of type std::complex<>
-            - is_power_of_two(data.nr()) == true
-            - is_power_of_two(data.nc()) == true
         ensures
             - This function is identical to fft() except that it does the FFT in-place.
               That is, after this function executes we will have:
@@ -100,8 +173,6 @@ namespace dlib
     /*!
         requires
             - data contains elements of type std::complex<>
-            - is_power_of_two(data.nr()) == true
-            - is_power_of_two(data.nc()) == true
         ensures
             - This function is identical to ifft() except that it does the inverse FFT
               in-place.  That is, after this function executes we will have:
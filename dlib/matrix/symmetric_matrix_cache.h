@@ -8,6 +8,8 @@
 #include "../matrix.h"
 #include "../algs.h"
 #include "../array.h"
+#include "../threads.h"
+#include <memory>
 
 namespace dlib 
 {
@@ -19,10 +21,12 @@ namespace dlib
     {
         inline op_symm_cache( 
             const M& m_,
-            long max_size_megabytes_
+            long max_size_megabytes_,
+            unsigned long num_threads_ = 1
         ) : 
             basic_op_m<M>(m_),
             max_size_megabytes(max_size_megabytes_),
+            num_threads(num_threads_),
             is_initialized(false)
         {
             lookup.assign(this->m.nr(), -1);
@@ -36,6 +40,7 @@ namespace dlib
             basic_op_m<M>(item.m),
             diag_cache(item.diag_cache),
             max_size_megabytes(item.max_size_megabytes),
+            num_threads(item.num_threads),
             is_initialized(false)
         {
             lookup.assign(this->m.nr(), -1);
@@ -134,6 +139,9 @@ namespace dlib
                 rlookup.assign(size,-1);
                 next = 0;
 
+                if (num_threads > 1)
+                    tp.reset(new thread_pool(num_threads));
+
                 is_initialized = true;
             }
         }
@@ -186,7 +194,23 @@ namespace dlib
             rlookup[next] = c;
 
             // compute this column in the matrix and store it in the cache
-            cache[next] = matrix_cast<cache_element_type>(colm(this->m,c));
+            if (tp)
+            {
+                // Each thread evaluates a contiguous block of the column's elements.
+                // For something like a kernel_matrix() that's where essentially all the
+                // time goes.
+                matrix<type,0,1,typename M::mem_manager_type>& column = cache[next];
+                column.set_size(this->m.nr());
+                parallel_for_blocked(*tp, 0, this->m.nr(), [&](long begin, long end)
+                {
+                    for (long r = begin; r < end; ++r)
+                        column(r) = static_cast<type>(this->m(r,c));
+                });
+            }
+            else
+            {
+                cache[next] = matrix_cast<cache_element_type>(colm(this->m,c));
+            }
 
             next = (next + 1)%cache.size();
         }
@@ -199,6 +223,7 @@ namespace dlib
             - diag_cache == the diagonal of the original matrix
             - is_initialized == false 
             - max_size_megabytes == the max_size_megabytes from symmetric_matrix_cache()
+            - num_threads == the num_threads from symmetric_matrix_cache()
 
         CONVENTION
             - diag_cache == the diagonal of the original matrix
@@ -215,6 +240,10 @@ namespace dlib
 
                 - next == the next element in the cache table to use to cache something 
                 - references[i] == the number of outstanding references to cache element cache[i]
+                - if (num_threads > 1) then
+                    - tp == the thread pool used to compute new columns 
+                - else
+                    - tp is empty
 
                 - diag_reference_count == the number of outstanding references to diag_cache. 
                   (this isn't really needed.  It's just here so that we can reuse the matrix
@@ -230,6 +259,8 @@ namespace dlib
         mutable long next;
 
         const long max_size_megabytes;
+        const unsigned long num_threads;
+        mutable std::shared_ptr<thread_pool> tp;
         mutable bool is_initialized;
         mutable long diag_reference_count;
 
@@ -260,6 +291,30 @@ namespace dlib
         return matrix_op<op>(op(m.ref(), max_size_megabytes));
     }
 
+    template <
+        typename cache_element_type,
+        typename EXP
+        >
+    const matrix_op<op_symm_cache<EXP,cache_element_type> >  symmetric_matrix_cache (
+        const matrix_exp<EXP>& m,
+        long max_size_megabytes,
+        unsigned long num_threads
+    )
+    {
+        DLIB_ASSERT(m.size() > 0 && m.nr() == m.nc() && max_size_megabytes >= 0 && num_threads > 0, 
+            "\tconst matrix_exp symmetric_matrix_cache(const matrix_exp& m, max_size_megabytes, num_threads)"
+            << "\n\t You have given invalid arguments to this function"
+            << "\n\t m.nr():             " << m.nr()
+            << "\n\t m.nc():             " << m.nc() 
+            << "\n\t m.size():           " << m.size() 
+            << "\n\t max_size_megabytes: " << max_size_megabytes 
+            << "\n\t num_threads:        " << num_threads 
+            );
+
+        typedef op_symm_cache<EXP,cache_element_type> op;
+        return matrix_op<op>(op(m.ref(), max_size_megabytes, num_threads));
+    }
+
 // ----------------------------------------------------------------------------------------
 
     template <typename M, typename cache_element_type>
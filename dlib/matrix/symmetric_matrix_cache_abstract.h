@@ -55,6 +55,35 @@ namespace dlib
                       entire row/column/diagonal worth of data.  
     !*/
 
+    template <
+        typename cache_element_type
+        >
+    const matrix_exp symmetric_matrix_cache (
+        const matrix_exp& m,
+        long max_size_megabytes,
+        unsigned long num_threads
+    );
+    /*!
+        requires
+            - m.size() > 0
+            - m.nr() == m.nc()
+            - max_size_megabytes >= 0
+            - num_threads > 0
+            - It must be safe to evaluate the elements of m from several threads at once.
+              This is the case for kernel_matrix() expressions using any of the kernels
+              that come with dlib.
+        ensures
+            - This function is identical to symmetric_matrix_cache(m,max_size_megabytes)
+              except that columns of m which aren't in the cache are computed using
+              num_threads threads, each evaluating a different block of rows of the
+              column.  So if m is expensive to evaluate, as is the case for a
+              kernel_matrix() over many samples, loading a column into the cache takes
+              roughly 1/num_threads as long.
+            - Columns are only computed when they are requested.  Nothing is prefetched,
+              since the SMO solvers that use this cache only know which column they need
+              next once they have applied the current one to their gradient.
+    !*/
+
 // ----------------------------------------------------------------------------------------
 
 }
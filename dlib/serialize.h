@@ -129,6 +129,18 @@
         A bool value is serialized as the single byte character '1' or '0' in ASCII.
         Where '1' indicates true and '0' indicates false.
 
+    BULK SERIALIZATION FORMAT
+        std::vector, matrix, and array2d objects that contain float, double, or integral
+        types other than bool and the char types are serialized as one block of raw
+        values.  The block starts with the byte 0x5B (which is never a valid control byte
+        in the integral format, so it's always possible to tell this format apart from
+        the older element by element format, which is still read), a version byte, the
+        character 'f', 'i', or 'u' for floating point, signed, and unsigned elements
+        respectively, and the size in bytes of each element.  Then the container's
+        dimensions follow in the integral serialization format and finally the elements
+        themselves in little endian byte order.  When reading, elements are converted
+        to the receiving type if they were written from a different one.
+
     FLOATING POINT SERIALIZATION FORMAT
         To serialize a floating point value we convert it into a float_details object and
         then serialize the exponent and mantissa values using dlib's integral serialization
@@ -150,6 +162,7 @@
 #include <map>
 #include <set>
 #include <limits>
+#include <algorithm>
 #include "uintn.h"
 #include "interfaces/enumerable.h"
 #include "interfaces/map_pair.h"
@@ -938,6 +951,257 @@ namespace dlib
         }
     }
 
+// ----------------------------------------------------------------------------------------
+
+    namespace ser_helper
+    {
+        /*!A bulk_element_traits
+            This is a template that tells you if a type can be written with the bulk
+            serialization format.  For those types value == true and kind is 'f' for
+            floating point types, 'i' for signed integers, and 'u' for unsigned integers.
+        !*/
+
+        template <typename T> struct bulk_element_traits { const static bool value = false; const static char kind = 0; };
+
+        #define DLIB_DEFINE_BULK_ELEMENT(T,K) \
+        template <> struct bulk_element_traits<T> { const static bool value = true; const static char kind = K; };
+
+        DLIB_DEFINE_BULK_ELEMENT(float,'f')
+        DLIB_DEFINE_BULK_ELEMENT(double,'f')
+        DLIB_DEFINE_BULK_ELEMENT(short,'i')
+        DLIB_DEFINE_BULK_ELEMENT(int,'i')
+        DLIB_DEFINE_BULK_ELEMENT(long,'i')
+        DLIB_DEFINE_BULK_ELEMENT(int64,'i')
+        DLIB_DEFINE_BULK_ELEMENT(unsigned short,'u')
+        DLIB_DEFINE_BULK_ELEMENT(unsigned int,'u')
+        DLIB_DEFINE_BULK_ELEMENT(unsigned long,'u')
+        DLIB_DEFINE_BULK_ELEMENT(uint64,'u')
+
+        #undef DLIB_DEFINE_BULK_ELEMENT
+
+        // The integral serialization format never writes this as a control byte, so an
+        // object that starts with it can't be in one of the older formats.
+        const unsigned char bulk_format_tag = 0x5B;
+        const unsigned char bulk_format_version = 1;
+
+        inline bool bulk_format_is_next (
+            std::istream& in
+        )
+        {
+            return in.rdbuf()->sgetc() == bulk_format_tag;
+        }
+
+        template <typename T>
+        void serialize_bulk_header (
+            std::ostream& out
+        )
+        {
+            std::streambuf* sbuf = out.rdbuf();
+            const char header[4] = {(char)bulk_format_tag, (char)bulk_format_version,
+                                    bulk_element_traits<T>::kind, (char)sizeof(T)};
+            if (sbuf->sputn(header, sizeof(header)) != sizeof(header))
+            {
+                out.setstate(std::ios::eofbit | std::ios::badbit);
+                abort();
+            }
+        }
+
+        inline void deserialize_bulk_header (
+            char& kind,
+            unsigned char& size,
+            std::istream& in
+        )
+        {
+            std::streambuf* sbuf = in.rdbuf();
+            char header[4];
+            if (sbuf->sgetn(header, sizeof(header)) != sizeof(header))
+            {
+                in.setstate(std::ios::badbit);
+                abort();
+            }
+            if ((unsigned char)header[0] != bulk_format_tag || (unsigned char)header[1] != bulk_format_version)
+                abort();
+            kind = header[2];
+            size = (unsigned char)header[3];
+        }
+
+        template <typename T>
+        void serialize_bulk_elements (
+            const T* data,
+            size_t num,
+            std::ostream& out
+        )
+        /*!
+            ensures
+                - writes data[0] through data[num-1] to out as little endian values.
+        !*/
+        {
+            std::streambuf* sbuf = out.rdbuf();
+            byte_orderer bo;
+            if (bo.host_is_little_endian())
+            {
+                const std::streamsize bytes = num*sizeof(T);
+                if (sbuf->sputn((const char*)data, bytes) != bytes)
+                {
+                    out.setstate(std::ios::eofbit | std::ios::badbit);
+                    abort();
+                }
+                return;
+            }
+
+            T buf[1024];
+            while (num != 0)
+            {
+                const size_t n = std::min<size_t>(num, 1024);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    buf[i] = data[i];
+                    bo.host_to_little(buf[i]);
+                }
+                if (sbuf->sputn((const char*)buf, n*sizeof(T)) != (std::streamsize)(n*sizeof(T)))
+                {
+                    out.setstate(std::ios::eofbit | std::ios::badbit);
+                    abort();
+                }
+                data += n;
+                num -= n;
+            }
+        }
+
+        template <typename T>
+        void deserialize_bulk_elements (
+            T* data,
+            size_t num,
+            std::istream& in
+        )
+        /*!
+            ensures
+                - reads num little endian values of type T from in into data.
+        !*/
+        {
+            std::streambuf* sbuf = in.rdbuf();
+            const std::streamsize bytes = num*sizeof(T);
+            if (sbuf->sgetn((char*)data, bytes) != bytes)
+            {
+                in.setstate(std::ios::badbit);
+                abort();
+            }
+            byte_orderer bo;
+            if (bo.host_is_big_endian())
+            {
+                for (size_t i = 0; i < num; ++i)
+                    bo.little_to_host(data[i]);
+            }
+        }
+
+        template <typename U, typename T>
+        void deserialize_and_convert_bulk_elements (
+            T* data,
+            size_t num,
+            std::istream& in
+        )
+        {
+            U buf[1024];
+            while (num != 0)
+            {
+                const size_t n = std::min<size_t>(num, 1024);
+                deserialize_bulk_elements(buf, n, in);
+                for (size_t i = 0; i < n; ++i)
+                    data[i] = static_cast<T>(buf[i]);
+                data += n;
+                num -= n;
+            }
+        }
+
+        template <typename T>
+        void deserialize_bulk_elements (
+            T* data,
+            size_t num,
+            char kind,
+            unsigned char size,
+            std::istream& in
+        )
+        /*!
+            requires
+                - kind and size came from deserialize_bulk_header()
+            ensures
+                - reads num values of the given kind and size from in and stores them
+                  into data.  If they were written from some other type than T, such as a
+                  float being read into a double, they are converted to T.
+        !*/
+        {
+            if (kind == bulk_element_traits<T>::kind && size == sizeof(T))
+                deserialize_bulk_elements(data, num, in);
+            else if (kind == 'f' && size == sizeof(float))
+                deserialize_and_convert_bulk_elements<float>(data, num, in);
+            else if (kind == 'f' && size == sizeof(double))
+                deserialize_and_convert_bulk_elements<double>(data, num, in);
+            else if (kind == 'i' && size == 2)
+                deserialize_and_convert_bulk_elements<int16>(data, num, in);
+            else if (kind == 'i' && size == 4)
+                deserialize_and_convert_bulk_elements<int32>(data, num, in);
+            else if (kind == 'i' && size == 8)
+                deserialize_and_convert_bulk_elements<int64>(data, num, in);
+            else if (kind == 'u' && size == 2)
+                deserialize_and_convert_bulk_elements<uint16>(data, num, in);
+            else if (kind == 'u' && size == 4)
+                deserialize_and_convert_bulk_elements<uint32>(data, num, in);
+            else if (kind == 'u' && size == 8)
+                deserialize_and_convert_bulk_elements<uint64>(data, num, in);
+            else
+                abort();
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename T, typename alloc>
+        typename enable_if_c<bulk_element_traits<T>::value,bool>::type serialize_bulk (
+            const std::vector<T,alloc>& item,
+            std::ostream& out
+        )
+        {
+            serialize_bulk_header<T>(out);
+            const unsigned long size = static_cast<unsigned long>(item.size());
+            if (pack_int(size,out))
+                abort();
+            if (size != 0)
+                serialize_bulk_elements(&item[0], size, out);
+            return true;
+        }
+
+        template <typename T, typename alloc>
+        typename disable_if_c<bulk_element_traits<T>::value,bool>::type serialize_bulk (
+            const std::vector<T,alloc>& ,
+            std::ostream& 
+        ) { return false; }
+
+        template <typename T, typename alloc>
+        typename enable_if_c<bulk_element_traits<T>::value,bool>::type deserialize_bulk (
+            std::vector<T,alloc>& item,
+            std::istream& in
+        )
+        {
+            if (!bulk_format_is_next(in))
+                return false;
+            char kind;
+            unsigned char elsize;
+            deserialize_bulk_header(kind, elsize, in);
+            unsigned long size;
+            if (unpack_int(size,in))
+                abort();
+            item.resize(size);
+            if (size != 0)
+                deserialize_bulk_elements(&item[0], size, kind, elsize, in);
+            return true;
+        }
+
+        template <typename T, typename alloc>
+        typename disable_if_c<bulk_element_traits<T>::value,bool>::type deserialize_bulk (
+            std::vector<T,alloc>& ,
+            std::istream& 
+        ) { return false; }
+    }
+
 // ----------------------------------------------------------------------------------------
 
     template <typename T, typename alloc>
@@ -948,6 +1212,9 @@ namespace dlib
     {
         try
         { 
+            if (ser_helper::serialize_bulk(item,out))
+                return;
+
             const unsigned long size = static_cast<unsigned long>(item.size());
 
             serialize(size,out); 
@@ -966,6 +1233,9 @@ namespace dlib
     {
         try 
         { 
+            if (ser_helper::deserialize_bulk(item,in))
+                return;
+
             unsigned long size;
             deserialize(size,in); 
             item.resize(size);
@@ -22,6 +22,12 @@
                 #define DLIB_HAVE_AVX
             #endif
         #endif
+        // MSVC has no flag for FMA alone but every AVX2 capable CPU also has FMA.
+        #ifdef __AVX2__
+            #ifndef DLIB_HAVE_FMA
+                #define DLIB_HAVE_FMA
+            #endif
+        #endif
         #if (defined( _M_X64) || defined(_M_IX86_FP) && _M_IX86_FP >= 2) && !defined(DLIB_HAVE_SSE2)
             #define DLIB_HAVE_SSE2
         #endif
@@ -51,6 +57,11 @@
                 #define DLIB_HAVE_AVX2
             #endif
         #endif
+        #ifdef __FMA__
+            #ifndef DLIB_HAVE_FMA
+                #define DLIB_HAVE_FMA
+            #endif
+        #endif
     #endif
 #endif
 
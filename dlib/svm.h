@@ -38,6 +38,7 @@
 
 #include "svm/one_vs_one_decision_function.h"
 #include "svm/multiclass_tools.h"
+#include "svm/cross_validate_folds.h"
 #include "svm/cross_validate_multiclass_trainer.h"
 #include "svm/cross_validate_regression_trainer.h"
 #include "svm/cross_validate_object_detection_trainer.h"
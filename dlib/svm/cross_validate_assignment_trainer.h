@@ -7,6 +7,7 @@
 #include <vector>
 #include "../matrix.h"
 #include "svm.h"
+#include "cross_validate_folds.h"
 
 
 namespace dlib
@@ -74,7 +75,8 @@ namespace dlib
         const trainer_type& trainer,
         const std::vector<typename trainer_type::sample_type>& samples,
         const std::vector<typename trainer_type::label_type>& labels,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     )
     {
         // make sure requires clause is not broken
@@ -82,11 +84,13 @@ namespace dlib
         if (trainer.forces_assignment())
         {
             DLIB_ASSERT(is_forced_assignment_problem(samples, labels) &&
-                        1 < folds && folds <= static_cast<long>(samples.size()),
+                        1 < folds && folds <= static_cast<long>(samples.size()) &&
+                        num_threads > 0,
                 "\t double cross_validate_assignment_trainer()"
                 << "\n\t invalid inputs were given to this function"
                 << "\n\t samples.size(): " << samples.size() 
                 << "\n\t folds:  " << folds 
+                << "\n\t num_threads:  " << num_threads 
                 << "\n\t is_forced_assignment_problem(samples,labels): " << is_forced_assignment_problem(samples,labels)
                 << "\n\t is_assignment_problem(samples,labels):        " << is_assignment_problem(samples,labels)
                 << "\n\t is_learning_problem(samples,labels):          " << is_learning_problem(samples,labels)
@@ -95,11 +99,13 @@ namespace dlib
         else
         {
             DLIB_ASSERT(is_assignment_problem(samples, labels) &&
-                        1 < folds && folds <= static_cast<long>(samples.size()),
+                        1 < folds && folds <= static_cast<long>(samples.size()) &&
+                        num_threads > 0,
                 "\t double cross_validate_assignment_trainer()"
                 << "\n\t invalid inputs were given to this function"
                 << "\n\t samples.size(): " << samples.size() 
                 << "\n\t folds:  " << folds 
+                << "\n\t num_threads:  " << num_threads 
                 << "\n\t is_assignment_problem(samples,labels): " << is_assignment_problem(samples,labels)
                 << "\n\t is_learning_problem(samples,labels):   " << is_learning_problem(samples,labels)
                 );
@@ -115,23 +121,17 @@ namespace dlib
         const long num_in_train = samples.size() - num_in_test;
 
 
-        std::vector<sample_type> samples_test, samples_train;
-        std::vector<label_type> labels_test, labels_train;
+        // the number of correct assignments and the total number of assignments made in
+        // each fold
+        std::vector<std::pair<double,double> > fold_counts(folds, std::make_pair(0.0,0.0));
 
-
-        long next_test_idx = 0;
-        double total_right = 0;
-        double total = 0;
-
-
-        for (long i = 0; i < folds; ++i)
+        run_cross_validation_folds(folds, num_threads, [&](long i)
         {
-            samples_test.clear();
-            labels_test.clear();
-            samples_train.clear();
-            labels_train.clear();
+            std::vector<sample_type> samples_test, samples_train;
+            std::vector<label_type> labels_test, labels_train;
 
             // load up the test samples
+            long next_test_idx = (i*num_in_test)%samples.size();
             for (long cnt = 0; cnt < num_in_test; ++cnt)
             {
                 samples_test.push_back(samples[next_test_idx]);
@@ -149,22 +149,32 @@ namespace dlib
             }
 
 
-            const typename trainer_type::trained_function_type& df = trainer.train(samples_train,labels_train);
+            const trainer_type fold_trainer(trainer);
+            const typename trainer_type::trained_function_type& df = fold_trainer.train(samples_train,labels_train);
 
             // check how good df is on the test data
-            for (unsigned long i = 0; i < samples_test.size(); ++i)
+            double& total_right = fold_counts[i].first;
+            double& total = fold_counts[i].second;
+            for (unsigned long k = 0; k < samples_test.size(); ++k)
             {
-                const std::vector<long>& out = df(samples_test[i]);
+                const std::vector<long>& out = df(samples_test[k]);
                 for (unsigned long j = 0; j < out.size(); ++j)
                 {
-                    if (out[j] == labels_test[i][j])
+                    if (out[j] == labels_test[k][j])
                         ++total_right;
 
                     ++total;
                 }
             }
+        });
 
-        } // for (long i = 0; i < folds; ++i)
+        double total_right = 0;
+        double total = 0;
+        for (long i = 0; i < folds; ++i)
+        {
+            total_right += fold_counts[i].first;
+            total += fold_counts[i].second;
+        }
 
         if (total != 0)
             return total_right/total;
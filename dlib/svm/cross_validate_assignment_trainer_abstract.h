@@ -42,7 +42,8 @@ namespace dlib
         const trainer_type& trainer,
         const std::vector<typename trainer_type::sample_type>& samples,
         const std::vector<typename trainer_type::label_type>& labels,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     );
     /*!
         requires
@@ -50,6 +51,7 @@ namespace dlib
             - if (trainer.forces_assignment()) then
                 - is_forced_assignment_problem(samples, labels) 
             - 1 < folds <= samples.size()
+            - num_threads > 0
             - trainer_type == dlib::structural_assignment_trainer or an object
               with a compatible interface.
         ensures
@@ -58,6 +60,9 @@ namespace dlib
               is tested using the output of the trainer and the fraction of assignments
               predicted correctly is returned.
             - The number of folds used is given by the folds argument.
+            - The folds are handed to run_cross_validation_folds() and so up to
+              num_threads of them are trained at once, each on a copy of trainer.  The
+              returned value is the same whatever num_threads is.
     !*/
 
 // ----------------------------------------------------------------------------------------
@@ -0,0 +1,69 @@
+// Copyright (C) 2026  agent (agent@local)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_CROSS_VALIDATE_FoLDS_Hh_
+#define DLIB_CROSS_VALIDATE_FoLDS_Hh_
+
+#include "cross_validate_folds_abstract.h"
+#include "../assert.h"
+#include "../threads.h"
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename fold_function
+        >
+    void run_cross_validation_folds (
+        const long folds,
+        const unsigned long num_threads,
+        const fold_function& funct
+    )
+    {
+        // make sure requires clause is not broken
+        DLIB_ASSERT(folds >= 0 && num_threads > 0,
+            "\t void run_cross_validation_folds()"
+            << "\n\t invalid inputs were given to this function"
+            << "\n\t folds:       " << folds 
+            << "\n\t num_threads: " << num_threads 
+            );
+
+        if (num_threads == 1 || folds <= 1)
+        {
+            for (long i = 0; i < folds; ++i)
+                funct(i);
+            return;
+        }
+
+        // An exception escaping from a thread_pool task would take down the whole
+        // program, so catch them here and rethrow the one from the earliest fold once
+        // everything has finished.  That way the caller sees the same exception it would
+        // have seen if the folds had been run one after another.
+        std::vector<std::exception_ptr> errors(folds);
+        thread_pool tp(std::min<unsigned long>(num_threads, folds));
+        for (long i = 0; i < folds; ++i)
+        {
+            tp.add_task_by_value([&funct,&errors,i]() {
+                try { funct(i); }
+                catch (...) { errors[i] = std::current_exception(); }
+            });
+        }
+        tp.wait_for_all_tasks();
+
+        for (long i = 0; i < folds; ++i)
+        {
+            if (errors[i])
+                std::rethrow_exception(errors[i]);
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_CROSS_VALIDATE_FoLDS_Hh_
+
@@ -0,0 +1,46 @@
+// Copyright (C) 2026  agent (agent@local)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#undef DLIB_CROSS_VALIDATE_FoLDS_ABSTRACT_Hh_
+#ifdef DLIB_CROSS_VALIDATE_FoLDS_ABSTRACT_Hh_
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    template <
+        typename fold_function
+        >
+    void run_cross_validation_folds (
+        const long folds,
+        const unsigned long num_threads,
+        const fold_function& funct
+    );
+    /*!
+        requires
+            - folds >= 0
+            - num_threads > 0
+            - funct must be a function object with the signature:
+                void funct(long fold)
+            - If num_threads > 1 then it must be safe to call funct from several threads
+              at once, provided each call is given a different fold. 
+        ensures
+            - Calls funct(i) for all i in the range [0, folds).  This is the executor the
+              cross_validate_*() routines use to evaluate their folds, so the usual way to
+              use it is to have funct(i) train and test on the i-th split and store its
+              results in element i of some vector.  Combining those per fold results in
+              fold order then gives the same answer no matter how many threads were used.
+            - If num_threads == 1 then the folds are processed one after another in the
+              calling thread.  Otherwise, up to num_threads folds are processed in
+              parallel.
+            - If any call to funct throws then this function throws the exception from
+              the call with the smallest fold index.  When running in parallel, this
+              happens only after all the other folds have finished.
+    !*/
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_CROSS_VALIDATE_FoLDS_ABSTRACT_Hh_
+
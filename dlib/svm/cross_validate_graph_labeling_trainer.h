@@ -6,6 +6,7 @@
 #include "../array.h"
 #include "../graph_cuts/min_cut.h"
 #include "svm.h"
+#include "cross_validate_folds.h"
 #include "cross_validate_graph_labeling_trainer_abstract.h"
 
 namespace dlib
@@ -111,7 +112,8 @@ namespace dlib
         const dlib::array<graph_type>& samples,
         const std::vector<std::vector<bool> >& labels,
         const std::vector<std::vector<double> >& losses,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     )
     {
 #ifdef ENABLE_ASSERTS
@@ -122,10 +124,12 @@ namespace dlib
             << "\n\t samples.size(): " << samples.size() 
             << "\n\t reason_for_failure: " << reason_for_failure 
             );
-        DLIB_ASSERT( 1 < folds && folds <= static_cast<long>(samples.size()),
+        DLIB_ASSERT( 1 < folds && folds <= static_cast<long>(samples.size()) &&
+                     num_threads > 0,
             "\t matrix cross_validate_graph_labeling_trainer()"
             << "\n\t invalid inputs were given to this function"
             << "\n\t folds:  " << folds 
+            << "\n\t num_threads:  " << num_threads 
             );
         DLIB_ASSERT((losses.size() == 0 || sizes_match(labels, losses) == true) &&
                     all_values_are_nonnegative(losses) == true,
@@ -144,31 +148,20 @@ namespace dlib
         const long num_in_train = samples.size() - num_in_test;
 
 
-        dlib::array<graph_type> samples_test, samples_train;
-        std::vector<label_type> labels_test, labels_train;
-        std::vector<std::vector<double> > losses_test, losses_train;
+        // For each fold this holds num_pos_correct, num_pos, num_neg_correct, and num_neg
+        // in that order.
+        std::vector<matrix<double,1,4> > fold_counts(folds);
 
-
-        long next_test_idx = 0;
-
-        std::vector<bool> temp;
-        double num_pos_correct = 0;
-        double num_pos = 0;
-        double num_neg_correct = 0;
-        double num_neg = 0;
-
-        graph_type gtemp;
-
-        for (long i = 0; i < folds; ++i)
+        run_cross_validation_folds(folds, num_threads, [&](long i)
         {
-            samples_test.clear();
-            labels_test.clear();
-            losses_test.clear();
-            samples_train.clear();
-            labels_train.clear();
-            losses_train.clear();
+            dlib::array<graph_type> samples_test, samples_train;
+            std::vector<label_type> labels_test, labels_train;
+            std::vector<std::vector<double> > losses_test, losses_train;
+
+            graph_type gtemp;
 
             // load up the test samples
+            long next_test_idx = (i*num_in_test)%samples.size();
             for (long cnt = 0; cnt < num_in_test; ++cnt)
             {
                 copy_graph(samples[next_test_idx], gtemp);
@@ -192,19 +185,25 @@ namespace dlib
             }
 
 
-            const typename trainer_type::trained_function_type& labeler = trainer.train(samples_train,labels_train,losses_train);
+            const trainer_type fold_trainer(trainer);
+            const typename trainer_type::trained_function_type& labeler = fold_trainer.train(samples_train,labels_train,losses_train);
 
             // check how good labeler is on the test data
-            for (unsigned long i = 0; i < samples_test.size(); ++i)
+            std::vector<bool> temp;
+            double num_pos_correct = 0;
+            double num_pos = 0;
+            double num_neg_correct = 0;
+            double num_neg = 0;
+            for (unsigned long k = 0; k < samples_test.size(); ++k)
             {
-                labeler(samples_test[i], temp);
-                for (unsigned long j = 0; j < labels_test[i].size(); ++j)
+                labeler(samples_test[k], temp);
+                for (unsigned long j = 0; j < labels_test[k].size(); ++j)
                 {
                     // What is the loss for this example?  It's just 1 unless we have a 
                     // per example loss vector.
-                    const double loss = (losses_test.size() == 0) ? 1.0 : losses_test[i][j];
+                    const double loss = (losses_test.size() == 0) ? 1.0 : losses_test[k][j];
 
-                    if (labels_test[i][j])
+                    if (labels_test[k][j])
                     {
                         num_pos += loss;
                         if (temp[j])
@@ -219,7 +218,20 @@ namespace dlib
                 }
             }
 
-        } // for (long i = 0; i < folds; ++i)
+            fold_counts[i] = num_pos_correct, num_pos, num_neg_correct, num_neg;
+        });
+
+        double num_pos_correct = 0;
+        double num_pos = 0;
+        double num_neg_correct = 0;
+        double num_neg = 0;
+        for (long i = 0; i < folds; ++i)
+        {
+            num_pos_correct += fold_counts[i](0);
+            num_pos         += fold_counts[i](1);
+            num_neg_correct += fold_counts[i](2);
+            num_neg         += fold_counts[i](3);
+        }
 
 
         matrix<double, 1, 2> res;
@@ -242,11 +254,12 @@ namespace dlib
         const trainer_type& trainer,
         const dlib::array<graph_type>& samples,
         const std::vector<std::vector<bool> >& labels,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     )
     {
         std::vector<std::vector<double> > losses;
-        return cross_validate_graph_labeling_trainer(trainer, samples, labels, losses, folds);
+        return cross_validate_graph_labeling_trainer(trainer, samples, labels, losses, folds, num_threads);
     }
 
 // ----------------------------------------------------------------------------------------
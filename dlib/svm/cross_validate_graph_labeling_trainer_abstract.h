@@ -81,12 +81,14 @@ namespace dlib
         const trainer_type& trainer,
         const dlib::array<graph_type>& samples,
         const std::vector<std::vector<bool> >& labels,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     );
     /*!
         requires
             - is_graph_labeling_problem(samples,labels) == true
             - 1 < folds <= samples.size()
+            - num_threads > 0
             - trainer_type == an object which trains some kind of graph labeler object
               (e.g. structural_graph_labeling_trainer)
         ensures
@@ -102,6 +104,9 @@ namespace dlib
               Therefore, if R is [1,1] then the labeler makes perfect predictions while
               an R of [0,0] indicates that it gets everything wrong.
             - The number of folds used is given by the folds argument.
+            - Up to num_threads folds are evaluated concurrently by
+              run_cross_validation_folds(), each training a copy of trainer.  R doesn't
+              depend on num_threads.
     !*/
 
 // ----------------------------------------------------------------------------------------
@@ -115,12 +120,14 @@ namespace dlib
         const dlib::array<graph_type>& samples,
         const std::vector<std::vector<bool> >& labels,
         const std::vector<std::vector<double> >& losses,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     );
     /*!
         requires
             - is_graph_labeling_problem(samples,labels) == true
             - 1 < folds <= samples.size()
+            - num_threads > 0
             - trainer_type == an object which trains some kind of graph labeler object
               (e.g. structural_graph_labeling_trainer)
             - if (losses.size() != 0) then
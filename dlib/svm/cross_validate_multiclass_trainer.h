@@ -6,6 +6,7 @@
 #include <vector>
 #include "../matrix.h"
 #include "cross_validate_multiclass_trainer_abstract.h"
+#include "cross_validate_folds.h"
 #include <sstream>
 
 namespace dlib
@@ -81,106 +82,86 @@ namespace dlib
         const trainer_type& trainer,
         const std::vector<sample_type>& x,
         const std::vector<label_type>& y,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     )
     {
         typedef typename trainer_type::mem_manager_type mem_manager_type;
 
         // make sure requires clause is not broken
         DLIB_ASSERT(is_learning_problem(x,y) == true &&
-                    1 < folds && folds <= static_cast<long>(x.size()),
+                    1 < folds && folds <= static_cast<long>(x.size()) &&
+                    num_threads > 0,
             "\tmatrix cross_validate_multiclass_trainer()"
             << "\n\t invalid inputs were given to this function"
             << "\n\t x.size(): " << x.size() 
             << "\n\t folds:  " << folds 
+            << "\n\t num_threads:  " << num_threads 
             << "\n\t is_learning_problem(x,y): " << is_learning_problem(x,y)
             );
 
         const std::vector<label_type> all_labels = select_all_distinct_labels(y);
 
-        // count the number of times each label shows up 
-        std::map<label_type,long> label_counts;
+        // find the indices of the samples with each label, in the order they appear in x
+        std::map<label_type,unsigned long> label_to_int;
+        for (unsigned long j = 0; j < all_labels.size(); ++j)
+            label_to_int[all_labels[j]] = j;
+        std::vector<std::vector<long> > label_idx(all_labels.size());
         for (unsigned long i = 0; i < y.size(); ++i)
-            label_counts[y[i]] += 1;
-
+            label_idx[label_to_int[y[i]]].push_back(i);
 
         // figure out how many samples from each class will be in the test and train splits 
-        std::map<label_type,long> num_in_test, num_in_train;
-        for (typename std::map<label_type,long>::iterator i = label_counts.begin(); i != label_counts.end(); ++i)
+        std::vector<long> num_in_test(all_labels.size()), num_in_train(all_labels.size());
+        for (unsigned long j = 0; j < all_labels.size(); ++j)
         {
-            const long in_test = i->second/folds;
+            const long count = label_idx[j].size();
+            const long in_test = count/folds;
             if (in_test == 0)
             {
                 std::ostringstream sout;
                 sout << "In dlib::cross_validate_multiclass_trainer(), the number of folds was larger" << std::endl;
                 sout << "than the number of elements of one of the training classes." << std::endl;
                 sout << "  folds: "<< folds << std::endl;
-                sout << "  size of class " << i->first << ": "<< i->second << std::endl;
+                sout << "  size of class " << all_labels[j] << ": "<< count << std::endl;
                 abort();
             }
-            num_in_test[i->first] = in_test; 
-            num_in_train[i->first] = i->second - in_test;
+            num_in_test[j] = in_test; 
+            num_in_train[j] = count - in_test;
         }
 
 
+        std::vector<matrix<double, 0, 0, mem_manager_type> > fold_results(folds);
 
-        std::vector<sample_type> x_test, x_train;
-        std::vector<label_type> y_test, y_train;
-
-        matrix<double, 0, 0, mem_manager_type> res;
-
-        std::map<label_type,long> next_test_idx;
-        for (unsigned long i = 0; i < all_labels.size(); ++i)
-            next_test_idx[all_labels[i]] = 0;
-
-        label_type label;
-
-        for (long i = 0; i < folds; ++i)
+        run_cross_validation_folds(folds, num_threads, [&](long i)
         {
-            x_test.clear();
-            y_test.clear();
-            x_train.clear();
-            y_train.clear();
+            std::vector<sample_type> x_test, x_train;
+            std::vector<label_type> y_test, y_train;
+
+            // Each fold tests on the num_in_test samples of each class that come after
+            // the ones the previous fold tested on, wrapping around at the end of x.  The
+            // samples that follow those are used for training.
 
             // load up the test samples
             for (unsigned long j = 0; j < all_labels.size(); ++j)
             {
-                label = all_labels[j];
-                long next = next_test_idx[label];
-
-                long cur = 0;
-                const long num_needed = num_in_test[label];
-                while (cur < num_needed)
+                const std::vector<long>& idx = label_idx[j];
+                for (long cnt = 0; cnt < num_in_test[j]; ++cnt)
                 {
-                    if (y[next] == label)
-                    {
-                        x_test.push_back(x[next]);
-                        y_test.push_back(label);
-                        ++cur;
-                    }
-                    next = (next + 1)%x.size();
+                    const long next = idx[(i*num_in_test[j] + cnt)%idx.size()];
+                    x_test.push_back(x[next]);
+                    y_test.push_back(all_labels[j]);
                 }
-
-                next_test_idx[label] = next;
             }
 
             // load up the training samples
             for (unsigned long j = 0; j < all_labels.size(); ++j)
             {
-                label = all_labels[j];
-                long next = next_test_idx[label];
-
-                long cur = 0;
-                const long num_needed = num_in_train[label];
-                while (cur < num_needed)
+                const std::vector<long>& idx = label_idx[j];
+                for (long cnt = 0; cnt < num_in_train[j]; ++cnt)
                 {
-                    if (y[next] == label)
-                    {
-                        x_train.push_back(x[next]);
-                        y_train.push_back(label);
-                        ++cur;
-                    }
-                    next = (next + 1)%x.size();
+                    const long next = idx[((i+1)*num_in_test[j] + cnt)%idx.size()];
+                    x_train.push_back(x[next]);
+                    y_train.push_back(all_labels[j]);
                 }
             }
 
@@ -188,14 +169,21 @@ namespace dlib
             try
             {
                 // do the training and testing
-                res += test_multiclass_decision_function(trainer.train(x_train,y_train),x_test,y_test);
+                const trainer_type fold_trainer(trainer);
+                fold_results[i] = test_multiclass_decision_function(fold_trainer.train(x_train,y_train),x_test,y_test);
             }
             catch (invalid_nu_error&)
             {
                 // just ignore cases which result in an invalid nu
             }
+        });
 
-        } // for (long i = 0; i < folds; ++i)
+        matrix<double, 0, 0, mem_manager_type> res;
+        for (long i = 0; i < folds; ++i)
+        {
+            if (fold_results[i].size() != 0)
+                res += fold_results[i];
+        }
 
         return res;
     }
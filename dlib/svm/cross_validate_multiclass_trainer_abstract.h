@@ -59,12 +59,14 @@ namespace dlib
         const trainer_type& trainer,
         const std::vector<sample_type>& x,
         const std::vector<label_type>& y,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     );
     /*!
         requires
             - is_learning_problem(x,y)
             - 1 < folds <= x.size()
+            - num_threads > 0
             - trainer_type == some kind of multiclass classification trainer object (e.g. one_vs_one_trainer)
         ensures
             - performs k-fold cross validation by using the given trainer to solve the
@@ -84,6 +86,9 @@ namespace dlib
               samples in a class is not an even multiple of folds.  This is because each fold has the 
               same number of test samples in it and so if the number of samples in a class isn't a 
               multiple of folds then a few are not tested.  
+            - The folds are run by run_cross_validation_folds() using up to num_threads
+              threads, each training its own copy of trainer.  Which samples land in
+              which fold doesn't depend on num_threads and so neither does C.
         throws
             - cross_validation_error
               This exception is thrown if one of the classes has fewer samples than
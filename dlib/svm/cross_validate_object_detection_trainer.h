@@ -11,6 +11,7 @@
 #include "../image_processing/full_object_detection.h"
 #include "../image_processing/box_overlap_testing.h"
 #include "../statistics.h"
+#include "cross_validate_folds.h"
 
 namespace dlib
 {
@@ -270,34 +271,38 @@ namespace dlib
         const std::vector<std::vector<rectangle> >& ignore,
         const long folds,
         const test_box_overlap& overlap_tester = test_box_overlap(),
-        const double adjust_threshold = 0
+        const double adjust_threshold = 0,
+        const unsigned long num_threads = 1
     )
     {
         // make sure requires clause is not broken
         DLIB_CASSERT( is_learning_problem(images,truth_dets) == true &&
                      ignore.size() == images.size() &&
-                     1 < folds && folds <= static_cast<long>(images.size()),
+                     1 < folds && folds <= static_cast<long>(images.size()) &&
+                     num_threads > 0,
                     "\t matrix cross_validate_object_detection_trainer()"
                     << "\n\t invalid inputs were given to this function"
                     << "\n\t is_learning_problem(images,truth_dets): " << is_learning_problem(images,truth_dets)
                     << "\n\t folds: "<< folds
+                    << "\n\t num_threads: "<< num_threads
                     << "\n\t ignore.size(): " << ignore.size() 
                     << "\n\t images.size(): " << images.size() 
                     );
 
-        double correct_hits = 0;
-        double total_true_targets = 0;
-
         const long test_size = images.size()/folds;
 
-        std::vector<std::pair<double,bool> > all_dets;
-        unsigned long missing_detections = 0;
-        unsigned long test_idx = 0;
-        for (long iter = 0; iter < folds; ++iter)
+        // the results of testing each fold
+        std::vector<double> fold_correct_hits(folds, 0);
+        std::vector<double> fold_true_targets(folds, 0);
+        std::vector<std::vector<std::pair<double,bool> > > fold_dets(folds);
+        std::vector<unsigned long> fold_missing_detections(folds, 0);
+
+        run_cross_validation_folds(folds, num_threads, [&](long iter)
         {
             std::vector<unsigned long> train_idx_set;
             std::vector<unsigned long> test_idx_set;
 
+            unsigned long test_idx = iter*test_size;
             for (long i = 0; i < test_size; ++i)
                 test_idx_set.push_back(test_idx++);
 
@@ -320,10 +325,21 @@ namespace dlib
                 std::vector<std::pair<double,rectangle> > hits; 
                 detector(images[test_idx_set[i]], hits, adjust_threshold);
 
-                correct_hits += impl::number_of_truth_hits(truth_dets[test_idx_set[i]], ignore[i], hits, overlap_tester, all_dets, missing_detections);
-                total_true_targets += truth_dets[test_idx_set[i]].size();
+                fold_correct_hits[iter] += impl::number_of_truth_hits(truth_dets[test_idx_set[i]], ignore[i], hits, overlap_tester, fold_dets[iter], fold_missing_detections[iter]);
+                fold_true_targets[iter] += truth_dets[test_idx_set[i]].size();
             }
+        });
 
+        double correct_hits = 0;
+        double total_true_targets = 0;
+        std::vector<std::pair<double,bool> > all_dets;
+        unsigned long missing_detections = 0;
+        for (long iter = 0; iter < folds; ++iter)
+        {
+            correct_hits += fold_correct_hits[iter];
+            total_true_targets += fold_true_targets[iter];
+            all_dets.insert(all_dets.end(), fold_dets[iter].begin(), fold_dets[iter].end());
+            missing_detections += fold_missing_detections[iter];
         }
 
         std::sort(all_dets.rbegin(), all_dets.rend());
@@ -359,7 +375,8 @@ namespace dlib
         const std::vector<std::vector<rectangle> >& ignore,
         const long folds,
         const test_box_overlap& overlap_tester = test_box_overlap(),
-        const double adjust_threshold = 0
+        const double adjust_threshold = 0,
+        const unsigned long num_threads = 1
     )
     {
         // convert into a list of regular rectangles.
@@ -372,7 +389,7 @@ namespace dlib
             }
         }
 
-        return cross_validate_object_detection_trainer(trainer, images, dets, ignore, folds, overlap_tester, adjust_threshold);
+        return cross_validate_object_detection_trainer(trainer, images, dets, ignore, folds, overlap_tester, adjust_threshold, num_threads);
     }
 
     template <
@@ -385,11 +402,12 @@ namespace dlib
         const std::vector<std::vector<rectangle> >& truth_dets,
         const long folds,
         const test_box_overlap& overlap_tester = test_box_overlap(),
-        const double adjust_threshold = 0
+        const double adjust_threshold = 0,
+        const unsigned long num_threads = 1
     )
     {
         const std::vector<std::vector<rectangle> > ignore(images.size());
-        return cross_validate_object_detection_trainer(trainer,images,truth_dets,ignore,folds,overlap_tester,adjust_threshold);
+        return cross_validate_object_detection_trainer(trainer,images,truth_dets,ignore,folds,overlap_tester,adjust_threshold,num_threads);
     }
 
     template <
@@ -402,11 +420,12 @@ namespace dlib
         const std::vector<std::vector<full_object_detection> >& truth_dets,
         const long folds,
         const test_box_overlap& overlap_tester = test_box_overlap(),
-        const double adjust_threshold = 0
+        const double adjust_threshold = 0,
+        const unsigned long num_threads = 1
     )
     {
         const std::vector<std::vector<rectangle> > ignore(images.size());
-        return cross_validate_object_detection_trainer(trainer,images,truth_dets,ignore,folds,overlap_tester,adjust_threshold);
+        return cross_validate_object_detection_trainer(trainer,images,truth_dets,ignore,folds,overlap_tester,adjust_threshold,num_threads);
     }
 
 // ----------------------------------------------------------------------------------------
@@ -145,17 +145,22 @@ namespace dlib
         const std::vector<std::vector<rectangle> >& ignore,
         const long folds,
         const test_box_overlap& overlap_tester = test_box_overlap(),
-        const double adjust_threshold = 0
+        const double adjust_threshold = 0,
+        const unsigned long num_threads = 1
     );
     /*!
         requires
             - is_learning_problem(images,truth_dets)
             - images.size() == ignore.size()
             - 1 < folds <= images.size()
+            - num_threads > 0
             - trainer_type == some kind of object detection trainer (e.g structural_object_detection_trainer)
             - image_array_type must be an implementation of dlib/array/array_kernel_abstract.h 
               and it must contain objects which can be accepted by detector().
             - it is legal to call trainer.train(images, truth_dets)
+            - if (num_threads > 1) then
+                - it is safe to call trainer.train() from multiple threads at the same
+                  time.  This is true for structural_object_detection_trainer.
         ensures
             - Performs k-fold cross-validation by using the given trainer to solve an
               object detection problem for the given number of folds.  Each fold is tested
@@ -163,6 +168,10 @@ namespace dlib
               returned.  The matrix contains the precision, recall, and average
               precision of the trained detectors and is defined identically to the
               test_object_detection_function() routine defined at the top of this file.
+            - Up to num_threads folds are trained and tested in parallel using
+              run_cross_validation_folds().  Object detection trainers usually aren't
+              copyable, so all the folds share the given trainer.  The returned matrix
+              doesn't depend on num_threads.
     !*/
 
     template <
@@ -176,7 +185,8 @@ namespace dlib
         const std::vector<std::vector<rectangle> >& ignore,
         const long folds,
         const test_box_overlap& overlap_tester = test_box_overlap(),
-        const double adjust_threshold = 0
+        const double adjust_threshold = 0,
+        const unsigned long num_threads = 1
     );
     /*!
         requires
@@ -198,7 +208,8 @@ namespace dlib
         const std::vector<std::vector<rectangle> >& truth_dets,
         const long folds,
         const test_box_overlap& overlap_tester = test_box_overlap(),
-        const double adjust_threshold = 0
+        const double adjust_threshold = 0,
+        const unsigned long num_threads = 1
     );
     /*!
         requires
@@ -218,7 +229,8 @@ namespace dlib
         const std::vector<std::vector<full_object_detection> >& truth_dets,
         const long folds,
         const test_box_overlap& overlap_tester = test_box_overlap(),
-        const double adjust_threshold = 0
+        const double adjust_threshold = 0,
+        const unsigned long num_threads = 1
     );
     /*!
         requires
@@ -7,6 +7,7 @@
 #include "../matrix.h"
 #include "../statistics.h"
 #include "cross_validate_regression_trainer_abstract.h"
+#include "cross_validate_folds.h"
 
 namespace dlib
 {
@@ -63,17 +64,20 @@ namespace dlib
         const trainer_type& trainer,
         const std::vector<sample_type>& x,
         const std::vector<label_type>& y,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     )
     {
 
         // make sure requires clause is not broken
         DLIB_ASSERT(is_learning_problem(x,y) == true &&
-                    1 < folds && folds <= static_cast<long>(x.size()),
+                    1 < folds && folds <= static_cast<long>(x.size()) &&
+                    num_threads > 0,
             "\tmatrix cross_validate_regression_trainer()"
             << "\n\t invalid inputs were given to this function"
             << "\n\t x.size(): " << x.size() 
             << "\n\t folds:  " << folds 
+            << "\n\t num_threads:  " << num_threads 
             << "\n\t is_learning_problem(x,y): " << is_learning_problem(x,y)
             );
 
@@ -82,24 +86,18 @@ namespace dlib
         const long num_in_test = x.size()/folds;
         const long num_in_train = x.size() - num_in_test;
 
-        running_stats<double> rs;
-        running_scalar_covariance<double> rc;
-
-        std::vector<sample_type> x_test, x_train;
-        std::vector<label_type> y_test, y_train;
-
+        // The predicted and true values for the test samples of each fold.  These are
+        // kept separately for each fold and only combined once all the folds are done so
+        // the results don't depend on the order in which the folds finish.
+        std::vector<std::vector<std::pair<double,double> > > fold_outputs(folds);
 
-        long next_test_idx = 0;
-
-
-        for (long i = 0; i < folds; ++i)
+        run_cross_validation_folds(folds, num_threads, [&](long i)
         {
-            x_test.clear();
-            y_test.clear();
-            x_train.clear();
-            y_train.clear();
+            std::vector<sample_type> x_test, x_train;
+            std::vector<label_type> y_test, y_train;
 
             // load up the test samples
+            long next_test_idx = (i*num_in_test)%x.size();
             for (long cnt = 0; cnt < num_in_test; ++cnt)
             {
                 x_test.push_back(x[next_test_idx]);
@@ -119,25 +117,33 @@ namespace dlib
 
             try
             {
-                const typename trainer_type::trained_function_type& df = trainer.train(x_train,y_train);
+                const trainer_type fold_trainer(trainer);
+                const typename trainer_type::trained_function_type& df = fold_trainer.train(x_train,y_train);
 
                 // do the training and testing
                 for (unsigned long j = 0; j < x_test.size(); ++j)
-                {
-                    // compute error
-                    const double output = df(x_test[j]);
-                    const double temp = output - y_test[j];
-
-                    rs.add(temp*temp);
-                    rc.add(output, y_test[j]);
-                }
+                    fold_outputs[i].push_back(std::make_pair(df(x_test[j]), y_test[j]));
             }
             catch (invalid_nu_error&)
             {
                 // just ignore cases which result in an invalid nu
             }
+        });
 
-        } // for (long i = 0; i < folds; ++i)
+        running_stats<double> rs;
+        running_scalar_covariance<double> rc;
+        for (long i = 0; i < folds; ++i)
+        {
+            for (unsigned long j = 0; j < fold_outputs[i].size(); ++j)
+            {
+                // compute error
+                const double output = fold_outputs[i][j].first;
+                const double temp = output - fold_outputs[i][j].second;
+
+                rs.add(temp*temp);
+                rc.add(output, fold_outputs[i][j].second);
+            }
+        }
 
         matrix<double,1,2> result;
         result = rs.mean(), std::pow(rc.correlation(),2);
@@ -49,12 +49,14 @@ namespace dlib
         const trainer_type& trainer,
         const std::vector<sample_type>& x,
         const std::vector<label_type>& y,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     );
     /*!
         requires
             - is_learning_problem(x,y)
             - 1 < folds <= x.size()
+            - num_threads > 0
             - trainer_type == some kind of regression trainer object (e.g. svr_trainer)
         ensures
             - Performs k-fold cross validation by using the given trainer to solve a 
@@ -66,6 +68,10 @@ namespace dlib
                 - M(1) == the R-squared value (i.e. the squared correlation between
                   a predicted y value and its true value).  This is a number between 
                   0 and 1.
+            - Up to num_threads folds are trained and tested at the same time, each using
+              its own copy of trainer (see run_cross_validation_folds()).  The way samples
+              are assigned to folds doesn't depend on num_threads, so neither does the
+              returned matrix.
     !*/
 
 }
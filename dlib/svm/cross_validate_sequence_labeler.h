@@ -7,6 +7,7 @@
 #include <vector>
 #include "../matrix.h"
 #include "svm.h"
+#include "cross_validate_folds.h"
 
 
 namespace dlib
@@ -65,16 +66,19 @@ namespace dlib
         const trainer_type& trainer,
         const std::vector<sequence_type>& samples,
         const std::vector<std::vector<unsigned long> >& labels,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     )
     {
         // make sure requires clause is not broken
         DLIB_ASSERT(is_sequence_labeling_problem(samples,labels) == true &&
-                    1 < folds && folds <= static_cast<long>(samples.size()),
+                    1 < folds && folds <= static_cast<long>(samples.size()) &&
+                    num_threads > 0,
             "\tmatrix cross_validate_sequence_labeler()"
             << "\n\t invalid inputs were given to this function"
             << "\n\t samples.size(): " << samples.size() 
             << "\n\t folds:  " << folds 
+            << "\n\t num_threads:  " << num_threads 
             << "\n\t is_sequence_labeling_problem(samples,labels): " << is_sequence_labeling_problem(samples,labels)
             );
 
@@ -102,23 +106,15 @@ namespace dlib
         const long num_in_test = samples.size()/folds;
         const long num_in_train = samples.size() - num_in_test;
 
-        std::vector<sequence_type> x_test, x_train;
-        std::vector<std::vector<unsigned long> > y_test, y_train;
+        std::vector<matrix<double> > fold_results(folds);
 
-
-        long next_test_idx = 0;
-
-        matrix<double> res;
-
-
-        for (long i = 0; i < folds; ++i)
+        run_cross_validation_folds(folds, num_threads, [&](long i)
         {
-            x_test.clear();
-            y_test.clear();
-            x_train.clear();
-            y_train.clear();
+            std::vector<sequence_type> x_test, x_train;
+            std::vector<std::vector<unsigned long> > y_test, y_train;
 
             // load up the test samples
+            long next_test_idx = (i*num_in_test)%samples.size();
             for (long cnt = 0; cnt < num_in_test; ++cnt)
             {
                 x_test.push_back(samples[next_test_idx]);
@@ -136,9 +132,13 @@ namespace dlib
             }
 
 
-            res += test_sequence_labeler(trainer.train(x_train,y_train), x_test, y_test);
+            const trainer_type fold_trainer(trainer);
+            fold_results[i] = test_sequence_labeler(fold_trainer.train(x_train,y_train), x_test, y_test);
+        });
 
-        } // for (long i = 0; i < folds; ++i)
+        matrix<double> res;
+        for (long i = 0; i < folds; ++i)
+            res += fold_results[i];
 
         return res;
     }
@@ -49,12 +49,14 @@ namespace dlib
         const trainer_type& trainer,
         const std::vector<sequence_type>& samples,
         const std::vector<std::vector<unsigned long> >& labels,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     );
     /*!
         requires
             - is_sequence_labeling_problem(samples, labels)
             - 1 < folds <= samples.size()
+            - num_threads > 0
             - for all valid i and j: labels[i][j] < trainer.num_labels()
             - trainer_type == dlib::structural_sequence_labeling_trainer or an object
               with a compatible interface.
@@ -71,6 +73,9 @@ namespace dlib
                 - C.nr() == trainer.num_labels() 
                 - C(T,P) == the number of times a sequence element with label T was predicted
                   to have a label of P.
+            - Up to num_threads folds are processed in parallel (see
+              run_cross_validation_folds()), each one with its own copy of trainer.  C is
+              the same for any value of num_threads.
     !*/
 
 // ----------------------------------------------------------------------------------------
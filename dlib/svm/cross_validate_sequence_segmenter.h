@@ -5,6 +5,7 @@
 
 #include "cross_validate_sequence_segmenter_abstract.h"
 #include "sequence_segmenter.h"
+#include "cross_validate_folds.h"
 
 namespace dlib
 {
@@ -112,15 +113,18 @@ namespace dlib
         const trainer_type& trainer,
         const std::vector<sequence_type>& samples,
         const std::vector<std::vector<std::pair<unsigned long,unsigned long> > >& segments,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     )
     {
         // make sure requires clause is not broken
         DLIB_ASSERT( is_sequence_segmentation_problem(samples, segments) == true &&
-                    1 < folds && folds <= static_cast<long>(samples.size()),
+                    1 < folds && folds <= static_cast<long>(samples.size()) &&
+                    num_threads > 0,
                     "\tmatrix cross_validate_sequence_segmenter()"
                     << "\n\t invalid inputs were given to this function"
                     << "\n\t folds:  " << folds 
+                    << "\n\t num_threads:  " << num_threads 
                     << "\n\t is_sequence_segmentation_problem(samples, segments): " 
                     << is_sequence_segmentation_problem(samples, segments));
 
@@ -128,22 +132,15 @@ namespace dlib
         const long num_in_test = samples.size()/folds;
         const long num_in_train = samples.size() - num_in_test;
 
-        std::vector<sequence_type> x_test, x_train;
-        std::vector<std::vector<std::pair<unsigned long,unsigned long> > > y_test, y_train;
+        std::vector<matrix<double,1,3> > fold_metrics(folds);
 
-        long next_test_idx = 0;
-
-        matrix<double,1,3> metrics;
-        metrics = 0;
-
-        for (long i = 0; i < folds; ++i)
+        run_cross_validation_folds(folds, num_threads, [&](long i)
         {
-            x_test.clear();
-            y_test.clear();
-            x_train.clear();
-            y_train.clear();
+            std::vector<sequence_type> x_test, x_train;
+            std::vector<std::vector<std::pair<unsigned long,unsigned long> > > y_test, y_train;
 
             // load up the test samples
+            long next_test_idx = (i*num_in_test)%samples.size();
             for (long cnt = 0; cnt < num_in_test; ++cnt)
             {
                 x_test.push_back(samples[next_test_idx]);
@@ -161,8 +158,14 @@ namespace dlib
             }
 
 
-            metrics += impl::raw_metrics_test_sequence_segmenter(trainer.train(x_train,y_train), x_test, y_test);
-        } // for (long i = 0; i < folds; ++i)
+            const trainer_type fold_trainer(trainer);
+            fold_metrics[i] = impl::raw_metrics_test_sequence_segmenter(fold_trainer.train(x_train,y_train), x_test, y_test);
+        });
+
+        matrix<double,1,3> metrics;
+        metrics = 0;
+        for (long i = 0; i < folds; ++i)
+            metrics += fold_metrics[i];
 
 
         const double total_detections    = metrics(0);
@@ -54,12 +54,14 @@ namespace dlib
         const trainer_type& trainer,
         const std::vector<sequence_type>& samples,
         const std::vector<std::vector<std::pair<unsigned long,unsigned long> > >& segments,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     );
     /*!
         requires
             - is_sequence_segmentation_problem(samples, segments) == true
             - 1 < folds <= samples.size()
+            - num_threads > 0
             - trainer_type == dlib::structural_sequence_segmentation_trainer or an object
               with a compatible interface.
         ensures
@@ -70,6 +72,9 @@ namespace dlib
             - This function returns the precision, recall, and F1-score for the trainer.
               In particular, the output is the same as the output from the
               test_sequence_segmenter() routine defined above.
+            - Uses run_cross_validation_folds() to work on up to num_threads folds at
+              once.  Each fold trains a copy of trainer, and the per fold counts are
+              added up in fold order, so the output doesn't depend on num_threads.
     !*/
 
 // ----------------------------------------------------------------------------------------
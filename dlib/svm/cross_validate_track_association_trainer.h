@@ -5,6 +5,7 @@
 
 #include "cross_validate_track_association_trainer_abstract.h"
 #include "structural_track_association_trainer.h"
+#include "cross_validate_folds.h"
 
 namespace dlib
 {
@@ -119,36 +120,45 @@ namespace dlib
     double cross_validate_track_association_trainer (
         const trainer_type& trainer,
         const std::vector<std::vector<std::vector<labeled_detection<detection_type,label_type> > > >& samples,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     )
     {
         const long num_in_test  = samples.size()/folds;
         const long num_in_train = samples.size() - num_in_test;
 
-        std::vector<std::vector<std::vector<labeled_detection<detection_type,label_type> > > > samples_train;
+        // total_dets and correctly_associated_dets for each fold
+        std::vector<std::pair<unsigned long,unsigned long> > fold_counts(folds, std::make_pair(0ul,0ul));
 
-        long next_test_idx = 0;
-        unsigned long total_dets = 0;
-        unsigned long correctly_associated_dets = 0;
-
-        for (long i = 0; i < folds; ++i)
+        run_cross_validation_folds(folds, num_threads, [&](long i)
         {
-            samples_train.clear();
+            std::vector<std::vector<std::vector<labeled_detection<detection_type,label_type> > > > samples_train;
 
             // load up the training samples
-            long next = (next_test_idx + num_in_test)%samples.size();
+            const long test_idx = (i*num_in_test)%samples.size();
+            long next = (test_idx + num_in_test)%samples.size();
             for (long cnt = 0; cnt < num_in_train; ++cnt)
             {
                 samples_train.push_back(samples[next]);
                 next = (next + 1)%samples.size();
             }
 
-            const track_association_function<detection_type>& df = trainer.train(samples_train);
+            const trainer_type fold_trainer(trainer);
+            const track_association_function<detection_type>& df = fold_trainer.train(samples_train);
+            long next_test_idx = test_idx;
             for (long cnt = 0; cnt < num_in_test; ++cnt)
             {
-                impl::test_track_association_function(df, samples[next_test_idx], total_dets, correctly_associated_dets);
+                impl::test_track_association_function(df, samples[next_test_idx], fold_counts[i].first, fold_counts[i].second);
                 next_test_idx = (next_test_idx + 1)%samples.size();
             }
+        });
+
+        unsigned long total_dets = 0;
+        unsigned long correctly_associated_dets = 0;
+        for (long i = 0; i < folds; ++i)
+        {
+            total_dets += fold_counts[i].first;
+            correctly_associated_dets += fold_counts[i].second;
         }
 
         return (double)correctly_associated_dets/(double)total_dets;
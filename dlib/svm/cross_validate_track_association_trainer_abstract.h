@@ -43,12 +43,14 @@ namespace dlib
     double cross_validate_track_association_trainer (
         const trainer_type& trainer,
         const std::vector<std::vector<std::vector<labeled_detection<detection_type,label_type> > > >& samples,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     );
     /*!
         requires
             - is_track_association_problem(samples)
             - 1 < folds <= samples.size()
+            - num_threads > 0
             - trainer_type == dlib::structural_track_association_trainer or an object with
               a compatible interface.
         ensures
@@ -58,6 +60,9 @@ namespace dlib
               mis-associated detections is returned (i.e. this function returns the same
               measure of track association quality as test_track_association_function()).
             - The number of folds used is given by the folds argument.
+            - run_cross_validation_folds() is used to train and test up to num_threads
+              folds in parallel, each with a copy of trainer.  The result is the same for
+              every num_threads.
     !*/
 
 // ----------------------------------------------------------------------------------------
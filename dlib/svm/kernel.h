@@ -10,6 +10,7 @@
 #include "../matrix.h"
 #include "../algs.h"
 #include "../serialize.h"
+#include "../simd.h"
 
 namespace dlib
 {
@@ -125,6 +126,173 @@ namespace dlib
         mutable sample_type temp;
     };
 
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        template <typename T>
+        inline typename T::type unordered_squared_distance (
+            const T& a,
+            const T& b
+        )
+        {
+            DLIB_ASSERT(a.size() == b.size(), "");
+            // Keep 4 independent partial sums so the additions don't form one long
+            // dependency chain.
+            typedef typename T::type type;
+            const long n = a.size();
+            type s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            long i = 0;
+            for (; i+4 <= n; i += 4)
+            {
+                const type d0 = a(i)-b(i);
+                const type d1 = a(i+1)-b(i+1);
+                const type d2 = a(i+2)-b(i+2);
+                const type d3 = a(i+3)-b(i+3);
+                s0 += d0*d0;
+                s1 += d1*d1;
+                s2 += d2*d2;
+                s3 += d3*d3;
+            }
+            for (; i < n; ++i)
+                s0 += (a(i)-b(i))*(a(i)-b(i));
+            return (s0+s1) + (s2+s3);
+        }
+
+        template <long NR, typename MM, typename L>
+        inline float unordered_squared_distance (
+            const matrix<float,NR,1,MM,L>& a,
+            const matrix<float,NR,1,MM,L>& b
+        )
+        {
+            DLIB_ASSERT(a.size() == b.size(), "");
+            const long n = a.size();
+            if (n == 0)
+                return 0;
+            const float* pa = &a(0);
+            const float* pb = &b(0);
+            simd8f acc(0);
+            long i = 0;
+            for (; i+8 <= n; i += 8)
+            {
+                simd8f x, y;
+                x.load(pa+i);
+                y.load(pb+i);
+                x -= y;
+                acc += x*x;
+            }
+            float d = sum(acc);
+            for (; i < n; ++i)
+                d += (pa[i]-pb[i])*(pa[i]-pb[i]);
+            return d;
+        }
+    }
+
+    template <
+        typename T
+        >
+    struct fast_radial_basis_kernel
+    {
+        typedef typename T::type scalar_type;
+        typedef T sample_type;
+        typedef typename T::mem_manager_type mem_manager_type;
+
+        // T must be capable of representing a column vector.
+        COMPILE_TIME_ASSERT(T::NC == 1 || T::NC == 0);
+
+        fast_radial_basis_kernel(const scalar_type g) : gamma(g) {}
+        fast_radial_basis_kernel() : gamma(0.1) {}
+        fast_radial_basis_kernel(
+            const fast_radial_basis_kernel& k
+        ) : gamma(k.gamma) {}
+
+
+        const scalar_type gamma;
+
+        scalar_type operator() (
+            const sample_type& a,
+            const sample_type& b
+        ) const
+        { 
+            const scalar_type d = impl::unordered_squared_distance(a,b);
+            return std::exp(-gamma*d);
+        }
+
+        fast_radial_basis_kernel& operator= (
+            const fast_radial_basis_kernel& k
+        )
+        {
+            const_cast<scalar_type&>(gamma) = k.gamma;
+            return *this;
+        }
+
+        bool operator== (
+            const fast_radial_basis_kernel& k
+        ) const
+        {
+            return gamma == k.gamma;
+        }
+    };
+
+    template <
+        typename T
+        >
+    void serialize (
+        const fast_radial_basis_kernel<T>& item,
+        std::ostream& out
+    )
+    {
+        try
+        {
+            serialize(item.gamma, out);
+        }
+        catch (serialization_error& e)
+        { 
+            abort(); 
+        }
+    }
+
+    template <
+        typename T
+        >
+    void deserialize (
+        fast_radial_basis_kernel<T>& item,
+        std::istream& in 
+    )
+    {
+        typedef typename T::type scalar_type;
+        try
+        {
+            deserialize(const_cast<scalar_type&>(item.gamma), in);
+        }
+        catch (serialization_error& e)
+        { 
+            abort(); 
+        }
+    }
+
+    template <
+        typename T 
+        >
+    struct kernel_derivative<fast_radial_basis_kernel<T> >
+    {
+        typedef typename T::type scalar_type;
+        typedef T sample_type;
+        typedef typename T::mem_manager_type mem_manager_type;
+
+        kernel_derivative(const fast_radial_basis_kernel<T>& k_) : k(k_){}
+
+        const sample_type& operator() (const sample_type& x, const sample_type& y) const
+        {
+            // return the derivative of the rbf kernel
+            temp = 2*k.gamma*(x-y)*k(x,y);
+            return temp;
+        }
+
+        const fast_radial_basis_kernel<T>& k;
+        mutable sample_type temp;
+    };
+
 // ----------------------------------------------------------------------------------------
 
     template <
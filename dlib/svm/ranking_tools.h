@@ -12,6 +12,7 @@
 #include <algorithm>
 #include "sparse_vector.h"
 #include "../statistics.h"
+#include "cross_validate_folds.h"
 
 namespace dlib
 {
@@ -332,16 +333,19 @@ namespace dlib
     matrix<double,1,2> cross_validate_ranking_trainer (
         const trainer_type& trainer,
         const std::vector<ranking_pair<T> >& samples,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     )
     {
         // make sure requires clause is not broken
         DLIB_ASSERT(is_ranking_problem(samples) &&
-                    1 < folds && folds <= static_cast<long>(samples.size()),
+                    1 < folds && folds <= static_cast<long>(samples.size()) &&
+                    num_threads > 0,
             "\t double cross_validate_ranking_trainer()"
             << "\n\t invalid inputs were given to this function"
             << "\n\t samples.size(): " << samples.size() 
             << "\n\t folds:  " << folds 
+            << "\n\t num_threads:  " << num_threads 
             << "\n\t is_ranking_problem(samples): " << is_ranking_problem(samples)
             );
 
@@ -350,29 +354,18 @@ namespace dlib
         const long num_in_train = samples.size() - num_in_test;
 
 
-        std::vector<ranking_pair<T> > samples_test, samples_train;
+        // The average precision of each test sample along with the number of pairs and
+        // the number of misordered pairs, recorded separately for each fold.
+        std::vector<std::vector<double> > fold_aps(folds);
+        std::vector<unsigned long> fold_pairs(folds, 0);
+        std::vector<unsigned long> fold_wrong(folds, 0);
 
-
-        long next_test_idx = 0;
-
-        unsigned long total_pairs = 0;
-        unsigned long total_wrong = 0;
-
-        std::vector<double> rel_scores;
-        std::vector<double> nonrel_scores;
-        std::vector<unsigned long> rel_counts;
-        std::vector<unsigned long> nonrel_counts;
-
-        running_stats<double> rs;
-        std::vector<std::pair<double,bool> > total_scores;
-        std::vector<bool> total_ranking;
-
-        for (long i = 0; i < folds; ++i)
+        run_cross_validation_folds(folds, num_threads, [&](long i)
         {
-            samples_test.clear();
-            samples_train.clear();
+            std::vector<ranking_pair<T> > samples_test, samples_train;
 
             // load up the test samples
+            long next_test_idx = (i*num_in_test)%samples.size();
             for (long cnt = 0; cnt < num_in_test; ++cnt)
             {
                 samples_test.push_back(samples[next_test_idx]);
@@ -388,25 +381,34 @@ namespace dlib
             }
 
 
-            const typename trainer_type::trained_function_type& df = trainer.train(samples_train);
+            const trainer_type fold_trainer(trainer);
+            const typename trainer_type::trained_function_type& df = fold_trainer.train(samples_train);
+
+            std::vector<double> rel_scores;
+            std::vector<double> nonrel_scores;
+            std::vector<unsigned long> rel_counts;
+            std::vector<unsigned long> nonrel_counts;
+
+            std::vector<std::pair<double,bool> > total_scores;
+            std::vector<bool> total_ranking;
 
             // check how good df is on the test data
-            for (unsigned long i = 0; i < samples_test.size(); ++i)
+            for (unsigned long j = 0; j < samples_test.size(); ++j)
             {
-                rel_scores.resize(samples_test[i].relevant.size());
-                nonrel_scores.resize(samples_test[i].nonrelevant.size());
+                rel_scores.resize(samples_test[j].relevant.size());
+                nonrel_scores.resize(samples_test[j].nonrelevant.size());
 
                 total_scores.clear();
 
                 for (unsigned long k = 0; k < rel_scores.size(); ++k)
                 {
-                    rel_scores[k] = df(samples_test[i].relevant[k]);
+                    rel_scores[k] = df(samples_test[j].relevant[k]);
                     total_scores.push_back(std::make_pair(rel_scores[k], true));
                 }
 
                 for (unsigned long k = 0; k < nonrel_scores.size(); ++k)
                 {
-                    nonrel_scores[k] = df(samples_test[i].nonrelevant[k]);
+                    nonrel_scores[k] = df(samples_test[j].nonrelevant[k]);
                     total_scores.push_back(std::make_pair(nonrel_scores[k], false));
                 }
 
@@ -417,21 +419,31 @@ namespace dlib
                 // constant value for everything and still getting a good MAP score.
                 std::sort(total_scores.rbegin(), total_scores.rend(), impl::compare_first_reverse_second);
                 total_ranking.clear();
-                for (unsigned long i = 0; i < total_scores.size(); ++i)
-                    total_ranking.push_back(total_scores[i].second);
-                rs.add(average_precision(total_ranking));
+                for (unsigned long k = 0; k < total_scores.size(); ++k)
+                    total_ranking.push_back(total_scores[k].second);
+                fold_aps[i].push_back(average_precision(total_ranking));
 
 
                 count_ranking_inversions(rel_scores, nonrel_scores, rel_counts, nonrel_counts);
 
-                total_pairs += rel_scores.size()*nonrel_scores.size();
+                fold_pairs[i] += rel_scores.size()*nonrel_scores.size();
 
                 // Note that we don't need to look at nonrel_counts since it is redundant with
                 // the information in rel_counts in this case.
-                total_wrong += sum(mat(rel_counts));
+                fold_wrong[i] += sum(mat(rel_counts));
             }
+        });
 
-        } // for (long i = 0; i < folds; ++i)
+        unsigned long total_pairs = 0;
+        unsigned long total_wrong = 0;
+        running_stats<double> rs;
+        for (long i = 0; i < folds; ++i)
+        {
+            total_pairs += fold_pairs[i];
+            total_wrong += fold_wrong[i];
+            for (unsigned long j = 0; j < fold_aps[i].size(); ++j)
+                rs.add(fold_aps[i][j]);
+        }
 
         const double rank_swaps = static_cast<double>(total_pairs - total_wrong) / total_pairs;
         const double mean_average_precision = rs.mean();
@@ -216,12 +216,14 @@ namespace dlib
     matrix<double,1,2> cross_validate_ranking_trainer (
         const trainer_type& trainer,
         const std::vector<ranking_pair<T> >& samples,
-        const long folds
+        const long folds,
+        const unsigned long num_threads = 1
     );
     /*!
         requires
             - is_ranking_problem(samples) == true
             - 1 < folds <= samples.size()
+            - num_threads > 0
             - trainer_type == some kind of ranking trainer object (e.g. svm_rank_trainer)
         ensures
             - Performs k-fold cross validation by using the given trainer to solve the
@@ -236,6 +238,9 @@ namespace dlib
                 - M(0) == the ranking accuracy
                 - M(1) == the mean average precision
             - The number of folds used is given by the folds argument.
+            - If num_threads > 1 then several folds are trained at once, each on its own
+              copy of trainer (see run_cross_validation_folds()).  M is the same as what
+              you get with num_threads == 1.
     !*/
 
 // ----------------------------------------------------------------------------------------
@@ -0,0 +1,214 @@
+// Copyright (C) 2026  agent (agent@local)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#ifndef DLIB_SAMPLE_SOuRCE_Hh_
+#define DLIB_SAMPLE_SOuRCE_Hh_
+
+#include "sample_source_abstract.h"
+#include "../algs.h"
+#include "../noncopyable.h"
+#include "ranking_tools.h"
+#include "sparse_vector.h"
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    namespace impl
+    {
+        template <typename sample_source_type, typename T, typename label_type>
+        bool read_source_batch (
+            sample_source_type& source,
+            std::vector<T>& samples,
+            std::vector<label_type>& labels
+        )
+        {
+            return source.next_batch(samples, labels);
+        }
+
+        template <typename sample_source_type, typename T, typename label_type>
+        bool read_source_batch (
+            sample_source_type& source,
+            std::vector<ranking_pair<T> >& samples,
+            std::vector<label_type>& labels
+        )
+        {
+            labels.clear();
+            return source.next_batch(samples);
+        }
+
+        template <typename T>
+        void check_source_batch (
+            const std::vector<T>& 
+        )
+        {
+        }
+
+        template <typename T>
+        void check_source_batch (
+            const std::vector<ranking_pair<T> >& queries
+        )
+        {
+            // make sure requires clause is not broken
+            DLIB_CASSERT(is_ranking_problem(queries) == true,
+                "\t sample_source_cursor::sample_source_cursor(source)"
+                << "\n\t The queries from a ranking source must form a ranking problem."
+                << "\n\t queries.size(): " << queries.size() 
+                << "\n\t is_ranking_problem(queries): " << is_ranking_problem(queries)
+                );
+        }
+
+    // ------------------------------------------------------------------------------------
+
+        template <
+            typename sample_source_type,
+            typename element_type,
+            typename label_type = double
+            >
+        class sample_source_cursor : noncopyable
+        {
+            /*!
+                WHAT THIS OBJECT REPRESENTS
+                    This object presents the contents of a sample source as a read-only
+                    array of size() elements so that code written for in-memory data can
+                    run over it.  Only one batch from the source is held in memory at a
+                    time.  Accessing an element beyond the current batch reads forward
+                    through the source, while accessing one before it rewinds the source.
+                    So this object is only efficient when the elements are visited in
+                    order, as the oca problems used by the linear trainers do.
+
+                    Since the labels are needed at random by those trainers they are all
+                    kept in memory.  For ranking sources get_labels() is empty, and each
+                    batch of queries is checked with is_ranking_problem() during the first
+                    pass.
+            !*/
+
+        public:
+
+            sample_source_cursor (
+                sample_source_type& source_
+            ) : 
+                source(source_),
+                num(0),
+                num_dims(0),
+                batch_begin(0),
+                batch_end(0)
+            {
+                // Make one pass over the data to find out how much of it there is.
+                source.reset();
+                while (read_source_batch(source, batch, batch_labels))
+                {
+                    check_source_batch(batch);
+                    num += batch.size();
+                    num_dims = std::max(num_dims, dlib::max_index_plus_one(batch));
+                    labels.insert(labels.end(), batch_labels.begin(), batch_labels.end());
+                }
+                batch.clear();
+                batch_labels.clear();
+                source.reset();
+            }
+
+            long size (
+            ) const { return num; }
+
+            unsigned long max_index_plus_one (
+            ) const { return num_dims; }
+
+            const std::vector<label_type>& get_labels (
+            ) const { return labels; }
+
+            long load_batch (
+                long i
+            ) const
+            /*!
+                requires
+                    - 0 <= i < size()
+                ensures
+                    - makes sure the i-th element is in memory and returns one past the
+                      index of the last element in the same batch.  All the elements in
+                      that range can be accessed without touching the source.
+            !*/
+            {
+                if (i < batch_begin)
+                {
+                    source.reset();
+                    batch_begin = 0;
+                    batch_end = 0;
+                }
+
+                while (i >= batch_end)
+                {
+                    const bool got_batch = read_source_batch(source, batch, batch_labels);
+                    DLIB_CASSERT(got_batch && batch.size() != 0,
+                        "\t sample_source_cursor::load_batch()"
+                        << "\n\t The sample source returned fewer samples than it did on the first pass."
+                        << "\n\t i:      " << i 
+                        << "\n\t size(): " << size()
+                        );
+                    batch_begin = batch_end;
+                    batch_end += batch.size();
+                }
+
+                return batch_end;
+            }
+
+            const element_type& operator() (
+                long i
+            ) const
+            {
+                if (i < batch_begin || i >= batch_end)
+                    load_batch(i);
+                return batch[i-batch_begin];
+            }
+
+            const element_type& operator[] (
+                long i
+            ) const { return (*this)(i); }
+
+        private:
+
+            sample_source_type& source;
+            long num;
+            unsigned long num_dims;
+            std::vector<label_type> labels;
+
+            mutable std::vector<element_type> batch;
+            mutable std::vector<label_type> batch_labels;
+            mutable long batch_begin;
+            mutable long batch_end;
+        };
+
+    // ------------------------------------------------------------------------------------
+
+        template <typename T>
+        long loaded_range_end (
+            const T& samples,
+            long 
+        ) 
+        /*!
+            ensures
+                - returns one past the last element of samples that can be accessed along
+                  with element i without loading anything.  For in-memory containers
+                  that's all of them.
+        !*/
+        { 
+            return samples.size(); 
+        }
+
+        template <typename sample_source_type, typename element_type, typename label_type>
+        long loaded_range_end (
+            const sample_source_cursor<sample_source_type,element_type,label_type>& samples,
+            long i
+        ) 
+        { 
+            return samples.load_batch(i); 
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_SAMPLE_SOuRCE_Hh_
+
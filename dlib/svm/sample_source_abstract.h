@@ -0,0 +1,109 @@
+// Copyright (C) 2026  agent (agent@local)
+// License: Boost Software License   See LICENSE.txt for the full license.
+#undef DLIB_SAMPLE_SOuRCE_ABSTRACT_Hh_
+#ifdef DLIB_SAMPLE_SOuRCE_ABSTRACT_Hh_
+
+#include "ranking_tools_abstract.h"
+#include <vector>
+
+namespace dlib
+{
+
+// ----------------------------------------------------------------------------------------
+
+    class example_sample_source
+    {
+        /*!
+            WHAT THIS OBJECT REPRESENTS
+                This object defines the interface the train_from_source() methods of
+                svm_c_linear_trainer and svm_c_linear_dcd_trainer expect from a source of
+                labeled training data.  It is not a real class, it is just here to
+                document the interface.
+
+                A sample source hands out its samples a batch at a time so that a dataset
+                never has to be fully loaded into memory.  The trainers make many passes
+                over the data, each time calling reset() and then next_batch() until it
+                returns false.  Each pass must produce the same samples in the same order.
+
+                dlib::libsvm_sample_source is an implementation of this interface which
+                reads libsvm formatted files from disk.  
+        !*/
+
+    public:
+
+        typedef some_sample_type sample_type;
+        typedef some_label_type label_type;
+
+        void reset (
+        );
+        /*!
+            ensures
+                - rewinds this object so that the next call to next_batch() returns the
+                  first batch of samples.
+        !*/
+
+        bool next_batch (
+            std::vector<sample_type>& samples,
+            std::vector<label_type>& labels
+        );
+        /*!
+            ensures
+                - if (there are samples left in the current pass) then
+                    - loads some of them into #samples and their labels into #labels
+                    - #samples.size() == #labels.size()
+                    - #samples.size() > 0
+                    - returns true
+                - else
+                    - #samples.size() == 0
+                    - returns false
+        !*/
+    };
+
+// ----------------------------------------------------------------------------------------
+
+    class example_ranking_source
+    {
+        /*!
+            WHAT THIS OBJECT REPRESENTS
+                This object defines the interface svm_rank_trainer::train_from_source()
+                expects from a source of ranking training data.  It works just like
+                example_sample_source except that it hands out ranking_pair objects
+                rather than labeled samples.
+
+                dlib::libsvm_ranking_source is an implementation of this interface which
+                reads SVMrank style libsvm files from disk.  
+        !*/
+
+    public:
+
+        typedef some_sample_type sample_type;
+
+        void reset (
+        );
+        /*!
+            ensures
+                - rewinds this object so that the next call to next_batch() returns the
+                  first batch of queries.
+        !*/
+
+        bool next_batch (
+            std::vector<ranking_pair<sample_type> >& queries
+        );
+        /*!
+            ensures
+                - if (there are queries left in the current pass) then
+                    - loads some of them into #queries
+                    - #queries.size() > 0
+                    - returns true
+                - else
+                    - #queries.size() == 0
+                    - returns false
+        !*/
+    };
+
+// ----------------------------------------------------------------------------------------
+
+}
+
+#endif // DLIB_SAMPLE_SOuRCE_ABSTRACT_Hh_
+
@@ -9,9 +9,13 @@
 #include "../matrix.h"
 #include "../algs.h"
 #include "../rand.h"
+#include "../threads.h"
+#include <memory>
+#include <algorithm>
 
 #include "function.h"
 #include "kernel.h"
+#include "sample_source.h"
 
 namespace dlib 
 {
@@ -48,7 +52,8 @@ namespace dlib
             have_bias(true),
             last_weight_1(false),
             do_shrinking(true),
-            do_svm_l2(false)
+            do_svm_l2(false),
+            num_threads(1)
         {
         }
 
@@ -63,7 +68,8 @@ namespace dlib
             have_bias(true),
             last_weight_1(false),
             do_shrinking(true),
-            do_svm_l2(false)
+            do_svm_l2(false),
+            num_threads(1)
         {
             // make sure requires clause is not broken
             DLIB_ASSERT(0 < C_,
@@ -113,6 +119,22 @@ namespace dlib
             bool enabled
         ) { do_svm_l2 = enabled; }
 
+        unsigned long get_num_threads (
+        ) const { return num_threads; }
+
+        void set_num_threads (
+            unsigned long num
+        ) 
+        { 
+            // make sure requires clause is not broken
+            DLIB_ASSERT(num > 0,
+                "\t void svm_c_linear_dcd_trainer::set_num_threads()"
+                << "\n\t invalid inputs were given to this function"
+                << "\n\t num: " << num 
+                );
+            num_threads = num; 
+        }
+
         void be_verbose (
         )
         {
@@ -482,8 +504,180 @@ namespace dlib
             return do_train(mat(x), mat(y), state);
         }
 
+        template <
+            typename sample_source_type
+            >
+        const decision_function<kernel_type> train_from_source (
+            sample_source_type& source
+        ) const
+        {
+            typedef typename sample_source_type::label_type label_type;
+            const impl::sample_source_cursor<sample_source_type,sample_type,label_type> x(source);
+            const std::vector<label_type>& y = x.get_labels();
+
+            // make sure requires clause is not broken
+            DLIB_ASSERT(x.size() > 0,
+                "\t decision_function svm_c_linear_dcd_trainer::train_from_source(source)"
+                << "\n\t the sample source must contain at least one sample"
+                );
+#ifdef ENABLE_ASSERTS
+            for (long i = 0; i < x.size(); ++i)
+            {
+                DLIB_ASSERT(y[i] == +1 || y[i] == -1,
+                    "\t decision_function svm_c_linear_dcd_trainer::train_from_source(source)"
+                    << "\n\t invalid inputs were given to this function"
+                    << "\n\t label of sample "<<i<<": " << y[i]
+                );
+            }
+#endif
+
+            // Only the parts of the optimizer state that don't scale with the size of
+            // the data are used here.  The Q values are recomputed each time a sample is
+            // loaded and there is no shrinking, so neither Q nor index are filled in.
+            optimizer_state state;
+            state.did_init = true;
+            state.have_bias = have_bias;
+            state.last_weight_1 = last_weight_1;
+            state.dims = x.max_index_plus_one();
+            state.alpha.assign(x.size(), 0);
+            if (have_bias && !last_weight_1)
+                state.w.set_size(state.dims+1);
+            else
+                state.w.set_size(state.dims);
+            state.w = 0;
+            if (last_weight_1)
+                state.w(state.dims-1) = 1;
+
+            std::vector<scalar_type>& alpha = state.alpha;
+            scalar_vector_type& w = state.w;
+            const long dims = state.dims;
+            std::vector<long> index;
+
+            const scalar_type Dii_pos = 1/(2*Cpos);
+            const scalar_type Dii_neg = 1/(2*Cneg);
+
+            // This is the block minimization method from "Large Linear Classification When
+            // Data Cannot Fit In Memory" by Yu, Hsieh, Chang, and Lin.  Each iteration
+            // loads the batches from the source one after another and does a DCD pass,
+            // in random order, over the samples of each one while it is in memory.
+            for (unsigned long iter = 0; iter < max_iterations; ++iter)
+            {
+                scalar_type PG_max = -std::numeric_limits<scalar_type>::infinity();
+                scalar_type PG_min = std::numeric_limits<scalar_type>::infinity();
+
+                for (long begin = 0, end = 0; begin < x.size(); begin = end)
+                {
+                    end = x.load_batch(begin);
+
+                    index.resize(end-begin);
+                    for (unsigned long i = 0; i < index.size(); ++i)
+                        index[i] = begin + i;
+                    // randomly shuffle the indices
+                    for (unsigned long i = 0; i < index.size(); ++i)
+                    {
+                        // pick a random index >= i
+                        const long j = i + state.rnd.get_random_32bit_number()%(index.size()-i);
+                        std::swap(index[i], index[j]);
+                    }
+
+                    for (unsigned long ii = 0; ii < index.size(); ++ii)
+                    {
+                        const long i = index[ii];
+                        const sample_type& xi = x(i);
+
+                        scalar_type Qii = state.length_squared(xi);
+                        if (have_bias && !last_weight_1)
+                            Qii += 1;
+                        else if (Qii == 0)
+                            continue;
+
+                        scalar_type G = y[i]*dot(w, xi) - 1;
+                        if (do_svm_l2)
+                        {
+                            const scalar_type Dii = (y[i] > 0) ? Dii_pos : Dii_neg;
+                            G += Dii*alpha[i];
+                            Qii += Dii;
+                        }
+                        const scalar_type C = (y[i] > 0) ? Cpos : Cneg;
+                        const scalar_type U = do_svm_l2 ? std::numeric_limits<scalar_type>::infinity() : C;
+
+                        scalar_type PG = 0;
+                        if (alpha[i] == 0)
+                        {
+                            if (G < 0)
+                                PG = G;
+                        }
+                        else if (alpha[i] == U)
+                        {
+                            if (G > 0)
+                                PG = G;
+                        }
+                        else
+                        {
+                            PG = G;
+                        }
+
+                        if (PG > PG_max) 
+                            PG_max = PG;
+                        if (PG < PG_min) 
+                            PG_min = PG;
+
+                        // if PG != 0
+                        if (std::abs(PG) > 1e-12)
+                        {
+                            const scalar_type alpha_old = alpha[i];
+                            alpha[i] = std::min(std::max(alpha[i] - G/Qii, (scalar_type)0.0), U);
+                            const scalar_type delta = (alpha[i]-alpha_old)*y[i];
+                            add_to(w, xi, delta);
+                            if (have_bias && !last_weight_1)
+                                w(w.size()-1) -= delta;
+
+                            if (last_weight_1)
+                                w(dims-1) = 1;
+                        }
+                    }
+                }
+
+                if (verbose)
+                {
+                    using namespace std;
+                    cout << "gap:         " << PG_max - PG_min << endl;
+                    cout << "iter:        " << iter << endl;
+                    cout << endl;
+                }
+
+                if (PG_max - PG_min <= eps)
+                    break;
+            }
+
+            return make_decision_function(w, dims);
+        }
+
     private:
 
+        decision_function<kernel_type> make_decision_function (
+            const scalar_vector_type& w,
+            const long dims
+        ) const
+        {
+            // put the solution into a decision function and then return it
+            decision_function<kernel_type> df;
+            if (have_bias && !last_weight_1)
+                df.b = w(w.size()-1);
+            else
+                df.b = 0;
+
+            df.basis_vectors.set_size(1);
+            // Copy the plane normal into the output basis vector.  The output vector might
+            // be a sparse vector container so we need to use this special kind of copy to
+            // handle that case.  
+            assign(df.basis_vectors(0), colm(w, 0, dims));
+            df.alpha.set_size(1);
+            df.alpha(0) = 1;
+
+            return df;
+        }
+
     // ------------------------------------------------------------------------------------
 
         template <
@@ -517,19 +711,16 @@ namespace dlib
 
             state.init(x,y,have_bias,last_weight_1,do_svm_l2,Cpos,Cneg);
 
-            std::vector<scalar_type>& alpha = state.alpha;
-            scalar_vector_type& w = state.w;
             std::vector<long>& index = state.index;
-            const long dims = state.dims;
-
 
             unsigned long active_size = index.size();
 
             scalar_type PG_max_prev = std::numeric_limits<scalar_type>::infinity();
             scalar_type PG_min_prev = -std::numeric_limits<scalar_type>::infinity();
 
-            const scalar_type Dii_pos = 1/(2*Cpos);
-            const scalar_type Dii_neg = 1/(2*Cneg);
+            std::unique_ptr<thread_pool> tp;
+            if (num_threads > 1)
+                tp.reset(new thread_pool(num_threads));
 
             // main loop
             for (unsigned long iter = 0; iter < max_iterations; ++iter)
@@ -545,18 +736,220 @@ namespace dlib
                     std::swap(index[i], index[j]);
                 }
                 
-                // for all the active training samples
-                for (unsigned long ii = 0; ii < active_size; ++ii)
+                if (tp)
+                    parallel_pass(x, y, state, *tp, active_size, PG_max_prev, PG_min_prev, PG_max, PG_min);
+                else
+                    serial_pass(x, y, state, active_size, PG_max_prev, PG_min_prev, PG_max, PG_min);
+
+                if (verbose)
+                {
+                    using namespace std;
+                    cout << "gap:         " << PG_max - PG_min << endl;
+                    cout << "active_size: " << active_size << endl;
+                    cout << "iter:        " << iter << endl;
+                    cout << endl;
+                }
+
+                if (PG_max - PG_min <= eps)
+                {
+                    // stop if we are within eps tolerance and the last iteration
+                    // was over all the samples
+                    if (active_size == index.size())
+                        break;
+
+                    // Turn off shrinking on the next iteration.  We will stop if the
+                    // tolerance is still <= eps when shrinking is off.
+                    active_size = index.size();
+                    PG_max_prev = std::numeric_limits<scalar_type>::infinity();
+                    PG_min_prev = -std::numeric_limits<scalar_type>::infinity();
+                }
+                else if (do_shrinking)
+                {
+                    PG_max_prev = PG_max;
+                    PG_min_prev = PG_min;
+                    if (PG_max_prev <= 0)
+                        PG_max_prev = std::numeric_limits<scalar_type>::infinity();
+                    if (PG_min_prev >= 0)
+                        PG_min_prev = -std::numeric_limits<scalar_type>::infinity();
+                }
+
+            } // end of main optimization loop
+
+            return make_decision_function(state.w, state.dims);
+        }
+
+        template <
+            typename in_sample_vector_type,
+            typename in_scalar_vector_type
+            >
+        void serial_pass (
+            const in_sample_vector_type& x,
+            const in_scalar_vector_type& y,
+            optimizer_state& state,
+            unsigned long& active_size,
+            const scalar_type PG_max_prev,
+            const scalar_type PG_min_prev,
+            scalar_type& PG_max,
+            scalar_type& PG_min
+        ) const
+        /*!
+            ensures
+                - Performs one pass of dual coordinate descent over the first active_size
+                  elements of state.index, in order.
+                - #active_size == the number of samples still active after shrinking, and
+                  these samples are at the front of state.index.
+                - #PG_max and #PG_min == the extreme projected gradient values seen.
+        !*/
+        {
+            std::vector<scalar_type>& alpha = state.alpha;
+            scalar_vector_type& w = state.w;
+            std::vector<long>& index = state.index;
+            const long dims = state.dims;
+
+            const scalar_type Dii_pos = 1/(2*Cpos);
+            const scalar_type Dii_neg = 1/(2*Cneg);
+
+            // for all the active training samples
+            for (unsigned long ii = 0; ii < active_size; ++ii)
+            {
+                const long i = index[ii];
+
+                scalar_type G = y(i)*dot(w, x(i)) - 1;
+                if (do_svm_l2)
+                {
+                    if (y(i) > 0)
+                        G += Dii_pos*alpha[i];
+                    else
+                        G += Dii_neg*alpha[i];
+                }
+                const scalar_type C = (y(i) > 0) ? Cpos : Cneg;
+                const scalar_type U = do_svm_l2 ? std::numeric_limits<scalar_type>::infinity() : C;
+
+                scalar_type PG = 0;
+                if (alpha[i] == 0)
+                {
+                    if (G > PG_max_prev)
+                    {
+                        // shrink the active set of training examples
+                        --active_size;
+                        std::swap(index[ii], index[active_size]);
+                        --ii;
+                        continue;
+                    }
+
+                    if (G < 0)
+                        PG = G;
+                }
+                else if (alpha[i] == U)
+                {
+                    if (G < PG_min_prev)
+                    {
+                        // shrink the active set of training examples
+                        --active_size;
+                        std::swap(index[ii], index[active_size]);
+                        --ii;
+                        continue;
+                    }
+
+                    if (G > 0)
+                        PG = G;
+                }
+                else
+                {
+                    PG = G;
+                }
+
+                if (PG > PG_max) 
+                    PG_max = PG;
+                if (PG < PG_min) 
+                    PG_min = PG;
+
+                // if PG != 0
+                if (std::abs(PG) > 1e-12)
+                {
+                    const scalar_type alpha_old = alpha[i];
+                    alpha[i] = std::min(std::max(alpha[i] - G/state.Q[i], (scalar_type)0.0), U);
+                    const scalar_type delta = (alpha[i]-alpha_old)*y(i);
+                    add_to(w, x(i), delta);
+                    if (have_bias && !last_weight_1)
+                        w(w.size()-1) -= delta;
+
+                    if (last_weight_1)
+                        w(dims-1) = 1;
+                }
+
+            }
+        }
+
+        template <
+            typename in_sample_vector_type,
+            typename in_scalar_vector_type
+            >
+        void parallel_pass (
+            const in_sample_vector_type& x,
+            const in_scalar_vector_type& y,
+            optimizer_state& state,
+            thread_pool& tp,
+            unsigned long& active_size,
+            const scalar_type PG_max_prev,
+            const scalar_type PG_min_prev,
+            scalar_type& PG_max,
+            scalar_type& PG_min
+        ) const
+        /*!
+            ensures
+                - Performs one pass of dual coordinate descent over the first active_size
+                  elements of state.index, just like the serial loop in do_train(), except
+                  that the active samples are split into blocks which are optimized at the
+                  same time by the threads in tp.
+                - #active_size == the number of samples still active after shrinking, and
+                  these samples are moved to the front of state.index.
+                - #PG_max and #PG_min == the extreme projected gradient values seen.
+        !*/
+        {
+            std::vector<scalar_type>& alpha = state.alpha;
+            scalar_vector_type& w = state.w;
+            std::vector<long>& index = state.index;
+            const long dims = state.dims;
+
+            const unsigned long num_blocks = std::min<unsigned long>(tp.num_threads_in_pool(), active_size);
+            if (num_blocks == 0)
+                return;
+
+            // Each block runs coordinate descent on its own copy of w, but takes steps as
+            // if the curvature of the data term were num_blocks times larger.  Averaging
+            // the copies afterwards then applies the sum of all the blocks' alpha updates
+            // to w, and because of the scaled curvature that sum can't overshoot, so every
+            // pass still improves the dual objective.  This is the CoCoA+ scheme from
+            // "Adding vs. Averaging in Distributed Primal-Dual Optimization" by Ma et al.
+            const scalar_type sigma = num_blocks;
+            const scalar_type Dii_pos = 1/(2*Cpos);
+            const scalar_type Dii_neg = 1/(2*Cneg);
+
+            std::vector<unsigned long> block_begin(num_blocks+1);
+            for (unsigned long t = 0; t <= num_blocks; ++t)
+                block_begin[t] = active_size*t/num_blocks;
+            std::vector<unsigned long> block_active(num_blocks);
+            std::vector<scalar_type> block_PG_max(num_blocks), block_PG_min(num_blocks);
+            std::vector<scalar_vector_type> local_w(num_blocks);
+
+            parallel_for(tp, 0, num_blocks, [&](long t)
+            {
+                scalar_vector_type& v = local_w[t];
+                v = w;
+                scalar_type local_PG_max = -std::numeric_limits<scalar_type>::infinity();
+                scalar_type local_PG_min = std::numeric_limits<scalar_type>::infinity();
+                unsigned long end = block_begin[t+1];
+                for (unsigned long ii = block_begin[t]; ii < end; ++ii)
                 {
                     const long i = index[ii];
 
-                    scalar_type G = y(i)*dot(w, x(i)) - 1;
+                    scalar_type G = y(i)*dot(v, x(i)) - 1;
+                    scalar_type Dii = 0;
                     if (do_svm_l2)
                     {
-                        if (y(i) > 0)
-                            G += Dii_pos*alpha[i];
-                        else
-                            G += Dii_neg*alpha[i];
+                        Dii = (y(i) > 0) ? Dii_pos : Dii_neg;
+                        G += Dii*alpha[i];
                     }
                     const scalar_type C = (y(i) > 0) ? Cpos : Cneg;
                     const scalar_type U = do_svm_l2 ? std::numeric_limits<scalar_type>::infinity() : C;
@@ -566,9 +959,9 @@ namespace dlib
                     {
                         if (G > PG_max_prev)
                         {
-                            // shrink the active set of training examples
-                            --active_size;
-                            std::swap(index[ii], index[active_size]);
+                            // shrink the active set of this block
+                            --end;
+                            std::swap(index[ii], index[end]);
                             --ii;
                             continue;
                         }
@@ -580,9 +973,9 @@ namespace dlib
                     {
                         if (G < PG_min_prev)
                         {
-                            // shrink the active set of training examples
-                            --active_size;
-                            std::swap(index[ii], index[active_size]);
+                            // shrink the active set of this block
+                            --end;
+                            std::swap(index[ii], index[end]);
                             --ii;
                             continue;
                         }
@@ -595,80 +988,53 @@ namespace dlib
                         PG = G;
                     }
 
-                    if (PG > PG_max) 
-                        PG_max = PG;
-                    if (PG < PG_min) 
-                        PG_min = PG;
+                    if (PG > local_PG_max) 
+                        local_PG_max = PG;
+                    if (PG < local_PG_min) 
+                        local_PG_min = PG;
 
-                    // if PG != 0
                     if (std::abs(PG) > 1e-12)
                     {
                         const scalar_type alpha_old = alpha[i];
-                        alpha[i] = std::min(std::max(alpha[i] - G/state.Q[i], (scalar_type)0.0), U);
-                        const scalar_type delta = (alpha[i]-alpha_old)*y(i);
-                        add_to(w, x(i), delta);
+                        alpha[i] = std::min(std::max(alpha[i] - G/(sigma*(state.Q[i]-Dii)+Dii), (scalar_type)0.0), U);
+                        const scalar_type delta = sigma*(alpha[i]-alpha_old)*y(i);
+                        add_to(v, x(i), delta);
                         if (have_bias && !last_weight_1)
-                            w(w.size()-1) -= delta;
+                            v(v.size()-1) -= delta;
 
                         if (last_weight_1)
-                            w(dims-1) = 1;
+                            v(dims-1) = 1;
                     }
-
-                }
-
-                if (verbose)
-                {
-                    using namespace std;
-                    cout << "gap:         " << PG_max - PG_min << endl;
-                    cout << "active_size: " << active_size << endl;
-                    cout << "iter:        " << iter << endl;
-                    cout << endl;
-                }
-
-                if (PG_max - PG_min <= eps)
-                {
-                    // stop if we are within eps tolerance and the last iteration
-                    // was over all the samples
-                    if (active_size == index.size())
-                        break;
-
-                    // Turn off shrinking on the next iteration.  We will stop if the
-                    // tolerance is still <= eps when shrinking is off.
-                    active_size = index.size();
-                    PG_max_prev = std::numeric_limits<scalar_type>::infinity();
-                    PG_min_prev = -std::numeric_limits<scalar_type>::infinity();
                 }
-                else if (do_shrinking)
-                {
-                    PG_max_prev = PG_max;
-                    PG_min_prev = PG_min;
-                    if (PG_max_prev <= 0)
-                        PG_max_prev = std::numeric_limits<scalar_type>::infinity();
-                    if (PG_min_prev >= 0)
-                        PG_min_prev = -std::numeric_limits<scalar_type>::infinity();
-                }
-
-            } // end of main optimization loop
-
-
-
-
-            // put the solution into a decision function and then return it
-            decision_function<kernel_type> df;
-            if (have_bias && !last_weight_1)
-                df.b = w(w.size()-1);
-            else
-                df.b = 0;
-
-            df.basis_vectors.set_size(1);
-            // Copy the plane normal into the output basis vector.  The output vector might
-            // be a sparse vector container so we need to use this special kind of copy to
-            // handle that case.  
-            assign(df.basis_vectors(0), colm(w, 0, dims));
-            df.alpha.set_size(1);
-            df.alpha(0) = 1;
-
-            return df;
+                block_active[t] = end - block_begin[t];
+                block_PG_max[t] = local_PG_max;
+                block_PG_min[t] = local_PG_min;
+            });
+
+            w = local_w[0];
+            for (unsigned long t = 1; t < num_blocks; ++t)
+                w += local_w[t];
+            w /= num_blocks;
+            if (last_weight_1)
+                w(dims-1) = 1;
+
+            // Put the samples that are still active at the front of index, followed by the
+            // ones shrunk during this pass.
+            std::vector<long> temp;
+            temp.reserve(active_size);
+            for (unsigned long t = 0; t < num_blocks; ++t)
+                temp.insert(temp.end(), index.begin()+block_begin[t], index.begin()+block_begin[t]+block_active[t]);
+            for (unsigned long t = 0; t < num_blocks; ++t)
+                temp.insert(temp.end(), index.begin()+block_begin[t]+block_active[t], index.begin()+block_begin[t+1]);
+            std::copy(temp.begin(), temp.end(), index.begin());
+
+            active_size = 0;
+            for (unsigned long t = 0; t < num_blocks; ++t)
+            {
+                active_size += block_active[t];
+                PG_max = std::max(PG_max, block_PG_max[t]);
+                PG_min = std::min(PG_min, block_PG_min[t]);
+            }
         }
 
         scalar_type dot (
@@ -698,6 +1064,7 @@ namespace dlib
         bool last_weight_1;
         bool do_shrinking;
         bool do_svm_l2;
+        unsigned long num_threads;
 
     }; // end of class svm_c_linear_dcd_trainer
 
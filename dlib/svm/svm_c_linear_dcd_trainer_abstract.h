@@ -68,6 +68,7 @@ namespace dlib
                 - #includes_bias() == true
                 - #shrinking_enabled() == true
                 - #solving_svm_l2_problem() == false
+                - #get_num_threads() == 1
         !*/
 
         explicit svm_c_linear_dcd_trainer (
@@ -88,6 +89,7 @@ namespace dlib
                 - #includes_bias() == true
                 - #shrinking_enabled() == true
                 - #solving_svm_l2_problem() == false
+                - #get_num_threads() == 1
         !*/
 
         bool includes_bias (
@@ -159,6 +161,31 @@ namespace dlib
                 - #solving_svm_l2_problem() == enabled
         !*/
 
+        unsigned long get_num_threads (
+        ) const;
+        /*!
+            ensures
+                - returns the number of threads used during training.  If this is 1 then
+                  the usual sequential dual coordinate descent method is used.  Otherwise,
+                  each pass over the training data splits the active samples into
+                  get_num_threads() blocks that are optimized in parallel, each against
+                  its own copy of w, and the copies are combined at the end of the pass.
+                  The solver stops under the same epsilon criterion either way, so both
+                  modes find solutions of the same accuracy, although not bit for bit
+                  identical ones.  For a fixed number of threads the results are
+                  deterministic.
+        !*/
+
+        void set_num_threads (
+            unsigned long num
+        );
+        /*!
+            requires
+                - num > 0
+            ensures
+                - #get_num_threads() == num
+        !*/
+
         void be_verbose (
         );
         /*!
@@ -372,6 +399,34 @@ namespace dlib
                     - else
                         - F(new_x) < 0
         !*/
+
+        template <
+            typename sample_source_type
+            >
+        const decision_function<kernel_type> train_from_source (
+            sample_source_type& source
+        ) const;
+        /*!
+            requires
+                - sample_source_type implements the interface defined by
+                  example_sample_source in dlib/svm/sample_source_abstract.h.  
+                - sample_source_type::sample_type == sample_type
+                - source must contain at least one sample and all its labels must be
+                  equal to +1 or -1.
+            ensures
+                - Trains a C support vector classifier on the samples and labels in
+                  source and returns the result, just like train(x,y) does.  However, the
+                  samples are streamed from source one batch at a time rather than being
+                  held in memory.  So this function can train on datasets much larger
+                  than the available RAM.  Only the labels and the alpha/dual values are
+                  kept in memory.
+                - Each iteration of the optimizer makes one pass over source.  The DCD
+                  updates are done a batch at a time, in random order within each batch,
+                  and shrinking is not used.  So the result is not bit for bit identical
+                  to what train(x,y) produces, but it solves the same problem to within
+                  get_epsilon().
+                - get_num_threads() is ignored by this function.
+        !*/
     }; 
 
 // ----------------------------------------------------------------------------------------
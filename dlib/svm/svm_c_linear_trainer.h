@@ -7,11 +7,14 @@
 #include "../algs.h"
 #include "../optimization.h"
 #include "../matrix.h"
+#include "../threads.h"
+#include <memory>
 #include "function.h"
 #include "kernel.h"
 #include <iostream>
 #include <vector>
 #include "sparse_vector.h"
+#include "sample_source.h"
 
 namespace dlib
 {
@@ -33,6 +36,13 @@ namespace dlib
 
             The bias parameter is dealt with by imagining that each sample vector has -1
             as its last element.
+
+            If num_threads > 1 then the passes over the samples are split into
+            num_threads contiguous chunks which are processed in parallel.  Each chunk
+            sums its part of the risk and subgradient into its own accumulator and the
+            accumulators are added together, in chunk order, at the end.  So the results
+            only depend on the number of threads and not on how the threads get
+            scheduled.
         */
 
         typedef typename matrix_type::type scalar_type;
@@ -45,7 +55,8 @@ namespace dlib
             const bool be_verbose_,
             const scalar_type eps_,
             const unsigned long max_iter,
-            const unsigned long dims_
+            const unsigned long dims_,
+            const unsigned long num_threads = 1
         ) :
             samples(samples_),
             labels(labels_),
@@ -59,6 +70,8 @@ namespace dlib
         {
             dot_prods.resize(samples.size());
             is_first_call = true;
+            if (num_threads > 1)
+                tp.reset(new thread_pool(num_threads));
         }
 
         virtual scalar_type get_c (
@@ -125,8 +138,64 @@ namespace dlib
             risk = 0;
 
 
-            // loop over all the samples and compute the risk and its subgradient at the current solution point w
-            for (long i = 0; i < samples.size(); ++i)
+            // loop over all the samples and compute the risk and its subgradient at the
+            // current solution point w.  This goes over whatever range of samples can be
+            // accessed at once, which is all of them unless they are being streamed from
+            // a sample source.
+            for (long begin = 0, end = 0; begin < samples.size(); begin = end)
+            {
+                end = impl::loaded_range_end(samples, begin);
+
+                if (tp)
+                {
+                    const long num_chunks = std::min<long>(tp->num_threads_in_pool(), end-begin);
+                    chunk_risk.assign(num_chunks, 0);
+                    chunk_subgradient.resize(num_chunks);
+                    parallel_for(*tp, 0, num_chunks, [&](long c)
+                    {
+                        chunk_subgradient[c].set_size(w.size(),1);
+                        chunk_subgradient[c] = 0;
+                        accumulate_risk(begin + (end-begin)*c/num_chunks, 
+                                        begin + (end-begin)*(c+1)/num_chunks, 
+                                        chunk_risk[c], chunk_subgradient[c]);
+                    }, 1);
+
+                    for (long c = 0; c < num_chunks; ++c)
+                    {
+                        risk += chunk_risk[c];
+                        subgradient += chunk_subgradient[c];
+                    }
+                }
+                else
+                {
+                    accumulate_risk(begin, end, risk, subgradient);
+                }
+            }
+
+            scalar_type scale = 1.0/samples.size();
+
+            risk *= scale;
+            subgradient = scale*subgradient;
+        }
+
+    private:
+
+    // -----------------------------------------------------
+    // -----------------------------------------------------
+
+        void accumulate_risk (
+            const long begin,
+            const long end,
+            scalar_type& risk,
+            matrix_type& subgradient
+        ) const
+        /*!
+            ensures
+                - adds the risk and subgradient contributions of the samples in the range
+                  [begin, end) to risk and subgradient.
+        !*/
+        {
+            for (long i = begin; i < end; ++i)
             {
                 // multiply current SVM output for the ith sample by its label
                 const scalar_type df_val = labels(i)*dot_prods[i];
@@ -152,18 +221,8 @@ namespace dlib
                     }
                 }
             }
-
-            scalar_type scale = 1.0/samples.size();
-
-            risk *= scale;
-            subgradient = scale*subgradient;
         }
 
-    private:
-
-    // -----------------------------------------------------
-    // -----------------------------------------------------
-
         void line_search (
             matrix_type& w
         ) const
@@ -176,8 +235,23 @@ namespace dlib
             // The reason for using w_size_m1 and not just w.size()-1 is because
             // doing it this way avoids an inane warning from gcc that can occur in some cases.
             const long w_size_m1 = w.size()-1;
-            for (long i = 0; i < samples.size(); ++i)
-                dot_prods[i] = dot(colm(w,0,w_size_m1), samples(i)) - w(w_size_m1);
+            for (long begin = 0, end = 0; begin < samples.size(); begin = end)
+            {
+                end = impl::loaded_range_end(samples, begin);
+
+                if (tp)
+                {
+                    parallel_for(*tp, begin, end, [&](long i)
+                    {
+                        dot_prods[i] = dot(colm(w,0,w_size_m1), samples(i)) - w(w_size_m1);
+                    });
+                }
+                else
+                {
+                    for (long i = begin; i < end; ++i)
+                        dot_prods[i] = dot(colm(w,0,w_size_m1), samples(i)) - w(w_size_m1);
+                }
+            }
 
             if (is_first_call)
             {
@@ -292,6 +366,10 @@ namespace dlib
         mutable matrix_type best_so_far;  // best w seen so far
         mutable std::vector<scalar_type> dot_prods_best; // dot products between best_so_far and samples
 
+        std::shared_ptr<thread_pool> tp;
+        mutable std::vector<scalar_type> chunk_risk;
+        mutable std::vector<matrix_type> chunk_subgradient;
+
 
         const in_sample_vector_type& samples;
         const in_scalar_vector_type& labels;
@@ -321,11 +399,12 @@ namespace dlib
         const bool be_verbose,
         const scalar_type eps,
         const unsigned long max_iterations,
-        const unsigned long dims
+        const unsigned long dims,
+        const unsigned long num_threads = 1
     )
     {
         return oca_problem_c_svm<matrix_type, in_sample_vector_type, in_scalar_vector_type>(
-            C_pos, C_neg, samples, labels, be_verbose, eps, max_iterations, dims);
+            C_pos, C_neg, samples, labels, be_verbose, eps, max_iterations, dims, num_threads);
     }
 
 // ----------------------------------------------------------------------------------------
@@ -359,6 +438,7 @@ namespace dlib
             max_iterations = 10000;
             learn_nonnegative_weights = false;
             last_weight_1 = false;
+            num_threads = 1;
         }
 
         explicit svm_c_linear_trainer (
@@ -380,6 +460,7 @@ namespace dlib
             max_iterations = 10000;
             learn_nonnegative_weights = false;
             last_weight_1 = false;
+            num_threads = 1;
         }
 
         void set_epsilon (
@@ -410,6 +491,23 @@ namespace dlib
             max_iterations = max_iter;
         }
 
+        unsigned long get_num_threads (
+        ) const { return num_threads; }
+
+        void set_num_threads (
+            unsigned long num
+        )
+        {
+            // make sure requires clause is not broken
+            DLIB_ASSERT(num > 0,
+                "\t void svm_c_linear_trainer::set_num_threads()"
+                << "\n\t invalid inputs were given to this function"
+                << "\n\t num: " << num 
+                );
+
+            num_threads = num;
+        }
+
         void be_verbose (
         )
         {
@@ -579,6 +677,46 @@ namespace dlib
             return do_train(mat(x),mat(y),svm_objective);
         }
 
+        template <
+            typename sample_source_type
+            >
+        const decision_function<kernel_type> train_from_source (
+            sample_source_type& source
+        ) const
+        {
+            scalar_type obj;
+            return train_from_source(source, obj);
+        }
+
+        template <
+            typename sample_source_type
+            >
+        const decision_function<kernel_type> train_from_source (
+            sample_source_type& source,
+            scalar_type& svm_objective
+        ) const
+        {
+            const impl::sample_source_cursor<sample_source_type,sample_type,typename sample_source_type::label_type> x(source);
+
+            // make sure requires clause is not broken
+            DLIB_ASSERT(x.size() > 0,
+                "\t decision_function svm_c_linear_trainer::train_from_source(source)"
+                << "\n\t the sample source must contain at least one sample"
+                );
+#ifdef ENABLE_ASSERTS
+            for (long i = 0; i < x.size(); ++i)
+            {
+                DLIB_ASSERT(x.get_labels()[i] == +1 || x.get_labels()[i] == -1,
+                    "\t decision_function svm_c_linear_trainer::train_from_source(source)"
+                    << "\n\t invalid inputs were given to this function"
+                    << "\n\t label of sample "<<i<<": " << x.get_labels()[i]
+                );
+            }
+#endif
+
+            return do_train(x, mat(x.get_labels()), x.max_index_plus_one(), svm_objective);
+        }
+
     private:
 
         template <
@@ -612,12 +750,29 @@ namespace dlib
             }
 #endif
 
+            return do_train(x, y, max_index_plus_one(x), svm_objective);
+        }
 
+        template <
+            typename in_sample_vector_type,
+            typename in_scalar_vector_type
+            >
+        const decision_function<kernel_type> do_train (
+            const in_sample_vector_type& x,
+            const in_scalar_vector_type& y,
+            const unsigned long num_dims,
+            scalar_type& svm_objective
+        ) const
+        /*!
+            requires
+                - x only needs to support x.size() and x(i).  The samples are always
+                  visited in order so x can be a sample_source_cursor.
+                - num_dims == max_index_plus_one(x)
+        !*/
+        {
             typedef matrix<scalar_type,0,1> w_type;
             w_type w;
 
-            const unsigned long num_dims = max_index_plus_one(x);
-
             unsigned long num_nonnegative = 0;
             if (learn_nonnegative_weights)
             {
@@ -654,14 +809,14 @@ namespace dlib
                                                                          mat(prior_b));
 
                 svm_objective = solver(
-                    make_oca_problem_c_svm<w_type>(Cpos, Cneg, x, y, verbose, eps, max_iterations, dims), 
+                    make_oca_problem_c_svm<w_type>(Cpos, Cneg, x, y, verbose, eps, max_iterations, dims, num_threads), 
                     w,
                     prior_temp);
             }
             else
             {
                 svm_objective = solver(
-                    make_oca_problem_c_svm<w_type>(Cpos, Cneg, x, y, verbose, eps, max_iterations, num_dims), 
+                    make_oca_problem_c_svm<w_type>(Cpos, Cneg, x, y, verbose, eps, max_iterations, num_dims, num_threads), 
                     w,
                     num_nonnegative,
                     force_weight_1_idx);
@@ -673,9 +828,9 @@ namespace dlib
             df.basis_vectors.set_size(1);
             // Copy the plane normal into the output basis vector.  The output vector might be a
             // sparse vector container so we need to use this special kind of copy to handle that case.
-            // As an aside, the reason for using max_index_plus_one() and not just w.size()-1 is because
+            // As an aside, the reason for using num_dims and not just w.size()-1 is because
             // doing it this way avoids an inane warning from gcc that can occur in some cases.
-            const long out_size = max_index_plus_one(x);
+            const long out_size = num_dims;
             assign(df.basis_vectors(0), matrix_cast<scalar_type>(colm(w, 0, out_size)));
             df.alpha.set_size(1);
             df.alpha(0) = 1;
@@ -693,6 +848,7 @@ namespace dlib
         bool last_weight_1;
         matrix<scalar_type,0,1> prior;
         scalar_type prior_b;
+        unsigned long num_threads;
     }; 
 
 // ----------------------------------------------------------------------------------------
@@ -55,6 +55,7 @@ namespace dlib
                 - #learns_nonnegative_weights() == false
                 - #force_last_weight_to_1() == false
                 - #has_prior() == false
+                - #get_num_threads() == 1
         !*/
 
         explicit svm_c_linear_trainer (
@@ -75,6 +76,7 @@ namespace dlib
                 - #learns_nonnegative_weights() == false
                 - #force_last_weight_to_1() == false
                 - #has_prior() == false
+                - #get_num_threads() == 1
         !*/
 
         void set_epsilon (
@@ -114,6 +116,28 @@ namespace dlib
                   run before it is required to stop and return a result.
         !*/
 
+        unsigned long get_num_threads (
+        ) const;
+        /*!
+            ensures
+                - returns the number of threads used to evaluate the risk and its
+                  subgradient during training.  The samples are split into this many
+                  contiguous chunks, each processed by its own thread into its own
+                  accumulator.  The results for a given number of threads are
+                  deterministic, but they can differ in the last few bits from the
+                  single threaded results.
+        !*/
+
+        void set_num_threads (
+            unsigned long num
+        );
+        /*!
+            requires
+                - num > 0
+            ensures
+                - #get_num_threads() == num
+        !*/
+
         void be_verbose (
         );
         /*!
@@ -351,6 +375,47 @@ namespace dlib
                         - F(new_x) < 0
         !*/
 
+        template <
+            typename sample_source_type
+            >
+        const decision_function<kernel_type> train_from_source (
+            sample_source_type& source
+        ) const;
+        /*!
+            requires
+                - sample_source_type implements the interface defined by
+                  example_sample_source in dlib/svm/sample_source_abstract.h.  
+                - sample_source_type::sample_type == sample_type
+                - source must contain at least one sample and all its labels must be
+                  equal to +1 or -1.
+                - if (has_prior()) then
+                    - The vectors in source must have the same dimensionality as the
+                      vectors used to train the prior given to set_prior().  
+            ensures
+                - performs the same training as train(x,y) would if x and y contained all
+                  the samples and labels in source, and returns the same result.  However,
+                  the samples are streamed from source one batch at a time rather than
+                  being held in memory.  So this function can train on datasets much
+                  larger than the available RAM.  Only the labels and two scalars per
+                  sample are kept in memory.
+                - Each iteration of the optimizer makes two passes over source.
+        !*/
+
+        template <
+            typename sample_source_type
+            >
+        const decision_function<kernel_type> train_from_source (
+            sample_source_type& source,
+            scalar_type& svm_objective
+        ) const;
+        /*!
+            requires
+                - The same requirements as train_from_source(source).
+            ensures
+                - performs train_from_source(source) and returns the result.
+                - #svm_objective == the final value of the SVM objective function
+        !*/
+
     }; 
 
 }
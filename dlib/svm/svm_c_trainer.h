@@ -38,6 +38,7 @@ namespace dlib
             Cpos(1),
             Cneg(1),
             cache_size(200),
+            num_threads(1),
             eps(0.001)
         {
         }
@@ -50,6 +51,7 @@ namespace dlib
             Cpos(C_),
             Cneg(C_),
             cache_size(200),
+            num_threads(1),
             eps(0.001)
         {
             // make sure requires clause is not broken
@@ -79,6 +81,25 @@ namespace dlib
             return cache_size;
         }
 
+        void set_num_threads (
+            unsigned long num
+        )
+        {
+            // make sure requires clause is not broken
+            DLIB_ASSERT(num > 0,
+                "\tvoid svm_c_trainer::set_num_threads(num)"
+                << "\n\t invalid inputs were given to this function"
+                << "\n\t num: " << num 
+                );
+            num_threads = num;
+        }
+
+        unsigned long get_num_threads (
+        ) const
+        {
+            return num_threads;
+        }
+
         void set_epsilon (
             scalar_type eps_
         )
@@ -189,6 +210,7 @@ namespace dlib
             exchange(Cpos,            item.Cpos);
             exchange(Cneg,            item.Cneg);
             exchange(cache_size,      item.cache_size);
+            exchange(num_threads,     item.num_threads);
             exchange(eps,             item.eps);
         }
 
@@ -225,7 +247,7 @@ namespace dlib
 
             solve_qp3_using_smo<scalar_vector_type> solver;
 
-            solver(symmetric_matrix_cache<float>((diagm(y)*kernel_matrix(kernel_function,x)*diagm(y)), cache_size), 
+            solver(symmetric_matrix_cache<float>((diagm(y)*kernel_matrix(kernel_function,x)*diagm(y)), cache_size, num_threads), 
             //solver(symmetric_matrix_cache<float>(make_label_kernel_matrix(kernel_matrix(kernel_function,x),y), cache_size), 
                    uniform_matrix<scalar_type>(y.size(),1,-1),
                    y, 
@@ -340,6 +362,7 @@ namespace dlib
         scalar_type Cpos;
         scalar_type Cneg;
         long cache_size;
+        unsigned long num_threads;
         scalar_type eps;
     }; // end of class svm_c_trainer
 
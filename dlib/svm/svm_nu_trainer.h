@@ -38,6 +38,7 @@ namespace dlib
         ) :
             nu(0.1),
             cache_size(200),
+            num_threads(1),
             eps(0.001)
         {
         }
@@ -49,6 +50,7 @@ namespace dlib
             kernel_function(kernel_),
             nu(nu_),
             cache_size(200),
+            num_threads(1),
             eps(0.001)
         {
             // make sure requires clause is not broken
@@ -78,6 +80,25 @@ namespace dlib
             return cache_size;
         }
 
+        void set_num_threads (
+            unsigned long num
+        )
+        {
+            // make sure requires clause is not broken
+            DLIB_ASSERT(num > 0,
+                "\tvoid svm_nu_trainer::set_num_threads(num)"
+                << "\n\t invalid inputs were given to this function"
+                << "\n\t num: " << num 
+                );
+            num_threads = num;
+        }
+
+        unsigned long get_num_threads (
+        ) const
+        {
+            return num_threads;
+        }
+
         void set_epsilon (
             scalar_type eps_
         )
@@ -148,6 +169,7 @@ namespace dlib
             exchange(kernel_function, item.kernel_function);
             exchange(nu,              item.nu);
             exchange(cache_size,      item.cache_size);
+            exchange(num_threads,     item.num_threads);
             exchange(eps,             item.eps);
         }
 
@@ -184,7 +206,7 @@ namespace dlib
 
             solve_qp2_using_smo<scalar_vector_type> solver;
 
-            solver(symmetric_matrix_cache<float>((diagm(y)*kernel_matrix(kernel_function,x)*diagm(y)), cache_size), 
+            solver(symmetric_matrix_cache<float>((diagm(y)*kernel_matrix(kernel_function,x)*diagm(y)), cache_size, num_threads), 
             //solver(symmetric_matrix_cache<float>(make_label_kernel_matrix(kernel_matrix(kernel_function,x),y), cache_size), 
                    y, 
                    nu,
@@ -307,6 +329,7 @@ namespace dlib
         kernel_type kernel_function;
         scalar_type nu;
         long cache_size;
+        unsigned long num_threads;
         scalar_type eps;
     }; // end of class svm_nu_trainer
 
@@ -55,6 +55,7 @@ namespace dlib
                   to train a support vector machine.
                 - #get_nu() == 0.1 
                 - #get_cache_size() == 200
+                - #get_num_threads() == 1
                 - #get_epsilon() == 0.001
         !*/
 
@@ -71,6 +72,7 @@ namespace dlib
                 - #get_kernel() == kernel
                 - #get_nu() == nu
                 - #get_cache_size() == 200
+                - #get_num_threads() == 1
                 - #get_epsilon() == 0.001
         !*/
 
@@ -95,6 +97,28 @@ namespace dlib
                   memory, obviously.)
         !*/
 
+        void set_num_threads (
+            unsigned long num
+        );
+        /*!
+            requires
+                - num > 0
+            ensures
+                - #get_num_threads() == num
+        !*/
+
+        unsigned long get_num_threads (
+        ) const;
+        /*!
+            ensures
+                - returns the number of threads used to compute the kernel matrix columns
+                  needed during training.  Since computing these columns is usually the
+                  bulk of the work, using more threads on a multi-core machine makes
+                  training faster without changing the result.  Note that this requires
+                  kernel_type's operator() to be safe to call from several threads at
+                  once, which is true of all the kernels that come with dlib.
+        !*/
+
         void set_epsilon (
             scalar_type eps
         );
@@ -8,10 +8,13 @@
 #include "ranking_tools.h"
 #include "../algs.h"
 #include "../optimization.h"
+#include "../threads.h"
 #include "function.h"
 #include "kernel.h"
 #include "sparse_vector.h"
+#include "sample_source.h"
 #include <iostream>
+#include <memory>
 
 namespace dlib
 {
@@ -20,7 +23,8 @@ namespace dlib
 
     template <
         typename matrix_type, 
-        typename sample_type 
+        typename sample_type,
+        typename sample_container_type = std::vector<ranking_pair<sample_type> >
         >
     class oca_problem_ranking_svm : public oca_problem<matrix_type >
     {
@@ -28,17 +32,26 @@ namespace dlib
         /*
             This class is used as part of the implementation of the svm_rank_trainer
             defined towards the end of this file.
+
+            sample_container_type only needs to support size() and operator[].  The
+            samples are always visited in order so it can be a sample_source_cursor.
+
+            If num_threads > 1 then the samples are split into num_threads contiguous
+            chunks which are processed in parallel, each with its own risk and
+            subgradient accumulator.  The accumulators are added together in chunk
+            order so the results don't depend on how the threads get scheduled.
         */
 
         typedef typename matrix_type::type scalar_type;
 
         oca_problem_ranking_svm(
             const scalar_type C_,
-            const std::vector<ranking_pair<sample_type> >& samples_,
+            const sample_container_type& samples_,
             const bool be_verbose_,
             const scalar_type eps_,
             const unsigned long max_iter,
-            const unsigned long dims_
+            const unsigned long dims_,
+            const unsigned long num_threads = 1
         ) :
             samples(samples_),
             C(C_),
@@ -47,6 +60,8 @@ namespace dlib
             max_iterations(max_iter),
             dims(dims_)
         {
+            if (num_threads > 1)
+                tp.reset(new thread_pool(num_threads));
         }
 
         virtual scalar_type get_c (
@@ -114,24 +129,87 @@ namespace dlib
             // time.
 
 
+            unsigned long total_pairs = 0;
+
+            // loop over all the samples and compute the risk and its subgradient at the
+            // current solution point w.  This goes over whatever range of samples can be
+            // accessed at once, which is all of them unless they are being streamed from
+            // a ranking source.
+            const long num = samples.size();
+            for (long begin = 0, end = 0; begin < num; begin = end)
+            {
+                end = impl::loaded_range_end(samples, begin);
+
+                if (tp)
+                {
+                    const long num_chunks = std::min<long>(tp->num_threads_in_pool(), end-begin);
+                    chunk_risk.assign(num_chunks, 0);
+                    chunk_pairs.assign(num_chunks, 0);
+                    chunk_subgradient.resize(num_chunks);
+                    parallel_for(*tp, 0, num_chunks, [&](long c)
+                    {
+                        chunk_subgradient[c].set_size(w.size(),1);
+                        chunk_subgradient[c] = 0;
+                        accumulate_risk(w, begin + (end-begin)*c/num_chunks, 
+                                        begin + (end-begin)*(c+1)/num_chunks, 
+                                        chunk_risk[c], chunk_subgradient[c], chunk_pairs[c]);
+                    }, 1);
+
+                    for (long c = 0; c < num_chunks; ++c)
+                    {
+                        risk += chunk_risk[c];
+                        subgradient += chunk_subgradient[c];
+                        total_pairs += chunk_pairs[c];
+                    }
+                }
+                else
+                {
+                    accumulate_risk(w, begin, end, risk, subgradient, total_pairs);
+                }
+            }
+
+            const scalar_type scale = 1.0/total_pairs;
+
+            risk *= scale;
+            subgradient = scale*subgradient;
+        }
+
+    private:
+
+    // -----------------------------------------------------
+    // -----------------------------------------------------
+
+        void accumulate_risk (
+            const matrix_type& w,
+            const long begin,
+            const long end,
+            scalar_type& risk,
+            matrix_type& subgradient,
+            unsigned long& total_pairs
+        ) const
+        /*!
+            ensures
+                - adds the risk and subgradient contributions of the samples in the range
+                  [begin, end) to risk and subgradient and the number of pairs they
+                  contain to total_pairs.
+        !*/
+        {
             std::vector<double> rel_scores;
             std::vector<double> nonrel_scores;
             std::vector<unsigned long> rel_counts;
             std::vector<unsigned long> nonrel_counts;
 
-            unsigned long total_pairs = 0;
-
-            // loop over all the samples and compute the risk and its subgradient at the current solution point w
-            for (unsigned long i = 0; i < samples.size(); ++i)
+            for (long i = begin; i < end; ++i)
             {
-                rel_scores.resize(samples[i].relevant.size());
-                nonrel_scores.resize(samples[i].nonrelevant.size());
+                const ranking_pair<sample_type>& sample = samples[i];
+                rel_scores.resize(sample.relevant.size());
+                nonrel_scores.resize(sample.nonrelevant.size());
 
                 for (unsigned long k = 0; k < rel_scores.size(); ++k)
-                    rel_scores[k] = dot(samples[i].relevant[k], w);
+                    rel_scores[k] = dot(sample.relevant[k], w);
 
                 for (unsigned long k = 0; k < nonrel_scores.size(); ++k)
-                    nonrel_scores[k] = dot(samples[i].nonrelevant[k], w) + 1;
+                    nonrel_scores[k] = dot(sample.nonrelevant[k], w) + 1;
 
                 count_ranking_inversions(rel_scores, nonrel_scores, rel_counts, nonrel_counts);
 
@@ -142,7 +220,7 @@ namespace dlib
                     if (rel_counts[k] != 0)
                     {
                         risk -= rel_counts[k]*rel_scores[k];
-                        subtract_from(subgradient, samples[i].relevant[k], rel_counts[k]); 
+                        subtract_from(subgradient, sample.relevant[k], rel_counts[k]); 
                     }
                 }
 
@@ -151,31 +229,24 @@ namespace dlib
                     if (nonrel_counts[k] != 0)
                     {
                         risk += nonrel_counts[k]*nonrel_scores[k];
-                        add_to(subgradient, samples[i].nonrelevant[k], nonrel_counts[k]); 
+                        add_to(subgradient, sample.nonrelevant[k], nonrel_counts[k]); 
                     }
                 }
-
             }
-
-            const scalar_type scale = 1.0/total_pairs;
-
-            risk *= scale;
-            subgradient = scale*subgradient;
         }
 
-    private:
-
-    // -----------------------------------------------------
-    // -----------------------------------------------------
-
-
-        const std::vector<ranking_pair<sample_type> >& samples;
+        const sample_container_type& samples;
         const scalar_type C;
 
         const bool be_verbose;
         const scalar_type eps;
         const unsigned long max_iterations;
         const unsigned long dims;
+
+        std::shared_ptr<thread_pool> tp;
+        mutable std::vector<scalar_type> chunk_risk;
+        mutable std::vector<unsigned long> chunk_pairs;
+        mutable std::vector<matrix_type> chunk_subgradient;
     };
 
 // ----------------------------------------------------------------------------------------
@@ -191,11 +262,12 @@ namespace dlib
         const bool be_verbose,
         const scalar_type eps,
         const unsigned long max_iterations,
-        const unsigned long dims
+        const unsigned long dims,
+        const unsigned long num_threads = 1
     )
     {
         return oca_problem_ranking_svm<matrix_type, sample_type>(
-            C, samples, be_verbose, eps, max_iterations, dims);
+            C, samples, be_verbose, eps, max_iterations, dims, num_threads);
     }
 
 // ----------------------------------------------------------------------------------------
@@ -228,6 +300,7 @@ namespace dlib
             max_iterations = 10000;
             learn_nonnegative_weights = false;
             last_weight_1 = false;
+            num_threads = 1;
         }
 
         explicit svm_rank_trainer (
@@ -248,6 +321,7 @@ namespace dlib
             max_iterations = 10000;
             learn_nonnegative_weights = false;
             last_weight_1 = false;
+            num_threads = 1;
         }
 
         void set_epsilon (
@@ -278,6 +352,23 @@ namespace dlib
             max_iterations = max_iter;
         }
 
+        unsigned long get_num_threads (
+        ) const { return num_threads; }
+
+        void set_num_threads (
+            unsigned long num
+        )
+        {
+            // make sure requires clause is not broken
+            DLIB_ASSERT(num > 0,
+                "\t void svm_rank_trainer::set_num_threads()"
+                << "\n\t invalid inputs were given to this function"
+                << "\n\t num: " << num 
+                );
+
+            num_threads = num;
+        }
+
         void be_verbose (
         )
         {
@@ -394,12 +485,52 @@ namespace dlib
                 << "\n\t is_ranking_problem(samples): " << is_ranking_problem(samples)
                 );
 
+            return do_train(samples, max_index_plus_one(samples));
+        }
+
+        const decision_function<kernel_type> train (
+            const ranking_pair<sample_type>& sample
+        ) const
+        {
+            return train(std::vector<ranking_pair<sample_type> >(1, sample));
+        }
+
+        template <
+            typename ranking_source_type
+            >
+        const decision_function<kernel_type> train_from_source (
+            ranking_source_type& source
+        ) const
+        {
+            const impl::sample_source_cursor<ranking_source_type,ranking_pair<sample_type> > samples(source);
+
+            // make sure requires clause is not broken
+            DLIB_CASSERT(samples.size() > 0,
+                "\t decision_function svm_rank_trainer::train_from_source(source)"
+                << "\n\t the ranking source must contain at least one query"
+                );
+
+            return do_train(samples, samples.max_index_plus_one());
+        }
+
+    private:
 
+        template <
+            typename sample_container_type
+            >
+        const decision_function<kernel_type> do_train (
+            const sample_container_type& samples,
+            const unsigned long num_dims
+        ) const
+        /*!
+            requires
+                - num_dims == max_index_plus_one(samples)
+        !*/
+        {
             typedef matrix<scalar_type,0,1> w_type;
+            typedef oca_problem_ranking_svm<w_type, sample_type, sample_container_type> problem_type;
             w_type w;
 
-            const unsigned long num_dims = max_index_plus_one(samples);
-
             unsigned long num_nonnegative = 0;
             if (learn_nonnegative_weights)
             {
@@ -433,13 +564,13 @@ namespace dlib
                 if ((unsigned long)prior.size() < dims)
                 {
                     matrix<scalar_type,0,1> prior_temp = join_cols(prior, zeros_matrix<scalar_type>(dims-prior.size(),1));
-                    solver( make_oca_problem_ranking_svm<w_type>(C, samples, verbose, eps, max_iterations, dims), 
+                    solver( problem_type(C, samples, verbose, eps, max_iterations, dims, num_threads), 
                         w, 
                         prior_temp);
                 }
                 else
                 {
-                    solver( make_oca_problem_ranking_svm<w_type>(C, samples, verbose, eps, max_iterations, dims), 
+                    solver( problem_type(C, samples, verbose, eps, max_iterations, dims, num_threads), 
                         w, 
                         prior);
                 }
@@ -447,7 +578,7 @@ namespace dlib
             }
             else
             {
-                solver( make_oca_problem_ranking_svm<w_type>(C, samples, verbose, eps, max_iterations, num_dims), 
+                solver( problem_type(C, samples, verbose, eps, max_iterations, num_dims, num_threads), 
                     w, 
                     num_nonnegative,
                     force_weight_1_idx);
@@ -468,15 +599,6 @@ namespace dlib
             return df;
         }
 
-        const decision_function<kernel_type> train (
-            const ranking_pair<sample_type>& sample
-        ) const
-        {
-            return train(std::vector<ranking_pair<sample_type> >(1, sample));
-        }
-
-    private:
-
         scalar_type C;
         oca solver;
         scalar_type eps;
@@ -485,6 +607,7 @@ namespace dlib
         bool learn_nonnegative_weights;
         bool last_weight_1;
         matrix<scalar_type,0,1> prior;
+        unsigned long num_threads;
     }; 
 
 // ----------------------------------------------------------------------------------------
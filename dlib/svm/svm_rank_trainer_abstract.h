@@ -59,6 +59,7 @@ namespace dlib
                 - #learns_nonnegative_weights() == false
                 - #forces_last_weight_to_1() == false
                 - #has_prior() == false
+                - #get_num_threads() == 1
         !*/
 
         explicit svm_rank_trainer (
@@ -78,6 +79,7 @@ namespace dlib
                 - #learns_nonnegative_weights() == false
                 - #forces_last_weight_to_1() == false
                 - #has_prior() == false
+                - #get_num_threads() == 1
         !*/
 
         void set_epsilon (
@@ -118,6 +120,28 @@ namespace dlib
                 - #get_max_iterations() == max_iter
         !*/
 
+        unsigned long get_num_threads (
+        ) const;
+        /*!
+            ensures
+                - returns the number of threads used to evaluate the risk and its
+                  subgradient during training.  The samples are split into this many
+                  contiguous chunks, each processed by its own thread into its own
+                  accumulator.  The results for a given number of threads are
+                  deterministic, but they can differ in the last few bits from the
+                  single threaded results.
+        !*/
+
+        void set_num_threads (
+            unsigned long num
+        );
+        /*!
+            requires
+                - num > 0
+            ensures
+                - #get_num_threads() == num
+        !*/
+
         void be_verbose (
         );
         /*!
@@ -288,6 +312,33 @@ namespace dlib
                     return train(std::vector<ranking_pair<sample_type> >(1, sample));
         !*/
 
+        template <
+            typename ranking_source_type
+            >
+        const decision_function<kernel_type> train_from_source (
+            ranking_source_type& source
+        ) const;
+        /*!
+            requires
+                - ranking_source_type implements the interface defined by
+                  example_ranking_source in dlib/svm/sample_source_abstract.h.  
+                - ranking_source_type::sample_type == sample_type
+                - source must contain at least one query and every query must have at
+                  least one relevant and one nonrelevant vector.  That is, the queries in
+                  source must form a valid ranking problem according to
+                  is_ranking_problem().
+                - if (has_prior()) then
+                    - The vectors in source must have the same dimensionality as the
+                      vectors used to train the prior given to set_prior().  
+            ensures
+                - performs the same training as train(samples) would if samples contained
+                  all the queries in source, and returns the same result.  However, the
+                  queries are streamed from source one batch at a time rather than being
+                  held in memory.  So this function can train on datasets much larger
+                  than the available RAM.
+                - Each iteration of the optimizer makes one pass over source.
+        !*/
+
     }; 
 
 // ----------------------------------------------------------------------------------------
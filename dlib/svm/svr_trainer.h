@@ -36,6 +36,7 @@ namespace dlib
             C(1),
             eps_insensitivity(0.1),
             cache_size(200),
+            num_threads(1),
             eps(0.001)
         {
         }
@@ -59,6 +60,25 @@ namespace dlib
             return cache_size;
         }
 
+        void set_num_threads (
+            unsigned long num
+        )
+        {
+            // make sure requires clause is not broken
+            DLIB_ASSERT(num > 0,
+                "\tvoid svr_trainer::set_num_threads(num)"
+                << "\n\t invalid inputs were given to this function"
+                << "\n\t num: " << num 
+                );
+            num_threads = num;
+        }
+
+        unsigned long get_num_threads (
+        ) const
+        {
+            return num_threads;
+        }
+
         void set_epsilon (
             scalar_type eps_
         )
@@ -151,6 +171,7 @@ namespace dlib
             exchange(C,            item.C);
             exchange(eps_insensitivity, item.eps_insensitivity);
             exchange(cache_size,      item.cache_size);
+            exchange(num_threads,     item.num_threads);
             exchange(eps,             item.eps);
         }
 
@@ -260,7 +281,7 @@ namespace dlib
 
             solve_qp3_using_smo<scalar_vector_type> solver;
 
-            solver(symmetric_matrix_cache<float>(make_quad(kernel_matrix(kernel_function,x)), cache_size), 
+            solver(symmetric_matrix_cache<float>(make_quad(kernel_matrix(kernel_function,x)), cache_size, num_threads), 
                    uniform_matrix<scalar_type>(2*x.size(),1, eps_insensitivity) + join_cols(y,-y),
                    join_cols(uniform_matrix<scalar_type>(x.size(),1,1), uniform_matrix<scalar_type>(x.size(),1,-1)), 
                    0,
@@ -374,6 +395,7 @@ namespace dlib
         scalar_type C;
         scalar_type eps_insensitivity;
         long cache_size;
+        unsigned long num_threads;
         scalar_type eps;
     }; // end of class svr_trainer
 
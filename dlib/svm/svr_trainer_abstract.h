@@ -51,6 +51,7 @@ namespace dlib
                 - #get_c() == 1
                 - #get_epsilon_insensitivity() == 0.1
                 - #get_cache_size() == 200
+                - #get_num_threads() == 1
                 - #get_epsilon() == 0.001
         !*/
 
@@ -75,6 +76,28 @@ namespace dlib
                   memory, obviously.)
         !*/
 
+        void set_num_threads (
+            unsigned long num
+        );
+        /*!
+            requires
+                - num > 0
+            ensures
+                - #get_num_threads() == num
+        !*/
+
+        unsigned long get_num_threads (
+        ) const;
+        /*!
+            ensures
+                - returns the number of threads used to compute the kernel matrix columns
+                  needed during training.  Since computing these columns is usually the
+                  bulk of the work, using more threads on a multi-core machine makes
+                  training faster without changing the result.  Note that this requires
+                  kernel_type's operator() to be safe to call from several threads at
+                  once, which is true of all the kernels that come with dlib.
+        !*/
+
         void set_epsilon (
             scalar_type eps
         );
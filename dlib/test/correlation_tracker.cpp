@@ -80,6 +80,42 @@ namespace
                 DLIB_TEST(rect_confidence >= 0.98);
                 print_spinner();
             }
+
+            test_update_trackers(frames, sizeof(frames) / sizeof(frames[0]));
+        }
+
+        template <typename frame_fn_type>
+        void test_update_trackers (
+            const frame_fn_type* frames,
+            unsigned long num_frames
+        )
+        {
+            // Updating a bunch of trackers at once should give exactly the same results
+            // as updating them one at a time.
+            array2d<unsigned char> img;
+            std::istringstream sin(frames[0]());
+            load_bmp(img, sin);
+
+            std::vector<correlation_tracker> trackers(3), serial_trackers;
+            trackers[0].start_track(img, centered_rect(point(93, 110), 38, 86));
+            trackers[1].start_track(img, centered_rect(point(60, 60), 30, 30));
+            trackers[2].start_track(img, centered_rect(point(120, 90), 50, 40));
+            serial_trackers = trackers;
+
+            for (unsigned long i = 1; i < num_frames; ++i)
+            {
+                std::istringstream sin(frames[i]());
+                load_bmp(img, sin);
+
+                const std::vector<double> psr = update_trackers(trackers, img);
+                DLIB_TEST(psr.size() == trackers.size());
+                for (unsigned long j = 0; j < trackers.size(); ++j)
+                {
+                    DLIB_TEST(psr[j] == serial_trackers[j].update(img));
+                    DLIB_TEST(trackers[j].get_position() == serial_trackers[j].get_position());
+                }
+                print_spinner();
+            }
         }
 
     // ------------------------------------------------------------------------------------
@@ -8,6 +8,8 @@
 #include "create_iris_datafile.h"
 #include <vector>
 #include <sstream>
+#include <fstream>
+#include <cstdio>
 
 namespace  
 {
@@ -205,6 +207,146 @@ namespace
         }
 
 
+        void test_load_image_dataset()
+        {
+            print_spinner();
+            dlib::rand rnd;
+
+            // Write a little dataset into the current directory.
+            image_dataset_metadata::dataset data;
+            for (int i = 0; i < 7; ++i)
+            {
+                array2d<rgb_pixel> img(20+rnd.get_random_32bit_number()%30, 20+rnd.get_random_32bit_number()%30);
+                for (long r = 0; r < img.nr(); ++r)
+                {
+                    for (long c = 0; c < img.nc(); ++c)
+                    {
+                        img[r][c].red = rnd.get_random_8bit_number();
+                        img[r][c].green = rnd.get_random_8bit_number();
+                        img[r][c].blue = rnd.get_random_8bit_number();
+                    }
+                }
+                image_dataset_metadata::image meta("load_image_dataset_test_" + cast_to_string(i) + ".bmp");
+                // Leave a few images empty so skip_empty_images() has something to do.
+                if (i%3 != 0)
+                    meta.boxes.push_back(image_dataset_metadata::box(rectangle(i,i,10+i,10+i)));
+                save_bmp(img, meta.filename);
+                data.images.push_back(meta);
+            }
+            save_image_dataset_metadata(data, "load_image_dataset_test.xml");
+            const std::string cache_file = "load_image_dataset_test.dat";
+            std::remove(cache_file.c_str());
+
+            const image_dataset_file source("load_image_dataset_test.xml");
+            const image_dataset_file sources[] = {
+                source.skip_empty_images(),
+                source.use_threads(3),
+                source.skip_empty_images().use_threads(4),
+                source.use_cache(cache_file),
+                // The second time through the images come from the cache.
+                source.use_cache(cache_file).use_threads(2),
+                // A different set of images must not reuse the cache.
+                source.skip_empty_images().use_cache(cache_file),
+                source.skip_empty_images().use_cache(cache_file)
+            };
+            DLIB_TEST(source.get_num_threads() == 1);
+            DLIB_TEST(source.get_cache_filename() == "");
+            DLIB_TEST(sources[4].get_num_threads() == 2);
+            DLIB_TEST(sources[4].get_cache_filename() == cache_file);
+
+            for (auto& s : sources)
+            {
+                const image_dataset_file serial = s.should_skip_empty_images() ? source.skip_empty_images() : source;
+                dlib::array<array2d<rgb_pixel> > images, images2;
+                std::vector<std::vector<rectangle> > boxes, boxes2;
+                load_image_dataset(images, boxes, serial);
+                load_image_dataset(images2, boxes2, s);
+                DLIB_TEST(images.size() == (s.should_skip_empty_images() ? 4 : 7));
+                DLIB_TEST(images2.size() == images.size());
+                DLIB_TEST(boxes2 == boxes);
+                for (unsigned long i = 0; i < images.size(); ++i)
+                {
+                    DLIB_TEST(images2[i].nr() == images[i].nr());
+                    DLIB_TEST(images2[i].nc() == images[i].nc());
+                    for (long r = 0; r < images[i].nr(); ++r)
+                    {
+                        for (long c = 0; c < images[i].nc(); ++c)
+                        {
+                            DLIB_TEST(images2[i][r][c].red == images[i][r][c].red);
+                            DLIB_TEST(images2[i][r][c].green == images[i][r][c].green);
+                            DLIB_TEST(images2[i][r][c].blue == images[i][r][c].blue);
+                        }
+                    }
+                }
+            }
+
+            // A cache made for one image type isn't used for another.
+            dlib::array<array2d<unsigned char> > gray, gray2;
+            std::vector<std::vector<full_object_detection> > dets, dets2;
+            std::vector<std::string> parts_list;
+            load_image_dataset(gray, dets, source, parts_list);
+            load_image_dataset(gray2, dets2, source.use_cache(cache_file), parts_list);
+            DLIB_TEST(gray2.size() == 7);
+            for (unsigned long i = 0; i < gray.size(); ++i)
+                DLIB_TEST(mat(gray2[i]) == mat(gray[i]));
+
+            // Overwriting an image with a different one of the same file size must not
+            // reuse the cache either.  Keep rewriting it until the file system records a
+            // new modification time.
+            const std::string changed_file = data.images[0].filename;
+            const auto old_time = file(changed_file).last_modified();
+            array2d<unsigned char> changed(gray[0].nr(), gray[0].nc());
+            assign_all_pixels(changed, 0);
+            for (int i = 0; i < 30 && file(changed_file).last_modified() == old_time; ++i)
+            {
+                dlib::sleep(100);
+                array2d<rgb_pixel> temp;
+                assign_image(temp, changed);
+                save_bmp(temp, changed_file);
+            }
+            DLIB_TEST(file(changed_file).last_modified() != old_time);
+            load_image_dataset(gray2, dets2, source.use_cache(cache_file), parts_list);
+            DLIB_TEST(gray2.size() == 7);
+            DLIB_TEST(mat(gray2[0]) == mat(changed));
+            DLIB_TEST(mat(gray[0]) != mat(changed));
+
+            // A truncated or foreign cache file is ignored and rewritten.
+            std::string cache_contents;
+            {
+                std::ifstream fin(cache_file.c_str(), std::ios::binary);
+                std::ostringstream sout;
+                sout << fin.rdbuf();
+                cache_contents = sout.str();
+            }
+            DLIB_TEST(cache_contents.size() > 100);
+            const std::string damaged[] = {
+                cache_contents.substr(0, cache_contents.size()/2),
+                cache_contents.substr(0, cache_contents.size()-1),
+                "not an image dataset cache"
+            };
+            for (auto& contents : damaged)
+            {
+                {
+                    std::ofstream fout(cache_file.c_str(), std::ios::binary);
+                    fout << contents;
+                }
+                gray2.clear();
+                load_image_dataset(gray2, dets2, source.use_cache(cache_file), parts_list);
+                DLIB_TEST(gray2.size() == 7);
+                DLIB_TEST(mat(gray2[0]) == mat(changed));
+                for (unsigned long i = 1; i < gray.size(); ++i)
+                    DLIB_TEST(mat(gray2[i]) == mat(gray[i]));
+                DLIB_TEST(file(cache_file).size() == cache_contents.size());
+                DLIB_TEST(!std::ifstream((cache_file + ".tmp").c_str()));
+            }
+
+            std::remove(cache_file.c_str());
+            std::remove("load_image_dataset_test.xml");
+            std::remove("image_metadata_stylesheet.xsl");
+            for (auto& img : data.images)
+                std::remove(img.filename.c_str());
+        }
+
         void perform_test (
         )
         {
@@ -212,6 +354,7 @@ namespace
             create_iris_datafile();
 
             test_sparse_to_dense();
+            test_load_image_dataset();
 
             run_test<std::map<unsigned int, double> >();
             run_test<std::map<unsigned int, float> >();
@@ -4,10 +4,16 @@
 
 #include <sstream>
 #include <string>
+#include <cstdio>
 #include <cstdlib>
 #include <ctime>
 #include <vector>
 #include "../dnn.h"
+#include "../string.h"
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
 
 #include "tester.h"
 
@@ -1467,6 +1473,234 @@ namespace
             }
         }
     }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_cpu_conv_algorithms()
+    {
+        // The CPU convolution picks between img2col, direct, and Winograd based methods
+        // depending on dnn_prefer_fastest_algorithms().  Make sure they all agree.
+        dlib::rand prnd;
+        int num_winograd = 0;
+        int num_direct = 0;
+        for (int iter = 0; iter < 200; ++iter)
+        {
+            print_spinner();
+
+            resizable_tensor data(prnd.get_random_32bit_number()%3+1,
+                prnd.get_random_32bit_number()%8+1,
+                prnd.get_random_32bit_number()%25+1,
+                prnd.get_random_32bit_number()%25+1
+            );
+            const bool do_3x3 = prnd.get_random_double() < 0.5;
+            resizable_tensor filters(
+                prnd.get_random_32bit_number()%8+1,
+                data.k(),
+                do_3x3 ? 3 : prnd.get_random_32bit_number()%6+1,
+                do_3x3 ? 3 : prnd.get_random_32bit_number()%6+1 
+            );
+
+            tt::tensor_rand rnd;
+            rnd.fill_uniform(data);
+            rnd.fill_uniform(filters);
+
+            const int stride_y = do_3x3 ? 1 : prnd.get_random_32bit_number()%3+1;
+            const int stride_x = do_3x3 ? 1 : prnd.get_random_32bit_number()%3+1;
+            int padding_y = prnd.get_random_32bit_number()%(filters.nr()/2+1);
+            int padding_x = prnd.get_random_32bit_number()%(filters.nc()/2+1);
+            if (!(filters.nr() <= data.nr() + 2*padding_y))
+                padding_y = (filters.nr()-data.nr()+1)/2;
+            if (!(filters.nc() <= data.nc() + 2*padding_x))
+                padding_x = (filters.nc()-data.nc()+1)/2;
+
+            cpu::tensor_conv conv1, conv2;
+            resizable_tensor output1, output2;
+            set_dnn_prefer_fastest_algorithms();
+            conv1(output1, data, filters, stride_y, stride_x, padding_y, padding_x);
+            set_dnn_prefer_smallest_algorithms();
+            conv2(output2, data, filters, stride_y, stride_x, padding_y, padding_x);
+            set_dnn_prefer_fastest_algorithms();
+
+            if (conv1.get_last_algorithm() == cpu::tensor_conv::algorithm::winograd_2x2 ||
+                conv1.get_last_algorithm() == cpu::tensor_conv::algorithm::winograd_4x4)
+                ++num_winograd;
+            if (conv2.get_last_algorithm() == cpu::tensor_conv::algorithm::direct)
+                ++num_direct;
+
+            DLIB_TEST(have_same_dimensions(output1, output2));
+            const float error = max(abs(mat(output1)-mat(output2)));
+            dlog << LINFO << "conv algorithm error: "<< error;
+            DLIB_TEST_MSG(error < 1e-3, error
+                 <<"\n\t padding_y: "<< padding_y 
+                 <<"\n\t padding_x: "<< padding_x 
+                 );
+        }
+        DLIB_TEST(num_winograd > 10);
+        DLIB_TEST(num_direct > 10);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_cpu_winograd_vs_img2col()
+    {
+        // Winograd is what 3x3 stride 1 convolutions use by default, so check it against
+        // the img2col + gemm path the CPU convolution used to always take.  The outputs
+        // must agree to within 1e-5 of the largest output magnitude.
+        dlib::rand prnd;
+        for (int iter = 0; iter < 100; ++iter)
+        {
+            print_spinner();
+
+            resizable_tensor data(prnd.get_random_32bit_number()%3+1,
+                prnd.get_random_32bit_number()%16+1,
+                prnd.get_random_32bit_number()%20+3,
+                prnd.get_random_32bit_number()%20+3
+            );
+            resizable_tensor filters(prnd.get_random_32bit_number()%16+1, data.k(), 3, 3);
+
+            tt::tensor_rand rnd(iter);
+            rnd.fill_uniform(data);
+            rnd.fill_uniform(filters);
+            data = mat(data) - 0.5;
+            filters = mat(filters) - 0.5;
+            const int padding_y = prnd.get_random_32bit_number()%2;
+            const int padding_x = prnd.get_random_32bit_number()%2;
+
+            cpu::tensor_conv conv;
+            resizable_tensor out_ref, out_w2, out_w4;
+            conv(out_ref, data, filters, 1, 1, padding_y, padding_x, cpu::tensor_conv::algorithm::img2col);
+            conv(out_w2, data, filters, 1, 1, padding_y, padding_x, cpu::tensor_conv::algorithm::winograd_2x2);
+            DLIB_TEST(conv.get_last_algorithm() == cpu::tensor_conv::algorithm::winograd_2x2);
+            conv(out_w4, data, filters, 1, 1, padding_y, padding_x, cpu::tensor_conv::algorithm::winograd_4x4);
+
+            DLIB_TEST(have_same_dimensions(out_ref, out_w2));
+            DLIB_TEST(have_same_dimensions(out_ref, out_w4));
+            const float scale = std::max(1.0f, max(abs(mat(out_ref))));
+            const float error2 = max(abs(mat(out_ref)-mat(out_w2)))/scale;
+            const float error4 = max(abs(mat(out_ref)-mat(out_w4)))/scale;
+            DLIB_TEST_MSG(error2 < 1e-5, error2);
+            DLIB_TEST_MSG(error4 < 1e-5, error4);
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_cpu_threading()
+    {
+        // Run a bunch of the CPU tensor routines with different numbers of threads and
+        // make sure they always produce the same outputs as the single threaded versions.
+        print_spinner();
+        const unsigned long old_num_threads = dnn_cpu_num_threads();
+
+        tt::tensor_rand rnd;
+        resizable_tensor src(8,16,24,24), src2, gi, gamma(1,16), beta(1,16);
+        resizable_tensor gamma2(1,16,24,24), beta2(1,16,24,24);
+        resizable_tensor filters(7,16,3,3);
+        rnd.fill_gaussian(src);
+        rnd.fill_gaussian(gamma);
+        rnd.fill_gaussian(beta);
+        rnd.fill_gaussian(gamma2);
+        rnd.fill_gaussian(beta2);
+        rnd.fill_gaussian(filters);
+        src2.copy_size(src);
+        rnd.fill_gaussian(src2);
+        gi.copy_size(src);
+        rnd.fill_gaussian(gi);
+        resizable_tensor pool_gi(8,16,12,12);
+        rnd.fill_gaussian(pool_gi);
+
+        std::vector<matrix<float>> results[2];
+        const unsigned long thread_counts[] = {1, 4};
+        for (int t = 0; t < 2; ++t)
+        {
+            set_dnn_cpu_num_threads(thread_counts[t]);
+            DLIB_TEST(dnn_cpu_num_threads() == thread_counts[t]);
+            auto& res = results[t];
+
+            resizable_tensor dest, dest2, means, invstds, rm, rv, grad, gamma_grad, beta_grad;
+            dest.copy_size(src);
+            cpu::multiply(false, dest, src, src2);
+            res.push_back(mat(dest));
+            dest.set_size(1,16,24,24);
+            cpu::multiply(false, dest, src, src2);
+            res.push_back(mat(dest));
+            dest.copy_size(src);
+            cpu::add(dest, src, src2);
+            res.push_back(mat(dest));
+            dest = 1;
+            cpu::add(2, dest, 3, gamma);
+            res.push_back(mat(dest));
+            cpu::affine_transform_conv(dest, src, gamma, beta);
+            res.push_back(mat(dest));
+            cpu::affine_transform(dest, src, gamma2, beta2);
+            res.push_back(mat(dest));
+
+            cpu::batch_normalize(DEFAULT_BATCH_NORM_EPS, dest, means, invstds, 1, rm, rv, src, gamma2, beta2);
+            res.push_back(mat(dest));
+            res.push_back(mat(rv));
+            grad.copy_size(src);
+            grad = 0;
+            gamma_grad.copy_size(gamma2);
+            beta_grad.copy_size(beta2);
+            cpu::batch_normalize_gradient(DEFAULT_BATCH_NORM_EPS, gi, means, invstds, src, gamma2, grad, gamma_grad, beta_grad);
+            res.push_back(mat(grad));
+            res.push_back(mat(gamma_grad));
+            res.push_back(mat(beta_grad));
+
+            cpu::batch_normalize_conv(DEFAULT_BATCH_NORM_EPS, dest, means, invstds, 1, rm, rv, src, gamma, beta);
+            res.push_back(mat(dest));
+            res.push_back(mat(rv));
+            grad = 0;
+            gamma_grad.copy_size(gamma);
+            beta_grad.copy_size(beta);
+            cpu::batch_normalize_conv_gradient(DEFAULT_BATCH_NORM_EPS, gi, means, invstds, src, gamma, grad, gamma_grad, beta_grad);
+            res.push_back(mat(grad));
+            res.push_back(mat(gamma_grad));
+            res.push_back(mat(beta_grad));
+            cpu::batch_normalize_conv_inference(DEFAULT_BATCH_NORM_EPS, dest2, src, gamma, beta, rm, rv);
+            res.push_back(mat(dest2));
+
+            cpu::softmax(dest, src);
+            res.push_back(mat(dest));
+            grad = 0;
+            cpu::softmax_gradient(grad, dest, gi);
+            res.push_back(mat(grad));
+            cpu::relu(dest, src);
+            res.push_back(mat(dest));
+            cpu::tanh(dest, src);
+            res.push_back(mat(dest));
+
+            resizable_tensor gamma_conv_grad(1,16);
+            cpu::assign_conv_bias_gradient(gamma_conv_grad, gi);
+            res.push_back(mat(gamma_conv_grad));
+
+            cpu::pooling mp;
+            mp.setup_max_pooling(3,3,2,2,1,1);
+            mp(dest, src);
+            res.push_back(mat(dest));
+            grad = 0;
+            mp.get_gradient(pool_gi, dest, src, grad);
+            res.push_back(mat(grad));
+
+            cpu::tensor_conv conv;
+            conv(dest, src, filters, 1, 1, 1, 1);
+            res.push_back(mat(dest));
+            grad = 0;
+            conv.get_gradient_for_data(dest, filters, grad);
+            res.push_back(mat(grad));
+        }
+
+        DLIB_TEST(results[0].size() == results[1].size());
+        for (unsigned long i = 0; i < results[0].size(); ++i)
+        {
+            DLIB_TEST(results[0][i].size() == results[1][i].size());
+            DLIB_TEST_MSG(max(abs(results[0][i]-results[1][i])) == 0, 
+                i << ": " << max(abs(results[0][i]-results[1][i])));
+        }
+
+        set_dnn_cpu_num_threads(old_num_threads);
+    }
+
 #ifdef DLIB_USE_CUDA
     void test_copy_tensor_gpu()
     {
@@ -1520,6 +1754,460 @@ namespace
     }
 #endif//DLIB_USE_CUDA
 
+    void test_int8_kernels()
+    {
+        // The int8 routines should closely approximate the float versions.
+        dlib::rand prnd;
+        for (int iter = 0; iter < 50; ++iter)
+        {
+            print_spinner();
+
+            resizable_tensor data(prnd.get_random_32bit_number()%3+1,
+                prnd.get_random_32bit_number()%8+1,
+                prnd.get_random_32bit_number()%20+1,
+                prnd.get_random_32bit_number()%20+1
+            );
+            resizable_tensor filters(
+                prnd.get_random_32bit_number()%8+1,
+                data.k(),
+                prnd.get_random_32bit_number()%5+1,
+                prnd.get_random_32bit_number()%5+1 
+            );
+
+            for (auto& v : data) v = prnd.get_random_gaussian();
+            for (auto& v : filters) v = prnd.get_random_gaussian();
+
+            const int stride_y = prnd.get_random_32bit_number()%3+1;
+            const int stride_x = prnd.get_random_32bit_number()%3+1;
+            int padding_y = prnd.get_random_32bit_number()%(filters.nr()/2+1);
+            int padding_x = prnd.get_random_32bit_number()%(filters.nc()/2+1);
+            if (!(filters.nr() <= data.nr() + 2*padding_y))
+                padding_y = (filters.nr()-data.nr()+1)/2;
+            if (!(filters.nc() <= data.nc() + 2*padding_x))
+                padding_x = (filters.nc()-data.nc()+1)/2;
+
+            tt::int8_filters qfilters;
+            qfilters.quantize(filters, false, max(abs(mat(data))));
+            DLIB_TEST(qfilters.num_filters() == filters.num_samples());
+            DLIB_TEST(qfilters.filter_size() == (long)filters.size()/filters.num_samples());
+
+            cpu::tensor_conv conv;
+            resizable_tensor output1, output2;
+            conv(output1, data, filters, stride_y, stride_x, padding_y, padding_x);
+            tt::int8_conv(output2, data, qfilters, filters.nr(), filters.nc(), stride_y, stride_x, padding_y, padding_x);
+            DLIB_TEST(have_same_dimensions(output1, output2));
+            float error = max(abs(mat(output1)-mat(output2)));
+            DLIB_TEST_MSG(error < 0.05*max(abs(mat(output1)))+1e-5, error << "  " << max(abs(mat(output1))));
+
+            // Now check the fc version, where the filters are the columns of the weight
+            // matrix.
+            resizable_tensor weights(data.k()*data.nr()*data.nc(), filters.num_samples());
+            for (auto& v : weights) v = prnd.get_random_gaussian();
+            qfilters.quantize(weights, true, max(abs(mat(data))));
+            output1.set_size(data.num_samples(), weights.nc()*weights.k());
+            tt::gemm(0, output1, 1, data, false, weights, false);
+            tt::int8_fc(output2, data, qfilters);
+            DLIB_TEST(have_same_dimensions(output1, output2));
+            error = max(abs(mat(output1)-mat(output2)));
+            DLIB_TEST_MSG(error < 0.05*max(abs(mat(output1)))+1e-5, error << "  " << max(abs(mat(output1))));
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_quantize_network()
+    {
+        print_spinner();
+        using net_type = loss_multiclass_log<fc<10,relu<con<8,3,3,2,2,relu<con<6,5,5,1,1,input<matrix<float>>>>>>>>;
+        net_type net;
+
+        dlib::rand rnd;
+        std::vector<matrix<float>> samples;
+        for (int i = 0; i < 20; ++i)
+        {
+            matrix<float> samp(16,16);
+            for (auto& v : samp)
+                v = rnd.get_random_float();
+            samples.push_back(samp);
+        }
+
+        resizable_tensor x;
+        net.to_tensor(samples.begin(), samples.end(), x);
+        const matrix<float> float_out = mat(net.subnet().forward(x));
+
+        net_type qnet = net;
+        quantize_network(qnet, samples, 7);
+        DLIB_TEST(layer<1>(qnet).layer_details().is_quantized());
+        DLIB_TEST(layer<3>(qnet).layer_details().is_quantized());
+        DLIB_TEST(layer<5>(qnet).layer_details().is_quantized());
+        DLIB_TEST(!layer<1>(net).layer_details().is_quantized());
+
+        const matrix<float> int8_out = mat(qnet.subnet().forward(x));
+        const float error = max(abs(float_out-int8_out));
+        dlog << LINFO << "quantized network error: " << error << "  output range: "<< max(abs(float_out));
+        DLIB_TEST_MSG(error < 0.05*max(abs(float_out)), error << "  " << max(abs(float_out)));
+
+        // The quantized network should serialize to something much smaller and come back
+        // exactly the same.
+        net.clean();
+        qnet.clean();
+        std::ostringstream sout_float, sout_int8;
+        serialize(net, sout_float);
+        serialize(qnet, sout_int8);
+        dlog << LINFO << "float network size: " << sout_float.str().size() << "  int8 size: "<< sout_int8.str().size();
+        DLIB_TEST(sout_int8.str().size() < sout_float.str().size());
+
+        net_type qnet2;
+        std::istringstream sin(sout_int8.str());
+        deserialize(qnet2, sin);
+        DLIB_TEST(layer<5>(qnet2).layer_details().is_quantized());
+        DLIB_TEST(max(abs(mat(qnet2.subnet().forward(x))-int8_out)) == 0);
+        DLIB_TEST(qnet2(samples) == qnet(samples));
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_fuse_layers()
+    {
+        print_spinner();
+        // Batch normalized networks get deployed by converting their bn layers to affine
+        // layers, so build the network that way.
+        using bn_net_type = loss_multiclass_log<fc<10,relu<bn_fc<fc<12,relu<bn_con<con<8,3,3,2,2,
+                            relu<bn_con<con<6,5,5,1,1,input<matrix<float>>>>>>>>>>>>>;
+        using net_type = loss_multiclass_log<fc<10,relu<affine<fc<12,relu<affine<con<8,3,3,2,2,
+                         relu<affine<con<6,5,5,1,1,input<matrix<float>>>>>>>>>>>>>;
+        bn_net_type bnnet;
+
+        dlib::rand rnd;
+        std::vector<matrix<float>> samples;
+        for (int i = 0; i < 5; ++i)
+        {
+            matrix<float> samp(16,16);
+            for (auto& v : samp)
+                v = rnd.get_random_float();
+            samples.push_back(samp);
+        }
+
+        resizable_tensor x;
+        bnnet.to_tensor(samples.begin(), samples.end(), x);
+        bnnet.subnet().forward(x);
+        // Give the bn layers something other than the identity transform to fold.
+        visit_layer_parameters(bnnet, [&](size_t, tensor& t) {
+            for (auto& v : t)
+                v += 0.5*rnd.get_random_gaussian();
+        });
+        net_type net = bnnet;
+        const matrix<float> out = mat(net.subnet().forward(x));
+
+        net_type fnet = net;
+        fuse_layers(fnet);
+        DLIB_TEST(layer<2>(fnet).layer_details().is_disabled());
+        DLIB_TEST(layer<3>(fnet).layer_details().is_disabled());
+        DLIB_TEST(layer<4>(fnet).layer_details().relu_is_enabled());
+        DLIB_TEST(layer<5>(fnet).layer_details().is_disabled());
+        DLIB_TEST(layer<6>(fnet).layer_details().is_disabled());
+        DLIB_TEST(layer<7>(fnet).layer_details().relu_is_enabled());
+        DLIB_TEST(layer<8>(fnet).layer_details().is_disabled());
+        DLIB_TEST(layer<9>(fnet).layer_details().is_disabled());
+        DLIB_TEST(layer<10>(fnet).layer_details().relu_is_enabled());
+        DLIB_TEST(!layer<1>(fnet).layer_details().relu_is_enabled());
+        DLIB_TEST(!layer<2>(net).layer_details().is_disabled());
+
+        const matrix<float> fused_out = mat(fnet.subnet().forward(x));
+        DLIB_TEST_MSG(max(abs(out-fused_out)) < 1e-4*max(abs(out)), max(abs(out-fused_out)));
+
+        fnet.clean();
+        std::ostringstream sout;
+        serialize(fnet, sout);
+        net_type fnet2;
+        std::istringstream sin(sout.str());
+        deserialize(fnet2, sin);
+        DLIB_TEST(layer<3>(fnet2).layer_details().is_disabled());
+        DLIB_TEST(layer<4>(fnet2).layer_details().relu_is_enabled());
+        DLIB_TEST(max(abs(mat(fnet2.subnet().forward(x))-fused_out)) == 0);
+
+        // Fusing then quantizing should also work.
+        quantize_network(fnet2, samples);
+        DLIB_TEST(layer<10>(fnet2).layer_details().is_quantized());
+        DLIB_TEST(layer<10>(fnet2).layer_details().relu_is_enabled());
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_mini_batch_prefetcher()
+    {
+        print_spinner();
+        {
+            // Batches come out in order even though several threads make them.
+            mini_batch_prefetcher<int,unsigned long> batches([](unsigned long long i, std::vector<int>& data, std::vector<unsigned long>& labels)
+                {
+                    if (i >= 50)
+                        return false;
+                    data.assign(i%4+1, i);
+                    labels.assign(i%4+1, 2*i);
+                    return true;
+                }, 3, 2);
+            std::vector<int> data;
+            std::vector<unsigned long> labels;
+            for (int i = 0; i < 50; ++i)
+            {
+                DLIB_TEST(batches.get_next_batch(data, labels));
+                DLIB_TEST(data.size() == (size_t)i%4+1 && labels.size() == data.size());
+                DLIB_TEST(data[0] == i && labels[0] == 2*(unsigned long)i);
+            }
+            DLIB_TEST(!batches.get_next_batch(data, labels));
+            DLIB_TEST(!batches.get_next_batch(data, labels));
+        }
+        {
+            // Exceptions thrown by the source end the stream and come out of get_next_batch().
+            mini_batch_prefetcher<int,unsigned long> batches([](unsigned long long i, std::vector<int>& data, std::vector<unsigned long>& labels)
+                {
+                    if (i == 5)
+                        throw error("bad batch");
+                    data.assign(1, i);
+                    labels.assign(1, i);
+                    return true;
+                }, 2, 4);
+            std::vector<int> data;
+            std::vector<unsigned long> labels;
+            for (int i = 0; i < 5; ++i)
+                DLIB_TEST(batches.get_next_batch(data, labels) && data[0] == i);
+            bool caught = false;
+            try { batches.get_next_batch(data, labels); } catch (error&) { caught = true; }
+            DLIB_TEST(caught);
+        }
+        {
+            // Train a classifier on a stream of generated data.
+            auto make_sample = [](dlib::rand& rnd, matrix<float>& samp, unsigned long& label)
+            {
+                label = rnd.get_random_32bit_number()%2;
+                samp.set_size(2,1);
+                samp(0) = rnd.get_random_gaussian() + (label==0 ? 3 : -3);
+                samp(1) = rnd.get_random_gaussian();
+            };
+            using net_type = loss_multiclass_log<fc<2,input<matrix<float>>>>;
+            net_type net;
+            mini_batch_prefetcher<matrix<float>,unsigned long> batches([&](unsigned long long i, std::vector<matrix<float>>& data, std::vector<unsigned long>& labels)
+                {
+                    if (i >= 200)
+                        return false;
+                    dlib::rand rnd(i);
+                    data.resize(32);
+                    labels.resize(32);
+                    for (size_t j = 0; j < data.size(); ++j)
+                        make_sample(rnd, data[j], labels[j]);
+                    return true;
+                });
+            dnn_trainer<net_type> trainer(net);
+            trainer.set_learning_rate(0.1);
+            trainer.train(batches);
+            DLIB_TEST(trainer.get_train_one_step_calls() == 200);
+
+            dlib::rand rnd(1234);
+            std::vector<matrix<float>> samples(100);
+            std::vector<unsigned long> labels(100);
+            for (size_t j = 0; j < samples.size(); ++j)
+                make_sample(rnd, samples[j], labels[j]);
+            const auto predicted = net(samples);
+            int num_right = 0;
+            for (size_t j = 0; j < samples.size(); ++j)
+                num_right += predicted[j] == labels[j];
+            DLIB_TEST_MSG(num_right > 95, num_right);
+        }
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    std::vector<network_address> make_local_ring (
+        std::vector<scoped_ptr<listener>>& listeners
+    )
+    {
+        // Let the OS pick free ports.  The listeners are handed to the ring_all_reducers
+        // as they are, so no other process can grab the ports in the meantime.
+        std::vector<network_address> nodes;
+        for (auto& l : listeners)
+        {
+            DLIB_TEST(create_listener(l, 0, "127.0.0.1") == 0);
+            nodes.push_back(network_address("127.0.0.1", l->get_listening_port()));
+        }
+        return nodes;
+    }
+
+    using distributed_net_type = loss_multiclass_log<fc<2,relu<fc<5,input<matrix<float>>>>>>;
+
+    std::vector<float> get_all_parameters (
+        distributed_net_type& net
+    )
+    {
+        std::vector<float> params;
+        visit_layer_parameters(net, [&](size_t, tensor& t){ params.insert(params.end(), t.begin(), t.end()); });
+        return params;
+    }
+
+    void train_distributed_rank (
+        distributed_net_type& net,
+        const std::vector<network_address>& nodes,
+        unsigned long rank,
+        scoped_ptr<listener>* listen_socket
+    )
+    {
+        // Each rank trains on different data.
+        dlib::rand rnd(rank);
+        std::vector<matrix<float>> samples(20);
+        std::vector<unsigned long> labels(20);
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            labels[i] = i%2;
+            samples[i] = matrix_cast<float>(randm(2,1,rnd)) + labels[i];
+        }
+        dnn_trainer<distributed_net_type> trainer(net);
+        if (listen_socket)
+            trainer.set_distributed_nodes(nodes, rank, *listen_socket, 10000);
+        else
+            trainer.set_distributed_nodes(nodes, rank, 10000);
+        // Small enough that each layer gets its own bucket.
+        trainer.set_distributed_bucket_size(7);
+        for (int i = 0; i < 10; ++i)
+            trainer.train_one_step(samples, labels);
+        trainer.get_net();
+    }
+
+    void test_ring_all_reducer()
+    {
+        print_spinner();
+        {
+            std::vector<scoped_ptr<listener>> listeners(3);
+            const auto nodes = make_local_ring(listeners);
+            std::vector<std::vector<float>> results(nodes.size());
+            std::vector<std::vector<float>> small_results(nodes.size());
+            {
+                std::vector<std::unique_ptr<thread_function>> threads;
+                for (unsigned long r = 0; r < nodes.size(); ++r)
+                {
+                    threads.emplace_back(new thread_function([&,r]() {
+                        ring_all_reducer reducer(nodes, r, listeners[r], 10000);
+                        results[r].resize(1000);
+                        for (size_t i = 0; i < results[r].size(); ++i)
+                            results[r][i] = i + 1000*r;
+                        reducer.sum(results[r].data(), results[r].size());
+                        // Fewer elements than nodes.
+                        small_results[r].assign(2, r+1);
+                        reducer.sum(small_results[r].data(), small_results[r].size());
+                    }));
+                }
+            }
+            for (unsigned long r = 0; r < nodes.size(); ++r)
+            {
+                DLIB_TEST(results[r].size() == 1000);
+                for (size_t i = 0; i < results[r].size(); ++i)
+                    DLIB_TEST(results[r][i] == 3*i + 3000);
+                DLIB_TEST(small_results[r].size() == 2);
+                DLIB_TEST(small_results[r][0] == 6 && small_results[r][1] == 6);
+            }
+        }
+        {
+            // Two processes training on different data end up with the same network.
+            std::vector<scoped_ptr<listener>> listeners(2);
+            const auto nodes = make_local_ring(listeners);
+            std::vector<distributed_net_type> nets(nodes.size());
+            {
+                std::vector<std::unique_ptr<thread_function>> threads;
+                for (unsigned long r = 0; r < nodes.size(); ++r)
+                {
+                    threads.emplace_back(new thread_function([&,r]() {
+                        train_distributed_rank(nets[r], nodes, r, &listeners[r]);
+                    }));
+                }
+            }
+            const auto params0 = get_all_parameters(nets[0]);
+            DLIB_TEST(params0.size() == 2*5+5 + 5*2+2);
+            DLIB_TEST(params0 == get_all_parameters(nets[1]));
+        }
+#ifdef __linux__
+        {
+            // The same thing but with rank 1 in a separate process.  It's this test
+            // program run again with the --test_dnn_distributed_worker option.
+            std::vector<scoped_ptr<listener>> listeners(2);
+            auto nodes = make_local_ring(listeners);
+            // The child opens its own listening socket.
+            listeners[1].reset();
+            const std::string net_file = "dnn_distributed_worker.dat";
+            std::remove(net_file.c_str());
+            const std::string worker_arg = cast_to_string(nodes[0].port) + "," +
+                cast_to_string(nodes[1].port) + "," + net_file;
+            const pid_t child = fork();
+            DLIB_TEST(child != -1);
+            if (child == 0)
+            {
+                execl("/proc/self/exe", "dtest", "-q", "--test_dnn_distributed_worker", worker_arg.c_str(), (char*)0);
+                _exit(127);
+            }
+
+            distributed_net_type net0, net1;
+            std::string error;
+            try
+            {
+                train_distributed_rank(net0, nodes, 0, &listeners[0]);
+            }
+            catch (std::exception& e)
+            {
+                error = e.what();
+            }
+            int status = 0;
+            DLIB_TEST(waitpid(child, &status, 0) == child);
+            DLIB_TEST_MSG(error.size() == 0, error);
+            DLIB_TEST_MSG(WIFEXITED(status) && WEXITSTATUS(status) == 0, status);
+            deserialize(net_file) >> net1;
+            std::remove(net_file.c_str());
+            DLIB_TEST(get_all_parameters(net0) == get_all_parameters(net1));
+        }
+#endif
+    }
+
+    template <typename SUBNET> using cb_fc3 = relu<fc<3,SUBNET>>;
+
+    void test_gradient_ready_callback()
+    {
+        print_spinner();
+        using net_type = loss_multiclass_log<fc<2,
+                         add_prev1<repeat<2,cb_fc3,
+                         tag1<relu<fc<3,input<matrix<float>>>>>>>>>;
+        net_type net;
+        dlib::rand rnd;
+        std::vector<matrix<float>> samples(4);
+        std::vector<unsigned long> labels(4);
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            samples[i] = matrix_cast<float>(randm(2,1,rnd));
+            labels[i] = i%2;
+        }
+        resizable_tensor x;
+        net.to_tensor(samples.begin(), samples.end(), x);
+
+        std::vector<tensor*> expected;
+        visit_layer_parameter_gradients(net, [&](size_t, tensor& t){ expected.push_back(&t); });
+        DLIB_TEST(expected.size() == net_type::num_computational_layers);
+
+        // The callback is given each layer's gradient once, top down, and sees the
+        // same values back_propagate_error() leaves in the network.
+        const double loss = net.compute_parameter_gradients(x, labels.begin());
+        std::vector<float> grads;
+        visit_layer_parameter_gradients(net, [&](size_t, tensor& t){ grads.insert(grads.end(), t.begin(), t.end()); });
+
+        std::vector<tensor*> reported;
+        std::vector<float> reported_grads;
+        gradient_ready_callback on_gradient_ready = [&](tensor& t)
+        {
+            reported.push_back(&t);
+            reported_grads.insert(reported_grads.end(), t.begin(), t.end());
+        };
+        DLIB_TEST(net.compute_parameter_gradients(x, labels.begin(), on_gradient_ready) == loss);
+        DLIB_TEST(reported == expected);
+        DLIB_TEST(reported_grads == grads);
+    }
+
+// ----------------------------------------------------------------------------------------
+
     template <typename SUBNET> using concat_block1 = con<5,1,1,1,1,SUBNET>;
     template <typename SUBNET> using concat_block2 = con<8,3,3,1,1,SUBNET>;
     template <typename SUBNET> using concat_block3 = max_pool<3,3,1,1,SUBNET>;
@@ -1581,6 +2269,164 @@ namespace
         error = memcmp(g3.host(), b3g.host(), b3g.size());
         DLIB_TEST(error == 0);
     }
+// ----------------------------------------------------------------------------------------
+
+    class record_output_
+    {
+        /*!
+            This layer just copies its input to its output, but it also records where in
+            memory it wrote its output each time forward() was called.  That lets the
+            tests see when output tensors get reallocated.
+        !*/
+    public:
+        template <typename SUBNET>
+        void setup (const SUBNET& /*sub*/)
+        {
+        }
+
+        template <typename SUBNET>
+        void forward(const SUBNET& sub, resizable_tensor& output)
+        {
+            output.copy_size(sub.get_output());
+            tt::copy_tensor(output, 0, sub.get_output(), 0, output.k());
+            addresses.push_back(output.host());
+        }
+
+        template <typename SUBNET>
+        void backward(const tensor& gradient_input, SUBNET& sub, tensor& /*params_grad*/)
+        {
+            tt::add(sub.get_gradient_input(), sub.get_gradient_input(), gradient_input);
+        }
+
+        const tensor& get_layer_params() const { return params; }
+        tensor& get_layer_params() { return params; }
+
+        friend void serialize(const record_output_& , std::ostream& out) { serialize("record_output_", out); }
+        friend void deserialize(record_output_& , std::istream& in) { std::string version; deserialize(version, in); }
+        friend std::ostream& operator<<(std::ostream& out, const record_output_& ) { return out << "record_output"; }
+        friend void to_xml(const record_output_& , std::ostream& out) { out << "<record_output/>\n"; }
+
+        std::vector<const float*> addresses;
+
+    private:
+        resizable_tensor params;
+    };
+
+    template <typename SUBNET> using record_output = add_layer<record_output_, SUBNET>;
+
+    template <typename net_type>
+    void check_outputs_not_reallocated(
+        net_type& net,
+        const size_t calls
+    )
+    {
+        // Each record_output layer must have written into the same tensor in each of the
+        // last two calls to forward().  Note that this relies on the record_output layers
+        // all having different output sizes, since layers with the same output size may
+        // trade tensors from one call to the next.
+        const auto& a1 = layer<1>(net).layer_details().addresses;
+        const auto& a3 = layer<3>(net).layer_details().addresses;
+        const auto& a5 = layer<5>(net).layer_details().addresses;
+        DLIB_TEST(a1.size() == calls && a3.size() == calls && a5.size() == calls);
+        DLIB_TEST(a1[calls-1] == a1[calls-2]);
+        DLIB_TEST(a3[calls-1] == a3[calls-2]);
+        DLIB_TEST(a5[calls-1] == a5[calls-2]);
+    }
+
+    void test_inference_mode_reuses_outputs()
+    {
+        print_spinner();
+        // The layers in this network all have different output sizes.  In inference mode
+        // the output tensors are recycled, and after a couple of runs each layer should
+        // keep getting a tensor of the right size rather than reallocating one.
+        using net_type = fc<3,record_output<max_pool<2,2,2,2,record_output<con<6,3,3,1,1,record_output<input<matrix<float>>>>>>>>;
+        net_type net;
+
+        dlib::rand rnd;
+        std::vector<matrix<float>> samples;
+        for (int i = 0; i < 3; ++i)
+        {
+            matrix<float> samp(10,10);
+            for (auto& v : samp)
+                v = rnd.get_random_gaussian();
+            samples.push_back(samp);
+        }
+        resizable_tensor x, x2;
+        net.to_tensor(samples.begin(), samples.end(), x);
+        net.to_tensor(samples.begin(), samples.begin()+2, x2);
+        const matrix<float> out = mat(net.forward(x));
+        const matrix<float> out2 = mat(net.forward(x2));
+
+        net.set_inference_mode(true);
+        size_t calls = 2;
+        for (int iter = 0; iter < 4; ++iter)
+        {
+            DLIB_TEST(max(abs(out-mat(net.forward(x)))) < 1e-6);
+            ++calls;
+        }
+        check_outputs_not_reallocated(net, calls);
+
+        // Changing the input shape changes the output sizes, which drops the recycled
+        // tensors.  The network then settles down again.
+        for (int iter = 0; iter < 4; ++iter)
+        {
+            DLIB_TEST(max(abs(out2-mat(net.forward(x2)))) < 1e-6);
+            ++calls;
+        }
+        check_outputs_not_reallocated(net, calls);
+        DLIB_TEST(max(abs(out-mat(net.forward(x)))) < 1e-6);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_inference_mode()
+    {
+        print_spinner();
+        // This network has in-place layers that only run in place in inference mode
+        // (sig on top of relu and relu on top of max_pool) along with tags, skips, and
+        // repeats whose outputs must not get recycled while they are still needed.
+        using net_type = loss_multiclass_log<fc<10,relu<max_pool<2,2,2,2,concat_incept<
+                         repeat<2,ares,ares_down<sig<relu<con<8,3,3,1,1,input<matrix<float>>>>>>>>>>>>;
+        net_type net;
+
+        dlib::rand rnd;
+        std::vector<matrix<float>> samples;
+        std::vector<unsigned long> labels;
+        for (int i = 0; i < 4; ++i)
+        {
+            matrix<float> samp(20,20);
+            for (auto& v : samp)
+                v = rnd.get_random_gaussian();
+            samples.push_back(samp);
+            labels.push_back(i);
+        }
+
+        resizable_tensor x;
+        net.to_tensor(samples.begin(), samples.end(), x);
+        const matrix<float> out = mat(net.subnet().forward(x));
+        const std::vector<unsigned long> predicted = net(samples);
+        DLIB_TEST(layer<3>(net).get_output().size() != 0);
+
+        net.set_inference_mode(true);
+        for (int iter = 0; iter < 3; ++iter)
+        {
+            const matrix<float> iout = mat(net.subnet().forward(x));
+            DLIB_TEST_MSG(max(abs(out-iout)) < 1e-6, max(abs(out-iout)));
+            // Intermediate outputs get recycled once the layer above has used them.
+            DLIB_TEST(layer<3>(net).get_output().size() == 0);
+            DLIB_TEST(net(samples) == predicted);
+        }
+
+        // Copies keep the mode and turning it off makes the network trainable again.
+        net_type net2 = net;
+        DLIB_TEST(max(abs(mat(net2.subnet().forward(x))-out)) < 1e-6);
+        DLIB_TEST(layer<3>(net2).get_output().size() == 0);
+        net2.set_inference_mode(false);
+        DLIB_TEST(max(abs(mat(net2.subnet().forward(x))-out)) < 1e-6);
+        DLIB_TEST(layer<3>(net2).get_output().size() != 0);
+        net2.compute_parameter_gradients(x, labels.begin());
+    }
+
 // ----------------------------------------------------------------------------------------
 
     class dnn_tester : public tester
@@ -1647,9 +2493,50 @@ namespace
             test_layers();
             test_visit_funcions();
             test_copy_tensor_cpu();
+            test_cpu_conv_algorithms();
+            test_cpu_winograd_vs_img2col();
+            test_cpu_threading();
+            test_int8_kernels();
+            test_quantize_network();
+            test_fuse_layers();
+            test_inference_mode();
+            test_inference_mode_reuses_outputs();
+            test_mini_batch_prefetcher();
+            test_ring_all_reducer();
+            test_gradient_ready_callback();
             test_concat();
         }
     } a;
+
+    class dnn_distributed_worker_tester : public tester
+    {
+        /*!
+            Rank 1 of the multi-process part of test_ring_all_reducer().  It takes an
+            argument of the form "port0,port1,filename" and saves the trained network
+            to filename.  Since it takes an argument --runall doesn't run it.
+        !*/
+    public:
+        dnn_distributed_worker_tester (
+        ) :
+            tester ("test_dnn_distributed_worker",
+                "Trains rank 1 of test_dnn's distributed network.",
+                1)
+        {}
+
+        void perform_test (
+            const std::string& arg
+        )
+        {
+            const auto fields = split(arg, ",");
+            DLIB_TEST(fields.size() == 3);
+            std::vector<network_address> nodes;
+            nodes.push_back(network_address("127.0.0.1", string_cast<unsigned short>(fields[0])));
+            nodes.push_back(network_address("127.0.0.1", string_cast<unsigned short>(fields[1])));
+            distributed_net_type net;
+            train_distributed_rank(net, nodes, 1, 0);
+            serialize(fields[2]) << net;
+        }
+    } b;
 }
 
 
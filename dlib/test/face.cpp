@@ -48,6 +48,115 @@ namespace
             deserialize(objects[0], sin);
         }
 
+        bool same_detection (
+            const full_object_detection& a,
+            const full_object_detection& b
+        )
+        {
+            if (a.get_rect() != b.get_rect() || a.num_parts() != b.num_parts())
+                return false;
+            for (unsigned long i = 0; i < a.num_parts(); ++i)
+            {
+                if (a.part(i) != b.part(i))
+                    return false;
+            }
+            return true;
+        }
+
+        void test_shape_predictor_forest_layout (
+            const shape_predictor& sp,
+            const array2d<unsigned char>& img,
+            const std::vector<full_object_detection>& objects
+        )
+        {
+            // The shape_predictor stores its trees in a flattened form.  Make sure that
+            // doesn't change the file format or the outputs.  To do this we load the
+            // model back as regression_tree objects and evaluate them the simple way.
+            ostringstream sout;
+            serialize(sp, sout);
+            shape_predictor sp2;
+            istringstream sin(sout.str());
+            deserialize(sp2, sin);
+            ostringstream sout2;
+            serialize(sp2, sout2);
+            DLIB_TEST(sout.str() == sout2.str());
+
+            int version;
+            matrix<float,0,1> initial_shape;
+            std::vector<std::vector<impl::regression_tree> > forests;
+            std::vector<std::vector<unsigned long> > anchor_idx;
+            std::vector<std::vector<dlib::vector<float,2> > > deltas;
+            sin.clear();
+            sin.str(sout.str());
+            deserialize(version, sin);
+            deserialize(initial_shape, sin);
+            deserialize(forests, sin);
+            deserialize(anchor_idx, sin);
+            deserialize(deltas, sin);
+            DLIB_TEST(forests.size() > 0 && forests[0].size() > 0);
+
+            for (unsigned long k = 0; k < objects.size(); ++k)
+            {
+                const rectangle rect = objects[k].get_rect();
+                matrix<float,0,1> current_shape = initial_shape;
+                std::vector<float> feature_pixel_values;
+                std::vector<std::pair<unsigned long,double> > true_feats, feats;
+                unsigned long feat_offset = 0;
+                for (unsigned long iter = 0; iter < forests.size(); ++iter)
+                {
+                    impl::extract_feature_pixel_values(img, rect, current_shape, initial_shape,
+                        anchor_idx[iter], deltas[iter], feature_pixel_values);
+                    for (unsigned long i = 0; i < forests[iter].size(); ++i)
+                    {
+                        unsigned long leaf_idx;
+                        current_shape += forests[iter][i](feature_pixel_values, leaf_idx);
+                        true_feats.push_back(std::make_pair(feat_offset+leaf_idx, 1));
+                        feat_offset += forests[iter][i].num_leaves();
+                    }
+                }
+                DLIB_TEST(feat_offset == sp2.num_features());
+
+                const full_object_detection det = sp2(img, rect);
+                const full_object_detection det2 = sp2(img, rect, feats);
+                const point_transform_affine tform_to_img = impl::unnormalizing_tform(rect);
+                DLIB_TEST((long)det.num_parts() == initial_shape.size()/2);
+                for (unsigned long i = 0; i < det.num_parts(); ++i)
+                {
+                    DLIB_TEST(det.part(i) == point(tform_to_img(impl::location(current_shape, i))));
+                    DLIB_TEST(det2.part(i) == det.part(i));
+                }
+                DLIB_TEST(feats == true_feats);
+            }
+
+            // The batch versions must give the same outputs as the single calls.
+            std::vector<rectangle> rects;
+            for (unsigned long k = 0; k < objects.size(); ++k)
+            {
+                rects.push_back(objects[k].get_rect());
+                rects.push_back(translate_rect(objects[k].get_rect(), point(3,-2)));
+            }
+            const std::vector<full_object_detection> dets = sp2(img, rects);
+            DLIB_TEST(dets.size() == rects.size());
+            for (unsigned long k = 0; k < rects.size(); ++k)
+                DLIB_TEST(same_detection(dets[k], sp2(img, rects[k])));
+
+            std::vector<matrix<unsigned char> > imgs(3);
+            std::vector<std::vector<rectangle> > img_rects(imgs.size());
+            for (unsigned long i = 0; i < imgs.size(); ++i)
+            {
+                imgs[i] = mat(img)+i;
+                img_rects[i].assign(rects.begin()+i, rects.end());
+            }
+            const std::vector<std::vector<full_object_detection> > img_dets = sp2(imgs, img_rects);
+            DLIB_TEST(img_dets.size() == imgs.size());
+            for (unsigned long i = 0; i < imgs.size(); ++i)
+            {
+                DLIB_TEST(img_dets[i].size() == img_rects[i].size());
+                for (unsigned long k = 0; k < img_rects[i].size() && k < img_dets[i].size(); ++k)
+                    DLIB_TEST(same_detection(img_dets[i][k], sp2(imgs[i], img_rects[i][k])));
+            }
+        }
+
         void perform_test()
         {
             print_spinner();
@@ -70,6 +179,9 @@ namespace
             // It should have been able to perfectly fit the data
             DLIB_TEST(test_shape_predictor(sp, images, objects) == 0);
 
+            print_spinner();
+            test_shape_predictor_forest_layout(sp, images[0], objects[0]);
+
             print_spinner();
 
             // While we are here, make sure the default face detector works
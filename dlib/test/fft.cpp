@@ -128,6 +128,127 @@ namespace
         }
     }
 
+// ----------------------------------------------------------------------------------------
+
+    matrix<complex<double> > naive_dft(const matrix<complex<double> >& m)
+    {
+        // A direct O(n^2) evaluation of the DFT definition to check against.
+        matrix<complex<double> > out(m.nr(), m.nc());
+        for (long u = 0; u < m.nr(); ++u)
+        {
+            for (long v = 0; v < m.nc(); ++v)
+            {
+                complex<double> sum = 0;
+                for (long r = 0; r < m.nr(); ++r)
+                {
+                    for (long c = 0; c < m.nc(); ++c)
+                    {
+                        const double angle = -2*pi*((double)u*r/m.nr() + (double)v*c/m.nc());
+                        sum += m(r,c)*std::polar(1.0, angle);
+                    }
+                }
+                out(u,v) = sum;
+            }
+        }
+        return out;
+    }
+
+    void test_arbitrary_size_ffts()
+    {
+        print_spinner();
+        // Covers the radix 2, 3, 4, and 5 butterflies as well as sizes with larger prime
+        // factors that go through Bluestein's algorithm.
+        const long sizes[] = {1, 2, 3, 5, 6, 7, 9, 10, 11, 12, 15, 17, 25, 30, 36, 45, 49, 60, 97, 100, 120, 143, 243, 250};
+        for (auto n : sizes)
+        {
+            for (auto m1 : {rand_complex(n,1), rand_complex(1,n)})
+            {
+                const matrix<complex<double> > D = naive_dft(m1);
+                const double scale = max(norm(D));
+                DLIB_TEST_MSG(max(norm(fft(m1)-D)) < 1e-20*scale*n, n);
+                DLIB_TEST_MSG(max(norm(ifft(fft(m1))-m1)) < 1e-20*scale, n);
+                DLIB_TEST(max(norm(ifft(D)-m1)) < 1e-20*scale);
+
+                const matrix<complex<float> > fm1 = matrix_cast<complex<float> >(m1);
+                DLIB_TEST_MSG(max(norm(matrix_cast<complex<double> >(fft(fm1))-D)) < 1e-10*scale*n, n);
+
+                matrix<complex<double> > temp = m1;
+                fft_inplace(temp);
+                DLIB_TEST(max(norm(temp-fft(m1))) < 1e-20*scale);
+                ifft_inplace(temp);
+                DLIB_TEST(max(norm(temp/n-m1)) < 1e-20*scale);
+            }
+        }
+
+        for (long nr : {3, 4, 7, 12})
+        {
+            for (long nc : {5, 8, 11, 18})
+            {
+                print_spinner();
+                const matrix<complex<double> > m1 = rand_complex(nr,nc);
+                const matrix<complex<double> > D = naive_dft(m1);
+                const double scale = max(norm(D));
+                DLIB_TEST(max(norm(fft(m1)-D)) < 1e-20*scale*m1.size());
+                DLIB_TEST(max(norm(ifft(fft(m1))-m1)) < 1e-20*scale);
+
+                matrix<complex<float> > ftemp = matrix_cast<complex<float> >(m1);
+                fft_inplace(ftemp);
+                DLIB_TEST(max(norm(matrix_cast<complex<double> >(ftemp)-D)) < 1e-10*scale*m1.size());
+            }
+        }
+
+        // A large prime size.
+        const matrix<complex<double> > m1 = rand_complex(1,4099);
+        DLIB_TEST(max(norm(ifft(fft(m1))-m1)) < 1e-16);
+        DLIB_TEST(max(norm(fft(m1)-naive_dft(m1))) < 1e-12*max(norm(fft(m1))));
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_rfft()
+    {
+        print_spinner();
+        for (long n = 1; n <= 40; ++n)
+        {
+            for (auto m1 : {rand_complex(n,1), rand_complex(1,n)})
+            {
+                const matrix<double> x = real(m1);
+                const matrix<complex<double> > D = fft(complex_matrix(x));
+                const matrix<complex<double> > R = rfft(x);
+                if (x.nc() == 1)
+                {
+                    DLIB_TEST(R.nr() == n/2+1 && R.nc() == 1);
+                    DLIB_TEST(max(norm(R-rowm(D,range(0,n/2)))) < 1e-16*n);
+                }
+                else
+                {
+                    DLIB_TEST(R.nr() == 1 && R.nc() == n/2+1);
+                    DLIB_TEST(max(norm(R-colm(D,range(0,n/2)))) < 1e-16*n);
+                }
+
+                DLIB_TEST(max(abs(irfft(R,n)-x)) < 1e-10);
+                if (n%2 == 0 && n > 0)
+                    DLIB_TEST(max(abs(irfft(R)-x)) < 1e-10);
+
+                const matrix<float> fx = matrix_cast<float>(x);
+                DLIB_TEST(max(abs(irfft(rfft(fx),n)-fx)) < 1e-4);
+            }
+        }
+
+        for (long nr : {2, 3, 8, 9})
+        {
+            for (long nc : {2, 5, 6, 16})
+            {
+                const matrix<double> x = real(rand_complex(nr,nc));
+                const matrix<complex<double> > D = fft(complex_matrix(x));
+                const matrix<complex<double> > R = rfft(x);
+                DLIB_TEST(R.nr() == nr && R.nc() == nc/2+1);
+                DLIB_TEST(max(norm(R-colm(D,range(0,nc/2)))) < 1e-16*x.size());
+                DLIB_TEST(max(abs(irfft(R,nc)-x)) < 1e-10);
+            }
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 
     class test_fft : public tester
@@ -145,6 +266,8 @@ namespace
             test_against_saved_good_ffts();
             test_random_ffts();
             test_random_real_ffts();
+            test_arbitrary_size_ffts();
+            test_rfft();
         }
     } a;
 
@@ -4,6 +4,8 @@
 #include <string>
 #include <cstdlib>
 #include <ctime>
+#include <fstream>
+#include <iterator>
 #include <dlib/pixel.h>
 #include <dlib/array2d.h>
 #include <dlib/image_transforms.h>
@@ -1575,6 +1577,396 @@ namespace
 
 // ----------------------------------------------------------------------------------------
 
+    bool same_rgb_image (
+        const array2d<rgb_pixel>& a,
+        const array2d<rgb_pixel>& b
+    )
+    {
+        if (a.nr() != b.nr() || a.nc() != b.nc())
+            return false;
+        for (long r = 0; r < a.nr(); ++r)
+        {
+            for (long c = 0; c < a.nc(); ++c)
+            {
+                if (a[r][c].red != b[r][c].red || a[r][c].green != b[r][c].green || a[r][c].blue != b[r][c].blue)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    void test_parallel_resize_and_chips (
+        dlib::rand& rnd
+    )
+    {
+        print_spinner();
+        thread_pool tp(3);
+        const long nr = rnd.get_random_32bit_number()%40 + 2;
+        const long nc = rnd.get_random_32bit_number()%60 + 2;
+        array2d<float> img(nr,nc);
+        array2d<rgb_pixel> rgb_img(nr,nc);
+        for (long r = 0; r < img.nr(); ++r)
+        {
+            for (long c = 0; c < img.nc(); ++c)
+            {
+                img[r][c] = rnd.get_random_gaussian();
+                rgb_img[r][c] = rgb_pixel(rnd.get_random_8bit_number(),
+                                          rnd.get_random_8bit_number(),
+                                          rnd.get_random_8bit_number());
+            }
+        }
+        array2d<unsigned char> gray_img;
+        assign_image(gray_img, rgb_img);
+
+        const long out_nr = rnd.get_random_32bit_number()%80 + 1;
+        const long out_nc = rnd.get_random_32bit_number()%80 + 1;
+
+        // Resizing float images shouldn't throw away the fractional part of the pixels.
+        array2d<float> fout1(out_nr,out_nc), fout2(out_nr,out_nc);
+        array2d<double> dout(out_nr,out_nc);
+        resize_image(img, fout1);
+        resize_image(img, dout, interpolate_bilinear());
+        DLIB_TEST(max(abs(matrix_cast<double>(mat(fout1)) - mat(dout))) < 1e-4);
+        resize_image(img, fout2, interpolate_bilinear(), tp);
+        DLIB_TEST(mat(fout1) == mat(fout2));
+
+        array2d<rgb_pixel> rgb_out1(out_nr,out_nc), rgb_out2(out_nr,out_nc);
+        resize_image(rgb_img, rgb_out1);
+        resize_image(rgb_img, rgb_out2, interpolate_bilinear(), tp);
+        DLIB_TEST(same_rgb_image(rgb_out1, rgb_out2));
+
+        array2d<unsigned char> gray_out1(out_nr,out_nc), gray_out2(out_nr,out_nc);
+        resize_image(gray_img, gray_out1);
+        resize_image(gray_img, gray_out2, interpolate_bilinear(), tp);
+        DLIB_TEST(mat(gray_out1) == mat(gray_out2));
+
+        resize_image(gray_img, dout, interpolate_bilinear(), tp);
+        DLIB_TEST(max(abs(matrix_cast<double>(mat(gray_out1)) - mat(dout))) < 1.01);
+
+        // Extracting chips in parallel should give the same chips as doing it serially.
+        std::vector<chip_details> dets;
+        for (int i = 0; i < 10; ++i)
+        {
+            const long size = rnd.get_random_32bit_number()%400 + 4;
+            const double angle = rnd.get_random_double()*pi;
+            const point p(rnd.get_random_32bit_number()%nc, rnd.get_random_32bit_number()%nr);
+            dets.push_back(chip_details(centered_rect(p, rnd.get_random_32bit_number()%50+1, 
+                                                         rnd.get_random_32bit_number()%50+1), size, angle));
+        }
+        dets.push_back(chip_details(rectangle(1,1,nc/2,nr/2)));
+        dlib::array<array2d<float> > chips1, chips2;
+        extract_image_chips(img, dets, chips1);
+        extract_image_chips(img, dets, chips2, tp);
+        DLIB_TEST(chips1.size() == dets.size() && chips2.size() == dets.size());
+        for (unsigned long i = 0; i < dets.size(); ++i)
+            DLIB_TEST(mat(chips1[i]) == mat(chips2[i]));
+
+        dlib::array<array2d<rgb_pixel> > rgb_chips1, rgb_chips2;
+        extract_image_chips(rgb_img, dets, rgb_chips1);
+        extract_image_chips(rgb_img, dets, rgb_chips2, tp);
+        for (unsigned long i = 0; i < dets.size(); ++i)
+            DLIB_TEST(same_rgb_image(rgb_chips1[i], rgb_chips2[i]));
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_external_image (
+        dlib::rand& rnd
+    )
+    {
+        print_spinner();
+        const long nr = rnd.get_random_32bit_number()%40 + 10;
+        const long nc = rnd.get_random_32bit_number()%40 + 10;
+        const long padding = rnd.get_random_32bit_number()%4;
+
+        // Make a buffer with some padding at the end of each row, like a camera might.
+        std::vector<rgb_pixel> buf(nr*(nc+padding));
+        for (unsigned long i = 0; i < buf.size(); ++i)
+            buf[i] = rgb_pixel(rnd.get_random_8bit_number(), rnd.get_random_8bit_number(), rnd.get_random_8bit_number());
+        external_image<rgb_pixel> img(&buf[0], nr, nc, (nc+padding)*sizeof(rgb_pixel));
+        DLIB_TEST(num_rows(img) == nr && num_columns(img) == nc);
+        DLIB_TEST(width_step(img) == (long)((nc+padding)*sizeof(rgb_pixel)));
+        DLIB_TEST(image_data(img) == &buf[0]);
+        DLIB_TEST(&img[1][0] == &buf[nc+padding]);
+
+        array2d<rgb_pixel> copy;
+        assign_image(copy, img);
+        array2d<unsigned char> gray1, gray2;
+        assign_image(gray1, img);
+        assign_image(gray2, copy);
+        DLIB_TEST(mat(gray1) == mat(gray2));
+
+        // Routines should do the same thing on the view as on a copy of the pixels.
+        array2d<rgb_pixel> out1(nr/2+3, nc*2), out2(nr/2+3, nc*2);
+        resize_image(img, out1);
+        resize_image(copy, out2);
+        DLIB_TEST(same_rgb_image(out1, out2));
+
+        pyramid_down<2> pyr;
+        pyr(img, out1);
+        pyr(copy, out2);
+        DLIB_TEST(same_rgb_image(out1, out2));
+
+        array2d<matrix<float,31,1> > hog1, hog2;
+        extract_fhog_features(img, hog1);
+        extract_fhog_features(copy, hog2);
+        DLIB_TEST(hog1.nr() == hog2.nr() && hog1.nc() == hog2.nc());
+        for (long r = 0; r < hog1.nr(); ++r)
+        {
+            for (long c = 0; c < hog1.nc(); ++c)
+                DLIB_TEST(hog1[r][c] == hog2[r][c]);
+        }
+
+        std::vector<chip_details> dets;
+        dets.push_back(chip_details(rectangle(2,3,nc/2,nr/2), 9*9, 0.3));
+        dets.push_back(chip_details(rectangle(1,1,5,6)));
+        dlib::array<array2d<rgb_pixel> > chips1, chips2;
+        extract_image_chips(img, dets, chips1);
+        extract_image_chips(copy, dets, chips2);
+        for (unsigned long i = 0; i < dets.size(); ++i)
+            DLIB_TEST(same_rgb_image(chips1[i], chips2[i]));
+
+        const rectangle rect(1,2,nc/2,nr-3);
+        assign_image(out1, sub_image(img, rect));
+        assign_image(out2, sub_image(copy, rect));
+        DLIB_TEST(same_rgb_image(out1, out2));
+
+        // The view can also be written to, as long as its size doesn't need to change.
+        std::vector<float> fbuf(nr*nc, -1);
+        external_image<float> fimg(&fbuf[0], nr, nc);
+        DLIB_TEST(width_step(fimg) == (long)(nc*sizeof(float)));
+        assign_image(fimg, gray1);
+        DLIB_TEST(mat(fimg) == matrix_cast<float>(mat(gray1)));
+        for (long r = 0; r < nr; ++r)
+        {
+            for (long c = 0; c < nc; ++c)
+                DLIB_TEST(fbuf[r*nc+c] == gray1[r][c]);
+        }
+        array2d<float> fout;
+        const matrix<float> filt = matrix_cast<float>(randm(3,1,rnd));
+        spatially_filter_image_separable(gray1, fout, filt, filt);
+        spatially_filter_image_separable(gray1, fimg, filt, filt);
+        DLIB_TEST(mat(fimg) == mat(fout));
+
+        external_image<float> empty;
+        DLIB_TEST(num_rows(empty) == 0 && num_columns(empty) == 0 && image_data(empty) == 0);
+        swap(empty, fimg);
+        DLIB_TEST(num_rows(fimg) == 0 && image_data(empty) == &fbuf[0]);
+
+        // A const_external_image can wrap memory we only have const access to.
+        const std::vector<rgb_pixel>& cbuf = buf;
+        const_external_image<rgb_pixel> cimg(&cbuf[0], nr, nc, (nc+padding)*sizeof(rgb_pixel));
+        DLIB_TEST(num_rows(cimg) == nr && num_columns(cimg) == nc);
+        DLIB_TEST(width_step(cimg) == (long)((nc+padding)*sizeof(rgb_pixel)));
+        DLIB_TEST(image_data(cimg) == &cbuf[0]);
+        DLIB_TEST(&cimg[1][0] == &cbuf[nc+padding]);
+        assign_image(gray2, cimg);
+        DLIB_TEST(mat(gray1) == mat(gray2));
+        resize_image(cimg, out1);
+        resize_image(copy, out2);
+        DLIB_TEST(same_rgb_image(out1, out2));
+        pyr(cimg, out1);
+        pyr(copy, out2);
+        DLIB_TEST(same_rgb_image(out1, out2));
+        extract_fhog_features(cimg, hog1);
+        for (long r = 0; r < hog1.nr(); ++r)
+        {
+            for (long c = 0; c < hog1.nc(); ++c)
+                DLIB_TEST(hog1[r][c] == hog2[r][c]);
+        }
+        assign_image(out1, sub_image(cimg, rect));
+        assign_image(out2, sub_image(copy, rect));
+        DLIB_TEST(same_rgb_image(out1, out2));
+
+        const_external_image<float> cfimg = empty;
+        DLIB_TEST(image_data(cfimg) == &fbuf[0] && mat(cfimg) == mat(fout));
+        const_external_image<float> cempty(fimg);
+        DLIB_TEST(num_rows(cempty) == 0 && num_columns(cempty) == 0 && image_data(cempty) == 0);
+        swap(cempty, cfimg);
+        DLIB_TEST(num_rows(cfimg) == 0 && image_data(cempty) == &fbuf[0]);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    std::vector<unsigned char> read_file_bytes (
+        const std::string& filename
+    )
+    {
+        std::ifstream fin(filename.c_str(), std::ios::binary);
+        return std::vector<unsigned char>((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+    }
+
+    void test_streaming_image_loaders (
+    )
+    {
+        print_spinner();
+        dlib::rand rnd;
+        array2d<rgb_pixel> img(37,53);
+        for (long r = 0; r < img.nr(); ++r)
+        {
+            for (long c = 0; c < img.nc(); ++c)
+            {
+                img[r][c].red = static_cast<unsigned char>(r*4 + rnd.get_random_8bit_number()%8);
+                img[r][c].green = static_cast<unsigned char>(c*4);
+                img[r][c].blue = static_cast<unsigned char>((r+c)*2);
+            }
+        }
+        array2d<unsigned char> gray_img;
+        assign_image(gray_img, img);
+
+#ifdef DLIB_PNG_SUPPORT
+        {
+            save_png(img, "test.png");
+            const std::vector<unsigned char> buf = read_file_bytes("test.png");
+
+            png_loader loader(&buf[0], buf.size());
+            DLIB_TEST(loader.is_rgb() && loader.bit_depth() == 8);
+            DLIB_TEST(loader.nr() == 37 && loader.nc() == 53);
+
+            // Decoding straight into an rgb_pixel image and decoding through a
+            // conversion should both give the original pixels back.
+            array2d<rgb_pixel> rgb1, rgb2;
+            array2d<unsigned char> gray1, gray2;
+            load_png(rgb1, "test.png");
+            loader.get_image(rgb2);
+            load_png(gray1, &buf[0], buf.size());
+            loader.get_image(gray2);
+            DLIB_TEST(same_rgb_image(rgb1, img));
+            DLIB_TEST(same_rgb_image(rgb2, img));
+            DLIB_TEST(mat(gray1) == mat(gray_img));
+            DLIB_TEST(mat(gray2) == mat(gray_img));
+
+            array2d<uint16> gray16(img.nr(), img.nc()), gray16_loaded;
+            for (long r = 0; r < gray16.nr(); ++r)
+            {
+                for (long c = 0; c < gray16.nc(); ++c)
+                    gray16[r][c] = static_cast<uint16>(r*1000 + c*7);
+            }
+            save_png(gray16, "test.png");
+            const std::vector<unsigned char> buf16 = read_file_bytes("test.png");
+            load_png(gray16_loaded, &buf16[0], buf16.size());
+            DLIB_TEST(mat(gray16_loaded) == mat(gray16));
+            array2d<float> gray16_float;
+            load_png(gray16_float, "test.png");
+            DLIB_TEST(mat(gray16_float) == matrix_cast<float>(mat(gray16)));
+        }
+#endif // DLIB_PNG_SUPPORT
+
+#ifdef DLIB_JPEG_SUPPORT
+        {
+            save_jpeg(img, "test.jpg", 95);
+            const std::vector<unsigned char> buf = read_file_bytes("test.jpg");
+
+            array2d<rgb_pixel> rgb1, rgb2;
+            array2d<unsigned char> gray1, gray2;
+            load_jpeg(rgb1, "test.jpg");
+            load_jpeg(rgb2, &buf[0], buf.size());
+            DLIB_TEST(rgb1.nr() == 37 && rgb1.nc() == 53);
+            DLIB_TEST(same_rgb_image(rgb1, rgb2));
+
+            // Decoding into a different pixel type should be the same as converting the
+            // rgb image afterwards.
+            load_jpeg(gray1, &buf[0], buf.size());
+            assign_image(gray2, rgb1);
+            DLIB_TEST(mat(gray1) == mat(gray2));
+            DLIB_TEST(mean(abs(matrix_cast<double>(mat(gray1))-matrix_cast<double>(mat(gray_img)))) < 4);
+
+            for (unsigned long scale = 1; scale <= 8; scale *= 2)
+            {
+                jpeg_loader loader(&buf[0], buf.size());
+                DLIB_TEST(loader.get_downscale() == 1);
+                loader.set_downscale(scale);
+                DLIB_TEST(loader.get_downscale() == scale);
+                DLIB_TEST(loader.nr() == (37+scale-1)/scale);
+                DLIB_TEST(loader.nc() == (53+scale-1)/scale);
+                array2d<unsigned char> small;
+                loader.get_image(small);
+                DLIB_TEST(small.nr() == (long)loader.nr() && small.nc() == (long)loader.nc());
+
+                // The result should look like a box filtered version of the full image.
+                double err = 0;
+                for (unsigned long r = 0; r < 37/scale; ++r)
+                {
+                    for (unsigned long c = 0; c < 53/scale; ++c)
+                    {
+                        double avg = 0;
+                        for (unsigned long rr = r*scale; rr < (r+1)*scale; ++rr)
+                            for (unsigned long cc = c*scale; cc < (c+1)*scale; ++cc)
+                                avg += gray2[rr][cc];
+                        err += std::abs(avg/scale/scale - small[r][c]);
+                    }
+                }
+                err /= (37/scale)*(53/scale);
+                DLIB_TEST_MSG(err < 4, "scale: " << scale << "  err: " << err);
+            }
+
+            // A buffer that ends in the middle of the compressed pixel data still gives
+            // an image of the right size.
+            unsigned long sos = 0;
+            while (sos+1 < buf.size() && !(buf[sos] == 0xFF && buf[sos+1] == 0xDA))
+                ++sos;
+            DLIB_TEST(sos+1 < buf.size());
+            array2d<rgb_pixel> truncated;
+            load_jpeg(truncated, &buf[0], (sos+buf.size())/2);
+            DLIB_TEST(truncated.nr() == 37 && truncated.nc() == 53);
+        }
+#endif // DLIB_JPEG_SUPPORT
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_parallel_separable_filtering (
+        dlib::rand& rnd
+    )
+    {
+        print_spinner();
+        thread_pool tp(3);
+        // Use widths that exercise the 16 and 8 wide SIMD loops as well as the scalar
+        // loop that handles the leftover columns.
+        const long nr = rnd.get_random_32bit_number()%40 + 1;
+        const long nc = rnd.get_random_32bit_number()%60 + 1;
+        array2d<float> img(nr,nc);
+        for (long r = 0; r < img.nr(); ++r)
+        {
+            for (long c = 0; c < img.nc(); ++c)
+            {
+                img[r][c] = rnd.get_random_gaussian();
+            }
+        }
+        const matrix<float> row_filt = matrix_cast<float>(randm(rnd.get_random_32bit_number()%9+1,1,rnd));
+        const matrix<float> col_filt = matrix_cast<float>(randm(rnd.get_random_32bit_number()%9+1,1,rnd));
+
+        // The SIMD code must give exactly the same outputs as the plain scalar code.
+        array2d<float> out1, out2, out3, scratch;
+        const rectangle rect1 = impl::grayscale_spatially_filter_image_separable(img, out1, row_filt, col_filt, 1, false, false);
+        const rectangle rect2 = float_spatially_filter_image_separable(img, out2, row_filt, col_filt, scratch);
+        const rectangle rect3 = float_spatially_filter_image_separable(img, out3, row_filt, col_filt, scratch, false, tp);
+        DLIB_TEST(rect1 == rect2 && rect1 == rect3);
+        DLIB_TEST(mat(out1) == mat(out2));
+        DLIB_TEST(mat(out1) == mat(out3));
+
+        assign_image(out2, out1);
+        assign_image(out3, out1);
+        impl::grayscale_spatially_filter_image_separable(img, out1, row_filt, col_filt, 1, false, true);
+        float_spatially_filter_image_separable(img, out2, row_filt, col_filt, scratch, true);
+        float_spatially_filter_image_separable(img, out3, row_filt, col_filt, scratch, true, tp);
+        DLIB_TEST(mat(out1) == mat(out2));
+        DLIB_TEST(mat(out1) == mat(out3));
+
+        spatially_filter_image_separable(img, out1, row_filt, col_filt, 3, true, false);
+        spatially_filter_image_separable(img, out2, row_filt, col_filt, 3, true, false, tp);
+        DLIB_TEST(mat(out1) == mat(out2));
+
+        // The generic code path should also give the same results when run in parallel.
+        array2d<unsigned char> img2;
+        assign_image_scaled(img2, img);
+        array2d<double> dout1, dout2;
+        const matrix<double> drow_filt = matrix_cast<double>(row_filt);
+        spatially_filter_image_separable(img2, dout1, drow_filt, drow_filt, 2, true, false);
+        spatially_filter_image_separable(img2, dout2, drow_filt, drow_filt, 2, true, false, tp);
+        DLIB_TEST(mat(dout1) == mat(dout2));
+    }
+
     template <typename T>
     void test_filtering_center (
         dlib::rand& rnd
@@ -1875,6 +2267,14 @@ namespace
                 test_filtering2(7,7,rnd);
             }
 
+            for (int i = 0; i < 100; ++i)
+                test_parallel_separable_filtering(rnd);
+            for (int i = 0; i < 100; ++i)
+                test_parallel_resize_and_chips(rnd);
+            for (int i = 0; i < 20; ++i)
+                test_external_image(rnd);
+            test_streaming_image_loaders();
+
             for (int i = 0; i < 100; ++i)
                 test_filtering_center<float>(rnd);
             for (int i = 0; i < 100; ++i)
@@ -1072,6 +1072,49 @@ namespace
 
     }
 
+    void test_default_float_multiply()
+    {
+        // Call default_matrix_multiply() directly so the non-BLAS float code path is
+        // tested even when dlib is linked against a BLAS library.
+        dlib::rand rnd;
+        for (int iter = 0; iter < 30; ++iter)
+        {
+            print_spinner();
+            const long nr = rnd.get_random_32bit_number()%150+1;
+            const long nk = rnd.get_random_32bit_number()%300+1;
+            const long nc = rnd.get_random_32bit_number()%150+1;
+
+            matrix<float> a(nr,nk), b(nk,nc), bt(nc,nk);
+            for (long r = 0; r < a.nr(); ++r)
+                for (long c = 0; c < a.nc(); ++c)
+                    a(r,c) = rnd.get_random_gaussian();
+            for (long r = 0; r < b.nr(); ++r)
+                for (long c = 0; c < b.nc(); ++c)
+                    b(r,c) = rnd.get_random_gaussian();
+            bt = trans(b);
+
+            const matrix<double> truth = matrix_cast<double>(a)*matrix_cast<double>(b);
+            const matrix<float> init = 10*ones_matrix<float>(nr,nc);
+
+            matrix<float> dest = init;
+            default_matrix_multiply(dest, a, b);
+            DLIB_TEST_MSG(max(abs(matrix_cast<double>(dest-init) - truth)) < 1e-3, 
+                max(abs(matrix_cast<double>(dest-init) - truth)));
+
+            dest = init;
+            default_matrix_multiply(dest, a, trans(bt));
+            DLIB_TEST(max(abs(matrix_cast<double>(dest-init) - truth)) < 1e-3);
+
+            matrix<float,0,0,default_memory_manager,column_major_layout> cdest = init;
+            default_matrix_multiply(cdest, a, trans(bt));
+            DLIB_TEST(max(abs(matrix_cast<double>(cdest-init) - truth)) < 1e-3);
+
+            dest = init;
+            default_matrix_multiply(dest, trans(trans(a)), 2*b);
+            DLIB_TEST(max(abs(matrix_cast<double>(dest-init) - 2*truth)) < 1e-3);
+        }
+    }
+
     class matrix_tester : public tester
     {
     public:
@@ -1096,6 +1139,7 @@ namespace
 
             test_complex();
             test_linpiece();
+            test_default_float_multiply();
         }
     } a;
 
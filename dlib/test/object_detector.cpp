@@ -430,6 +430,65 @@ namespace
             DLIB_TEST(d1.size() == d2.size());
             DLIB_TEST(set_intersection_size(d1,d2) == d1.size());
         }
+
+        {
+            // The batch version of operator() must give the same outputs as running the
+            // images through one at a time.
+            object_detector<image_scanner_type> detector3(std::vector<object_detector<image_scanner_type> >(3, detector));
+            std::vector<matrix<unsigned char> > imgs(images.size()*2);
+            for (unsigned long i = 0; i < imgs.size(); ++i)
+                assign_image(imgs[i], images[i%images.size()]);
+            for (int iter = 0; iter < 2; ++iter)
+            {
+                std::vector<std::vector<rect_detection> > dets;
+                detector3(imgs, dets, -0.5);
+                std::vector<std::vector<rectangle> > rects = detector3(imgs);
+                DLIB_TEST(dets.size() == imgs.size());
+                DLIB_TEST(rects.size() == imgs.size());
+                for (unsigned long i = 0; i < imgs.size(); ++i)
+                {
+                    std::vector<rect_detection> truth;
+                    detector3(imgs[i], truth, -0.5);
+                    DLIB_TEST(truth.size() > 0);
+                    DLIB_TEST(dets[i].size() == truth.size());
+                    for (unsigned long j = 0; j < truth.size(); ++j)
+                    {
+                        DLIB_TEST(dets[i][j].rect == truth[j].rect);
+                        DLIB_TEST(dets[i][j].weight_index == truth[j].weight_index);
+                        DLIB_TEST(dets[i][j].detection_confidence == truth[j].detection_confidence);
+                    }
+                    DLIB_TEST(rects[i] == detector3(imgs[i]));
+                }
+            }
+        }
+
+        {
+            // Parallel processing inside the scanner must not change the outputs.
+            array2d<unsigned char> big(images[0].nr()*7/2, images[0].nc()*7/2);
+            resize_image(images[0], big);
+
+            thread_pool tp(4);
+            image_scanner_type scanner1, scanner2;
+            scanner1.copy_configuration(detector.get_scanner());
+            scanner2.copy_configuration(detector.get_scanner());
+            DLIB_TEST(scanner2.get_thread_pool() == 0);
+            scanner2.enable_parallel_processing(tp);
+            DLIB_TEST(scanner2.get_thread_pool() == &tp);
+            scanner1.load(big);
+            scanner2.load(big);
+            std::vector<std::pair<double, rectangle> > dets1, dets2;
+            scanner1.detect(detector.get_w(), dets1, -std::numeric_limits<double>::infinity());
+            scanner2.detect(detector.get_w(), dets2, -std::numeric_limits<double>::infinity());
+            DLIB_TEST(dets1.size() > 1000);
+            DLIB_TEST(dets1.size() == dets2.size());
+            for (unsigned long i = 0; i < dets1.size() && i < dets2.size(); ++i)
+                DLIB_TEST(dets1[i] == dets2[i]);
+
+            object_detector<image_scanner_type> pdetector(scanner2, detector.get_overlap_tester(), detector.get_w());
+            DLIB_TEST(pdetector.get_scanner().get_thread_pool() == &tp);
+            std::vector<object_detector<image_scanner_type> > detectors(2, detector), pdetectors(2, pdetector);
+            DLIB_TEST(evaluate_detectors(detectors, big, -1) == evaluate_detectors(pdetectors, big, -1));
+        }
     }
 
 // ----------------------------------------------------------------------------------------
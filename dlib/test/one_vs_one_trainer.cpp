@@ -130,6 +130,9 @@ namespace
 
             randomize_samples(samples, labels);
             matrix<double> res = cross_validate_multiclass_trainer(trainer, samples, labels, 2);
+            DLIB_TEST(cross_validate_multiclass_trainer(trainer, samples, labels, 2, 2) == res);
+            DLIB_TEST(cross_validate_multiclass_trainer(trainer, samples, labels, 5, 3) ==
+                      cross_validate_multiclass_trainer(trainer, samples, labels, 5));
 
             print_spinner();
 
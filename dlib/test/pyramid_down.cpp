@@ -304,6 +304,73 @@ void test_pyramid_down_small_sizes()
     }
 }
 
+// ----------------------------------------------------------------------------------------
+
+void test_pyramid_down_2_fast_path()
+{
+    // pyramid_down<2> has a vectorized version for unsigned char, rgb_pixel and
+    // bgr_pixel images.  It must give exactly the same output as the generic code, which
+    // is what runs when the input and output pixel types differ.
+    dlib::rand rnd;
+    pyramid_down<2> pyr;
+    for (int iter = 0; iter < 100; ++iter)
+    {
+        const long nr = rnd.get_random_32bit_number()%80;
+        const long nc = rnd.get_random_32bit_number()%80;
+        array2d<unsigned char> gray(nr,nc), gray_down;
+        array2d<rgb_pixel> rgb(nr,nc), rgb_down;
+        array2d<bgr_pixel> bgr(nr,nc), bgr_down;
+        array2d<int> gray_ref;
+        array2d<bgr_pixel> rgb_ref;
+        array2d<rgb_pixel> bgr_ref;
+        for (long r = 0; r < nr; ++r)
+        {
+            for (long c = 0; c < nc; ++c)
+            {
+                // Use saturated images sometimes to check that nothing overflows.
+                if (iter%4 == 0)
+                {
+                    gray[r][c] = 255;
+                    rgb[r][c] = rgb_pixel(255,255,255);
+                }
+                else
+                {
+                    gray[r][c] = rnd.get_random_8bit_number();
+                    rgb[r][c].red = rnd.get_random_8bit_number();
+                    rgb[r][c].green = rnd.get_random_8bit_number();
+                    rgb[r][c].blue = rnd.get_random_8bit_number();
+                }
+                assign_pixel(bgr[r][c], rgb[r][c]);
+            }
+        }
+
+        pyr(gray, gray_down);
+        pyr(gray, gray_ref);
+        pyr(rgb, rgb_down);
+        pyr(rgb, rgb_ref);
+        pyr(bgr, bgr_down);
+        pyr(bgr, bgr_ref);
+
+        DLIB_TEST(mat(gray_down) == matrix_cast<unsigned char>(mat(gray_ref)));
+        DLIB_TEST(rgb_down.nr() == rgb_ref.nr() && rgb_down.nc() == rgb_ref.nc());
+        DLIB_TEST(bgr_down.nr() == rgb_ref.nr() && bgr_down.nc() == rgb_ref.nc());
+        DLIB_TEST(bgr_ref.nr() == rgb_ref.nr() && bgr_ref.nc() == rgb_ref.nc());
+        for (long r = 0; r < rgb_ref.nr(); ++r)
+        {
+            for (long c = 0; c < rgb_ref.nc(); ++c)
+            {
+                DLIB_TEST(rgb_down[r][c].red   == rgb_ref[r][c].red);
+                DLIB_TEST(rgb_down[r][c].green == rgb_ref[r][c].green);
+                DLIB_TEST(rgb_down[r][c].blue  == rgb_ref[r][c].blue);
+                DLIB_TEST(bgr_down[r][c].red   == bgr_ref[r][c].red);
+                DLIB_TEST(bgr_down[r][c].green == bgr_ref[r][c].green);
+                DLIB_TEST(bgr_down[r][c].blue  == bgr_ref[r][c].blue);
+                DLIB_TEST(bgr_down[r][c].red   == rgb_down[r][c].red);
+            }
+        }
+    }
+}
+
 // ----------------------------------------------------------------------------------------
 
 
@@ -323,6 +390,8 @@ void test_pyramid_down_small_sizes()
             test_pyramid_down_grayscale();
             print_spinner();
             test_pyramid_down_rgb();
+            print_spinner();
+            test_pyramid_down_2_fast_path();
 
             print_spinner();
             dlog << LINFO << "call test_pyramid_down_small_sizes<pyramid_down<2> >();";
@@ -2,11 +2,14 @@
 // License: Boost Software License   See LICENSE.txt for the full license.
 #include <dlib/svm.h>
 #include <dlib/rand.h>
+#include <dlib/data_io.h>
 #include <sstream>
 #include <string>
 #include <cstdlib>
+#include <cstdio>
 #include <ctime>
 #include <map>
+#include <fstream>
 
 #include "tester.h"
 
@@ -197,6 +200,7 @@ namespace
 
         dlog << LINFO << "cv-accuracy: "<< cross_validate_ranking_trainer(trainer, samples,2);
         DLIB_TEST(std::abs(cross_validate_ranking_trainer(trainer, samples,2)(0) - 0.7777777778) < 0.0001);
+        DLIB_TEST(equal(cross_validate_ranking_trainer(trainer, samples,2,2), cross_validate_ranking_trainer(trainer, samples,2)));
 
         trainer.set_learns_nonnegative_weights(true);
         df = trainer.train(samples);
@@ -405,6 +409,125 @@ namespace
 
 // ----------------------------------------------------------------------------------------
 // ----------------------------------------------------------------------------------------
+// ----------------------------------------------------------------------------------------
+
+    void test_train_from_source()
+    {
+        print_spinner();
+        dlog << LINFO << "in test_train_from_source()";
+
+        typedef std::vector<std::pair<unsigned long,double> > sample_type;
+        typedef sparse_linear_kernel<sample_type> kernel_type;
+
+        // Write an SVMrank style file and build the same ranking problem in memory.  The
+        // feature values are multiples of 1/4 so they come back from the file exactly.
+        dlib::rand rnd;
+        std::vector<ranking_pair<sample_type> > samples;
+        {
+            ofstream fout("ranking_source.dat");
+            fout << "# an SVMrank style file\n";
+            for (int q = 0; q < 30; ++q)
+            {
+                ranking_pair<sample_type> p;
+                for (int d = 0; d < 6; ++d)
+                {
+                    const int label = (d < 2) ? 1+d : 0;
+                    sample_type samp;
+                    fout << label << " qid:" << q;
+                    for (unsigned long j = 0; j < 8; ++j)
+                    {
+                        const double val = (rnd.get_random_32bit_number()%8)/4.0 + ((label > 0 && j < 3) ? 0.5 : 0);
+                        if (val != 0)
+                        {
+                            samp.push_back(make_pair(j+1, val));
+                            fout << " " << j+1 << ":" << val;
+                        }
+                    }
+                    fout << "\n";
+
+                    if (label > 0)
+                        p.relevant.push_back(samp);
+                    else
+                        p.nonrelevant.push_back(samp);
+                }
+                samples.push_back(p);
+
+                // A query with nothing relevant in it should be skipped by the source.
+                if (q == 10)
+                    fout << "0 qid:ignored 1:1\n0 qid:ignored 2:1\n";
+            }
+        }
+
+        libsvm_ranking_source<sample_type> source("ranking_source.dat", 4);
+        std::vector<ranking_pair<sample_type> > batch;
+        unsigned long num_queries = 0;
+        while (source.next_batch(batch))
+        {
+            DLIB_TEST(batch.size() <= 4);
+            num_queries += batch.size();
+        }
+        DLIB_TEST(num_queries == samples.size());
+
+        // Streaming the queries gives exactly the same result as training on them all at
+        // once.
+        svm_rank_trainer<kernel_type> trainer;
+        trainer.set_c(5);
+        decision_function<kernel_type> df = trainer.train(samples);
+        decision_function<kernel_type> df2 = trainer.train_from_source(source);
+        DLIB_TEST(df.basis_vectors(0) == df2.basis_vectors(0));
+        dlog << LINFO << "accuracy: "<< test_ranking_function(df2, samples);
+        DLIB_TEST(test_ranking_function(df2, samples)(0) > 0.75);
+
+        // The risk can be computed with several threads, also when streaming.  The
+        // results are deterministic and match the single threaded ones.
+        svm_rank_trainer<kernel_type> trainer2(trainer);
+        trainer2.set_epsilon(1e-10);
+        df = trainer2.train(samples);
+        DLIB_TEST(trainer2.get_num_threads() == 1);
+        trainer2.set_num_threads(3);
+        DLIB_TEST(trainer2.get_num_threads() == 3);
+        decision_function<kernel_type> df3 = trainer2.train(samples);
+        decision_function<kernel_type> df4 = trainer2.train(samples);
+        decision_function<kernel_type> df5 = trainer2.train_from_source(source);
+        DLIB_TEST(df3.basis_vectors(0) == df4.basis_vectors(0));
+        dlog << LINFO << "threaded distance: " << dlib::distance(df.basis_vectors(0), df3.basis_vectors(0));
+        dlog << LINFO << "threaded streaming distance: " << dlib::distance(df.basis_vectors(0), df5.basis_vectors(0));
+        DLIB_TEST(dlib::distance(df.basis_vectors(0), df3.basis_vectors(0)) < 1e-4);
+        DLIB_TEST(dlib::distance(df.basis_vectors(0), df5.basis_vectors(0)) < 1e-4);
+
+        // The qid fields don't trip up load_libsvm_formatted_data().
+        std::vector<sample_type> x;
+        std::vector<double> y;
+        load_libsvm_formatted_data("ranking_source.dat", x, y);
+        DLIB_TEST(x.size() == 30*6+2);
+        DLIB_TEST(x[0] == samples[0].relevant[0]);
+
+        // Files that are missing or malformed are reported with sample_data_io_error.
+        std::remove("ranking_source.dat");
+        bool caught = false;
+        try { libsvm_ranking_source<sample_type> missing("ranking_source.dat"); }
+        catch (sample_data_io_error&) { caught = true; }
+        DLIB_TEST(caught);
+        caught = false;
+        try { load_libsvm_formatted_data("ranking_source.dat", x, y); }
+        catch (sample_data_io_error&) { caught = true; }
+        DLIB_TEST(caught);
+        {
+            ofstream fout("ranking_source.dat");
+            fout << "1 qid:1 1:1\n0 qid:1 1:0.5\n1 qid:2 1 0.5\n";
+        }
+        libsvm_ranking_source<sample_type> bad_source("ranking_source.dat");
+        caught = false;
+        try { bad_source.next_batch(batch); }
+        catch (sample_data_io_error&) { caught = true; }
+        DLIB_TEST(caught);
+        caught = false;
+        try { load_libsvm_formatted_data("ranking_source.dat", x, y); }
+        catch (sample_data_io_error&) { caught = true; }
+        DLIB_TEST(caught);
+        std::remove("ranking_source.dat");
+    }
+
 // ----------------------------------------------------------------------------------------
 
     class test_ranking_tools : public tester
@@ -427,6 +550,7 @@ namespace
             test_svmrank_weight_force_dense<false>();
             run_prior_test();
             run_prior_sparse_test();
+            test_train_from_source();
 
         }
     } a;
@@ -342,6 +342,7 @@ namespace
         double accuracy = sum(diag(confusion_matrix))/sum(confusion_matrix);
         dlog << LINFO << "label accuracy: "<< accuracy;
         DLIB_TEST(std::abs(accuracy - 0.882) < 0.01);
+        DLIB_TEST(cross_validate_sequence_labeler(trainer, samples, labels, 4, 3) == confusion_matrix);
 
         print_spinner();
 
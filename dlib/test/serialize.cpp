@@ -940,6 +940,102 @@ namespace
         }
     }
 
+// ----------------------------------------------------------------------------------------
+
+    void test_bulk_serialization()
+    {
+        print_spinner();
+        dlib::rand rnd;
+
+        matrix<double> md = randm(13,7,rnd) - 0.5;
+        matrix<float,0,1> mf = matrix_cast<float>(randm(29,1,rnd));
+        matrix<long,3,4> ml;
+        for (long r = 0; r < ml.nr(); ++r)
+            for (long c = 0; c < ml.nc(); ++c)
+                ml(r,c) = (long)(rnd.get_random_32bit_number()) - 2000000000L;
+        matrix<double,0,0,default_memory_manager,column_major_layout> mcol = md;
+        array2d<float> af(5,6);
+        for (long r = 0; r < af.nr(); ++r)
+            for (long c = 0; c < af.nc(); ++c)
+                af[r][c] = rnd.get_random_gaussian();
+        std::vector<double> vd(1000);
+        for (unsigned long i = 0; i < vd.size(); ++i)
+            vd[i] = rnd.get_random_gaussian();
+        std::vector<int> vi;
+        for (int i = -10; i < 30; ++i)
+            vi.push_back(i*100000);
+        std::vector<unsigned long> vempty;
+        matrix<double> mempty;
+
+        ostringstream sout;
+        dlib::serialize(md, sout);
+        // The bulk format is just a small header followed by the raw values.
+        DLIB_TEST(sout.str().size() < md.size()*sizeof(double) + 10);
+        DLIB_TEST((unsigned char)sout.str()[0] == 0x5B);
+        dlib::serialize(mf, sout);
+        dlib::serialize(ml, sout);
+        dlib::serialize(mcol, sout);
+        dlib::serialize(af, sout);
+        dlib::serialize(vd, sout);
+        dlib::serialize(vi, sout);
+        dlib::serialize(vempty, sout);
+        dlib::serialize(mempty, sout);
+        dlib::serialize(mf, sout);
+        dlib::serialize(af, sout);
+        dlib::serialize(vi, sout);
+        dlib::serialize(md, sout);
+        dlib::serialize(std::string("the end"), sout);
+
+        istringstream sin(sout.str());
+        matrix<double> md2;
+        matrix<float,0,1> mf2;
+        matrix<long,3,4> ml2;
+        matrix<double,0,0,default_memory_manager,column_major_layout> mcol2;
+        array2d<float> af2;
+        std::vector<double> vd2;
+        std::vector<int> vi2;
+        std::vector<unsigned long> vempty2(4);
+        matrix<double> mempty2 = md;
+        dlib::deserialize(md2, sin);        DLIB_TEST(md2 == md);
+        dlib::deserialize(mf2, sin);        DLIB_TEST(mf2 == mf);
+        dlib::deserialize(ml2, sin);        DLIB_TEST(ml2 == ml);
+        dlib::deserialize(mcol2, sin);      DLIB_TEST(mcol2 == mcol);
+        dlib::deserialize(af2, sin);        DLIB_TEST(mat(af2) == mat(af));
+        dlib::deserialize(vd2, sin);        DLIB_TEST(vd2 == vd);
+        dlib::deserialize(vi2, sin);        DLIB_TEST(vi2 == vi);
+        dlib::deserialize(vempty2, sin);    DLIB_TEST(vempty2.size() == 0);
+        dlib::deserialize(mempty2, sin);    DLIB_TEST(mempty2.size() == 0);
+
+        // Reading into a different type converts the values.
+        matrix<double> mdf;
+        matrix<float> maf;
+        std::vector<long> vl;
+        dlib::deserialize(mdf, sin);        DLIB_TEST(mdf == matrix_cast<double>(mf));
+        dlib::deserialize(maf, sin);        DLIB_TEST(maf == mat(af));
+        dlib::deserialize(vl, sin);         DLIB_TEST(mat(vl) == matrix_cast<long>(mat(vi)));
+        array2d<double> ad;
+        dlib::deserialize(ad, sin);         DLIB_TEST(mat(ad) == md);
+        std::string str;
+        dlib::deserialize(str, sin);        DLIB_TEST(str == "the end");
+
+        // Objects written in the older element by element formats can still be read.
+        sout.str("");
+        dlib::serialize(-md.nr(), sout);
+        dlib::serialize(-md.nc(), sout);
+        for (long r = 0; r < md.nr(); ++r)
+            for (long c = 0; c < md.nc(); ++c)
+                dlib::serialize(md(r,c), sout);
+        dlib::serialize(vd.size(), sout);
+        for (unsigned long i = 0; i < vd.size(); ++i)
+            dlib::serialize(vd[i], sout);
+        sin.clear();
+        sin.str(sout.str());
+        md2.set_size(0,0);
+        vd2.clear();
+        dlib::deserialize(md2, sin);        DLIB_TEST(md2 == md);
+        dlib::deserialize(vd2, sin);        DLIB_TEST(vd2 == vd);
+    }
+
 // ----------------------------------------------------------------------------------------
 
     void test_strings()
@@ -1019,6 +1115,7 @@ namespace
             test_vector<int>();
             test_vector_bool();
             test_array2d_and_matrix_serialization();
+            test_bulk_serialization();
             test_strings();
         }
     } a;
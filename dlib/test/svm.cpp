@@ -254,6 +254,11 @@ namespace
         DLIB_TEST(cv(0) < 1e-4);
         DLIB_TEST(cv(1) > 0.99);
 
+        // Running the folds in parallel must not change the results at all.
+        DLIB_TEST(cross_validate_regression_trainer(krr_test, samples, labels, 6, 4) ==
+                  cross_validate_regression_trainer(krr_test, samples, labels, 6));
+        DLIB_TEST(cross_validate_regression_trainer(svr_test, samples, labels, 6, 3) == cv);
+
 
 
 
@@ -633,6 +638,147 @@ namespace
 
     }
 
+// ----------------------------------------------------------------------------------------
+
+    template <typename sample_type>
+    void test_fast_radial_basis_kernel_values()
+    {
+        typedef typename sample_type::type scalar_type;
+        dlib::rand rnd;
+        const radial_basis_kernel<sample_type> k(0.1);
+        const fast_radial_basis_kernel<sample_type> fk(0.1);
+        for (long n = 0; n < 40; ++n)
+        {
+            const sample_type a = matrix_cast<scalar_type>(randm(n,1,rnd));
+            const sample_type b = matrix_cast<scalar_type>(randm(n,1,rnd));
+            DLIB_TEST(std::abs(fk(a,b) - k(a,b)) < 1e-6);
+            DLIB_TEST(fk(a,a) == 1);
+        }
+    }
+
+    void test_fast_radial_basis_kernel()
+    {
+        print_spinner();
+        test_fast_radial_basis_kernel_values<matrix<float,0,1> >();
+        test_fast_radial_basis_kernel_values<matrix<double,0,1> >();
+        test_fast_radial_basis_kernel_values<matrix<float,19,1> >();
+
+        typedef matrix<float,0,1> sample_type;
+        typedef fast_radial_basis_kernel<sample_type> kernel_type;
+        dlib::rand rnd;
+        std::vector<sample_type> samples;
+        std::vector<float> labels;
+        for (int i = 0; i < 300; ++i)
+        {
+            sample_type samp = matrix_cast<float>(randm(19,1,rnd));
+            samples.push_back(samp);
+            labels.push_back(sum(samp) > 9.5 ? +1 : -1);
+        }
+
+        svm_c_trainer<kernel_type> trainer(kernel_type(0.1), 10);
+        trainer.set_num_threads(3);
+        const decision_function<kernel_type> df = trainer.train(samples, labels);
+        svm_c_trainer<radial_basis_kernel<sample_type> > exact_trainer(radial_basis_kernel<sample_type>(0.1), 10);
+        const decision_function<radial_basis_kernel<sample_type> > exact_df = exact_trainer.train(samples, labels);
+        for (unsigned long i = 0; i < samples.size(); ++i)
+            DLIB_TEST_MSG(std::abs(df(samples[i]) - exact_df(samples[i])) < 1e-3, df(samples[i]) - exact_df(samples[i]));
+
+        ostringstream sout;
+        serialize(df, sout);
+        istringstream sin(sout.str());
+        decision_function<kernel_type> df2;
+        deserialize(df2, sin);
+        DLIB_TEST(df2.kernel_function == df.kernel_function);
+        DLIB_TEST(df2(samples[0]) == df(samples[0]));
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_threaded_smo_trainers()
+    {
+        print_spinner();
+        typedef matrix<float,0,1> sample_type;
+        typedef radial_basis_kernel<sample_type> kernel_type;
+        dlib::rand rnd;
+
+        std::vector<sample_type> samples;
+        std::vector<float> labels, targets;
+        for (int i = 0; i < 300; ++i)
+        {
+            sample_type samp = matrix_cast<float>(randm(19,1,rnd));
+            samples.push_back(samp);
+            labels.push_back(sum(samp) > 9.5 ? +1 : -1);
+            targets.push_back(std::sin(sum(samp)));
+        }
+
+        const kernel_type k(0.1);
+
+        // Computing the kernel columns with several threads gives the same results.
+        svm_c_trainer<kernel_type> c_trainer(k, 10);
+        svm_nu_trainer<kernel_type> nu_trainer(k, 0.1);
+        svr_trainer<kernel_type> r_trainer;
+        r_trainer.set_kernel(k);
+        // Use a tiny cache so columns have to be recomputed a lot.
+        c_trainer.set_cache_size(1);
+        nu_trainer.set_cache_size(1);
+        r_trainer.set_cache_size(1);
+        DLIB_TEST(c_trainer.get_num_threads() == 1);
+        DLIB_TEST(nu_trainer.get_num_threads() == 1);
+        DLIB_TEST(r_trainer.get_num_threads() == 1);
+        const decision_function<kernel_type> c_df = c_trainer.train(samples, labels);
+        const decision_function<kernel_type> nu_df = nu_trainer.train(samples, labels);
+        const decision_function<kernel_type> r_df = r_trainer.train(samples, targets);
+
+        c_trainer.set_num_threads(3);
+        nu_trainer.set_num_threads(3);
+        r_trainer.set_num_threads(3);
+        DLIB_TEST(c_trainer.get_num_threads() == 3);
+        const decision_function<kernel_type> c_df2 = c_trainer.train(samples, labels);
+        const decision_function<kernel_type> nu_df2 = nu_trainer.train(samples, labels);
+        const decision_function<kernel_type> r_df2 = r_trainer.train(samples, targets);
+
+        DLIB_TEST(c_df.alpha == c_df2.alpha && c_df.b == c_df2.b);
+        DLIB_TEST(nu_df.alpha == nu_df2.alpha && nu_df.b == nu_df2.b);
+        DLIB_TEST(r_df.alpha == r_df2.alpha && r_df.b == r_df2.b);
+        DLIB_TEST(c_df.alpha.size() > 0);
+        long num_wrong = 0;
+        for (unsigned long i = 0; i < samples.size(); ++i)
+        {
+            if (c_df2(samples[i])*labels[i] <= 0)
+                ++num_wrong;
+        }
+        DLIB_TEST_MSG(num_wrong < 30, num_wrong);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_cross_validation_folds()
+    {
+        print_spinner();
+        for (unsigned long num_threads = 1; num_threads <= 4; ++num_threads)
+        {
+            std::vector<long> calls(7, 0);
+            run_cross_validation_folds(7, num_threads, [&](long fold) { calls[fold] += fold+1; });
+            for (long i = 0; i < 7; ++i)
+                DLIB_TEST(calls[i] == i+1);
+
+            // The exception from the first failing fold is the one that comes out.
+            try
+            {
+                run_cross_validation_folds(7, num_threads, [&](long fold) 
+                    {
+                        if (fold == 2 || fold == 5) 
+                            throw dlib::error(cast_to_string(fold)); 
+                    });
+                DLIB_TEST(false);
+            }
+            catch (dlib::error& e)
+            {
+                DLIB_TEST(e.info == "2");
+            }
+        }
+    }
+
 // ----------------------------------------------------------------------------------------
 
     class svm_tester : public tester
@@ -653,6 +799,9 @@ namespace
             test_regression();
             test_anomaly_detection();
             test_svm_trainer2();
+            test_threaded_smo_trainers();
+            test_fast_radial_basis_kernel();
+            test_cross_validation_folds();
         }
     } a;
 
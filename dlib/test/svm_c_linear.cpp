@@ -16,6 +16,7 @@
 
 #include "tester.h"
 #include <dlib/svm.h>
+#include <dlib/data_io.h>
 
 
 namespace  
@@ -241,6 +242,96 @@ namespace
 
     }
 
+// ----------------------------------------------------------------------------------------
+
+    void test_train_from_source (
+    )
+    {
+        print_spinner();
+        dlog << LINFO << "test train_from_source()";
+        dlib::rand rnd;
+        std::vector<sparse_sample_type> samples;
+        std::vector<double> labels;
+        for (int i = 0; i < 200; ++i)
+        {
+            const double label = (i%2 == 0) ? +1 : -1;
+            sparse_sample_type samp;
+            for (unsigned int j = 0; j < 15; ++j)
+            {
+                if (rnd.get_random_double() < 0.4)
+                    samp.push_back(make_pair(j, rnd.get_random_gaussian() + ((j%3 == 0) ? label : 0)));
+            }
+            samples.push_back(samp);
+            labels.push_back(label);
+        }
+        save_libsvm_formatted_data("svm_c_linear_source.dat", samples, labels);
+        // Load the file back so the in-memory samples are exactly what the source reads.
+        load_libsvm_formatted_data("svm_c_linear_source.dat", samples, labels);
+
+        svm_c_linear_trainer<sparse_linear_kernel<sparse_sample_type> > trainer;
+        trainer.set_c(10);
+
+        // Streaming the samples in small batches gives exactly the same result as
+        // training on them all at once.
+        libsvm_sample_source<sparse_sample_type> source("svm_c_linear_source.dat", 17);
+        DLIB_TEST(source.get_batch_size() == 17);
+        double obj, obj2;
+        decision_function<sparse_linear_kernel<sparse_sample_type> > df = trainer.train(samples, labels, obj);
+        decision_function<sparse_linear_kernel<sparse_sample_type> > df2 = trainer.train_from_source(source, obj2);
+        dlog << LINFO << "obj: " << obj;
+        DLIB_TEST(obj == obj2);
+        DLIB_TEST(df.b == df2.b);
+        DLIB_TEST(df.basis_vectors(0) == df2.basis_vectors(0));
+        DLIB_TEST(test_binary_decision_function(df2, samples, labels)(0) > 0.8);
+
+        trainer.set_prior(df);
+        trainer.set_c(1);
+        df = trainer.train(samples, labels);
+        df2 = trainer.train_from_source(source);
+        DLIB_TEST(df.b == df2.b);
+        DLIB_TEST(df.basis_vectors(0) == df2.basis_vectors(0));
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    void test_threaded (
+    )
+    {
+        print_spinner();
+        dlog << LINFO << "test_threaded()";
+        dlib::rand rnd;
+        std::vector<sample_type> samples;
+        std::vector<double> labels;
+        for (int i = 0; i < 500; ++i)
+        {
+            samples.push_back(randm(10,1,rnd));
+            labels.push_back(sum(samples.back()) + 0.3*rnd.get_random_gaussian() > 5 ? +1 : -1);
+        }
+
+        svm_c_linear_trainer<linear_kernel<sample_type> > trainer;
+        trainer.set_c(10);
+        trainer.set_epsilon(1e-6);
+        DLIB_TEST(trainer.get_num_threads() == 1);
+        svm_c_linear_trainer<linear_kernel<sample_type> > trainer2(trainer);
+        trainer2.set_num_threads(4);
+        DLIB_TEST(trainer2.get_num_threads() == 4);
+
+        double obj, obj2, obj3;
+        decision_function<linear_kernel<sample_type> > df = trainer.train(samples, labels, obj);
+        decision_function<linear_kernel<sample_type> > df2 = trainer2.train(samples, labels, obj2);
+        decision_function<linear_kernel<sample_type> > df3 = trainer2.train(samples, labels, obj3);
+        dlog << LINFO << "obj: " << obj << "  obj2: " << obj2;
+        DLIB_TEST(std::abs(obj - obj2) < 1e-6*obj);
+        DLIB_TEST_MSG(length(df.basis_vectors(0) - df2.basis_vectors(0)) < 1e-3, 
+            length(df.basis_vectors(0) - df2.basis_vectors(0)));
+        DLIB_TEST(std::abs(df.b - df2.b) < 1e-3);
+
+        // The threaded results don't depend on how the threads get scheduled.
+        DLIB_TEST(obj2 == obj3);
+        DLIB_TEST(df2.b == df3.b);
+        DLIB_TEST(equal(df2.basis_vectors(0), df3.basis_vectors(0)));
+    }
+
 // ----------------------------------------------------------------------------------------
 
     void test_dense (
@@ -294,6 +385,8 @@ namespace
             test_sparse();
             run_prior_test();
             run_prior_sparse_test();
+            test_train_from_source();
+            test_threaded();
 
             // test mixed sparse and dense dot products
             {
@@ -499,6 +499,175 @@ namespace
         DLIB_TEST(df(sample) < 0);
     }
 
+    template <typename sample_type>
+    struct linear_kernel_for { typedef sparse_linear_kernel<sample_type> type; };
+    template <>
+    struct linear_kernel_for<matrix<double,0,1> > { typedef linear_kernel<matrix<double,0,1> > type; };
+
+    void make_threaded_test_data (
+        std::vector<matrix<double,0,1> >& samples,
+        std::vector<double>& labels,
+        dlib::rand& rnd,
+        long num
+    )
+    {
+        for (long i = 0; i < num; ++i)
+        {
+            matrix<double,0,1> samp = randm(6,1,rnd);
+            // Make the last element a constant so force_last_weight_to_1() has something
+            // sensible to work with.
+            samp(5) = 1;
+            labels.push_back(sum(samp) + 0.3*rnd.get_random_gaussian() > 3.5 ? +1 : -1);
+            samples.push_back(samp);
+        }
+    }
+
+    void make_threaded_test_data (
+        std::vector<std::map<unsigned long,double> >& samples,
+        std::vector<double>& labels,
+        dlib::rand& rnd,
+        long num
+    )
+    {
+        for (long i = 0; i < num; ++i)
+        {
+            const double label = (rnd.get_random_double() > 0.5) ? +1 : -1;
+            std::map<unsigned long,double> samp;
+            for (int j = 0; j < 5; ++j)
+                samp[rnd.get_random_32bit_number()%20] = label*rnd.get_random_double() + 0.2*rnd.get_random_gaussian();
+            samples.push_back(samp);
+            labels.push_back(label);
+        }
+    }
+
+    double weight_distance (
+        const matrix<double,0,1>& a,
+        const matrix<double,0,1>& b
+    ) { return length(a-b); }
+
+    double weight_distance (
+        const std::map<unsigned long,double>& a,
+        const std::map<unsigned long,double>& b
+    ) { return dlib::distance(a,b); }
+
+    template <typename sample_type>
+    void test_threaded (
+        bool have_bias,
+        bool force_weight,
+        bool svm_l2
+    )
+    {
+        print_spinner();
+        typedef typename linear_kernel_for<sample_type>::type kernel_type;
+        dlib::rand rnd;
+        std::vector<sample_type> samples;
+        std::vector<double> labels;
+        make_threaded_test_data(samples, labels, rnd, 300);
+
+        svm_c_linear_dcd_trainer<kernel_type> trainer(0.05);
+        trainer.set_epsilon(1e-9);
+        trainer.include_bias(have_bias);
+        trainer.force_last_weight_to_1(force_weight);
+        trainer.solve_svm_l2_problem(svm_l2);
+        svm_c_linear_dcd_trainer<kernel_type> trainer2(trainer);
+        DLIB_TEST(trainer2.get_num_threads() == 1);
+        trainer2.set_num_threads(3);
+        DLIB_TEST(trainer2.get_num_threads() == 3);
+
+        // The parallel solver converges to the same solution as the serial one, also
+        // when warm started from a previous state.
+        typename svm_c_linear_dcd_trainer<kernel_type>::optimizer_state state, state2;
+        for (unsigned long n = 100; n <= samples.size(); n += 100)
+        {
+            const std::vector<sample_type> x(samples.begin(), samples.begin()+n);
+            const std::vector<double> y(labels.begin(), labels.begin()+n);
+            const decision_function<kernel_type> df = trainer.train(x, y, state);
+            const decision_function<kernel_type> df2 = trainer2.train(x, y, state2);
+            const decision_function<kernel_type> df3 = trainer2.train(x, y);
+            DLIB_TEST_MSG(weight_distance(df.basis_vectors(0), df2.basis_vectors(0)) < 1e-5, 
+                weight_distance(df.basis_vectors(0), df2.basis_vectors(0)));
+            DLIB_TEST(weight_distance(df.basis_vectors(0), df3.basis_vectors(0)) < 1e-5);
+            DLIB_TEST(std::abs(df.b - df2.b) < 1e-5);
+            DLIB_TEST(std::abs(df.b - df3.b) < 1e-5);
+            DLIB_TEST(state2.get_alpha().size() == n);
+        }
+
+        // The threaded solver is deterministic.
+        const decision_function<kernel_type> df4 = trainer2.train(samples, labels);
+        const decision_function<kernel_type> df5 = trainer2.train(samples, labels);
+        DLIB_TEST(weight_distance(df4.basis_vectors(0), df5.basis_vectors(0)) == 0);
+        DLIB_TEST(df4.b == df5.b);
+    }
+
+// ----------------------------------------------------------------------------------------
+
+    template <typename T>
+    class vector_sample_source
+    {
+        // A sample source that hands out an in-memory dataset in batches.
+    public:
+        typedef T sample_type;
+        typedef double label_type;
+
+        vector_sample_source (
+            const std::vector<T>& samples_,
+            const std::vector<double>& labels_,
+            unsigned long batch_size_
+        ) : samples(samples_), labels(labels_), batch_size(batch_size_), pos(0), num_resets(0) {}
+
+        void reset () { pos = 0; ++num_resets; }
+
+        bool next_batch (
+            std::vector<T>& x,
+            std::vector<double>& y
+        )
+        {
+            const unsigned long end = std::min<unsigned long>(pos+batch_size, samples.size());
+            x.assign(samples.begin()+pos, samples.begin()+end);
+            y.assign(labels.begin()+pos, labels.begin()+end);
+            pos = end;
+            return x.size() != 0;
+        }
+
+        const std::vector<T>& samples;
+        const std::vector<double>& labels;
+        unsigned long batch_size;
+        unsigned long pos;
+        unsigned long num_resets;
+    };
+
+    template <typename sample_type>
+    void test_train_from_source (
+        bool have_bias,
+        bool force_weight,
+        bool svm_l2
+    )
+    {
+        print_spinner();
+        typedef typename linear_kernel_for<sample_type>::type kernel_type;
+        dlib::rand rnd;
+        std::vector<sample_type> samples;
+        std::vector<double> labels;
+        make_threaded_test_data(samples, labels, rnd, 300);
+
+        svm_c_linear_dcd_trainer<kernel_type> trainer(0.05);
+        trainer.set_epsilon(1e-9);
+        trainer.include_bias(have_bias);
+        trainer.force_last_weight_to_1(force_weight);
+        trainer.solve_svm_l2_problem(svm_l2);
+
+        // Streaming the data in batches solves the same problem as loading it all.
+        vector_sample_source<sample_type> source(samples, labels, 37);
+        const decision_function<kernel_type> df = trainer.train(samples, labels);
+        const decision_function<kernel_type> df2 = trainer.train_from_source(source);
+        DLIB_TEST_MSG(weight_distance(df.basis_vectors(0), df2.basis_vectors(0)) < 1e-5, 
+            weight_distance(df.basis_vectors(0), df2.basis_vectors(0)));
+        DLIB_TEST(std::abs(df.b - df2.b) < 1e-5);
+        DLIB_TEST(source.num_resets > 2);
+    }
+
+// ----------------------------------------------------------------------------------------
+
     class tester_svm_c_linear_dcd : public tester
     {
     public:
@@ -535,6 +704,14 @@ namespace
             print_spinner();
 
             test_l2_version();
+
+            for (int i = 0; i < 8; ++i)
+            {
+                test_threaded<matrix<double,0,1> >(i&1, i&2, i&4);
+                test_threaded<std::map<unsigned long,double> >(i&1, false, i&4);
+                test_train_from_source<matrix<double,0,1> >(i&1, i&2, i&4);
+                test_train_from_source<std::map<unsigned long,double> >(i&1, false, i&4);
+            }
         }
     } a;
 
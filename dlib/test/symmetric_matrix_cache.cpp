@@ -187,9 +187,31 @@ namespace
         }
 
 
+        void test_threaded (
+            long csize 
+        )
+        {
+            print_spinner();
+            matrix<double> m = randm(300,300,rnd);
+            m = make_symmetric(m);
+
+            DLIB_TEST(equal(symmetric_matrix_cache<float>(m, csize, 3), matrix_cast<float>(m)));
+            DLIB_TEST(equal(symmetric_matrix_cache<double>(m, csize, 3), m));
+            for (long i = 0; i < m.nr(); i += 7)
+            {
+                DLIB_TEST(equal(colm(symmetric_matrix_cache<float>(m, csize, 2),i), colm(matrix_cast<float>(m),i)));
+                DLIB_TEST(equal(rowm(symmetric_matrix_cache<float>(m, csize, 4),i), rowm(matrix_cast<float>(m),i)));
+            }
+            test_colm_exp(symmetric_matrix_cache<float>(m,csize,3), matrix_cast<float>(m));
+            test_rowm_exp(symmetric_matrix_cache<float>(m,csize,3), matrix_cast<float>(m));
+            test_diag_exp(symmetric_matrix_cache<float>(m,csize,3), matrix_cast<float>(m));
+        }
+
         void perform_test (
         )
         {
+            test_threaded(0);
+            test_threaded(1);
 
             for (int itr = 0; itr < 5; ++itr)
             {